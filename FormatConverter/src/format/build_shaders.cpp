@@ -0,0 +1,352 @@
+#include "format.h"
+
+#include <util/shadergen.h>
+#include <util/shadercache.h>
+#include <util/shaderlibrary.h>
+#include <core/jobsystem.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <d3dcompiler.h>
+#endif
+
+using namespace FD;
+
+/*
+ Shader library manifest, one directive per line, # starts a comment:
+
+ shader <name>
+ vertex <file>
+ pixel <file>
+ geometry <file>
+ variable <vertex|pixel|geometry> <name> <value>...
+
+ Files are relative to the manifest. A value of - leaves the variable undefined. Every stage is
+ built for every combination of its own variables, a stage without variables is built once.
+ Files wrapped in a raw string literal (the shaders Frodo embeds with #include) are unwrapped.
+*/
+
+enum SHADER_STAGE {
+	SHADER_STAGE_VERTEX,
+	SHADER_STAGE_PIXEL,
+	SHADER_STAGE_GEOMETRY,
+	SHADER_STAGE_COUNT
+};
+
+//Same entry points and profiles as Shader::Compile. Only the profile is part of the cache key,
+//each profile has one entry point so it identifies that as well.
+static const char* stageNames[SHADER_STAGE_COUNT] = { "vertex", "pixel", "geometry" };
+static const char* stageProfiles[SHADER_STAGE_COUNT] = { "vs_5_0", "ps_5_0", "gs_5_0" };
+
+#ifdef _WIN32
+static const char* stageEntries[SHADER_STAGE_COUNT] = { "vsMain", "psMain", "gsMain" };
+#endif
+
+struct ShaderVariableValue {
+	bool defined;
+	float32 data;
+};
+
+struct ShaderVariableDeclaration {
+	String name;
+	SHADER_STAGE stage;
+	List<ShaderVariableValue> values;
+
+	ShaderVariableDeclaration() : values(8, 8) {}
+};
+
+struct ShaderDeclaration {
+	String name;
+	String templates[SHADER_STAGE_COUNT];
+	List<ShaderVariableDeclaration*> variables;
+
+	ShaderDeclaration() : variables(4, 4) {}
+	~ShaderDeclaration() { variables.Free(); }
+};
+
+//One stage of one permutation, built by a job
+struct ShaderBuildItem {
+	const ShaderDeclaration* shader;
+	SHADER_STAGE stage;
+	uint_t permutation;
+
+	ShaderLibraryStage* result;
+	bool failed;
+};
+
+static bool ParseStage(const String& token, SHADER_STAGE* stage) {
+	for (uint32 i = 0; i < SHADER_STAGE_COUNT; i++) {
+		if (token == stageNames[i]) {
+			*stage = (SHADER_STAGE)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//What the runtime parses when the file is #included into a const char*, comments are stripped like in the Shader constructor
+static String LoadTemplate(const String& filename) {
+	String source = FDReadTextFile(filename);
+
+	uint_t start = 0;
+
+	while (start < source.length && (source[start] == ' ' || source[start] == '\t' || source[start] == '\r' || source[start] == '\n')) start++;
+
+	if (start + 2 < source.length && source[start] == 'R' && source[start + 1] == '"') {
+		uint_t open = source.Find("(", start);
+		uint_t close = source.length;
+
+		if (open != (uint_t)-1) {
+			String delimiter = String(")") + source.SubString(start + 2, open) + "\"";
+
+			//The last occurrence of the closing delimiter
+			for (uint_t i = open; (i = source.Find(delimiter, i)) != (uint_t)-1; i++) close = i;
+		}
+
+		if (close == source.length) {
+			FD_WARNING("[ShaderBuild] \"%s\" has an unterminated raw string", *filename);
+			return source;
+		}
+
+		//Raw strings get \n line endings no matter what the file has
+		String result;
+
+		for (uint_t i = open + 1; i < close; i++) {
+			if (source[i] != '\r') result.Append(source[i]);
+		}
+
+		source = result;
+	}
+
+	ShaderGen::RemoveComments(source);
+
+	return source;
+}
+
+//Whitespace separated tokens of a line up to a #
+static void Tokenize(const char* line, const char* end, List<String*>& tokens) {
+	while (line < end && *line != '#') {
+		if (*line == ' ' || *line == '\t' || *line == '\r') {
+			line++;
+			continue;
+		}
+
+		const char* start = line;
+
+		while (line < end && *line != ' ' && *line != '\t' && *line != '\r' && *line != '#') line++;
+
+		tokens.Push_back(new String((char*)start, (uint_t)(line - start)));
+	}
+}
+
+static bool ParseManifest(const String& filename, List<ShaderDeclaration*>& shaders) {
+	String manifest = FDReadTextFile(filename);
+
+	uint_t slash = (uint_t)-1;
+
+	for (uint_t i = 0; i < filename.length; i++) {
+		if (filename[i] == '/' || filename[i] == '\\') slash = i;
+	}
+
+	String directory = slash == (uint_t)-1 ? String("") : filename.SubString(0, slash + 1);
+
+	ShaderDeclaration* shader = nullptr;
+	bool result = true;
+
+	List<String*> tokens(8, 8);
+	uint_t lineStart = 0;
+
+	for (uint_t i = 0; lineStart < manifest.length; i++) {
+		uint_t lineEnd = manifest.Find('\n', lineStart);
+		if (lineEnd == (uint_t)-1) lineEnd = manifest.length;
+
+		tokens.Free();
+		tokens.Clear();
+
+		Tokenize(manifest.str + lineStart, manifest.str + lineEnd, tokens);
+
+		lineStart = lineEnd + 1;
+
+		if (tokens.GetSize() == 0) continue;
+
+		const String& directive = (*tokens[0]);
+		SHADER_STAGE stage;
+
+		if (directive == "shader" && tokens.GetSize() == 2) {
+			shader = new ShaderDeclaration;
+			shader->name = (*tokens[1]);
+
+			shaders.Push_back(shader);
+		} else if (!shader) {
+			FD_WARNING("[ShaderBuild] %s:%u \"%s\" before the first shader", *filename, (uint32)(i + 1), *directive);
+			result = false;
+		} else if (ParseStage(directive, &stage) && tokens.GetSize() == 2) {
+			shader->templates[stage] = LoadTemplate(directory + (*tokens[1]));
+		} else if (directive == "variable" && tokens.GetSize() >= 4 && ParseStage((*tokens[1]), &stage)) {
+			ShaderVariableDeclaration* var = new ShaderVariableDeclaration;
+
+			var->name = (*tokens[2]);
+			var->stage = stage;
+
+			for (uint_t j = 3; j < tokens.GetSize(); j++) {
+				ShaderVariableValue value;
+
+				value.defined = (*tokens[j]) != "-";
+				value.data = value.defined ? (float32)atof(*(*tokens[j])) : 0.0f;
+
+				var->values.Push_back(value);
+			}
+
+			shader->variables.Push_back(var);
+		} else {
+			FD_WARNING("[ShaderBuild] %s:%u Malformed \"%s\"", *filename, (uint32)(i + 1), *directive);
+			result = false;
+		}
+	}
+
+	tokens.Free();
+
+	return result;
+}
+
+//Product of the value counts of the stage's variables
+static uint_t GetNumPermutations(const ShaderDeclaration* shader, SHADER_STAGE stage) {
+	uint_t count = 1;
+
+	for (uint_t i = 0; i < shader->variables.GetSize(); i++) {
+		const ShaderVariableDeclaration* var = shader->variables.Get(i);
+
+		if (var->stage == stage) count *= var->values.GetSize();
+	}
+
+	return count;
+}
+
+//Parses the stage template and sets the variables of the permutation, the index is split like a mixed radix number
+static void SetupShaderGen(ShaderGen& gen, const ShaderDeclaration* shader, SHADER_STAGE stage, uint_t permutation) {
+	gen.Parse(shader->templates[stage]);
+
+	for (uint_t i = 0; i < shader->variables.GetSize(); i++) {
+		const ShaderVariableDeclaration* var = shader->variables.Get(i);
+
+		if (var->stage != stage) continue;
+
+		uint_t numValues = var->values.GetSize();
+		ShaderVariableValue value = var->values.Get(permutation % numValues);
+
+		permutation /= numValues;
+
+		if (value.defined) gen.SetVariable(var->name, value.data);
+	}
+}
+
+static void BuildItem(ShaderBuildItem& item) {
+	ShaderGen gen;
+
+	SetupShaderGen(gen, item.shader, item.stage, item.permutation);
+
+	ShaderLibraryStage* stage = new ShaderLibraryStage;
+
+	stage->key = ShaderCache::MakeKey(gen.GetSourceHash(), gen.GetVariableHash(), stageProfiles[item.stage]);
+
+	gen.Generate(stage->source);
+
+	if (!stage->reflection.Parse(stage->source)) {
+		FD_WARNING("[ShaderBuild] %s %s permutation %u: reflection stopped at a syntax error", *item.shader->name, stageNames[item.stage], (uint32)item.permutation);
+		item.failed = true;
+	}
+
+#ifdef _WIN32
+	ID3DBlob* byteCode = nullptr;
+	ID3DBlob* error = nullptr;
+
+	D3DCompile(*stage->source, stage->source.length, 0, 0, 0, stageEntries[item.stage], stageProfiles[item.stage], 0, 0, &byteCode, &error);
+
+	if (error) {
+		FD_WARNING("[ShaderBuild] %s %s permutation %u: %s", *item.shader->name, stageNames[item.stage], (uint32)item.permutation, (const char*)error->GetBufferPointer());
+		error->Release();
+	}
+
+	if (byteCode) {
+		stage->byteCodeSize = (uint_t)byteCode->GetBufferSize();
+		stage->byteCode = (byte*)Memory::Allocate(stage->byteCodeSize, FD_MEMTAG_ASSET);
+
+		memcpy(stage->byteCode, byteCode->GetBufferPointer(), stage->byteCodeSize);
+
+		byteCode->Release();
+	} else {
+		item.failed = true;
+	}
+#endif
+
+	item.result = stage;
+}
+
+bool BuildShaderLibrary(const String& manifest, const String& output) {
+	List<ShaderDeclaration*> shaders(16, 16);
+
+	bool result = ParseManifest(manifest, shaders);
+
+	//Stages shared between shaders (the same template and variables) are only built once
+	List<ShaderBuildItem> items(256, 256);
+	List<uint64> keys(256, 256);
+
+	for (uint_t i = 0; i < shaders.GetSize(); i++) {
+		const ShaderDeclaration* shader = shaders.Get(i);
+
+		for (uint32 stage = 0; stage < SHADER_STAGE_COUNT; stage++) {
+			if (shader->templates[stage].length <= 1) continue;
+
+			uint_t numPermutations = GetNumPermutations(shader, (SHADER_STAGE)stage);
+
+			for (uint_t permutation = 0; permutation < numPermutations; permutation++) {
+				ShaderGen gen;
+
+				SetupShaderGen(gen, shader, (SHADER_STAGE)stage, permutation);
+
+				uint64 key = ShaderCache::MakeKey(gen.GetSourceHash(), gen.GetVariableHash(), stageProfiles[stage]);
+
+				if (keys.Find(key) != (uint_t)-1) continue;
+
+				keys.Push_back(key);
+
+				ShaderBuildItem item;
+
+				item.shader = shader;
+				item.stage = (SHADER_STAGE)stage;
+				item.permutation = permutation;
+				item.result = nullptr;
+				item.failed = false;
+
+				items.Push_back(item);
+			}
+		}
+	}
+
+	FD_INFO("[ShaderBuild] %u shaders, %u stages on %u threads", (uint32)shaders.GetSize(), (uint32)items.GetSize(), JobSystem::GetNumWorkers());
+
+	JobSystem::ParallelFor(items.GetSize(), 1, [&items](uint_t begin, uint_t end) {
+		for (uint_t i = begin; i < end; i++) BuildItem(items[i]);
+	});
+
+	ShaderLibrary library;
+
+	for (uint_t i = 0; i < items.GetSize(); i++) {
+		ShaderBuildItem& item = items[i];
+
+		if (item.failed) result = false;
+
+		library.Add(item.result);
+	}
+
+	shaders.Free();
+
+	if (!library.Write(output)) return false;
+
+	FD_INFO("[ShaderBuild] Wrote \"%s\"", *output);
+
+	return result;
+}
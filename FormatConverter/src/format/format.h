@@ -11,3 +11,6 @@
 
 
 bool ConvertOBJToFDM(const FD::String& filename, const FD::String& newFilename, uint32 attributes);
+
+//Generates, reflects and (on Windows) compiles every permutation declared in the manifest into a ShaderLibrary
+bool BuildShaderLibrary(const FD::String& manifest, const FD::String& output);
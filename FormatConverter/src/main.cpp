@@ -1,8 +1,33 @@
 #include "format/format.h"
+#include <core/jobsystem.h>
 
+using namespace FD;
+
+static void PrintUsage() {
+	printf("Usage: FormatConverter shaders <manifest> <output>\n");
+}
 
 int main(int argc, char** argv) {
+	if (argc < 2) {
+		PrintUsage();
+		return 1;
+	}
+
+	String command(argv[1]);
+
+	if (command == "shaders" && argc == 4) {
+		Logger::Init();
+		JobSystem::Init();
+
+		bool result = BuildShaderLibrary(argv[2], argv[3]);
+
+		JobSystem::Dispose();
+		Logger::Dispose();
 
+		return result ? 0 : 1;
+	}
 
+	PrintUsage();
 
-}
\ No newline at end of file
+	return 1;
+}
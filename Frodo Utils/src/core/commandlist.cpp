@@ -0,0 +1,57 @@
+#include "commandlist.h"
+
+namespace FD {
+
+RecordingCommandList::RecordingCommandList(List<RecordedCommand>* target) : commands(256, 256), target(target), recording(false) {
+
+}
+
+void RecordingCommandList::Begin() {
+	FD_ASSERT_MSG(recording, "[RecordingCommandList] Begin while recording");
+
+	commands.Clear();
+	recording = true;
+}
+
+void RecordingCommandList::End() {
+	FD_ASSERT_MSG(!recording, "[RecordingCommandList] End without Begin");
+
+	recording = false;
+}
+
+void RecordingCommandList::Execute() {
+	FD_ASSERT_MSG(recording, "[RecordingCommandList] Execute while recording");
+
+	if (target) {
+		for (uint_t i = 0; i < commands.GetSize(); i++) target->Push_back(commands[i]);
+	}
+
+	commands.Clear();
+}
+
+void RecordingCommandList::Record(uint32 id, uint64 argument) {
+	FD_ASSERT_MSG(!recording, "[RecordingCommandList] Record outside of Begin/End");
+
+	RecordedCommand cmd;
+
+	cmd.id = id;
+	cmd.argument = argument;
+
+	commands.Push_back(cmd);
+}
+
+ParallelRecorder::~ParallelRecorder() {
+	lists.Free();
+}
+
+void ParallelRecorder::AddList(CommandList* list) {
+	lists.Push_back(list);
+}
+
+void ParallelRecorder::Execute() {
+	for (uint_t i = 0; i < numRecorded; i++) lists[i]->Execute();
+
+	numRecorded = 0;
+}
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/list.h>
+#include <core/log.h>
+#include <core/jobsystem.h>
+
+namespace FD {
+
+/*
+ Commands recorded on one thread and executed later on the main thread. Backends only
+ implement the three steps, what a command is is up to them (the D3D backend records
+ into a deferred context).
+*/
+class FDUAPI CommandList {
+public:
+	virtual ~CommandList() {}
+
+	//On the recording thread, commands issued between Begin and End go to this list
+	virtual void Begin() = 0;
+	virtual void End() = 0;
+
+	//On the main thread, replays the recording and clears it
+	virtual void Execute() = 0;
+};
+
+struct RecordedCommand {
+	uint32 id;
+	uint64 argument;
+};
+
+/*
+ Backend without a device. Record stores an id and an argument, Execute appends them to the
+ target in order, a nullptr target drops them. Whatever the target ends up with after the
+ lists are executed is what recording on a single thread would have issued.
+*/
+class FDUAPI RecordingCommandList : public CommandList {
+private:
+	List<RecordedCommand> commands;
+	List<RecordedCommand>* target;
+
+	bool recording;
+
+public:
+	RecordingCommandList(List<RecordedCommand>* target = nullptr);
+
+	void Begin() override;
+	void End() override;
+	void Execute() override;
+
+	void Record(uint32 id, uint64 argument = 0);
+
+	inline const List<RecordedCommand>& GetCommands() const { return commands; }
+};
+
+/*
+ Splits count items into chunks, records the chunks into their own command lists on the job
+ system and executes the lists in chunk order, so the result is the same as recording them
+ one after the other. There are never more chunks than lists, a chunk is at least
+ minChunkSize items so small counts aren't split up for nothing.
+
+ The recorder owns the lists.
+*/
+class FDUAPI ParallelRecorder {
+private:
+	List<CommandList*> lists;
+	uint_t numRecorded;
+
+public:
+	ParallelRecorder() : lists(8, 8), numRecorded(0) {}
+	~ParallelRecorder();
+
+	ParallelRecorder(const ParallelRecorder& recorder) = delete;
+	ParallelRecorder& operator=(const ParallelRecorder& recorder) = delete;
+
+	void AddList(CommandList* list);
+
+	//func(list, begin, end) issues the commands for items [begin, end), returns the number of chunks
+	template<typename F>
+	uint_t Record(uint_t count, uint_t minChunkSize, const F& func) {
+		FD_ASSERT_MSG(lists.GetSize() == 0, "[ParallelRecorder] No command lists to record into");
+
+		if (count == 0) return numRecorded = 0;
+
+		uint_t chunkSize = minChunkSize ? minChunkSize : 1;
+		uint_t numChunks = (count + chunkSize - 1) / chunkSize;
+
+		if (numChunks > lists.GetSize()) numChunks = lists.GetSize();
+
+		//Even chunks, rounding can leave fewer than there are lists
+		chunkSize = (count + numChunks - 1) / numChunks;
+		numChunks = (count + chunkSize - 1) / chunkSize;
+
+		CommandList** data = lists.GetData();
+
+		JobSystem::ParallelFor(numChunks, 1, [data, count, chunkSize, &func](uint_t first, uint_t last) {
+			for (uint_t i = first; i < last; i++) {
+				uint_t begin = i * chunkSize;
+				uint_t end = begin + chunkSize < count ? begin + chunkSize : count;
+
+				data[i]->Begin();
+				func(data[i], begin, end);
+				data[i]->End();
+			}
+		});
+
+		return numRecorded = numChunks;
+	}
+
+	//Executes what the last Record recorded
+	void Execute();
+
+	inline uint_t GetNumLists() const { return lists.GetSize(); }
+};
+
+}
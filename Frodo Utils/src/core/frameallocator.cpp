@@ -0,0 +1,114 @@
+#include "frameallocator.h"
+#include "log.h"
+#include <stdlib.h>
+
+namespace FD {
+
+//Placed in front of every heap block, padded so the allocation after it stays 16 byte aligned
+struct FrameOverflowBlock {
+	void* next;
+	uint64 size;
+};
+
+FrameAllocator::Buffer FrameAllocator::buffers[2];
+uint32 FrameAllocator::current = 0;
+uint64 FrameAllocator::size = 0;
+uint64 FrameAllocator::peak = 0;
+
+void FrameAllocator::Init(uint64 size) {
+	Dispose();
+
+	for (uint32 i = 0; i < 2; i++) {
+		Buffer& buffer = buffers[i];
+
+		buffer.memory = (byte*)malloc(size);
+		buffer.offset = 0;
+		buffer.overflow = nullptr;
+		buffer.overflowBytes = 0;
+
+		if (!buffer.memory) {
+			FD_FATAL("[FrameAllocator] Failed to allocate %llu bytes", size);
+			size = 0;
+		}
+	}
+
+	FrameAllocator::size = size;
+	current = 0;
+}
+
+void FrameAllocator::Dispose() {
+	for (uint32 i = 0; i < 2; i++) {
+		ResetBuffer(buffers[i]);
+
+		free(buffers[i].memory);
+		buffers[i].memory = nullptr;
+	}
+
+	size = 0;
+}
+
+void FrameAllocator::ResetBuffer(Buffer& buffer) {
+	void* block = buffer.overflow;
+
+	while (block) {
+		void* next = ((FrameOverflowBlock*)block)->next;
+		free(block);
+		block = next;
+	}
+
+	buffer.offset = 0;
+	buffer.overflow = nullptr;
+	buffer.overflowBytes = 0;
+}
+
+void* FrameAllocator::AllocateOverflow(uint64 size, uint64 alignment) {
+	if (buffers[0].memory == nullptr) {
+		Init();
+
+		if (FrameAllocator::size != 0) return Allocate(size, alignment);
+	}
+
+	Buffer& buffer = buffers[current];
+
+	static bool warned = false;
+
+	if (!warned) {
+		FD_WARNING("[FrameAllocator] Frame buffer of %llu bytes is full, falling back to the heap. GetPeak shows the size needed", FrameAllocator::size);
+		warned = true;
+	}
+
+	uint64 header = (sizeof(FrameOverflowBlock) + alignment - 1) & ~(alignment - 1);
+
+	FrameOverflowBlock* block = (FrameOverflowBlock*)malloc(header + size + alignment);
+
+	if (!block) {
+		FD_FATAL("[FrameAllocator] Failed to allocate %llu bytes", size);
+		return nullptr;
+	}
+
+	block->next = buffer.overflow;
+	block->size = size;
+
+	buffer.overflow = block;
+	buffer.overflowBytes += size;
+
+	uint64 address = ((uint64)block + header + alignment - 1) & ~(alignment - 1);
+
+	return (void*)address;
+}
+
+void FrameAllocator::EndFrame() {
+	uint64 used = GetUsed();
+
+	if (used > peak) peak = used;
+
+	current ^= 1;
+
+	ResetBuffer(buffers[current]);
+}
+
+uint64 FrameAllocator::GetUsed() {
+	return buffers[current].offset + buffers[current].overflowBytes;
+}
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/list.h>
+#include <util/string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//Size of each of the two buffers if FrameAllocator::Init isn't called with a size
+#define FD_FRAME_ALLOCATOR_SIZE (4 << 20)
+
+namespace FD {
+
+/*
+ Bump allocator for data that doesn't outlive the frame. There are two buffers, allocations
+ come from the current one and stay valid until EndFrame has been called twice, so data
+ built in one frame can still be read in the next. EndFrame resets the other buffer in O(1).
+ When a buffer is full allocations fall back to the heap, those blocks are freed with the buffer.
+
+ Nothing is ever freed individually and destructors aren't run.
+ Main thread only, the buffers are created on the first allocation if Init wasn't called.
+*/
+class FDUAPI FrameAllocator {
+private:
+	struct Buffer {
+		byte* memory;
+		uint64 offset;
+
+		//Heap blocks for allocations that didn't fit, linked through their first bytes
+		void* overflow;
+		uint64 overflowBytes;
+	};
+
+	static Buffer buffers[2];
+	static uint32 current;
+	static uint64 size;
+	static uint64 peak;
+
+	static void* AllocateOverflow(uint64 size, uint64 alignment);
+	static void ResetBuffer(Buffer& buffer);
+
+public:
+	static void Init(uint64 size = FD_FRAME_ALLOCATOR_SIZE);
+	static void Dispose();
+
+	//alignment must be a power of 2
+	static __forceinline void* Allocate(uint64 size, uint64 alignment = 16) {
+		Buffer& buffer = buffers[current];
+
+		uint64 offset = (buffer.offset + alignment - 1) & ~(alignment - 1);
+
+		if (offset + size > FrameAllocator::size) return AllocateOverflow(size, alignment);
+
+		buffer.offset = offset + size;
+
+		return buffer.memory + offset;
+	}
+
+	template<typename T, typename... Args>
+	static T* New(Args&&... args) {
+		return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	//Elements are default initialized, same as new T[count]
+	template<typename T>
+	static T* NewArray(uint64 count) {
+		T* data = (T*)Allocate(count * sizeof(T), alignof(T));
+
+		if (!std::is_trivially_default_constructible<T>::value) {
+			for (uint64 i = 0; i < count; i++) new (data + i) T;
+		}
+
+		return data;
+	}
+
+	//Call once at the end of every frame
+	static void EndFrame();
+
+	//Bytes allocated from the current buffer this frame, including heap fallbacks
+	static uint64 GetUsed();
+	//Most bytes used by a single frame
+	static inline uint64 GetPeak() { return peak; }
+	static inline uint64 GetSize() { return size; }
+};
+
+//For std containers, deallocate does nothing
+template<typename T>
+class FrameStlAllocator {
+public:
+	typedef T value_type;
+
+	FrameStlAllocator() noexcept {}
+
+	template<typename U>
+	FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+	inline T* allocate(size_t count) { return (T*)FrameAllocator::Allocate(count * sizeof(T), alignof(T) > 16 ? alignof(T) : 16); }
+	inline void deallocate(T*, size_t) noexcept {}
+
+	template<typename U>
+	inline bool operator==(const FrameStlAllocator<U>&) const noexcept { return true; }
+	template<typename U>
+	inline bool operator!=(const FrameStlAllocator<U>&) const noexcept { return false; }
+};
+
+//List and String backed by the frame allocator. Their memory must not be used or freed after
+//the next EndFrame, keep them local to a frame.
+template<typename T>
+class FrameList : public List<T> {
+public:
+	FrameList(uint_t reserve = 16, uint_t extraReserve = 16) : List<T>(reserve, extraReserve, FD_MEMTAG_FRAME) {}
+};
+
+class FrameString : public String {
+public:
+	FrameString(const char* string) : String(string, FD_MEMTAG_FRAME) {}
+	FrameString(const String& string) : String(string, FD_MEMTAG_FRAME) {}
+	FrameString(const FrameString& string) : String(string, FD_MEMTAG_FRAME) {}
+	FrameString(char* string, uint_t length) : String(string, length, false, FD_MEMTAG_FRAME) {}
+};
+
+}
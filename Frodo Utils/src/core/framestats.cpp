@@ -0,0 +1,336 @@
+#include "framestats.h"
+#include "log.h"
+#include <chrono>
+#include <stdio.h>
+
+#ifdef FD_PLATFORM_WINDOWS
+#include <Windows.h>
+//GetProcessMemoryInfo maps to K32GetProcessMemoryInfo in kernel32, no extra library needed
+#include <Psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace FD {
+
+static uint64 GetTimeNanoseconds() {
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FrameTimeHistogram::FrameTimeHistogram() {
+	Clear();
+}
+
+uint_t FrameTimeHistogram::GetBucket(float64 ms) {
+	if (ms <= 0.0) return 0;
+
+	uint_t bucket = (uint_t)(ms / FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+
+	return bucket < FD_FRAMESTATS_HISTOGRAM_BUCKETS ? bucket : FD_FRAMESTATS_HISTOGRAM_BUCKETS - 1;
+}
+
+void FrameTimeHistogram::Add(float64 ms) {
+	if (count == FD_FRAMESTATS_WINDOW) {
+		float64 old = samples[next];
+
+		buckets[GetBucket(old)]--;
+		sum -= old;
+	} else {
+		count++;
+	}
+
+	samples[next] = ms;
+	buckets[GetBucket(ms)]++;
+	sum += ms;
+
+	next = (next + 1) % FD_FRAMESTATS_WINDOW;
+}
+
+void FrameTimeHistogram::Clear() {
+	memset(buckets, 0, sizeof(buckets));
+	memset(samples, 0, sizeof(samples));
+
+	count = 0;
+	next = 0;
+	sum = 0.0;
+}
+
+float64 FrameTimeHistogram::GetPercentile(float64 percentile) const {
+	if (count == 0) return 0.0;
+
+	uint_t target = (uint_t)(percentile * count + 0.5);
+
+	if (target < 1) target = 1;
+	if (target > count) target = count;
+
+	uint_t accumulated = 0;
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_HISTOGRAM_BUCKETS; i++) {
+		accumulated += buckets[i];
+
+		if (accumulated >= target) {
+			//Middle of the bucket, clamped so p0/p100 don't leave the measured range
+			float64 value = (i + 0.5) * FD_FRAMESTATS_HISTOGRAM_BUCKET_MS;
+			float64 min = GetMin();
+			float64 max = GetMax();
+
+			return value < min ? min : (value > max ? max : value);
+		}
+	}
+
+	return GetMax();
+}
+
+float64 FrameTimeHistogram::GetAverage() const {
+	return count ? sum / count : 0.0;
+}
+
+float64 FrameTimeHistogram::GetMin() const {
+	if (count == 0) return 0.0;
+
+	float64 min = samples[0];
+
+	for (uint_t i = 1; i < count; i++) {
+		if (samples[i] < min) min = samples[i];
+	}
+
+	return min;
+}
+
+float64 FrameTimeHistogram::GetMax() const {
+	float64 max = 0.0;
+
+	for (uint_t i = 0; i < count; i++) {
+		if (samples[i] > max) max = samples[i];
+	}
+
+	return max;
+}
+
+float64 FrameTimeHistogram::GetLast() const {
+	return count ? samples[(next + FD_FRAMESTATS_WINDOW - 1) % FD_FRAMESTATS_WINDOW] : 0.0;
+}
+
+std::atomic<uint64> FrameStats::counters[FD_FRAMESTATS_COUNTER_COUNT];
+uint64 FrameStats::counterHistory[FD_FRAMESTATS_COUNTER_COUNT][FD_FRAMESTATS_WINDOW];
+uint64 FrameStats::counterTotals[FD_FRAMESTATS_COUNTER_COUNT];
+
+FrameTimeHistogram FrameStats::timers[FD_FRAMESTATS_TIMER_COUNT];
+uint64 FrameStats::timerStart[FD_FRAMESTATS_TIMER_COUNT];
+//Negative when the timer didn't run during the frame, those frames aren't added to the histogram
+float64 FrameStats::timerAccumulated[FD_FRAMESTATS_TIMER_COUNT] = { -1.0, -1.0, -1.0 };
+
+uint64 FrameStats::frameNumber = 0;
+uint64 FrameStats::peakMemory = 0;
+
+void FrameStats::BeginFrame() {
+	timerStart[FD_FRAMESTATS_TIMER_FRAME] = GetTimeNanoseconds();
+}
+
+void FrameStats::EndFrame() {
+	timerAccumulated[FD_FRAMESTATS_TIMER_FRAME] = (GetTimeNanoseconds() - timerStart[FD_FRAMESTATS_TIMER_FRAME]) / 1000000.0;
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_TIMER_COUNT; i++) {
+		if (timerAccumulated[i] >= 0.0) timers[i].Add(timerAccumulated[i]);
+		timerAccumulated[i] = -1.0;
+	}
+
+	uint_t slot = (uint_t)(frameNumber % FD_FRAMESTATS_WINDOW);
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_COUNTER_COUNT; i++) {
+		uint64 count = counters[i].exchange(0, std::memory_order_relaxed);
+
+		counterHistory[i][slot] = count;
+		counterTotals[i] += count;
+	}
+
+	frameNumber++;
+}
+
+void FrameStats::BeginTimer(FD_FRAMESTATS_TIMER timer) {
+	timerStart[timer] = GetTimeNanoseconds();
+}
+
+void FrameStats::EndTimer(FD_FRAMESTATS_TIMER timer) {
+	float64 ms = (GetTimeNanoseconds() - timerStart[timer]) / 1000000.0;
+
+	timerAccumulated[timer] = timerAccumulated[timer] < 0.0 ? ms : timerAccumulated[timer] + ms;
+}
+
+FrameCounterStats FrameStats::GetCounter(FD_FRAMESTATS_COUNTER counter) {
+	FrameCounterStats stats = { 0, 0, 0.0, counterTotals[counter] };
+
+	uint_t frames = frameNumber < FD_FRAMESTATS_WINDOW ? (uint_t)frameNumber : FD_FRAMESTATS_WINDOW;
+
+	if (frames == 0) return stats;
+
+	const uint64* history = counterHistory[counter];
+	uint64 sum = 0;
+
+	for (uint_t i = 0; i < frames; i++) {
+		sum += history[i];
+		if (history[i] > stats.max) stats.max = history[i];
+	}
+
+	stats.last = history[(frameNumber - 1) % FD_FRAMESTATS_WINDOW];
+	stats.average = (float64)sum / frames;
+
+	return stats;
+}
+
+uint64 FrameStats::GetProcessMemory() {
+	uint64 memory = 0;
+
+#ifdef FD_PLATFORM_WINDOWS
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		memory = counters.WorkingSetSize;
+	}
+#else
+	FILE* file = fopen("/proc/self/statm", "r");
+
+	if (file) {
+		unsigned long long size = 0, resident = 0;
+
+		if (fscanf(file, "%llu %llu", &size, &resident) == 2) {
+			memory = resident * (uint64)sysconf(_SC_PAGESIZE);
+		}
+
+		fclose(file);
+	}
+#endif
+
+	if (memory > peakMemory) peakMemory = memory;
+
+	return memory;
+}
+
+uint64 FrameStats::GetPeakProcessMemory() {
+	uint64 peak = 0;
+
+	//The OS keeps the high water mark, spikes between two GetProcessMemory calls are in it too
+#ifdef FD_PLATFORM_WINDOWS
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		peak = counters.PeakWorkingSetSize;
+	}
+#else
+	FILE* file = fopen("/proc/self/status", "r");
+
+	if (file) {
+		char line[256];
+		unsigned long long kb = 0;
+
+		while (fgets(line, sizeof(line), file)) {
+			if (sscanf(line, "VmHWM: %llu kB", &kb) == 1) {
+				peak = kb * 1024;
+				break;
+			}
+		}
+
+		fclose(file);
+	}
+#endif
+
+	if (peak > peakMemory) peakMemory = peak;
+
+	return peakMemory;
+}
+
+const char* FrameStats::GetTimerName(FD_FRAMESTATS_TIMER timer) {
+	switch (timer) {
+		case FD_FRAMESTATS_TIMER_FRAME: return "Frame";
+		case FD_FRAMESTATS_TIMER_UPDATE: return "Update";
+		case FD_FRAMESTATS_TIMER_RENDER: return "Render";
+		default: return "Unknown";
+	}
+}
+
+const char* FrameStats::GetCounterName(FD_FRAMESTATS_COUNTER counter) {
+	switch (counter) {
+		case FD_FRAMESTATS_COUNTER_DRAW_CALLS: return "Draw calls";
+		case FD_FRAMESTATS_COUNTER_VERTICES: return "Vertices";
+		case FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_UPLOADS: return "CB uploads";
+		case FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_SKIPPED: return "CB skipped";
+		case FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_BYTES: return "CB bytes";
+		case FD_FRAMESTATS_COUNTER_TEXTURE_BINDS: return "Texture binds";
+		case FD_FRAMESTATS_COUNTER_STATE_CHANGES: return "State changes";
+		case FD_FRAMESTATS_COUNTER_STATE_SKIPPED: return "State skipped";
+		case FD_FRAMESTATS_COUNTER_INSTANCES: return "Instances";
+		default: return "Unknown";
+	}
+}
+
+String FrameStats::Dump() {
+	char line[256];
+	String result("");
+
+	uint_t frames = frameNumber < FD_FRAMESTATS_WINDOW ? (uint_t)frameNumber : FD_FRAMESTATS_WINDOW;
+
+	snprintf(line, sizeof(line), "Frame stats over the last %u frames (frame %llu)\n", (uint32)frames, (unsigned long long)frameNumber);
+	result.Append(line);
+
+	snprintf(line, sizeof(line), "%-14s %9s %9s %9s %9s %9s %9s %9s\n", "Timer (ms)", "last", "avg", "min", "p50", "p95", "p99", "max");
+	result.Append(line);
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_TIMER_COUNT; i++) {
+		const FrameTimeHistogram& h = timers[i];
+
+		snprintf(line, sizeof(line), "%-14s %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", GetTimerName((FD_FRAMESTATS_TIMER)i), h.GetLast(), h.GetAverage(), h.GetMin(), h.GetPercentile(0.5), h.GetPercentile(0.95), h.GetPercentile(0.99), h.GetMax());
+		result.Append(line);
+	}
+
+	snprintf(line, sizeof(line), "%-14s %9s %9s %9s %14s\n", "Counter", "last", "avg", "max", "total");
+	result.Append(line);
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_COUNTER_COUNT; i++) {
+		FrameCounterStats c = GetCounter((FD_FRAMESTATS_COUNTER)i);
+
+		snprintf(line, sizeof(line), "%-14s %9llu %9.1f %9llu %14llu\n", GetCounterName((FD_FRAMESTATS_COUNTER)i), (unsigned long long)c.last, c.average, (unsigned long long)c.max, (unsigned long long)c.total);
+		result.Append(line);
+	}
+
+	uint64 memory = GetProcessMemory();
+	uint64 peak = GetPeakProcessMemory();
+
+	snprintf(line, sizeof(line), "Memory: %.2f MB resident, %.2f MB peak\n", memory / (1024.0 * 1024.0), peak / (1024.0 * 1024.0));
+	result.Append(line);
+
+	return result;
+}
+
+bool FrameStats::WriteDump(const String& filename) {
+	FILE* file = fopen(*filename, "wb");
+
+	if (!file) {
+		FD_WARNING("[FrameStats] Failed to open \"%s\"", *filename);
+		return false;
+	}
+
+	String dump = Dump();
+
+	bool result = fwrite(*dump, 1, dump.length, file) == dump.length;
+
+	fclose(file);
+
+	return result;
+}
+
+void FrameStats::Reset() {
+	for (uint_t i = 0; i < FD_FRAMESTATS_TIMER_COUNT; i++) {
+		timers[i].Clear();
+		timerAccumulated[i] = -1.0;
+	}
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_COUNTER_COUNT; i++) counters[i].store(0, std::memory_order_relaxed);
+
+	memset(counterHistory, 0, sizeof(counterHistory));
+	memset(counterTotals, 0, sizeof(counterTotals));
+
+	frameNumber = 0;
+	peakMemory = 0;
+}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/string.h>
+#include <atomic>
+
+//Number of frames the statistics are calculated over
+#define FD_FRAMESTATS_WINDOW 512
+
+//Histogram resolution, times above FD_FRAMESTATS_HISTOGRAM_MAX_MS end up in the last bucket
+#define FD_FRAMESTATS_HISTOGRAM_BUCKET_MS 0.05
+#define FD_FRAMESTATS_HISTOGRAM_MAX_MS 100.0
+#define FD_FRAMESTATS_HISTOGRAM_BUCKETS 2001
+
+namespace FD {
+
+enum FD_FRAMESTATS_TIMER {
+	FD_FRAMESTATS_TIMER_FRAME,
+	FD_FRAMESTATS_TIMER_UPDATE,
+	FD_FRAMESTATS_TIMER_RENDER,
+	FD_FRAMESTATS_TIMER_COUNT
+};
+
+enum FD_FRAMESTATS_COUNTER {
+	FD_FRAMESTATS_COUNTER_DRAW_CALLS,
+	//Indexed draws count their indices
+	FD_FRAMESTATS_COUNTER_VERTICES,
+	FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_UPLOADS,
+	//Sets that matched the shadow copy and weren't uploaded
+	FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_SKIPPED,
+	FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_BYTES,
+	FD_FRAMESTATS_COUNTER_TEXTURE_BINDS,
+	//Pipeline state calls that went to the context and the ones dropped as redundant
+	FD_FRAMESTATS_COUNTER_STATE_CHANGES,
+	FD_FRAMESTATS_COUNTER_STATE_SKIPPED,
+	//Instances drawn by instanced draw calls
+	FD_FRAMESTATS_COUNTER_INSTANCES,
+	FD_FRAMESTATS_COUNTER_COUNT
+};
+
+//Times in milliseconds over the last FD_FRAMESTATS_WINDOW samples
+class FDUAPI FrameTimeHistogram {
+private:
+	uint32 buckets[FD_FRAMESTATS_HISTOGRAM_BUCKETS];
+	float64 samples[FD_FRAMESTATS_WINDOW];
+
+	uint_t count;
+	uint_t next;
+
+	float64 sum;
+
+	static uint_t GetBucket(float64 ms);
+
+public:
+	FrameTimeHistogram();
+
+	void Add(float64 ms);
+	void Clear();
+
+	//percentile in [0, 1]
+	float64 GetPercentile(float64 percentile) const;
+	float64 GetAverage() const;
+	float64 GetMin() const;
+	float64 GetMax() const;
+	float64 GetLast() const;
+
+	inline uint_t GetCount() const { return count; }
+};
+
+struct FrameCounterStats {
+	uint64 last;
+	uint64 max;
+	float64 average;
+	uint64 total;
+};
+
+/*
+ Call BeginFrame/EndFrame once per frame and wrap the update and render parts in
+ BeginTimer/EndTimer. Counters are bumped by the renderer and reset every frame,
+ Get* return values of completed frames so they can be read at any point.
+ Count can be called from any thread (command lists are recorded on the job system),
+ everything else is meant to be used from the main thread.
+*/
+class FDUAPI FrameStats {
+private:
+	static std::atomic<uint64> counters[FD_FRAMESTATS_COUNTER_COUNT];
+	static uint64 counterHistory[FD_FRAMESTATS_COUNTER_COUNT][FD_FRAMESTATS_WINDOW];
+	static uint64 counterTotals[FD_FRAMESTATS_COUNTER_COUNT];
+
+	static FrameTimeHistogram timers[FD_FRAMESTATS_TIMER_COUNT];
+	static uint64 timerStart[FD_FRAMESTATS_TIMER_COUNT];
+	static float64 timerAccumulated[FD_FRAMESTATS_TIMER_COUNT];
+
+	static uint64 frameNumber;
+	static uint64 peakMemory;
+
+public:
+	static void BeginFrame();
+	static void EndFrame();
+
+	//A timer can run several times per frame, the times are added up
+	static void BeginTimer(FD_FRAMESTATS_TIMER timer);
+	static void EndTimer(FD_FRAMESTATS_TIMER timer);
+
+	static __forceinline void Count(FD_FRAMESTATS_COUNTER counter, uint64 amount = 1) { counters[counter].fetch_add(amount, std::memory_order_relaxed); }
+
+	static inline const FrameTimeHistogram& GetTimer(FD_FRAMESTATS_TIMER timer) { return timers[timer]; }
+	static FrameCounterStats GetCounter(FD_FRAMESTATS_COUNTER counter);
+
+	static inline uint64 GetFrameNumber() { return frameNumber; }
+
+	//Resident memory of the process in bytes, 0 if it can't be queried
+	static uint64 GetProcessMemory();
+	//Highest resident memory since the process started, as the OS tracks it. Falls back to
+	//the highest GetProcessMemory result where the OS doesn't keep one.
+	static uint64 GetPeakProcessMemory();
+
+	static const char* GetTimerName(FD_FRAMESTATS_TIMER timer);
+	static const char* GetCounterName(FD_FRAMESTATS_COUNTER counter);
+
+	//Plain text table, doesn't need a window or renderer
+	static String Dump();
+	static bool WriteDump(const String& filename);
+
+	static void Reset();
+};
+
+}
@@ -0,0 +1,352 @@
+#include "jobsystem.h"
+#include "log.h"
+#include "profiler.h"
+#include "memory.h"
+#include <util/objectpool.h>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <stdio.h>
+
+//Empty rounds a worker spins through before it goes to sleep
+#define FD_JOB_SPIN_COUNT 64
+
+#define FD_JOB_DEQUE_MASK (FD_JOB_DEQUE_SIZE - 1)
+
+static_assert((FD_JOB_DEQUE_SIZE & FD_JOB_DEQUE_MASK) == 0, "FD_JOB_DEQUE_SIZE must be a power of two");
+
+namespace FD {
+
+/*
+ Chase-Lev deque (the C11 version from "Correct and Efficient Work-Stealing for Weak
+ Memory Models"). Only the owner calls Push and Pop, any thread can Steal.
+ The buffer doesn't grow, Push fails when it's full.
+*/
+struct JobDeque {
+	alignas(64) std::atomic<int64> top;
+	alignas(64) std::atomic<int64> bottom;
+	alignas(64) std::atomic<Job*> buffer[FD_JOB_DEQUE_SIZE];
+
+	JobDeque() : top(0), bottom(0) {
+		for (uint_t i = 0; i < FD_JOB_DEQUE_SIZE; i++) buffer[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	bool Push(Job* job) {
+		int64 b = bottom.load(std::memory_order_relaxed);
+		int64 t = top.load(std::memory_order_acquire);
+
+		if (b - t >= FD_JOB_DEQUE_SIZE) return false;
+
+		//Release so a thief that reads the pointer also sees the job
+		buffer[b & FD_JOB_DEQUE_MASK].store(job, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	Job* Pop() {
+		int64 b = bottom.load(std::memory_order_relaxed) - 1;
+
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		int64 t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = buffer[b & FD_JOB_DEQUE_MASK].load(std::memory_order_relaxed);
+
+		if (t == b) {
+			//Last job, race the thieves for it
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		return job;
+	}
+
+	Job* Steal() {
+		int64 t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b) return nullptr;
+
+		Job* job = buffer[t & FD_JOB_DEQUE_MASK].load(std::memory_order_acquire);
+
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+
+		return job;
+	}
+};
+
+struct JobWorker {
+	JobDeque deque;
+	std::thread* thread;
+	char name[16];
+};
+
+static JobWorker* workers = nullptr;
+static uint32 numWorkers = 1;
+
+static std::atomic<bool> running(false);
+static std::atomic<uint64> stealCount(0);
+
+static ObjectPool<Job> jobPool(1024);
+
+//Jobs from threads that aren't workers
+static std::mutex sharedMutex;
+static List<Job*> sharedJobs(64, 64);
+static std::atomic<uint32> sharedCount(0);
+
+static std::mutex sleepMutex;
+static std::condition_variable sleepCondition;
+static std::atomic<uint32> sleeping(0);
+
+static thread_local int32 workerIndex = -1;
+
+static Job* GetJob(int32 index) {
+	Job* job = nullptr;
+
+	if (index >= 0 && (job = workers[index].deque.Pop()) != nullptr) return job;
+
+	if (sharedCount.load(std::memory_order_acquire)) {
+		std::lock_guard<std::mutex> lock(sharedMutex);
+
+		uint_t size = sharedJobs.GetSize();
+
+		if (size) {
+			job = sharedJobs.RemoveIndex(size - 1);
+			sharedCount.fetch_sub(1, std::memory_order_release);
+
+			return job;
+		}
+	}
+
+	uint32 start = index >= 0 ? (uint32)index + 1 : 0;
+
+	for (uint32 i = 0; i < numWorkers; i++) {
+		uint32 victim = (start + i) % numWorkers;
+
+		if ((int32)victim == index) continue;
+
+		if ((job = workers[victim].deque.Steal()) != nullptr) {
+			stealCount.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void JobSystem::WorkerMain(uint32 index) {
+	workerIndex = (int32)index;
+
+	Profiler::SetThreadName(workers[index].name);
+
+	uint32 idle = 0;
+
+	while (running.load(std::memory_order_acquire)) {
+		Job* job = GetJob((int32)index);
+
+		if (job) {
+			Execute(job);
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < FD_JOB_SPIN_COUNT) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		//The timeout covers a job being queued between the last GetJob and the wait
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleeping.fetch_add(1, std::memory_order_acq_rel);
+		sleepCondition.wait_for(lock, std::chrono::milliseconds(1));
+		sleeping.fetch_sub(1, std::memory_order_acq_rel);
+
+		idle = 0;
+	}
+}
+
+void JobSystem::Init(uint32 numWorkers) {
+	if (running.load(std::memory_order_acquire)) return;
+
+	if (numWorkers == 0) numWorkers = std::thread::hardware_concurrency();
+	if (numWorkers == 0) numWorkers = 1;
+	if (numWorkers > FD_JOB_MAX_WORKERS) numWorkers = FD_JOB_MAX_WORKERS;
+
+	//JobWorker is over aligned for the deque indices, new[] only guarantees that from C++17
+	workers = (JobWorker*)Memory::AllocateAligned(numWorkers * sizeof(JobWorker), alignof(JobWorker));
+
+	for (uint32 i = 0; i < numWorkers; i++) new (workers + i) JobWorker;
+	FD::numWorkers = numWorkers;
+
+	running.store(true, std::memory_order_release);
+
+	workerIndex = 0;
+	workers[0].thread = nullptr;
+
+	for (uint32 i = 1; i < numWorkers; i++) {
+		snprintf(workers[i].name, sizeof(workers[i].name), "Worker %u", i);
+		workers[i].thread = new std::thread(WorkerMain, i);
+	}
+
+	FD_DEBUG("[JobSystem] Started %u workers", numWorkers);
+}
+
+void JobSystem::Dispose() {
+	if (!running.load(std::memory_order_acquire)) return;
+
+	running.store(false, std::memory_order_release);
+	sleepCondition.notify_all();
+
+	for (uint32 i = 1; i < numWorkers; i++) {
+		workers[i].thread->join();
+		delete workers[i].thread;
+	}
+
+	//Finish whatever is still queued so no counter is left waiting
+	Job* job;
+
+	while ((job = GetJob(-1)) != nullptr) Execute(job);
+
+	for (uint32 i = 0; i < numWorkers; i++) workers[i].~JobWorker();
+
+	Memory::FreeAligned(workers);
+
+	workers = nullptr;
+	numWorkers = 1;
+	workerIndex = -1;
+}
+
+void JobSystem::Schedule(const Job& job) {
+	Job* copy = running.load(std::memory_order_acquire) ? jobPool.Acquire() : nullptr;
+
+	if (!copy) {
+		job.function(job.data, job.begin, job.end);
+		Finish(job.counter);
+		return;
+	}
+
+	*copy = job;
+
+	int32 index = workerIndex;
+
+	if (index >= 0) {
+		if (!workers[index].deque.Push(copy)) {
+			jobPool.Release(copy);
+
+			job.function(job.data, job.begin, job.end);
+			Finish(job.counter);
+			return;
+		}
+	} else {
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		sharedJobs.Push_back(copy);
+		sharedCount.fetch_add(1, std::memory_order_release);
+	}
+
+	if (sleeping.load(std::memory_order_acquire)) sleepCondition.notify_one();
+}
+
+void JobSystem::Execute(Job* job) {
+	Job tmp = *job;
+
+	jobPool.Release(job);
+
+	tmp.function(tmp.data, tmp.begin, tmp.end);
+
+	Finish(tmp.counter);
+}
+
+void JobSystem::Finish(JobCounter* counter) {
+	if (!counter) return;
+
+	uint32 value = counter->value.load(std::memory_order_relaxed);
+
+	//Only the last job takes the lock, it has to release the dependents
+	while (value > 1) {
+		if (counter->value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return;
+	}
+
+	List<Job> dependents;
+
+	{
+		std::lock_guard<std::mutex> lock(counter->mutex);
+
+		if (counter->value.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+		if (counter->dependents.GetSize() == 0) return;
+
+		dependents = std::move(counter->dependents);
+	}
+
+	//counter may already be gone, only the local copy is used from here on
+	for (uint_t i = 0; i < dependents.GetSize(); i++) Schedule(dependents[i]);
+}
+
+void JobSystem::Run(const Job* jobs, uint_t count, JobCounter* counter, JobCounter* dependency) {
+	if (count == 0) return;
+
+	if (counter) counter->value.fetch_add((uint32)count, std::memory_order_acq_rel);
+
+	if (dependency && running.load(std::memory_order_acquire)) {
+		std::lock_guard<std::mutex> lock(dependency->mutex);
+
+		if (dependency->value.load(std::memory_order_acquire) != 0) {
+			for (uint_t i = 0; i < count; i++) {
+				Job job = jobs[i];
+				job.counter = counter;
+
+				dependency->dependents.Push_back(job);
+			}
+
+			return;
+		}
+	}
+
+	for (uint_t i = 0; i < count; i++) {
+		Job job = jobs[i];
+		job.counter = counter;
+
+		Schedule(job);
+	}
+}
+
+void JobSystem::Wait(JobCounter* counter) {
+	if (!counter) return;
+
+	while (!counter->IsDone()) {
+		Job* job = running.load(std::memory_order_acquire) ? GetJob(workerIndex) : nullptr;
+
+		if (job) {
+			Execute(job);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	//The last job can still be holding the lock after the counter reached 0
+	std::lock_guard<std::mutex> lock(counter->mutex);
+}
+
+uint32 JobSystem::GetNumWorkers() {
+	return numWorkers;
+}
+
+int32 JobSystem::GetWorkerIndex() {
+	return workerIndex;
+}
+
+uint64 JobSystem::GetStealCount() {
+	return stealCount.load(std::memory_order_relaxed);
+}
+
+}
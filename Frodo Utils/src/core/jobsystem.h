@@ -0,0 +1,141 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/list.h>
+#include <atomic>
+#include <mutex>
+
+//Jobs each worker can have queued, Run executes the job on the calling thread when its deque is full
+#define FD_JOB_DEQUE_SIZE 4096
+#define FD_JOB_MAX_WORKERS 64
+
+namespace FD {
+
+typedef void(*JobFunction)(void* data, uint_t begin, uint_t end);
+
+class JobCounter;
+
+struct Job {
+	JobFunction function;
+	void* data;
+	uint_t begin;
+	uint_t end;
+
+	//Set by JobSystem::Run
+	JobCounter* counter;
+};
+
+/*
+ Number of unfinished jobs. Jobs started with a dependency are held back in the counter
+ until it reaches 0. A counter must outlive its jobs, wait on it before it goes out of scope.
+*/
+class FDUAPI JobCounter {
+private:
+	friend class JobSystem;
+
+	std::atomic<uint32> value;
+
+	std::mutex mutex;
+	List<Job> dependents;
+
+public:
+	JobCounter() : value(0) { dependents.SetExtraReserve(4); }
+
+	JobCounter(const JobCounter& counter) = delete;
+	JobCounter& operator=(const JobCounter& counter) = delete;
+
+	inline bool IsDone() const { return value.load(std::memory_order_acquire) == 0; }
+	inline uint32 GetValue() const { return value.load(std::memory_order_acquire); }
+};
+
+/*
+ One worker per core, the thread calling Init is worker 0 and only runs jobs while it waits.
+ Every worker pushes and pops jobs at the bottom of its own Chase-Lev deque, idle workers
+ steal from the top of the others. Threads that aren't workers submit to a shared locked queue.
+
+ Wait doesn't block, the waiting thread runs queued jobs until the counter reaches 0, so
+ jobs can start and wait for other jobs.
+ Before Init (or after Dispose) Run executes jobs immediately on the calling thread.
+
+ Jobs run on any thread, they must not use FrameAllocator memory or other main thread only state.
+*/
+class FDUAPI JobSystem {
+private:
+	//Queues the job, runs it right away when the job system isn't running or the deque is full
+	static void Schedule(const Job& job);
+	static void Execute(Job* job);
+	static void Finish(JobCounter* counter);
+
+	static void WorkerMain(uint32 index);
+
+	template<typename F>
+	static void RunRange(void* data, uint_t begin, uint_t end) {
+		(*(const F*)data)(begin, end);
+	}
+
+public:
+	//0 workers means one per hardware thread
+	static void Init(uint32 numWorkers = 0);
+	static void Dispose();
+
+	//Adds count to counter before the jobs are queued and sets it as the counter of every job.
+	//With a dependency the jobs are queued once the dependency reaches 0.
+	static void Run(const Job* jobs, uint_t count, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+	static void Run(const Job& job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr) { Run(&job, 1, counter, dependency); }
+
+	//Runs other jobs on this thread until counter reaches 0
+	static void Wait(JobCounter* counter);
+
+	//Runs func(begin, end) over [0, count) in batches of batchSize and returns when all of them are done.
+	//A batchSize of 0 splits the range into a few batches per worker.
+	template<typename F>
+	static void ParallelFor(uint_t count, uint_t batchSize, const F& func) {
+		if (count == 0) return;
+
+		uint32 workers = GetNumWorkers();
+
+		if (batchSize == 0) batchSize = (count + workers * 4 - 1) / (workers * 4);
+
+		if (workers == 1 || batchSize >= count) {
+			func((uint_t)0, count);
+			return;
+		}
+
+		uint_t numJobs = (count + batchSize - 1) / batchSize;
+
+		Job jobs[64];
+		JobCounter counter;
+
+		for (uint_t first = 0; first < numJobs; first += 64) {
+			uint_t last = first + 64 < numJobs ? first + 64 : numJobs;
+
+			for (uint_t i = first; i < last; i++) {
+				Job& job = jobs[i - first];
+
+				job.function = RunRange<F>;
+				job.data = (void*)&func;
+				job.begin = i * batchSize;
+				job.end = job.begin + batchSize < count ? job.begin + batchSize : count;
+				job.counter = nullptr;
+			}
+
+			Run(jobs, last - first, &counter);
+		}
+
+		Wait(&counter);
+	}
+
+	//Workers including the thread that called Init, 1 when not initialized
+	static uint32 GetNumWorkers();
+	//-1 on threads that aren't workers
+	static int32 GetWorkerIndex();
+
+	//Jobs taken from another worker's deque
+	static uint64 GetStealCount();
+};
+
+}
@@ -1,57 +1,458 @@
 #include "log.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+#ifdef FD_PLATFORM_WINDOWS
 #include <Windows.h>
 
 #define FD_LOG_COLOR_INFO 0b00001111
 #define FD_LOG_COLOR_DEBUG 0b00001010
 #define FD_LOG_COLOR_WARNING 0b00001110
 #define FD_LOG_COLOR_FATAL 0b00001100
+#else
+#define FD_LOG_COLOR_INFO "\033[97m"
+#define FD_LOG_COLOR_DEBUG "\033[92m"
+#define FD_LOG_COLOR_WARNING "\033[93m"
+#define FD_LOG_COLOR_FATAL "\033[91m"
+#define FD_LOG_COLOR_RESET "\033[0m"
+#endif
 
 namespace FD {
 
-void FDLog(byte level, const char* message...) {
+#ifdef FD_PLATFORM_WINDOWS
 
-	HANDLE outhandle = GetStdHandle(STD_OUTPUT_HANDLE);
+static HANDLE outhandle = nullptr;
+static WORD defaultAttributes = 0;
 
-	CONSOLE_SCREEN_BUFFER_INFO info;
+static void SetColor(WORD color) {
+	if (!outhandle) {
+		outhandle = GetStdHandle(STD_OUTPUT_HANDLE);
 
-	GetConsoleScreenBufferInfo(outhandle, &info);
+		CONSOLE_SCREEN_BUFFER_INFO info;
+		GetConsoleScreenBufferInfo(outhandle, &info);
+		defaultAttributes = info.wAttributes;
+	}
 
-	va_list args;
-	va_start(args, message);
+	SetConsoleTextAttribute(outhandle, color);
+}
+
+static void ResetColor() {
+	SetConsoleTextAttribute(outhandle, defaultAttributes);
+}
+
+#else
+
+static void SetColor(const char* color) {
+	printf("%s", color);
+}
 
+static void ResetColor() {
+	printf(FD_LOG_COLOR_RESET);
+}
+
+#endif
+
+const char* LogSink::GetLevelName(byte level) {
+	switch (level) {
+		case FD_LOG_LEVEL_INFO: return "FD_INFO";
+		case FD_LOG_LEVEL_DEBUG: return "FD_DEBUG";
+		case FD_LOG_LEVEL_WARNING: return "FD_WARNING";
+		case FD_LOG_LEVEL_FATAL: return "FD_FATAL";
+	}
+
+	return "FD_UNKNOWN";
+}
+
+void ConsoleLogSink::Write(byte level, const char* message, uint_t length) {
 	switch (level) {
 		case FD_LOG_LEVEL_INFO:
-			SetConsoleTextAttribute(outhandle, FD_LOG_COLOR_INFO);
-			printf("FD_INFO: ");
-			vprintf(message, args);
-			printf("\n");
+			SetColor(FD_LOG_COLOR_INFO);
 			break;
 		case FD_LOG_LEVEL_DEBUG:
-			SetConsoleTextAttribute(outhandle, FD_LOG_COLOR_DEBUG);
-			printf("FD_DEBUG: ");
-			vprintf(message, args);
-			printf("\n");
+			SetColor(FD_LOG_COLOR_DEBUG);
 			break;
 		case FD_LOG_LEVEL_WARNING:
-			SetConsoleTextAttribute(outhandle, FD_LOG_COLOR_WARNING);
-			printf("FD_WARNING: ");
-			vprintf(message, args);
-			printf("\n");
+			SetColor(FD_LOG_COLOR_WARNING);
 			break;
 		case FD_LOG_LEVEL_FATAL:
-			SetConsoleTextAttribute(outhandle, FD_LOG_COLOR_FATAL);
-			printf("FD_FATAL: ");
-			vprintf(message, args);
-			printf("\n");
+			SetColor(FD_LOG_COLOR_FATAL);
 			break;
 	}
 
-	SetConsoleTextAttribute(outhandle, info.wAttributes);
+	printf("%s: ", GetLevelName(level));
+	fwrite(message, 1, length, stdout);
+	printf("\n");
+
+	ResetColor();
+}
+
+void ConsoleLogSink::Flush() {
+	fflush(stdout);
+}
+
+FileLogSink::FileLogSink(const String& filename, bool append) {
+	file = fopen(*filename, append ? "ab" : "wb");
+}
+
+FileLogSink::~FileLogSink() {
+	if (file) fclose(file);
+}
+
+void FileLogSink::Write(byte level, const char* message, uint_t length) {
+	if (!file) return;
+
+	fprintf(file, "%s: ", GetLevelName(level));
+	fwrite(message, 1, length, file);
+	fputc('\n', file);
+}
+
+void FileLogSink::Flush() {
+	if (file) fflush(file);
+}
+
+MemoryLogSink::MemoryLogSink(uint_t capacity) : capacity(capacity), count(0), next(0) {
+	entries = new Entry[capacity];
+	memset(entries, 0, sizeof(Entry) * capacity);
+}
+
+MemoryLogSink::~MemoryLogSink() {
+	Clear();
+	delete[] entries;
+}
+
+void MemoryLogSink::Write(byte level, const char* message, uint_t length) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Entry& entry = entries[next];
+
+	delete[] entry.message;
+
+	entry.level = level;
+	entry.message = new char[length + 1];
+	memcpy(entry.message, message, length);
+	entry.message[length] = 0;
+
+	next = (next + 1) % capacity;
+	if (count < capacity) count++;
+}
+
+uint_t MemoryLogSink::GetCount() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return count;
+}
+
+String MemoryLogSink::GetEntry(uint_t index, byte* level) const {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (index >= count) return String();
+
+	const Entry& entry = entries[(next + capacity - count + index) % capacity];
+
+	if (level) *level = entry.level;
+
+	return String(entry.message);
+}
+
+void MemoryLogSink::Clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (uint_t i = 0; i < capacity; i++) {
+		delete[] entries[i].message;
+		entries[i].message = nullptr;
+	}
+
+	count = 0;
+	next = 0;
+}
+
+/*
+ Bounded multi producer queue, every slot carries a sequence number.
+ sequence == pos means the slot is free for the producer claiming pos,
+ sequence == pos + 1 means the message at pos is ready for the writer.
+*/
+
+#define FD_LOG_QUEUE_MASK (FD_LOG_QUEUE_SIZE - 1)
+
+static_assert((FD_LOG_QUEUE_SIZE & FD_LOG_QUEUE_MASK) == 0, "FD_LOG_QUEUE_SIZE must be a power of two");
+
+struct LogSlot {
+	std::atomic<uint64> sequence;
+	byte level;
+	uint_t length;
+	char* heap;
+	char text[FD_LOG_MESSAGE_SIZE];
+};
+
+static LogSlot slots[FD_LOG_QUEUE_SIZE];
+
+static std::atomic<uint64> enqueuePos(0);
+static std::atomic<uint64> writtenPos(0);
+static std::atomic<uint64> queueFullCount(0);
+
+static std::atomic<bool> async(false);
+static std::atomic<uint32> activeProducers(0);
+
+static std::thread* writer = nullptr;
+static std::atomic<bool> writerRunning(false);
+static std::atomic<bool> writerSleeping(false);
+static std::mutex writerMutex;
+static std::condition_variable writerCondition;
+
+static std::mutex sinkMutex;
+static ConsoleLogSink consoleSink;
+
+static List<LogSink*>& GetSinks() {
+	static List<LogSink*> sinks(4, 4);
+	static bool initialized = false;
+
+	if (!initialized) {
+		sinks.Push_back(&consoleSink);
+		initialized = true;
+	}
+
+	return sinks;
+}
+
+static void WriteToSinks(byte level, const char* message, uint_t length) {
+	List<LogSink*>& sinks = GetSinks();
+
+	for (uint_t i = 0; i < sinks.GetSize(); i++) {
+		sinks[i]->Write(level, message, length);
+	}
+}
+
+static void FlushSinks() {
+	List<LogSink*>& sinks = GetSinks();
+
+	for (uint_t i = 0; i < sinks.GetSize(); i++) {
+		sinks[i]->Flush();
+	}
+}
+
+static void WakeWriter() {
+	if (writerSleeping.load(std::memory_order_acquire)) {
+		writerCondition.notify_one();
+	}
+}
+
+static void WriterMain() {
+	uint64 readPos = writtenPos.load(std::memory_order_relaxed);
+
+	while (true) {
+		bool wrote = false;
+
+		while (true) {
+			LogSlot& slot = slots[readPos & FD_LOG_QUEUE_MASK];
+
+			if (slot.sequence.load(std::memory_order_acquire) != readPos + 1) break;
+
+			{
+				std::lock_guard<std::mutex> lock(sinkMutex);
+				WriteToSinks(slot.level, slot.heap ? slot.heap : slot.text, slot.length);
+			}
+
+			delete[] slot.heap;
+			slot.heap = nullptr;
+
+			slot.sequence.store(readPos + FD_LOG_QUEUE_SIZE, std::memory_order_release);
+
+			readPos++;
+			writtenPos.store(readPos, std::memory_order_release);
+
+			wrote = true;
+		}
+
+		if (wrote) {
+			std::lock_guard<std::mutex> lock(sinkMutex);
+			FlushSinks();
+			continue;
+		}
+
+		if (!writerRunning.load(std::memory_order_acquire) && enqueuePos.load(std::memory_order_acquire) == readPos) break;
+
+		//The timeout covers a producer publishing between the check above and the wait
+		std::unique_lock<std::mutex> lock(writerMutex);
+		writerSleeping.store(true, std::memory_order_release);
+		writerCondition.wait_for(lock, std::chrono::milliseconds(5));
+		writerSleeping.store(false, std::memory_order_release);
+	}
+}
+
+void Logger::Init() {
+	if (writer) return;
+
+	for (uint_t i = 0; i < FD_LOG_QUEUE_SIZE; i++) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+		slots[i].heap = nullptr;
+	}
+
+	enqueuePos.store(0, std::memory_order_relaxed);
+	writtenPos.store(0, std::memory_order_relaxed);
+
+	writerRunning.store(true, std::memory_order_release);
+	writer = new std::thread(WriterMain);
+
+	async.store(true, std::memory_order_release);
+}
+
+void Logger::Dispose() {
+	if (!writer) return;
+
+	//Store async, then load activeProducers, FDLog does the opposite. Both sides have to be
+	//seq_cst, with release/acquire the load can move ahead of the store and miss a producer
+	//that already saw async set.
+	async.store(false, std::memory_order_seq_cst);
+
+	//Producers that saw async before it was cleared still have to publish their message
+	while (activeProducers.load(std::memory_order_seq_cst) != 0) {
+		std::this_thread::yield();
+	}
+
+	writerRunning.store(false, std::memory_order_release);
+	writerCondition.notify_one();
+
+	writer->join();
+
+	delete writer;
+	writer = nullptr;
+}
+
+void Logger::AddSink(LogSink* sink) {
+	std::lock_guard<std::mutex> lock(sinkMutex);
+
+	List<LogSink*>& sinks = GetSinks();
+
+	if (sinks.Find(sink) == (uint_t)-1) {
+		sinks.Reserve(sinks.GetSize() + 4);
+		sinks.Push_back(sink);
+	}
+}
+
+void Logger::RemoveSink(LogSink* sink) {
+	std::lock_guard<std::mutex> lock(sinkMutex);
+
+	sink->Flush();
+	GetSinks().Remove(sink);
+}
+
+void Logger::Flush() {
+	if (async.load(std::memory_order_acquire)) {
+		uint64 target = enqueuePos.load(std::memory_order_acquire);
+
+		while (writtenPos.load(std::memory_order_acquire) < target) {
+			writerCondition.notify_one();
+			std::this_thread::yield();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(sinkMutex);
+	FlushSinks();
+}
+
+LogSink* Logger::GetConsoleSink() {
+	return &consoleSink;
+}
+
+bool Logger::IsAsync() {
+	return async.load(std::memory_order_acquire);
+}
+
+uint64 Logger::GetQueueFullCount() {
+	return queueFullCount.load(std::memory_order_relaxed);
+}
+
+static void LogDirect(byte level, const char* message, va_list args) {
+	char text[FD_LOG_MESSAGE_SIZE];
+	char* heap = nullptr;
+
+	va_list copy;
+	va_copy(copy, args);
+
+	int32 length = vsnprintf(text, FD_LOG_MESSAGE_SIZE, message, args);
+
+	if (length >= FD_LOG_MESSAGE_SIZE) {
+		heap = new char[length + 1];
+		vsnprintf(heap, length + 1, message, copy);
+	}
+
+	va_end(copy);
+
+	if (length < 0) length = 0;
+
+	std::lock_guard<std::mutex> lock(sinkMutex);
+
+	WriteToSinks(level, heap ? heap : text, (uint_t)length);
+
+	if (level == FD_LOG_LEVEL_FATAL) FlushSinks();
+
+	delete[] heap;
+}
+
+static void LogAsync(byte level, const char* message, va_list args) {
+	uint64 pos = enqueuePos.load(std::memory_order_relaxed);
+	LogSlot* slot = nullptr;
+
+	while (true) {
+		slot = &slots[pos & FD_LOG_QUEUE_MASK];
+
+		int64 diff = (int64)slot->sequence.load(std::memory_order_acquire) - (int64)pos;
+
+		if (diff == 0) {
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		} else if (diff < 0) {
+			queueFullCount.fetch_add(1, std::memory_order_relaxed);
+			WakeWriter();
+			std::this_thread::yield();
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		} else {
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	va_list copy;
+	va_copy(copy, args);
+
+	int32 length = vsnprintf(slot->text, FD_LOG_MESSAGE_SIZE, message, args);
+
+	if (length >= FD_LOG_MESSAGE_SIZE) {
+		slot->heap = new char[length + 1];
+		vsnprintf(slot->heap, length + 1, message, copy);
+	}
+
+	va_end(copy);
+
+	slot->level = level;
+	slot->length = length < 0 ? 0 : (uint_t)length;
+
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	WakeWriter();
+}
+
+void FDLog(byte level, const char* message...) {
+
+	va_list args;
+	va_start(args, message);
+
+	//Pairs with Logger::Dispose, see there
+	activeProducers.fetch_add(1, std::memory_order_seq_cst);
+
+	if (async.load(std::memory_order_seq_cst)) {
+		LogAsync(level, message, args);
+		activeProducers.fetch_sub(1, std::memory_order_seq_cst);
+
+		if (level == FD_LOG_LEVEL_FATAL) Logger::Flush();
+	} else {
+		activeProducers.fetch_sub(1, std::memory_order_seq_cst);
+		LogDirect(level, message, args);
+	}
 
 	va_end(args);
 
 }
 
-}
\ No newline at end of file
+}
@@ -1,7 +1,13 @@
 #pragma once
 
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
 #include <fdu.h>
 #include <util/string.h>
+#include <util/list.h>
+#include <mutex>
 
 namespace FD {
 
@@ -10,12 +16,39 @@ namespace FD {
 #define FD_LOG_LEVEL_WARNING 0x03
 #define FD_LOG_LEVEL_FATAL   0x04
 
-#define FD_INFO(msg, ...) FDLog(FD_LOG_LEVEL_INFO, msg, __VA_ARGS__)
-#define FD_WARNING(msg, ...) FDLog(FD_LOG_LEVEL_WARNING, msg, __VA_ARGS__)
-#define FD_FATAL(msg, ...) FDLog(FD_LOG_LEVEL_FATAL, msg, __VA_ARGS__)
+#define FD_LOG_MASK(level) (1 << (level))
+
+//Levels compiled in, define FD_LOG_LEVELS before including this to strip the others.
+//Disabled levels expand to nothing, their arguments aren't evaluated.
+#ifndef FD_LOG_LEVELS
 #define FD_LOG_DISPLAY_DEBUG
 #if defined(_DEBUG) || defined(FD_LOG_DISPLAY_DEBUG)
-#define FD_DEBUG(msg, ...) FDLog(FD_LOG_LEVEL_DEBUG, msg, __VA_ARGS__)
+#define FD_LOG_LEVELS (FD_LOG_MASK(FD_LOG_LEVEL_INFO) | FD_LOG_MASK(FD_LOG_LEVEL_DEBUG) | FD_LOG_MASK(FD_LOG_LEVEL_WARNING) | FD_LOG_MASK(FD_LOG_LEVEL_FATAL))
+#else
+#define FD_LOG_LEVELS (FD_LOG_MASK(FD_LOG_LEVEL_INFO) | FD_LOG_MASK(FD_LOG_LEVEL_WARNING) | FD_LOG_MASK(FD_LOG_LEVEL_FATAL))
+#endif
+#endif
+
+#if FD_LOG_LEVELS & FD_LOG_MASK(FD_LOG_LEVEL_INFO)
+#define FD_INFO(msg, ...) FDLog(FD_LOG_LEVEL_INFO, msg, ##__VA_ARGS__)
+#else
+#define FD_INFO(msg, ...)
+#endif
+
+#if FD_LOG_LEVELS & FD_LOG_MASK(FD_LOG_LEVEL_WARNING)
+#define FD_WARNING(msg, ...) FDLog(FD_LOG_LEVEL_WARNING, msg, ##__VA_ARGS__)
+#else
+#define FD_WARNING(msg, ...)
+#endif
+
+#if FD_LOG_LEVELS & FD_LOG_MASK(FD_LOG_LEVEL_FATAL)
+#define FD_FATAL(msg, ...) FDLog(FD_LOG_LEVEL_FATAL, msg, ##__VA_ARGS__)
+#else
+#define FD_FATAL(msg, ...)
+#endif
+
+#if FD_LOG_LEVELS & FD_LOG_MASK(FD_LOG_LEVEL_DEBUG)
+#define FD_DEBUG(msg, ...) FDLog(FD_LOG_LEVEL_DEBUG, msg, ##__VA_ARGS__)
 
 #define FD_ASSERT_MSG(statement, msg) \
 if (statement) { \
@@ -37,10 +70,96 @@ if (statement) { \
 #define FD_ASSERT(statement)
 #endif
 
+//Messages longer than this are moved to the heap
+#define FD_LOG_MESSAGE_SIZE 512
+//Number of messages that can be queued before FDLog has to wait for the writer
+#define FD_LOG_QUEUE_SIZE 1024
+
+//Sinks are only called from one thread at a time, the writer thread once Logger::Init has been called
+class FDUAPI LogSink {
+public:
+	virtual ~LogSink() {}
 
+	virtual void Write(byte level, const char* message, uint_t length) = 0;
+	virtual void Flush() {}
 
+	static const char* GetLevelName(byte level);
+};
 
+class FDUAPI ConsoleLogSink : public LogSink {
+public:
+	void Write(byte level, const char* message, uint_t length) override;
+	void Flush() override;
+};
+
+class FDUAPI FileLogSink : public LogSink {
+private:
+	FILE* file;
+
+public:
+	FileLogSink(const String& filename, bool append = false);
+	~FileLogSink();
+
+	void Write(byte level, const char* message, uint_t length) override;
+	void Flush() override;
+
+	inline bool IsOpen() const { return file != nullptr; }
+};
+
+//Keeps the last messages in memory, can be read from any thread
+class FDUAPI MemoryLogSink : public LogSink {
+private:
+	struct Entry {
+		byte level;
+		char* message;
+	};
+
+	Entry* entries;
+	uint_t capacity;
+	uint_t count;
+	uint_t next;
+
+	mutable std::mutex mutex;
+
+public:
+	MemoryLogSink(uint_t capacity = 256);
+	~MemoryLogSink();
+
+	void Write(byte level, const char* message, uint_t length) override;
+
+	uint_t GetCount() const;
+	//Index 0 is the oldest message still in the ring
+	String GetEntry(uint_t index, byte* level = nullptr) const;
+	void Clear();
+};
+
+/*
+ FDLog formats the message on the calling thread into a slot of a bounded lock-free queue.
+ After Logger::Init a writer thread hands the queued messages to the sinks, before that
+ (and after Logger::Dispose) messages are written to the sinks directly. Fatal messages are
+ flushed before FDLog returns since they are usually followed by a crash.
+
+ A ConsoleLogSink is installed by default.
+*/
+class FDUAPI Logger {
+public:
+	static void Init();
+	static void Dispose();
+
+	static void AddSink(LogSink* sink);
+	//The sink isn't deleted
+	static void RemoveSink(LogSink* sink);
+
+	static LogSink* GetConsoleSink();
+
+	//Blocks until everything logged so far has been written
+	static void Flush();
+
+	static bool IsAsync();
+	//Number of times FDLog had to wait for the writer because the queue was full
+	static uint64 GetQueueFullCount();
+};
 
 void FDUAPI FDLog(byte level, const char* message...);
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,190 @@
+#include "memory.h"
+#include "frameallocator.h"
+#include "log.h"
+#include <util/string.h>
+#include <atomic>
+#include <stdlib.h>
+
+#define FD_MEMORY_MAGIC 0xFD3E3A6B
+
+namespace FD {
+
+struct MemoryHeader {
+	uint64 size;
+	uint32 tag;
+	uint32 magic;
+};
+
+static_assert(sizeof(MemoryHeader) == 16, "MemoryHeader must keep the 16 byte alignment of malloc");
+
+//One cache line per tag so threads allocating with different tags don't share counters
+struct alignas(64) MemoryTagCounters {
+	std::atomic<uint64> liveBytes;
+	std::atomic<uint64> peakBytes;
+	std::atomic<uint64> totalAllocations;
+	std::atomic<uint64> totalFrees;
+};
+
+static MemoryTagCounters counters[FD_MEMTAG_COUNT];
+
+void* Memory::Allocate(uint64 size, FD_MEMTAG tag) {
+	if (tag == FD_MEMTAG_FRAME) {
+		MemoryHeader* header = (MemoryHeader*)FrameAllocator::Allocate(sizeof(MemoryHeader) + size, 16);
+
+		header->size = size;
+		header->tag = tag;
+		header->magic = FD_MEMORY_MAGIC;
+
+		return header + 1;
+	}
+
+	MemoryHeader* header = (MemoryHeader*)malloc(sizeof(MemoryHeader) + size);
+
+	if (!header) {
+		FD_FATAL("[Memory] Failed to allocate %llu bytes (%s)", size, GetTagName(tag));
+		return nullptr;
+	}
+
+	header->size = size;
+	header->tag = tag;
+	header->magic = FD_MEMORY_MAGIC;
+
+#if FD_MEMORY_TRACKING
+	MemoryTagCounters& c = counters[tag];
+
+	uint64 live = c.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	uint64 peak = c.peakBytes.load(std::memory_order_relaxed);
+
+	while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+
+	c.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+	return header + 1;
+}
+
+void Memory::Free(void* memory) {
+	if (!memory) return;
+
+	MemoryHeader* header = (MemoryHeader*)memory - 1;
+
+	FD_ASSERT_MSG(header->magic != FD_MEMORY_MAGIC, "Memory::Free called on memory not allocated by Memory::Allocate");
+
+	if (header->tag == FD_MEMTAG_FRAME) return;
+
+#if FD_MEMORY_TRACKING
+	MemoryTagCounters& c = counters[header->tag];
+
+	c.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+	c.totalFrees.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+	header->magic = 0;
+
+	free(header);
+}
+
+void* Memory::AllocateAligned(uint64 size, uint64 alignment, FD_MEMTAG tag) {
+	FD_ASSERT_MSG(tag == FD_MEMTAG_FRAME, "Memory::AllocateAligned can't allocate frame memory");
+
+	//Room to move up to the alignment plus the pointer to the real block in front of it
+	byte* block = (byte*)Allocate(size + alignment + sizeof(void*), tag);
+
+	if (!block) return nullptr;
+
+	uint_t address = ((uint_t)(block + sizeof(void*)) + alignment - 1) & ~(uint_t)(alignment - 1);
+	byte* memory = (byte*)address;
+
+	((void**)memory)[-1] = block;
+
+	return memory;
+}
+
+void Memory::FreeAligned(void* memory) {
+	if (!memory) return;
+
+	Free(((void**)memory)[-1]);
+}
+
+uint64 Memory::GetSize(const void* memory) {
+	return memory ? ((const MemoryHeader*)memory - 1)->size : 0;
+}
+
+bool Memory::IsTracking() {
+	return FD_MEMORY_TRACKING != 0;
+}
+
+MemoryTagStats Memory::GetStats(FD_MEMTAG tag) {
+	const MemoryTagCounters& c = counters[tag];
+
+	MemoryTagStats stats;
+
+	stats.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+	stats.totalAllocations = c.totalAllocations.load(std::memory_order_relaxed);
+
+	//Allocations and frees can be counted between the two loads
+	uint64 frees = c.totalFrees.load(std::memory_order_relaxed);
+	stats.liveAllocations = stats.totalAllocations > frees ? stats.totalAllocations - frees : 0;
+
+	return stats;
+}
+
+const char* Memory::GetTagName(FD_MEMTAG tag) {
+	switch (tag) {
+		case FD_MEMTAG_GENERAL: return "General";
+		case FD_MEMTAG_LIST: return "List";
+		case FD_MEMTAG_STRING: return "String";
+		case FD_MEMTAG_FILE: return "File";
+		case FD_MEMTAG_ASSET: return "Asset";
+		case FD_MEMTAG_MESH: return "Mesh";
+		case FD_MEMTAG_TEXTURE: return "Texture";
+		case FD_MEMTAG_FONT: return "Font";
+		case FD_MEMTAG_AUDIO: return "Audio";
+		case FD_MEMTAG_FRAME: return "Frame";
+		default: return "Unknown";
+	}
+}
+
+String Memory::GetReport() {
+	char line[256];
+	String result("");
+
+	if (!FD_MEMORY_TRACKING) {
+		result.Append("Memory tracking is disabled, build with FD_MEMORY_TRACKING=1\n");
+		return result;
+	}
+
+	snprintf(line, sizeof(line), "%-10s %14s %14s %12s %12s\n", "Tag", "live bytes", "peak bytes", "live allocs", "total allocs");
+	result.Append(line);
+
+	for (uint_t i = 0; i < FD_MEMTAG_FRAME; i++) {
+		MemoryTagStats s = GetStats((FD_MEMTAG)i);
+
+		snprintf(line, sizeof(line), "%-10s %14llu %14llu %12llu %12llu\n", GetTagName((FD_MEMTAG)i), s.liveBytes, s.peakBytes, s.liveAllocations, s.totalAllocations);
+		result.Append(line);
+	}
+
+	snprintf(line, sizeof(line), "%-10s %14llu %14llu of %llu per frame\n", GetTagName(FD_MEMTAG_FRAME), FrameAllocator::GetUsed(), FrameAllocator::GetPeak(), FrameAllocator::GetSize());
+	result.Append(line);
+
+	return result;
+}
+
+uint64 Memory::ReportLeaks() {
+	uint64 total = 0;
+
+	for (uint_t i = 0; i < FD_MEMTAG_COUNT; i++) {
+		MemoryTagStats s = GetStats((FD_MEMTAG)i);
+
+		if (s.liveAllocations == 0) continue;
+
+		FD_WARNING("[Memory] %llu allocations (%llu bytes) tagged %s still alive", s.liveAllocations, s.liveBytes, GetTagName((FD_MEMTAG)i));
+
+		total += s.liveAllocations;
+	}
+
+	return total;
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <new>
+#include <type_traits>
+
+//Per tag statistics, on by default in debug builds. When off allocations still get their
+//header so memory can be passed between code built with and without tracking.
+#ifndef FD_MEMORY_TRACKING
+#ifdef NDEBUG
+#define FD_MEMORY_TRACKING 0
+#else
+#define FD_MEMORY_TRACKING 1
+#endif
+#endif
+
+namespace FD {
+
+class String;
+
+enum FD_MEMTAG {
+	FD_MEMTAG_GENERAL,
+	FD_MEMTAG_LIST,
+	FD_MEMTAG_STRING,
+	FD_MEMTAG_FILE,
+	FD_MEMTAG_ASSET,
+	FD_MEMTAG_MESH,
+	FD_MEMTAG_TEXTURE,
+	FD_MEMTAG_FONT,
+	FD_MEMTAG_AUDIO,
+	//Allocated from FrameAllocator, Free does nothing and it has no statistics
+	FD_MEMTAG_FRAME,
+	FD_MEMTAG_COUNT
+};
+
+struct MemoryTagStats {
+	uint64 liveBytes;
+	uint64 peakBytes;
+	uint64 liveAllocations;
+	uint64 totalAllocations;
+};
+
+/*
+ Every allocation gets a 16 byte header in front of it with the size and tag, so Free
+ doesn't need either and the returned memory keeps malloc's 16 byte alignment.
+ Memory from Allocate/NewArray must be released with Free/DeleteArray, not delete[].
+ The counters are atomics, allocating and freeing is safe from any thread.
+*/
+class FDUAPI Memory {
+public:
+	static void* Allocate(uint64 size, FD_MEMTAG tag = FD_MEMTAG_GENERAL);
+	static void Free(void* memory);
+
+	//Size in bytes requested in Allocate
+	static uint64 GetSize(const void* memory);
+
+	//alignment must be a power of 2, counted under tag like Allocate. Release with FreeAligned.
+	//Frame memory can't be allocated this way, FrameAllocator::Allocate takes an alignment.
+	static void* AllocateAligned(uint64 size, uint64 alignment, FD_MEMTAG tag = FD_MEMTAG_GENERAL);
+	static void FreeAligned(void* memory);
+
+	//Elements are default initialized, same as new T[count]
+	template<typename T>
+	static T* NewArray(uint64 count, FD_MEMTAG tag = FD_MEMTAG_GENERAL) {
+		T* data = (T*)Allocate(count * sizeof(T), tag);
+
+		if (!std::is_trivially_default_constructible<T>::value) {
+			for (uint64 i = 0; i < count; i++) new (data + i) T;
+		}
+
+		return data;
+	}
+
+	template<typename T>
+	static void DeleteArray(T* data) {
+		if (!data) return;
+
+		if (!std::is_trivially_destructible<T>::value) {
+			uint64 count = GetSize(data) / sizeof(T);
+			for (uint64 i = 0; i < count; i++) data[i].~T();
+		}
+
+		Free(data);
+	}
+
+	static MemoryTagStats GetStats(FD_MEMTAG tag);
+	static const char* GetTagName(FD_MEMTAG tag);
+
+	//Plain text table with one row per tag
+	static String GetReport();
+
+	//Logs every tag that still has live allocations, returns the number of live allocations
+	static uint64 ReportLeaks();
+
+	//Whether the library was built with FD_MEMORY_TRACKING
+	static bool IsTracking();
+};
+
+}
@@ -0,0 +1,431 @@
+#include "profiler.h"
+#include "log.h"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <stdio.h>
+
+namespace FD {
+
+#define FD_PROFILE_RING_MASK (FD_PROFILE_RING_SIZE - 1)
+#define FD_PROFILE_THREAD_NAME_LENGTH 64
+
+static_assert((FD_PROFILE_RING_SIZE & FD_PROFILE_RING_MASK) == 0, "FD_PROFILE_RING_SIZE must be a power of two");
+
+struct ProfileRing {
+	ProfileZone zones[FD_PROFILE_RING_SIZE];
+
+	std::atomic<uint64> write;
+	std::atomic<uint64> read;
+	std::atomic<uint64> dropped;
+
+	uint32 threadID;
+	uint32 depth;
+
+	char name[FD_PROFILE_THREAD_NAME_LENGTH];
+};
+
+static std::mutex ringMutex;
+static List<ProfileRing*> rings;
+
+//Bumped by Dispose so threads re-register instead of using a freed ring
+static std::atomic<uint32> ringGeneration(1);
+
+static thread_local ProfileRing* localRing = nullptr;
+static thread_local uint32 localGeneration = 0;
+
+static uint32 frameThreadID = 0;
+
+//Tick to steady_clock reference points, the rate is measured over the whole run so it gets more precise every frame
+static std::mutex calibrationMutex;
+static uint64 calibrationTicks = 0;
+static uint64 calibrationTime = 0;
+static float64 ticksPerNanosecond = 1.0;
+
+bool Profiler::enabled = true;
+bool Profiler::capturing = false;
+
+uint64 Profiler::frameNumber = 0;
+uint64 Profiler::frameStart = 0;
+
+List<ProfileZone> Profiler::frameZones;
+List<ProfileZone> Profiler::captureZones;
+List<ProfileFrame> Profiler::captureFrames;
+
+static ProfileRing* GetRing() {
+	uint32 generation = ringGeneration.load(std::memory_order_acquire);
+
+	if (localRing && localGeneration == generation) return localRing;
+
+	ProfileRing* ring = new ProfileRing;
+
+	ring->write.store(0, std::memory_order_relaxed);
+	ring->read.store(0, std::memory_order_relaxed);
+	ring->dropped.store(0, std::memory_order_relaxed);
+	ring->depth = 0;
+
+	std::lock_guard<std::mutex> lock(ringMutex);
+
+	ring->threadID = (uint32)rings.GetSize() + 1;
+	snprintf(ring->name, FD_PROFILE_THREAD_NAME_LENGTH, "Thread %u", ring->threadID);
+
+	rings.Push_back(ring);
+
+	localRing = ring;
+	localGeneration = generation;
+
+	return ring;
+}
+
+template<typename T>
+static void Grow(List<T>& list, uint_t count) {
+	uint_t required = list.GetSize() + count;
+
+	if (required > list.GetAllocated())
+		list.Reserve(required > list.GetAllocated() * 2 ? required : list.GetAllocated() * 2);
+}
+
+static bool CompareZones(const ProfileZone& a, const ProfileZone& b) {
+	if (a.threadID != b.threadID) return a.threadID < b.threadID;
+	if (a.start != b.start) return a.start < b.start;
+	return a.depth < b.depth;
+}
+
+static void Calibrate() {
+#if defined(_M_X64) || defined(__x86_64__)
+	std::lock_guard<std::mutex> lock(calibrationMutex);
+
+	if (calibrationTime == 0) {
+		calibrationTicks = Profiler::GetTime();
+		calibrationTime = Profiler::GetSteadyTime();
+	}
+
+	uint64 time = Profiler::GetSteadyTime();
+
+	//Spin for the first millisecond so there is a usable rate right away
+	while (time - calibrationTime < 1000000) {
+		time = Profiler::GetSteadyTime();
+	}
+
+	uint64 ticks = Profiler::GetTime();
+
+	ticksPerNanosecond = (float64)(ticks - calibrationTicks) / (float64)(time - calibrationTime);
+#endif
+}
+
+uint64 Profiler::GetSteadyTime() {
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64 Profiler::ToNanoseconds(uint64 ticks) {
+	if (calibrationTime == 0) Calibrate();
+
+	return (uint64)((float64)ticks / ticksPerNanosecond);
+}
+
+ProfileRing* Profiler::BeginZone(uint32* depth) {
+	ProfileRing* ring = GetRing();
+
+	*depth = ring->depth++;
+
+	return ring;
+}
+
+void Profiler::EndZone(ProfileRing* ring, const char* name, uint64 start, uint32 depth) {
+	uint64 end = GetTime();
+
+	ring->depth = depth;
+
+	uint64 write = ring->write.load(std::memory_order_relaxed);
+
+	if (write - ring->read.load(std::memory_order_acquire) >= FD_PROFILE_RING_SIZE) {
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	ProfileZone& zone = ring->zones[write & FD_PROFILE_RING_MASK];
+
+	zone.name = name;
+	zone.start = start;
+	zone.end = end;
+	zone.threadID = ring->threadID;
+	zone.depth = depth;
+
+	ring->write.store(write + 1, std::memory_order_release);
+}
+
+void Profiler::Drain(List<ProfileZone>& out) {
+	std::lock_guard<std::mutex> lock(ringMutex);
+
+	for (uint_t i = 0; i < rings.GetSize(); i++) {
+		ProfileRing* ring = rings[i];
+
+		uint64 read = ring->read.load(std::memory_order_relaxed);
+		uint64 write = ring->write.load(std::memory_order_acquire);
+
+		Grow(out, (uint_t)(write - read));
+
+		for (uint64 j = read; j < write; j++) {
+			out.Push_back(ring->zones[j & FD_PROFILE_RING_MASK]);
+		}
+
+		ring->read.store(write, std::memory_order_release);
+	}
+}
+
+void Profiler::SetEnabled(bool enabled) {
+	Profiler::enabled = enabled;
+}
+
+void Profiler::SetThreadName(const char* name) {
+	ProfileRing* ring = GetRing();
+
+	std::lock_guard<std::mutex> lock(ringMutex);
+	snprintf(ring->name, FD_PROFILE_THREAD_NAME_LENGTH, "%s", name);
+}
+
+void Profiler::BeginFrame() {
+	if (calibrationTime == 0) Calibrate();
+
+	frameThreadID = GetRing()->threadID;
+	frameStart = GetTime();
+}
+
+void Profiler::EndFrame() {
+	uint64 frameEnd = GetTime();
+
+	Calibrate();
+
+	frameZones.Resize(0);
+
+	Drain(frameZones);
+
+	std::sort(frameZones.GetData(), frameZones.GetData() + frameZones.GetSize(), CompareZones);
+
+	if (capturing) {
+		ProfileFrame frame;
+
+		frame.frame = frameNumber;
+		frame.start = frameStart;
+		frame.end = frameEnd;
+		frame.firstZone = captureZones.GetSize();
+		frame.numZones = frameZones.GetSize();
+
+		Grow(captureFrames, 1);
+		captureFrames.Push_back(frame);
+
+		Grow(captureZones, frameZones.GetSize());
+
+		for (uint_t i = 0; i < frameZones.GetSize(); i++) {
+			captureZones.Push_back(frameZones[i]);
+		}
+	}
+
+	frameNumber++;
+}
+
+void Profiler::BeginCapture() {
+	captureZones.Resize(0);
+	captureFrames.Resize(0);
+	capturing = true;
+}
+
+void Profiler::EndCapture() {
+	capturing = false;
+}
+
+uint64 Profiler::GetDroppedZones() {
+	std::lock_guard<std::mutex> lock(ringMutex);
+
+	uint64 dropped = 0;
+
+	for (uint_t i = 0; i < rings.GetSize(); i++) {
+		dropped += rings[i]->dropped.load(std::memory_order_relaxed);
+	}
+
+	return dropped;
+}
+
+static void WriteJSONString(FILE* file, const char* string) {
+	fputc('"', file);
+
+	for (const char* c = string; *c; c++) {
+		switch (*c) {
+			case '"':
+			case '\\':
+				fputc('\\', file);
+				fputc(*c, file);
+				break;
+			default:
+				if ((byte)*c >= 0x20) fputc(*c, file);
+		}
+	}
+
+	fputc('"', file);
+}
+
+bool Profiler::WriteChromeTrace(const String& filename) {
+	FILE* file = fopen(*filename, "wb");
+
+	if (!file) {
+		FD_WARNING("[Profiler] Failed to open \"%s\"", *filename);
+		return false;
+	}
+
+	Calibrate();
+
+	//Trace timestamps are microseconds relative to the first captured frame
+	uint64 base = ToNanoseconds(captureFrames.GetSize() ? captureFrames[0].start : 0);
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Frodo\"}}");
+
+	{
+		std::lock_guard<std::mutex> lock(ringMutex);
+
+		for (uint_t i = 0; i < rings.GetSize(); i++) {
+			fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", rings[i]->threadID);
+			WriteJSONString(file, rings[i]->name);
+			fprintf(file, "}}");
+		}
+	}
+
+	for (uint_t i = 0; i < captureFrames.GetSize(); i++) {
+		const ProfileFrame& frame = captureFrames[i];
+
+		fprintf(file, ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}", frameThreadID, (ToNanoseconds(frame.start) - base) / 1000.0, ToNanoseconds(frame.end - frame.start) / 1000.0, (unsigned long long)frame.frame);
+	}
+
+	for (uint_t i = 0; i < captureZones.GetSize(); i++) {
+		const ProfileZone& zone = captureZones[i];
+		uint64 start = ToNanoseconds(zone.start);
+
+		fprintf(file, ",\n{\"name\":");
+		WriteJSONString(file, zone.name);
+		fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", zone.threadID, start < base ? 0.0 : (start - base) / 1000.0, ToNanoseconds(zone.end - zone.start) / 1000.0);
+	}
+
+	fprintf(file, "\n]}\n");
+
+	bool result = ferror(file) == 0;
+
+	fclose(file);
+
+	return result;
+}
+
+/*
+ Binary capture layout, all values in host byte order, times in raw ticks, no padding:
+
+ char   magic[4] "FDPC"
+ uint32 version
+ float64 ticksPerNanosecond
+ uint32 numThreads
+ uint32 numNames
+ uint64 numFrames
+ uint64 numZones
+
+ numThreads * { uint32 threadID, uint32 nameLength, char name[nameLength] }
+ numNames   * { uint32 length, char name[length] }
+ numFrames  * { uint64 frame, uint64 start, uint64 end, uint64 firstZone, uint64 numZones }
+ numZones   * { uint32 nameIndex, uint32 threadID, uint32 depth, uint32 reserved, uint64 start, uint64 end }
+*/
+
+//Version 1 files have numThreads and numNames before ticksPerNanosecond
+#define FD_PROFILE_CAPTURE_VERSION 2
+
+bool Profiler::WriteBinaryCapture(const String& filename) {
+	FILE* file = fopen(*filename, "wb");
+
+	if (!file) {
+		FD_WARNING("[Profiler] Failed to open \"%s\"", *filename);
+		return false;
+	}
+
+	List<const char*> names(64, 64);
+	List<uint32> nameIndices(captureZones.GetSize() + 1);
+
+	for (uint_t i = 0; i < captureZones.GetSize(); i++) {
+		const char* name = captureZones[i].name;
+		uint_t index = names.Find(name);
+
+		if (index == (uint_t)-1) {
+			index = names.GetSize();
+			names.Push_back(name);
+		}
+
+		nameIndices.Push_back((uint32)index);
+	}
+
+	Calibrate();
+
+	std::lock_guard<std::mutex> lock(ringMutex);
+
+	uint32 version = FD_PROFILE_CAPTURE_VERSION;
+	uint32 numbers[2] = { (uint32)rings.GetSize(), (uint32)names.GetSize() };
+	uint64 counts[2] = { captureFrames.GetSize(), captureZones.GetSize() };
+
+	//In the order of the layout above
+	fwrite("FDPC", 1, 4, file);
+	fwrite(&version, sizeof(uint32), 1, file);
+	fwrite(&ticksPerNanosecond, sizeof(float64), 1, file);
+	fwrite(numbers, sizeof(numbers), 1, file);
+	fwrite(counts, sizeof(counts), 1, file);
+
+	for (uint_t i = 0; i < rings.GetSize(); i++) {
+		uint32 thread[2] = { rings[i]->threadID, (uint32)strlen(rings[i]->name) };
+
+		fwrite(thread, sizeof(thread), 1, file);
+		fwrite(rings[i]->name, 1, thread[1], file);
+	}
+
+	for (uint_t i = 0; i < names.GetSize(); i++) {
+		uint32 length = (uint32)strlen(names[i]);
+
+		fwrite(&length, sizeof(uint32), 1, file);
+		fwrite(names[i], 1, length, file);
+	}
+
+	for (uint_t i = 0; i < captureFrames.GetSize(); i++) {
+		const ProfileFrame& frame = captureFrames[i];
+		uint64 data[5] = { frame.frame, frame.start, frame.end, frame.firstZone, frame.numZones };
+
+		fwrite(data, sizeof(data), 1, file);
+	}
+
+	for (uint_t i = 0; i < captureZones.GetSize(); i++) {
+		const ProfileZone& zone = captureZones[i];
+		uint32 info[4] = { nameIndices[i], zone.threadID, zone.depth, 0 };
+		uint64 time[2] = { zone.start, zone.end };
+
+		fwrite(info, sizeof(info), 1, file);
+		fwrite(time, sizeof(time), 1, file);
+	}
+
+	bool result = ferror(file) == 0;
+
+	fclose(file);
+
+	return result;
+}
+
+//Threads that are still recording must be stopped before calling this
+void Profiler::Dispose() {
+	std::lock_guard<std::mutex> lock(ringMutex);
+
+	for (uint_t i = 0; i < rings.GetSize(); i++) {
+		delete rings[i];
+	}
+
+	rings.Resize(0);
+
+	ringGeneration.fetch_add(1, std::memory_order_release);
+
+	frameZones.Resize(0);
+	captureZones.Resize(0);
+	captureFrames.Resize(0);
+	capturing = false;
+}
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/string.h>
+#include <util/list.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+/*
+ Every thread records zones into its own ring buffer, only the owning thread writes to it
+ and Profiler::EndFrame drains all rings on the main thread. Nothing is locked on the
+ recording path, a full ring drops zones instead of blocking. Rings are kept until
+ Profiler::Dispose, so use long lived threads instead of spawning one per task.
+
+ Zone names are stored as pointers, they must be string literals or otherwise outlive the capture.
+
+ Timestamps are raw ticks (rdtsc on x86, steady_clock nanoseconds elsewhere), use
+ Profiler::ToNanoseconds to convert them. The tick rate is calibrated against steady_clock
+ every frame.
+*/
+
+#define FD_PROFILE_RING_SIZE 16384
+
+#ifndef FD_PROFILE_DISABLE
+#define FD_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define FD_PROFILE_CONCAT(a, b) FD_PROFILE_CONCAT_INTERNAL(a, b)
+#define FD_PROFILE_SCOPE(name) FD::ProfileScope FD_PROFILE_CONCAT(fdProfileScope, __LINE__)(name)
+#define FD_PROFILE_FUNCTION() FD_PROFILE_SCOPE(__FUNCTION__)
+#else
+#define FD_PROFILE_SCOPE(name)
+#define FD_PROFILE_FUNCTION()
+#endif
+
+namespace FD {
+
+struct ProfileRing;
+
+struct ProfileZone {
+	const char* name;
+	uint64 start;
+	uint64 end;
+	uint32 threadID;
+	uint32 depth;
+};
+
+struct ProfileFrame {
+	uint64 frame;
+	uint64 start;
+	uint64 end;
+	uint_t firstZone;
+	uint_t numZones;
+};
+
+class FDUAPI Profiler {
+private:
+	friend class ProfileScope;
+
+	static bool enabled;
+	static bool capturing;
+
+	static uint64 frameNumber;
+	static uint64 frameStart;
+
+	static List<ProfileZone> frameZones;
+	static List<ProfileZone> captureZones;
+	static List<ProfileFrame> captureFrames;
+
+	static ProfileRing* BeginZone(uint32* depth);
+	static void EndZone(ProfileRing* ring, const char* name, uint64 start, uint32 depth);
+
+	static void Drain(List<ProfileZone>& out);
+public:
+	static __forceinline uint64 GetTime() {
+#if defined(_M_X64) || defined(__x86_64__)
+		return __rdtsc();
+#else
+		return GetSteadyTime();
+#endif
+	}
+
+	static uint64 GetSteadyTime();
+	static uint64 ToNanoseconds(uint64 ticks);
+
+	static void SetEnabled(bool enabled);
+	static inline bool IsEnabled() { return enabled; }
+
+	//Names the calling thread in the trace, registers it if it hasn't recorded anything yet
+	static void SetThreadName(const char* name);
+
+	static void BeginFrame();
+	static void EndFrame();
+
+	static void BeginCapture();
+	static void EndCapture();
+	static inline bool IsCapturing() { return capturing; }
+
+	//Zones recorded during the last completed frame, sorted by thread and start time
+	static inline const List<ProfileZone>& GetFrameZones() { return frameZones; }
+	static inline uint64 GetFrameNumber() { return frameNumber; }
+
+	//Number of zones dropped because a thread's ring was full
+	static uint64 GetDroppedZones();
+
+	//chrome://tracing or https://ui.perfetto.dev
+	static bool WriteChromeTrace(const String& filename);
+	//Header, thread names, frames, zones with name indices, see profiler.cpp
+	static bool WriteBinaryCapture(const String& filename);
+
+	static void Dispose();
+};
+
+class ProfileScope {
+private:
+	ProfileRing* ring;
+	const char* name;
+	uint64 start;
+	uint32 depth;
+
+public:
+	__forceinline ProfileScope(const char* name) : ring(nullptr), name(name), start(0), depth(0) {
+		if (Profiler::enabled) {
+			ring = Profiler::BeginZone(&depth);
+			start = Profiler::GetTime();
+		}
+	}
+
+	__forceinline ~ProfileScope() {
+		if (ring) Profiler::EndZone(ring, name, start, depth);
+	}
+};
+
+}
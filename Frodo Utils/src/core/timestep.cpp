@@ -0,0 +1,53 @@
+#include "timestep.h"
+#include <chrono>
+
+namespace FD {
+
+FixedTimestep::FixedTimestep(float64 step, uint32 maxSteps) : step(step), maxSteps(maxSteps) {
+	Reset();
+}
+
+uint32 FixedTimestep::Advance(float64 frameTime) {
+	if (frameTime < 0.0) frameTime = 0.0;
+
+	if (step <= 0.0) {
+		lastDelta = frameTime;
+		totalSteps++;
+		return 1;
+	}
+
+	accumulator += frameTime;
+
+	uint32 steps = (uint32)(accumulator / step);
+
+	if (steps > maxSteps) {
+		steps = maxSteps;
+		accumulator = step * maxSteps;
+	}
+
+	accumulator -= steps * step;
+
+	//Rounding can leave the remainder just outside [0, step)
+	if (accumulator < 0.0) accumulator = 0.0;
+	if (accumulator >= step) accumulator = step * 0.999999;
+
+	totalSteps += steps;
+
+	return steps;
+}
+
+void FixedTimestep::Reset() {
+	accumulator = 0.0;
+	lastDelta = 0.0;
+	totalSteps = 0;
+}
+
+float64 FixedTimestep::Now() {
+	return NowNanoseconds() / 1000000000.0;
+}
+
+uint64 FixedTimestep::NowNanoseconds() {
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
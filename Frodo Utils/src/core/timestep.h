@@ -0,0 +1,45 @@
+#pragma once
+
+#include <fdu.h>
+
+//Most steps Advance returns for one frame, time beyond that is dropped so a long
+//hitch doesn't make the simulation fall further and further behind
+#define FD_TIMESTEP_MAX_STEPS 8
+
+namespace FD {
+
+/*
+ Fixed timestep accumulator. Frame times are added with Advance, which returns how many
+ steps of GetStep seconds to simulate. The remainder is kept for the next frame and
+ GetAlpha is how far the renderer is between the last two steps.
+ A step of 0 means a variable timestep, Advance always returns 1 step of the frame time.
+*/
+class FDUAPI FixedTimestep {
+private:
+	float64 step;
+	float64 accumulator;
+	float64 lastDelta;
+	uint32 maxSteps;
+
+	uint64 totalSteps;
+
+public:
+	FixedTimestep(float64 step = 1.0 / 60.0, uint32 maxSteps = FD_TIMESTEP_MAX_STEPS);
+
+	uint32 Advance(float64 frameTime);
+	void Reset();
+
+	inline void SetStep(float64 step) { this->step = step; Reset(); }
+
+	//Seconds per step, or the last frame time with a variable timestep
+	inline float64 GetDelta() const { return step > 0.0 ? step : lastDelta; }
+	inline float64 GetStep() const { return step; }
+	inline float64 GetAlpha() const { return step > 0.0 ? accumulator / step : 1.0; }
+	inline uint64 GetTotalSteps() const { return totalSteps; }
+
+	//Monotonic time in seconds, only differences between two calls are meaningful
+	static float64 Now();
+	static uint64 NowNanoseconds();
+};
+
+}
@@ -1,10 +1,30 @@
 #pragma once
+#include <stddef.h>
 
-#ifdef FDU_BUILD
-#define FDUAPI __declspec(dllexport)
-#else
-#define FDUAPI __declspec(dllimport)
-#endif
+#if defined(_WIN32)
+#define FD_PLATFORM_WINDOWS
+#elif defined(__linux__)
+#define FD_PLATFORM_LINUX
+#endif
+
+#if defined(FDU_STATIC)
+#define FDUAPI
+#elif defined(_MSC_VER)
+#ifdef FDU_BUILD
+#define FDUAPI __declspec(dllexport)
+#else
+#define FDUAPI __declspec(dllimport)
+#endif
+#else
+#define FDUAPI __attribute__((visibility("default")))
+#endif
+
+#ifndef _MSC_VER
+#ifndef __forceinline
+#define __forceinline inline __attribute__((always_inline))
+#endif
+#define __FUNCSIG__ __PRETTY_FUNCTION__
+#endif
 
 #ifndef FD_TYPES_DEFINED
 typedef unsigned char		byte;
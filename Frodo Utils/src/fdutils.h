@@ -3,6 +3,8 @@
 #include "util/fileutils.h"
 #include "util/list.h"
 #include "util/map.h"
+#include "util/radixsort.h"
 #include "util/string.h"
+#include "util/stringid.h"
 
 #define OFFSETOF(struct, m) (&((struct*)0x0)->m)
\ No newline at end of file
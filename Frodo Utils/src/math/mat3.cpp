@@ -69,7 +69,7 @@ mat3 mat3::operator*(const mat3& r) {
 	for (int32 y = 0; y < 3; y++) {
 		for (int32 x = 0; x < 3; x++) {
 			__m128 res = _mm_mul_ps(rows[x], col[y]);
-			tmp.m[x + y * 3] = res.m128_f32[0] + res.m128_f32[1] + res.m128_f32[2];
+			tmp.m[x + y * 3] = FD_M128_F32(res)[0] + FD_M128_F32(res)[1] + FD_M128_F32(res)[2];
 		}
 	}
 
@@ -91,7 +91,7 @@ vec3 mat3::operator*(const vec3& v) {
 	for (int32 i = 1; i < 3; i++)
 		res = _mm_fmadd_ps(vec[i], col[i], res);
 
-	return vec3(res.m128_f32[0], res.m128_f32[1], res.m128_f32[2]);
+	return vec3(FD_M128_F32(res)[0], FD_M128_F32(res)[1], FD_M128_F32(res)[2]);
 }
 
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "math.h"
+#include <core/log.h>
 #include <memory>
 
 namespace FD {
@@ -61,142 +62,182 @@ mat4 mat4::Rotate(const vec3& v) {
 	return x * y * z;
 }
 
-mat4 mat4::Scale(const vec3& v) {
+mat4 mat4::Rotate(const quat& q) {
 	mat4 tmp(1);
 
-	tmp.m[0 + 0 * 4] = v.x;
-	tmp.m[1 + 1 * 4] = v.y;
-	tmp.m[2 + 2 * 4] = v.z;
+	float32 xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	float32 xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	float32 wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+	tmp.m[0 + 0 * 4] = 1.0f - 2.0f * (yy + zz);
+	tmp.m[1 + 0 * 4] = 2.0f * (xy + wz);
+	tmp.m[2 + 0 * 4] = 2.0f * (xz - wy);
+
+	tmp.m[0 + 1 * 4] = 2.0f * (xy - wz);
+	tmp.m[1 + 1 * 4] = 1.0f - 2.0f * (xx + zz);
+	tmp.m[2 + 1 * 4] = 2.0f * (yz + wx);
+
+	tmp.m[0 + 2 * 4] = 2.0f * (xz + wy);
+	tmp.m[1 + 2 * 4] = 2.0f * (yz - wx);
+	tmp.m[2 + 2 * 4] = 1.0f - 2.0f * (xx + yy);
 
 	return tmp;
 }
 
-mat4 mat4::Inverse(mat4 m) {
+mat4 mat4::Scale(const vec3& v) {
+	mat4 tmp(1);
 
-	float tmp[16];
+	tmp.m[0 + 0 * 4] = v.x;
+	tmp.m[1 + 1 * 4] = v.y;
+	tmp.m[2 + 2 * 4] = v.z;
 
-	tmp[0] = m.m[5] * m.m[10] * m.m[15] -
-		m.m[5] * m.m[11] * m.m[14] -
-		m.m[9] * m.m[6] * m.m[15] +
-		m.m[9] * m.m[7] * m.m[14] +
-		m.m[13] * m.m[6] * m.m[11] -
-		m.m[13] * m.m[7] * m.m[10];
-
-	tmp[4] = -m.m[4] * m.m[10] * m.m[15] +
-		m.m[4] * m.m[11] * m.m[14] +
-		m.m[8] * m.m[6] * m.m[15] -
-		m.m[8] * m.m[7] * m.m[14] -
-		m.m[12] * m.m[6] * m.m[11] +
-		m.m[12] * m.m[7] * m.m[10];
-
-	tmp[8] = m.m[4] * m.m[9] * m.m[15] -
-		m.m[4] * m.m[11] * m.m[13] -
-		m.m[8] * m.m[5] * m.m[15] +
-		m.m[8] * m.m[7] * m.m[13] +
-		m.m[12] * m.m[5] * m.m[11] -
-		m.m[12] * m.m[7] * m.m[9];
-
-	tmp[12] = -m.m[4] * m.m[9] * m.m[14] +
-		m.m[4] * m.m[10] * m.m[13] +
-		m.m[8] * m.m[5] * m.m[14] -
-		m.m[8] * m.m[6] * m.m[13] -
-		m.m[12] * m.m[5] * m.m[10] +
-		m.m[12] * m.m[6] * m.m[9];
-
-	tmp[1] = -m.m[1] * m.m[10] * m.m[15] +
-		m.m[1] * m.m[11] * m.m[14] +
-		m.m[9] * m.m[2] * m.m[15] -
-		m.m[9] * m.m[3] * m.m[14] -
-		m.m[13] * m.m[2] * m.m[11] +
-		m.m[13] * m.m[3] * m.m[10];
-
-	tmp[5] = m.m[0] * m.m[10] * m.m[15] -
-		m.m[0] * m.m[11] * m.m[14] -
-		m.m[8] * m.m[2] * m.m[15] +
-		m.m[8] * m.m[3] * m.m[14] +
-		m.m[12] * m.m[2] * m.m[11] -
-		m.m[12] * m.m[3] * m.m[10];
-
-	tmp[9] = -m.m[0] * m.m[9] * m.m[15] +
-		m.m[0] * m.m[11] * m.m[13] +
-		m.m[8] * m.m[1] * m.m[15] -
-		m.m[8] * m.m[3] * m.m[13] -
-		m.m[12] * m.m[1] * m.m[11] +
-		m.m[12] * m.m[3] * m.m[9];
-
-	tmp[13] = m.m[0] * m.m[9] * m.m[14] -
-		m.m[0] * m.m[10] * m.m[13] -
-		m.m[8] * m.m[1] * m.m[14] +
-		m.m[8] * m.m[2] * m.m[13] +
-		m.m[12] * m.m[1] * m.m[10] -
-		m.m[12] * m.m[2] * m.m[9];
-
-	tmp[2] = m.m[1] * m.m[6] * m.m[15] -
-		m.m[1] * m.m[7] * m.m[14] -
-		m.m[5] * m.m[2] * m.m[15] +
-		m.m[5] * m.m[3] * m.m[14] +
-		m.m[13] * m.m[2] * m.m[7] -
-		m.m[13] * m.m[3] * m.m[6];
-
-	tmp[6] = -m.m[0] * m.m[6] * m.m[15] +
-		m.m[0] * m.m[7] * m.m[14] +
-		m.m[4] * m.m[2] * m.m[15] -
-		m.m[4] * m.m[3] * m.m[14] -
-		m.m[12] * m.m[2] * m.m[7] +
-		m.m[12] * m.m[3] * m.m[6];
-
-	tmp[10] = m.m[0] * m.m[5] * m.m[15] -
-		m.m[0] * m.m[7] * m.m[13] -
-		m.m[4] * m.m[1] * m.m[15] +
-		m.m[4] * m.m[3] * m.m[13] +
-		m.m[12] * m.m[1] * m.m[7] -
-		m.m[12] * m.m[3] * m.m[5];
-
-	tmp[14] = -m.m[0] * m.m[5] * m.m[14] +
-		m.m[0] * m.m[6] * m.m[13] +
-		m.m[4] * m.m[1] * m.m[14] -
-		m.m[4] * m.m[2] * m.m[13] -
-		m.m[12] * m.m[1] * m.m[6] +
-		m.m[12] * m.m[2] * m.m[5];
-
-	tmp[3] = -m.m[1] * m.m[6] * m.m[11] +
-		m.m[1] * m.m[7] * m.m[10] +
-		m.m[5] * m.m[2] * m.m[11] -
-		m.m[5] * m.m[3] * m.m[10] -
-		m.m[9] * m.m[2] * m.m[7] +
-		m.m[9] * m.m[3] * m.m[6];
-
-	tmp[7] = m.m[0] * m.m[6] * m.m[11] -
-		m.m[0] * m.m[7] * m.m[10] -
-		m.m[4] * m.m[2] * m.m[11] +
-		m.m[4] * m.m[3] * m.m[10] +
-		m.m[8] * m.m[2] * m.m[7] -
-		m.m[8] * m.m[3] * m.m[6];
-
-	tmp[11] = -m.m[0] * m.m[5] * m.m[11] +
-		m.m[0] * m.m[7] * m.m[9] +
-		m.m[4] * m.m[1] * m.m[11] -
-		m.m[4] * m.m[3] * m.m[9] -
-		m.m[8] * m.m[1] * m.m[7] +
-		m.m[8] * m.m[3] * m.m[5];
-
-	tmp[15] = m.m[0] * m.m[5] * m.m[10] -
-		m.m[0] * m.m[6] * m.m[9] -
-		m.m[4] * m.m[1] * m.m[10] +
-		m.m[4] * m.m[2] * m.m[9] +
-		m.m[8] * m.m[1] * m.m[6] -
-		m.m[8] * m.m[2] * m.m[5];
-
-	mat4 n;
-
-	float determinant = m.m[0] * tmp[0] + m.m[1] * tmp[4] + m.m[2] * tmp[8] + m.m[3] * tmp[12];
-
-	for (uint_t i = 0; i < 16; i++)
-		n.m[i] = tmp[i] * determinant;
-
-	return n;
+	return tmp;
 }
 
+#define FD_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define FD_SWIZZLE(a, x, y, z, w) FD_SHUFFLE(a, a, x, y, z, w)
+
+//2x2 matrices stored as (m00, m01, m10, m11) in a single register
+static __forceinline __m128 Mat2Mul(__m128 a, __m128 b) {
+	return _mm_add_ps(_mm_mul_ps(a, FD_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(FD_SWIZZLE(a, 1, 0, 3, 2), FD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//adj(a) * b
+static __forceinline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(FD_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(FD_SWIZZLE(a, 1, 1, 2, 2), FD_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+//a * adj(b)
+static __forceinline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(a, FD_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(FD_SWIZZLE(a, 1, 0, 3, 2), FD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+static __forceinline __m128 Cross(__m128 a, __m128 b) {
+	__m128 tmp = _mm_sub_ps(_mm_mul_ps(a, FD_SWIZZLE(b, 1, 2, 0, 3)), _mm_mul_ps(FD_SWIZZLE(a, 1, 2, 0, 3), b));
+	return FD_SWIZZLE(tmp, 1, 2, 0, 3);
+}
+
+mat4 mat4::Inverse(mat4 m) {
+	__m128 col[4];
+
+	for (uint_t i = 0; i < 4; i++)
+		col[i] = _mm_loadu_ps(m.m + i * 4);
+
+	//Block wise inverse with 2x2 sub matrices. Works on the transpose, which gives the transposed inverse, so the result can be stored as columns again
+	__m128 a = _mm_movelh_ps(col[0], col[1]);
+	__m128 b = _mm_movehl_ps(col[1], col[0]);
+	__m128 c = _mm_movelh_ps(col[2], col[3]);
+	__m128 d = _mm_movehl_ps(col[3], col[2]);
+
+	__m128 detSub = _mm_sub_ps(_mm_mul_ps(FD_SHUFFLE(col[0], col[2], 0, 2, 0, 2), FD_SHUFFLE(col[1], col[3], 1, 3, 1, 3)),
+							   _mm_mul_ps(FD_SHUFFLE(col[0], col[2], 1, 3, 1, 3), FD_SHUFFLE(col[1], col[3], 0, 2, 0, 2)));
+
+	__m128 detA = FD_SWIZZLE(detSub, 0, 0, 0, 0);
+	__m128 detB = FD_SWIZZLE(detSub, 1, 1, 1, 1);
+	__m128 detC = FD_SWIZZLE(detSub, 2, 2, 2, 2);
+	__m128 detD = FD_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	__m128 dc = Mat2AdjMul(d, c);
+	__m128 ab = Mat2AdjMul(a, b);
+
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+	__m128 tr = _mm_mul_ps(ab, FD_SWIZZLE(dc, 0, 2, 1, 3));
+	tr = _mm_hadd_ps(tr, tr);
+	tr = _mm_hadd_ps(tr, tr);
+
+	__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+	if (_mm_cvtss_f32(det) == 0.0f) {
+		FD_WARNING("[mat4] Inverse called on a singular matrix");
+		return mat4(1);
+	}
+
+	__m128 rcp = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+	x = _mm_mul_ps(x, rcp);
+	y = _mm_mul_ps(y, rcp);
+	z = _mm_mul_ps(z, rcp);
+	w = _mm_mul_ps(w, rcp);
+
+	mat4 r;
+
+	_mm_storeu_ps(r.m + 0, FD_SHUFFLE(x, y, 3, 1, 3, 1));
+	_mm_storeu_ps(r.m + 4, FD_SHUFFLE(x, y, 2, 0, 2, 0));
+	_mm_storeu_ps(r.m + 8, FD_SHUFFLE(z, w, 3, 1, 3, 1));
+	_mm_storeu_ps(r.m + 12, FD_SHUFFLE(z, w, 2, 0, 2, 0));
+
+	return r;
+}
+
+mat4 mat4::InverseAffine(const mat4& m) {
+	__m128 c0 = _mm_loadu_ps(m.m + 0);
+	__m128 c1 = _mm_loadu_ps(m.m + 4);
+	__m128 c2 = _mm_loadu_ps(m.m + 8);
+	__m128 t = _mm_loadu_ps(m.m + 12);
+
+	//Rows of the inverse 3x3 are the cross products of the columns divided by the determinant
+	__m128 r0 = Cross(c1, c2);
+	__m128 r1 = Cross(c2, c0);
+	__m128 r2 = Cross(c0, c1);
+
+	__m128 det = _mm_dp_ps(c0, r0, 0x7F);
+
+	if (_mm_cvtss_f32(det) == 0.0f) {
+		FD_WARNING("[mat4] InverseAffine called on a singular matrix");
+		return mat4(1);
+	}
+
+	__m128 rcp = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+	r0 = _mm_mul_ps(r0, rcp);
+	r1 = _mm_mul_ps(r1, rcp);
+	r2 = _mm_mul_ps(r2, rcp);
+
+	__m128 r3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+	__m128 translation = _mm_or_ps(_mm_or_ps(_mm_dp_ps(r0, t, 0x71), _mm_dp_ps(r1, t, 0x72)), _mm_dp_ps(r2, t, 0x74));
+	translation = _mm_sub_ps(r3, translation);
+
+	//Cross products leave w as 0
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	mat4 r;
+
+	_mm_storeu_ps(r.m + 0, r0);
+	_mm_storeu_ps(r.m + 4, r1);
+	_mm_storeu_ps(r.m + 8, r2);
+	_mm_storeu_ps(r.m + 12, translation);
+
+	return r;
+}
+
+mat4 mat4::InverseRigid(const mat4& m) {
+	__m128 c0 = _mm_loadu_ps(m.m + 0);
+	__m128 c1 = _mm_loadu_ps(m.m + 4);
+	__m128 c2 = _mm_loadu_ps(m.m + 8);
+	__m128 c3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	__m128 t = _mm_loadu_ps(m.m + 12);
+
+	__m128 translation = _mm_or_ps(_mm_or_ps(_mm_dp_ps(c0, t, 0x71), _mm_dp_ps(c1, t, 0x72)), _mm_dp_ps(c2, t, 0x74));
+	translation = _mm_sub_ps(c3, translation);
+
+	//Inverse of a rotation is its transpose, the bottom row of an affine matrix is 0, 0, 0, 1 so w of the columns is 0
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	mat4 r;
+
+	_mm_storeu_ps(r.m + 0, c0);
+	_mm_storeu_ps(r.m + 4, c1);
+	_mm_storeu_ps(r.m + 8, c2);
+	_mm_storeu_ps(r.m + 12, translation);
+
+	return r;
+}
+
 mat4 mat4::Perspective(float32 fov, float32 aspect, float32 zNear, float32 zFar) {
 
 	mat4 r(1);
@@ -277,7 +318,7 @@ mat4 mat4::operator*(const mat4& r) const {
 	for (int32 y = 0; y < 4; y++) {
 		for (int32 x = 0; x < 4; x++) {
 			__m128 res = _mm_mul_ps(rows[x], col[y]);
-			tmp.m[x + y * 4] = res.m128_f32[0] + res.m128_f32[1] + res.m128_f32[2] + res.m128_f32[3];
+			tmp.m[x + y * 4] = FD_M128_F32(res)[0] + FD_M128_F32(res)[1] + FD_M128_F32(res)[2] + FD_M128_F32(res)[3];
 		}
 	}
 
@@ -301,7 +342,7 @@ vec4 mat4::operator*(const vec4& v) const {
 	for (int32 i = 1; i < 4; i++)
 		res = _mm_fmadd_ps(vec[i], col[i], res);
 
-	return vec4(res.m128_f32[0], res.m128_f32[1], res.m128_f32[2], res.m128_f32[3]);
+	return vec4(FD_M128_F32(res)[0], FD_M128_F32(res)[1], FD_M128_F32(res)[2], FD_M128_F32(res)[3]);
 }
 
 vec3 mat4::operator*(const vec3& v) const {
@@ -320,7 +361,7 @@ vec3 mat4::operator*(const vec3& v) const {
 	for (int32 i = 1; i < 4; i++)
 		res = _mm_fmadd_ps(vec[i], col[i], res);
 
-	return vec3(res.m128_f32[0], res.m128_f32[1], res.m128_f32[2]);
+	return vec3(FD_M128_F32(res)[0], FD_M128_F32(res)[1], FD_M128_F32(res)[2]);
 }
 
 }
\ No newline at end of file
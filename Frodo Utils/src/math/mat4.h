@@ -8,6 +8,7 @@ private:
 	friend class mat3;
 	friend class vec3;
 	friend class vec4;
+	friend class TransformBatch;
 private:
 	float32 m[16];
 
@@ -22,9 +23,14 @@ public:
 
 	static mat4 Translate(const vec3& v);
 	static mat4 Rotate(const vec3& v);
+	static mat4 Rotate(const quat& q);
 	static mat4 Scale(const vec3& v);
 
 	static mat4 Inverse(mat4 m);
+	//Only valid when the bottom row is 0, 0, 0, 1
+	static mat4 InverseAffine(const mat4& m);
+	//Only valid for rotation + translation, no scale
+	static mat4 InverseRigid(const mat4& m);
 	static mat4 Transpose(mat4 m);
 
 	static mat4 Perspective(float32 fov, float32 aspect, float32 zNear, float32 zFar);
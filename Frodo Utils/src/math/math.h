@@ -5,3 +5,5 @@
 #include "vec4.h"
 #include "vec3.h"
 #include "vec2.h"
+#include "quat.h"
+#include "transformbatch.h"
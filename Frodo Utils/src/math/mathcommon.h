@@ -3,9 +3,17 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <string.h>
+
+#ifdef FD_PLATFORM_WINDOWS
 #include <DirectXMath.h>
+#endif
 
+#ifdef _MSC_VER
 #include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
 
 #define FD_PRE_TO_RADIANS 0.01745329251994329576923690768489
 #define FD_PRE_TO_DEGREES 57.295779513082320876798154814105
@@ -25,4 +33,24 @@
 #define FLOAT32_CMP(a, b) FLOAT_CMP(a, b, uint32)
 #define FLOAT64_CMP(a, b) FLOAT_CMP(a, b, uint64)
 
+//Lane access for SIMD registers, m128_f32 and friends only exist on msvc
+#define FD_M128_F32(xmm) ((float32*)&(xmm))
+#define FD_M128I_I32(xmm) ((int32*)&(xmm))
+#define FD_M128I_U32(xmm) ((uint32*)&(xmm))
+#define FD_M256I_I32(xmm) ((int32*)&(xmm))
+
+namespace FD {
+
+class vec2;
+class vec3;
+class vec4;
+class ivec2;
+class ivec3;
+class ivec4;
+class mat3;
+class mat4;
+class quat;
+
+}
+
 
@@ -0,0 +1,202 @@
+#include "math.h"
+#include <memory>
+
+namespace FD {
+
+quat::quat() : quat(0, 0, 0, 1) {}
+
+quat::quat(float32 x, float32 y, float32 z, float32 w) : x(x), y(y), z(z), w(w) {}
+
+quat::quat(const vec3& axis, float32 angle) {
+	float32 a = FD_TO_RADIANS_F(angle) * 0.5f;
+	float32 s = sinf(a);
+
+	vec3 n = vec3(axis).Normalize();
+
+	x = n.x * s;
+	y = n.y * s;
+	z = n.z * s;
+	w = cosf(a);
+}
+
+quat quat::FromEuler(const vec3& v) {
+	float32 xcos = cosf(FD_TO_RADIANS_F(v.x) * 0.5f);
+	float32 xsin = sinf(FD_TO_RADIANS_F(v.x) * 0.5f);
+	float32 ycos = cosf(FD_TO_RADIANS_F(v.y) * 0.5f);
+	float32 ysin = sinf(FD_TO_RADIANS_F(v.y) * 0.5f);
+	float32 zcos = cosf(FD_TO_RADIANS_F(v.z) * 0.5f);
+	float32 zsin = sinf(FD_TO_RADIANS_F(v.z) * 0.5f);
+
+	//x * y * z, mat4::Rotate rotates the opposite way around y
+	return quat(xsin * ycos * zcos - xcos * ysin * zsin,
+				-xsin * ycos * zsin - xcos * ysin * zcos,
+				xcos * ycos * zsin - xsin * ysin * zcos,
+				xcos * ycos * zcos + xsin * ysin * zsin);
+}
+
+quat quat::FromMatrix(const mat4& m) {
+	const float32* d = m.GetData();
+
+	float32 m00 = d[0 + 0 * 4], m01 = d[0 + 1 * 4], m02 = d[0 + 2 * 4];
+	float32 m10 = d[1 + 0 * 4], m11 = d[1 + 1 * 4], m12 = d[1 + 2 * 4];
+	float32 m20 = d[2 + 0 * 4], m21 = d[2 + 1 * 4], m22 = d[2 + 2 * 4];
+
+	float32 trace = m00 + m11 + m22;
+
+	quat q;
+
+	if (trace > 0.0f) {
+		float32 s = 0.5f / sqrtf(trace + 1.0f);
+		q.w = 0.25f / s;
+		q.x = (m21 - m12) * s;
+		q.y = (m02 - m20) * s;
+		q.z = (m10 - m01) * s;
+	} else if (m00 > m11 && m00 > m22) {
+		float32 s = 2.0f * sqrtf(1.0f + m00 - m11 - m22);
+		q.w = (m21 - m12) / s;
+		q.x = 0.25f * s;
+		q.y = (m01 + m10) / s;
+		q.z = (m02 + m20) / s;
+	} else if (m11 > m22) {
+		float32 s = 2.0f * sqrtf(1.0f + m11 - m00 - m22);
+		q.w = (m02 - m20) / s;
+		q.x = (m01 + m10) / s;
+		q.y = 0.25f * s;
+		q.z = (m12 + m21) / s;
+	} else {
+		float32 s = 2.0f * sqrtf(1.0f + m22 - m00 - m11);
+		q.w = (m10 - m01) / s;
+		q.x = (m02 + m20) / s;
+		q.y = (m12 + m21) / s;
+		q.z = 0.25f * s;
+	}
+
+	return q;
+}
+
+quat quat::Nlerp(const quat& a, const quat& b, float32 t) {
+	float32 s = a.Dot(b) < 0.0f ? -t : t;
+
+	__m128 xmm = _mm_loadu_ps(&a.x);
+	xmm = _mm_add_ps(_mm_mul_ps(xmm, _mm_set1_ps(1.0f - t)), _mm_mul_ps(_mm_loadu_ps(&b.x), _mm_set1_ps(s)));
+
+	quat q;
+	_mm_storeu_ps(&q.x, xmm);
+
+	return q.Normalize();
+}
+
+quat quat::Slerp(const quat& a, const quat& b, float32 t) {
+	float32 cosTheta = a.Dot(b);
+	float32 sign = 1.0f;
+
+	if (cosTheta < 0.0f) {
+		cosTheta = -cosTheta;
+		sign = -1.0f;
+	}
+
+	//Close enough to not lose precision in sinf(theta)
+	if (cosTheta > 0.9995f) return Nlerp(a, b, t);
+
+	float32 theta = acosf(cosTheta);
+	float32 invSin = 1.0f / sinf(theta);
+
+	float32 sa = sinf((1.0f - t) * theta) * invSin;
+	float32 sb = sinf(t * theta) * invSin * sign;
+
+	__m128 xmm = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&a.x), _mm_set1_ps(sa)), _mm_mul_ps(_mm_loadu_ps(&b.x), _mm_set1_ps(sb)));
+
+	quat q;
+	_mm_storeu_ps(&q.x, xmm);
+
+	return q;
+}
+
+quat& quat::Multiply(const quat& q) {
+	__m128 a = _mm_loadu_ps(&x);
+	__m128 b = _mm_loadu_ps(&q.x);
+
+	__m128 xmm = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+
+	__m128 tmp = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)));
+	xmm = _mm_add_ps(xmm, _mm_mul_ps(tmp, _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f)));
+
+	tmp = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)));
+	xmm = _mm_add_ps(xmm, _mm_mul_ps(tmp, _mm_set_ps(-1.0f, -1.0f, 1.0f, 1.0f)));
+
+	tmp = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)));
+	xmm = _mm_add_ps(xmm, _mm_mul_ps(tmp, _mm_set_ps(-1.0f, 1.0f, 1.0f, -1.0f)));
+
+	_mm_storeu_ps(&x, xmm);
+	return *this;
+}
+
+quat& quat::Normalize() {
+	__m128 xmm = _mm_loadu_ps(&x);
+	xmm = _mm_mul_ps(xmm, _mm_set1_ps(1.0f / LengthSqrt()));
+	_mm_storeu_ps(&x, xmm);
+	return *this;
+}
+
+quat& quat::Conjugate() {
+	x = -x;
+	y = -y;
+	z = -z;
+	return *this;
+}
+
+float32 quat::Length() const {
+	return x * x + y * y + z * z + w * w;
+}
+
+float32 quat::LengthSqrt() const {
+	return sqrtf(Length());
+}
+
+float32 quat::Dot(const quat& q) const {
+	return x * q.x + y * q.y + z * q.z + w * q.w;
+}
+
+vec3 quat::Rotate(const vec3& v) const {
+	vec3 u(x, y, z);
+	vec3 t = u.Cross(v) * 2.0f;
+
+	return v + t * w + u.Cross(t);
+}
+
+vec3 quat::ToEuler() const {
+	float32 xx = x * x, yy = y * y, zz = z * z;
+	float32 xy = x * y, xz = x * z, yz = y * z;
+	float32 wx = w * x, wy = w * y, wz = w * z;
+
+	float32 m02 = 2.0f * (xz + wy);
+
+	if (m02 > 0.9999f || m02 < -0.9999f) {
+		//Gimbal lock, put everything in x
+		float32 m11 = 1.0f - 2.0f * (xx + zz);
+		float32 m21 = 2.0f * (yz + wx);
+
+		return vec3(FD_TO_DEGREES_F(atan2f(m21, m11)), FD_TO_DEGREES_F(asinf(m02 > 0.0f ? -1.0f : 1.0f)), 0);
+	}
+
+	float32 m00 = 1.0f - 2.0f * (yy + zz);
+	float32 m01 = 2.0f * (xy - wz);
+	float32 m12 = 2.0f * (yz - wx);
+	float32 m22 = 1.0f - 2.0f * (xx + yy);
+
+	return vec3(FD_TO_DEGREES_F(atan2f(-m12, m22)), FD_TO_DEGREES_F(asinf(-m02)), FD_TO_DEGREES_F(atan2f(-m01, m00)));
+}
+
+mat4 quat::ToMatrix() const {
+	return mat4::Rotate(*this);
+}
+
+bool quat::operator==(const quat& q) const {
+	return FLOAT32_CMP(x, q.x) && FLOAT32_CMP(y, q.y) && FLOAT32_CMP(z, q.z) && FLOAT32_CMP(w, q.w);
+}
+
+bool quat::operator!=(const quat& q) const {
+	return !(FLOAT32_CMP(x, q.x) && FLOAT32_CMP(y, q.y) && FLOAT32_CMP(z, q.z) && FLOAT32_CMP(w, q.w));
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "mathcommon.h"
+
+namespace FD {
+
+class FDUAPI quat {
+public:
+	float32 x;
+	float32 y;
+	float32 z;
+	float32 w;
+
+public:
+	quat();
+	quat(float32 x, float32 y, float32 z, float32 w);
+	quat(const vec3& axis, float32 angle);
+
+	inline static quat Identity() { return quat(0, 0, 0, 1); }
+
+	//Euler angles in degrees, same convention as mat4::Rotate
+	static quat FromEuler(const vec3& v);
+	//Only the rotation part is used, the matrix must not contain any scale
+	static quat FromMatrix(const mat4& m);
+
+	static quat Slerp(const quat& a, const quat& b, float32 t);
+	static quat Nlerp(const quat& a, const quat& b, float32 t);
+
+	quat& Multiply(const quat& q);
+	quat& Normalize();
+	quat& Conjugate();
+
+	float32 Length() const;
+	float32 LengthSqrt() const;
+
+	float32 Dot(const quat& q) const;
+
+	vec3 Rotate(const vec3& v) const;
+	vec3 ToEuler() const;
+	mat4 ToMatrix() const;
+
+	__forceinline friend quat operator*(const quat& l, const quat& r) { return quat(l).Multiply(r); }
+	__forceinline friend vec3 operator*(const quat& l, const vec3& r) { return l.Rotate(r); }
+
+	__forceinline void operator*=(const quat& q) { Multiply(q); }
+
+	bool operator==(const quat& q) const;
+	bool operator!=(const quat& q) const;
+
+	__forceinline quat operator-() const { return quat(-x, -y, -z, -w); }
+};
+
+}
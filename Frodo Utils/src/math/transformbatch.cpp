@@ -0,0 +1,415 @@
+#include "transformbatch.h"
+
+namespace FD {
+
+#define FD_BATCH_WIDTH 8
+
+#define FD_SINCOS_DP1 -0.78515625f
+#define FD_SINCOS_DP2 -2.4187564849853515625e-4f
+#define FD_SINCOS_DP3 -3.77489497744594108e-8f
+
+#define FD_SIN_P0 -1.9515295891e-4f
+#define FD_SIN_P1  8.3321608736e-3f
+#define FD_SIN_P2 -1.6666654611e-1f
+
+#define FD_COS_P0  2.443315711809948e-5f
+#define FD_COS_P1 -1.388731625493765e-3f
+#define FD_COS_P2  4.166664568298827e-2f
+
+//Cephes style sincos, 8 lanes at a time
+static __forceinline void sincos_ps(__m256 x, __m256* s, __m256* c) {
+	const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+
+	__m256 signSin = _mm256_and_ps(x, signMask);
+	x = _mm256_andnot_ps(signMask, x);
+
+	__m256i quadrant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+	quadrant = _mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+
+	__m256 y = _mm256_cvtepi32_ps(quadrant);
+
+	__m256 swapSignSin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(4)), 29));
+	__m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(quadrant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+	__m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+	signSin = _mm256_xor_ps(signSin, swapSignSin);
+
+	x = _mm256_fmadd_ps(y, _mm256_set1_ps(FD_SINCOS_DP1), x);
+	x = _mm256_fmadd_ps(y, _mm256_set1_ps(FD_SINCOS_DP2), x);
+	x = _mm256_fmadd_ps(y, _mm256_set1_ps(FD_SINCOS_DP3), x);
+
+	__m256 z = _mm256_mul_ps(x, x);
+
+	__m256 polyCos = _mm256_fmadd_ps(_mm256_set1_ps(FD_COS_P0), z, _mm256_set1_ps(FD_COS_P1));
+	polyCos = _mm256_fmadd_ps(polyCos, z, _mm256_set1_ps(FD_COS_P2));
+	polyCos = _mm256_mul_ps(_mm256_mul_ps(polyCos, z), z);
+	polyCos = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, polyCos);
+	polyCos = _mm256_add_ps(polyCos, _mm256_set1_ps(1.0f));
+
+	__m256 polySin = _mm256_fmadd_ps(_mm256_set1_ps(FD_SIN_P0), z, _mm256_set1_ps(FD_SIN_P1));
+	polySin = _mm256_fmadd_ps(polySin, z, _mm256_set1_ps(FD_SIN_P2));
+	polySin = _mm256_fmadd_ps(_mm256_mul_ps(polySin, z), x, x);
+
+	*s = _mm256_xor_ps(_mm256_blendv_ps(polyCos, polySin, polyMask), signSin);
+	*c = _mm256_xor_ps(_mm256_blendv_ps(polySin, polyCos, polyMask), signCos);
+}
+
+//Transposes 4 registers of 8 lanes and stores lane n as column "column" of the nth matrix, out points to the first matrix's data
+static __forceinline void store_columns(__m256 r0, __m256 r1, __m256 r2, __m256 r3, float32* out, uint_t column) {
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+	__m256 t1 = _mm256_unpackhi_ps(r0, r1);
+	__m256 t2 = _mm256_unpacklo_ps(r2, r3);
+	__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+	__m256 c0 = _mm256_shuffle_ps(t0, t2, 0x44);
+	__m256 c1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+	__m256 c2 = _mm256_shuffle_ps(t1, t3, 0x44);
+	__m256 c3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+
+	out += column * 4;
+
+	_mm_storeu_ps(out + 0, _mm256_castps256_ps128(c0));
+	_mm_storeu_ps(out + 16, _mm256_castps256_ps128(c1));
+	_mm_storeu_ps(out + 32, _mm256_castps256_ps128(c2));
+	_mm_storeu_ps(out + 48, _mm256_castps256_ps128(c3));
+	_mm_storeu_ps(out + 64, _mm256_extractf128_ps(c0, 1));
+	_mm_storeu_ps(out + 80, _mm256_extractf128_ps(c1, 1));
+	_mm_storeu_ps(out + 96, _mm256_extractf128_ps(c2, 1));
+	_mm_storeu_ps(out + 112, _mm256_extractf128_ps(c3, 1));
+}
+
+static __forceinline void gather_vec3(const vec3* v, __m256* x, __m256* y, __m256* z) {
+	const __m256i index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+	const float32* base = &v->x;
+
+	*x = _mm256_i32gather_ps(base + 0, index, sizeof(float32));
+	*y = _mm256_i32gather_ps(base + 1, index, sizeof(float32));
+	*z = _mm256_i32gather_ps(base + 2, index, sizeof(float32));
+}
+
+static __forceinline void gather_quat(const quat* q, __m256* x, __m256* y, __m256* z, __m256* w) {
+	const __m256i index = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+	const float32* base = &q->x;
+
+	*x = _mm256_i32gather_ps(base + 0, index, sizeof(float32));
+	*y = _mm256_i32gather_ps(base + 1, index, sizeof(float32));
+	*z = _mm256_i32gather_ps(base + 2, index, sizeof(float32));
+	*w = _mm256_i32gather_ps(base + 3, index, sizeof(float32));
+}
+
+static __forceinline void scatter_vec3(vec3* v, __m256 x, __m256 y, __m256 z) {
+	alignas(32) float32 tx[FD_BATCH_WIDTH];
+	alignas(32) float32 ty[FD_BATCH_WIDTH];
+	alignas(32) float32 tz[FD_BATCH_WIDTH];
+
+	_mm256_store_ps(tx, x);
+	_mm256_store_ps(ty, y);
+	_mm256_store_ps(tz, z);
+
+	for (uint_t i = 0; i < FD_BATCH_WIDTH; i++) {
+		v[i].x = tx[i];
+		v[i].y = ty[i];
+		v[i].z = tz[i];
+	}
+}
+
+mat4 TransformBatch::ComposeTRS(const vec3& position, const vec3& rotation, const vec3& scale) {
+	float32 xcos = cosf(FD_TO_RADIANS_F(rotation.x));
+	float32 xsin = sinf(FD_TO_RADIANS_F(rotation.x));
+	float32 ycos = cosf(FD_TO_RADIANS_F(rotation.y));
+	float32 ysin = sinf(FD_TO_RADIANS_F(rotation.y));
+	float32 zcos = cosf(FD_TO_RADIANS_F(rotation.z));
+	float32 zsin = sinf(FD_TO_RADIANS_F(rotation.z));
+
+	mat4 r;
+	float32* m = r.m;
+
+	m[0 + 0 * 4] = ycos * zcos * scale.x;
+	m[1 + 0 * 4] = (xcos * zsin - xsin * ysin * zcos) * scale.x;
+	m[2 + 0 * 4] = (xsin * zsin + xcos * ysin * zcos) * scale.x;
+
+	m[0 + 1 * 4] = -ycos * zsin * scale.y;
+	m[1 + 1 * 4] = (xcos * zcos + xsin * ysin * zsin) * scale.y;
+	m[2 + 1 * 4] = (xsin * zcos - xcos * ysin * zsin) * scale.y;
+
+	m[0 + 2 * 4] = -ysin * scale.z;
+	m[1 + 2 * 4] = -xsin * ycos * scale.z;
+	m[2 + 2 * 4] = xcos * ycos * scale.z;
+
+	m[0 + 3 * 4] = position.x;
+	m[1 + 3 * 4] = position.y;
+	m[2 + 3 * 4] = position.z;
+	m[3 + 3 * 4] = 1.0f;
+
+	return r;
+}
+
+mat4 TransformBatch::ComposeTRS(const vec3& position, const quat& rotation, const vec3& scale) {
+	float32 xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+	float32 xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+	float32 wx = rotation.w * rotation.x, wy = rotation.w * rotation.y, wz = rotation.w * rotation.z;
+
+	mat4 r;
+	float32* m = r.m;
+
+	m[0 + 0 * 4] = (1.0f - 2.0f * (yy + zz)) * scale.x;
+	m[1 + 0 * 4] = 2.0f * (xy + wz) * scale.x;
+	m[2 + 0 * 4] = 2.0f * (xz - wy) * scale.x;
+
+	m[0 + 1 * 4] = 2.0f * (xy - wz) * scale.y;
+	m[1 + 1 * 4] = (1.0f - 2.0f * (xx + zz)) * scale.y;
+	m[2 + 1 * 4] = 2.0f * (yz + wx) * scale.y;
+
+	m[0 + 2 * 4] = 2.0f * (xz + wy) * scale.z;
+	m[1 + 2 * 4] = 2.0f * (yz - wx) * scale.z;
+	m[2 + 2 * 4] = (1.0f - 2.0f * (xx + yy)) * scale.z;
+
+	m[0 + 3 * 4] = position.x;
+	m[1 + 3 * 4] = position.y;
+	m[2 + 3 * 4] = position.z;
+	m[3 + 3 * 4] = 1.0f;
+
+	return r;
+}
+
+void TransformBatch::ComposeTRS(const vec3* position, const vec3* rotation, const vec3* scale, mat4* out, uint_t count) {
+	const __m256 toRadians = _mm256_set1_ps((float32)FD_PRE_TO_RADIANS);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	uint_t i = 0;
+
+	for (; i + FD_BATCH_WIDTH <= count; i += FD_BATCH_WIDTH) {
+		__m256 px, py, pz, rx, ry, rz, sx, sy, sz;
+
+		gather_vec3(position + i, &px, &py, &pz);
+		gather_vec3(rotation + i, &rx, &ry, &rz);
+		gather_vec3(scale + i, &sx, &sy, &sz);
+
+		__m256 xsin, xcos, ysin, ycos, zsin, zcos;
+
+		sincos_ps(_mm256_mul_ps(rx, toRadians), &xsin, &xcos);
+		sincos_ps(_mm256_mul_ps(ry, toRadians), &ysin, &ycos);
+		sincos_ps(_mm256_mul_ps(rz, toRadians), &zsin, &zcos);
+
+		__m256 xsinysin = _mm256_mul_ps(xsin, ysin);
+		__m256 xcosysin = _mm256_mul_ps(xcos, ysin);
+
+		__m256 m00 = _mm256_mul_ps(ycos, zcos);
+		__m256 m10 = _mm256_fnmadd_ps(xsinysin, zcos, _mm256_mul_ps(xcos, zsin));
+		__m256 m20 = _mm256_fmadd_ps(xcosysin, zcos, _mm256_mul_ps(xsin, zsin));
+
+		__m256 m01 = _mm256_sub_ps(zero, _mm256_mul_ps(ycos, zsin));
+		__m256 m11 = _mm256_fmadd_ps(xsinysin, zsin, _mm256_mul_ps(xcos, zcos));
+		__m256 m21 = _mm256_fnmadd_ps(xcosysin, zsin, _mm256_mul_ps(xsin, zcos));
+
+		__m256 m02 = _mm256_sub_ps(zero, ysin);
+		__m256 m12 = _mm256_sub_ps(zero, _mm256_mul_ps(xsin, ycos));
+		__m256 m22 = _mm256_mul_ps(xcos, ycos);
+
+		float32* o = out[i].m;
+
+		store_columns(_mm256_mul_ps(m00, sx), _mm256_mul_ps(m10, sx), _mm256_mul_ps(m20, sx), zero, o, 0);
+		store_columns(_mm256_mul_ps(m01, sy), _mm256_mul_ps(m11, sy), _mm256_mul_ps(m21, sy), zero, o, 1);
+		store_columns(_mm256_mul_ps(m02, sz), _mm256_mul_ps(m12, sz), _mm256_mul_ps(m22, sz), zero, o, 2);
+		store_columns(px, py, pz, one, o, 3);
+	}
+
+	for (; i < count; i++) {
+		out[i] = ComposeTRS(position[i], rotation[i], scale[i]);
+	}
+}
+
+void TransformBatch::ComposeTRS(const vec3* position, const quat* rotation, const vec3* scale, mat4* out, uint_t count) {
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+
+	uint_t i = 0;
+
+	for (; i + FD_BATCH_WIDTH <= count; i += FD_BATCH_WIDTH) {
+		__m256 px, py, pz, sx, sy, sz, qx, qy, qz, qw;
+
+		gather_vec3(position + i, &px, &py, &pz);
+		gather_quat(rotation + i, &qx, &qy, &qz, &qw);
+		gather_vec3(scale + i, &sx, &sy, &sz);
+
+		__m256 x2 = _mm256_mul_ps(qx, two);
+		__m256 y2 = _mm256_mul_ps(qy, two);
+		__m256 z2 = _mm256_mul_ps(qz, two);
+
+		__m256 xx = _mm256_mul_ps(qx, x2), yy = _mm256_mul_ps(qy, y2), zz = _mm256_mul_ps(qz, z2);
+		__m256 xy = _mm256_mul_ps(qx, y2), xz = _mm256_mul_ps(qx, z2), yz = _mm256_mul_ps(qy, z2);
+		__m256 wx = _mm256_mul_ps(qw, x2), wy = _mm256_mul_ps(qw, y2), wz = _mm256_mul_ps(qw, z2);
+
+		__m256 m00 = _mm256_sub_ps(one, _mm256_add_ps(yy, zz));
+		__m256 m10 = _mm256_add_ps(xy, wz);
+		__m256 m20 = _mm256_sub_ps(xz, wy);
+
+		__m256 m01 = _mm256_sub_ps(xy, wz);
+		__m256 m11 = _mm256_sub_ps(one, _mm256_add_ps(xx, zz));
+		__m256 m21 = _mm256_add_ps(yz, wx);
+
+		__m256 m02 = _mm256_add_ps(xz, wy);
+		__m256 m12 = _mm256_sub_ps(yz, wx);
+		__m256 m22 = _mm256_sub_ps(one, _mm256_add_ps(xx, yy));
+
+		float32* o = out[i].m;
+
+		store_columns(_mm256_mul_ps(m00, sx), _mm256_mul_ps(m10, sx), _mm256_mul_ps(m20, sx), zero, o, 0);
+		store_columns(_mm256_mul_ps(m01, sy), _mm256_mul_ps(m11, sy), _mm256_mul_ps(m21, sy), zero, o, 1);
+		store_columns(_mm256_mul_ps(m02, sz), _mm256_mul_ps(m12, sz), _mm256_mul_ps(m22, sz), zero, o, 2);
+		store_columns(px, py, pz, one, o, 3);
+	}
+
+	for (; i < count; i++) {
+		out[i] = ComposeTRS(position[i], rotation[i], scale[i]);
+	}
+}
+
+void TransformBatch::TransformPoints(const mat4& matrix, const float32* x, const float32* y, const float32* z, float32* outX, float32* outY, float32* outZ, uint_t count) {
+	const float32* m = matrix.m;
+
+	__m256 m00 = _mm256_set1_ps(m[0 + 0 * 4]), m01 = _mm256_set1_ps(m[0 + 1 * 4]), m02 = _mm256_set1_ps(m[0 + 2 * 4]), m03 = _mm256_set1_ps(m[0 + 3 * 4]);
+	__m256 m10 = _mm256_set1_ps(m[1 + 0 * 4]), m11 = _mm256_set1_ps(m[1 + 1 * 4]), m12 = _mm256_set1_ps(m[1 + 2 * 4]), m13 = _mm256_set1_ps(m[1 + 3 * 4]);
+	__m256 m20 = _mm256_set1_ps(m[2 + 0 * 4]), m21 = _mm256_set1_ps(m[2 + 1 * 4]), m22 = _mm256_set1_ps(m[2 + 2 * 4]), m23 = _mm256_set1_ps(m[2 + 3 * 4]);
+
+	uint_t i = 0;
+
+	for (; i + FD_BATCH_WIDTH <= count; i += FD_BATCH_WIDTH) {
+		__m256 vx = _mm256_loadu_ps(x + i);
+		__m256 vy = _mm256_loadu_ps(y + i);
+		__m256 vz = _mm256_loadu_ps(z + i);
+
+		_mm256_storeu_ps(outX + i, _mm256_fmadd_ps(m00, vx, _mm256_fmadd_ps(m01, vy, _mm256_fmadd_ps(m02, vz, m03))));
+		_mm256_storeu_ps(outY + i, _mm256_fmadd_ps(m10, vx, _mm256_fmadd_ps(m11, vy, _mm256_fmadd_ps(m12, vz, m13))));
+		_mm256_storeu_ps(outZ + i, _mm256_fmadd_ps(m20, vx, _mm256_fmadd_ps(m21, vy, _mm256_fmadd_ps(m22, vz, m23))));
+	}
+
+	for (; i < count; i++) {
+		float32 vx = x[i], vy = y[i], vz = z[i];
+
+		outX[i] = m[0 + 0 * 4] * vx + m[0 + 1 * 4] * vy + m[0 + 2 * 4] * vz + m[0 + 3 * 4];
+		outY[i] = m[1 + 0 * 4] * vx + m[1 + 1 * 4] * vy + m[1 + 2 * 4] * vz + m[1 + 3 * 4];
+		outZ[i] = m[2 + 0 * 4] * vx + m[2 + 1 * 4] * vy + m[2 + 2 * 4] * vz + m[2 + 3 * 4];
+	}
+}
+
+void TransformBatch::TransformPoints(const mat4& matrix, const vec3* points, vec3* out, uint_t count) {
+	const float32* m = matrix.m;
+
+	__m256 m00 = _mm256_set1_ps(m[0 + 0 * 4]), m01 = _mm256_set1_ps(m[0 + 1 * 4]), m02 = _mm256_set1_ps(m[0 + 2 * 4]), m03 = _mm256_set1_ps(m[0 + 3 * 4]);
+	__m256 m10 = _mm256_set1_ps(m[1 + 0 * 4]), m11 = _mm256_set1_ps(m[1 + 1 * 4]), m12 = _mm256_set1_ps(m[1 + 2 * 4]), m13 = _mm256_set1_ps(m[1 + 3 * 4]);
+	__m256 m20 = _mm256_set1_ps(m[2 + 0 * 4]), m21 = _mm256_set1_ps(m[2 + 1 * 4]), m22 = _mm256_set1_ps(m[2 + 2 * 4]), m23 = _mm256_set1_ps(m[2 + 3 * 4]);
+
+	uint_t i = 0;
+
+	for (; i + FD_BATCH_WIDTH <= count; i += FD_BATCH_WIDTH) {
+		__m256 vx, vy, vz;
+
+		gather_vec3(points + i, &vx, &vy, &vz);
+
+		__m256 rx = _mm256_fmadd_ps(m00, vx, _mm256_fmadd_ps(m01, vy, _mm256_fmadd_ps(m02, vz, m03)));
+		__m256 ry = _mm256_fmadd_ps(m10, vx, _mm256_fmadd_ps(m11, vy, _mm256_fmadd_ps(m12, vz, m13)));
+		__m256 rz = _mm256_fmadd_ps(m20, vx, _mm256_fmadd_ps(m21, vy, _mm256_fmadd_ps(m22, vz, m23)));
+
+		scatter_vec3(out + i, rx, ry, rz);
+	}
+
+	for (; i < count; i++) {
+		vec3 v = points[i];
+
+		out[i].x = m[0 + 0 * 4] * v.x + m[0 + 1 * 4] * v.y + m[0 + 2 * 4] * v.z + m[0 + 3 * 4];
+		out[i].y = m[1 + 0 * 4] * v.x + m[1 + 1 * 4] * v.y + m[1 + 2 * 4] * v.z + m[1 + 3 * 4];
+		out[i].z = m[2 + 0 * 4] * v.x + m[2 + 1 * 4] * v.y + m[2 + 2 * 4] * v.z + m[2 + 3 * 4];
+	}
+}
+
+void TransformBatch::TransformAABBs(const mat4& matrix, const vec3* min, const vec3* max, vec3* outMin, vec3* outMax, uint_t count) {
+	const float32* m = matrix.m;
+
+	float32 a[12];
+
+	for (uint_t i = 0; i < 12; i++)
+		a[i] = fabsf(m[i]);
+
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	__m256 m00 = _mm256_set1_ps(m[0 + 0 * 4]), m01 = _mm256_set1_ps(m[0 + 1 * 4]), m02 = _mm256_set1_ps(m[0 + 2 * 4]), m03 = _mm256_set1_ps(m[0 + 3 * 4]);
+	__m256 m10 = _mm256_set1_ps(m[1 + 0 * 4]), m11 = _mm256_set1_ps(m[1 + 1 * 4]), m12 = _mm256_set1_ps(m[1 + 2 * 4]), m13 = _mm256_set1_ps(m[1 + 3 * 4]);
+	__m256 m20 = _mm256_set1_ps(m[2 + 0 * 4]), m21 = _mm256_set1_ps(m[2 + 1 * 4]), m22 = _mm256_set1_ps(m[2 + 2 * 4]), m23 = _mm256_set1_ps(m[2 + 3 * 4]);
+
+	__m256 a00 = _mm256_set1_ps(a[0 + 0 * 4]), a01 = _mm256_set1_ps(a[0 + 1 * 4]), a02 = _mm256_set1_ps(a[0 + 2 * 4]);
+	__m256 a10 = _mm256_set1_ps(a[1 + 0 * 4]), a11 = _mm256_set1_ps(a[1 + 1 * 4]), a12 = _mm256_set1_ps(a[1 + 2 * 4]);
+	__m256 a20 = _mm256_set1_ps(a[2 + 0 * 4]), a21 = _mm256_set1_ps(a[2 + 1 * 4]), a22 = _mm256_set1_ps(a[2 + 2 * 4]);
+
+	uint_t i = 0;
+
+	for (; i + FD_BATCH_WIDTH <= count; i += FD_BATCH_WIDTH) {
+		__m256 minX, minY, minZ, maxX, maxY, maxZ;
+
+		gather_vec3(min + i, &minX, &minY, &minZ);
+		gather_vec3(max + i, &maxX, &maxY, &maxZ);
+
+		__m256 cx = _mm256_mul_ps(_mm256_add_ps(minX, maxX), half);
+		__m256 cy = _mm256_mul_ps(_mm256_add_ps(minY, maxY), half);
+		__m256 cz = _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half);
+
+		__m256 ex = _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half);
+		__m256 ey = _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half);
+		__m256 ez = _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half);
+
+		__m256 ncx = _mm256_fmadd_ps(m00, cx, _mm256_fmadd_ps(m01, cy, _mm256_fmadd_ps(m02, cz, m03)));
+		__m256 ncy = _mm256_fmadd_ps(m10, cx, _mm256_fmadd_ps(m11, cy, _mm256_fmadd_ps(m12, cz, m13)));
+		__m256 ncz = _mm256_fmadd_ps(m20, cx, _mm256_fmadd_ps(m21, cy, _mm256_fmadd_ps(m22, cz, m23)));
+
+		__m256 nex = _mm256_fmadd_ps(a00, ex, _mm256_fmadd_ps(a01, ey, _mm256_mul_ps(a02, ez)));
+		__m256 ney = _mm256_fmadd_ps(a10, ex, _mm256_fmadd_ps(a11, ey, _mm256_mul_ps(a12, ez)));
+		__m256 nez = _mm256_fmadd_ps(a20, ex, _mm256_fmadd_ps(a21, ey, _mm256_mul_ps(a22, ez)));
+
+		scatter_vec3(outMin + i, _mm256_sub_ps(ncx, nex), _mm256_sub_ps(ncy, ney), _mm256_sub_ps(ncz, nez));
+		scatter_vec3(outMax + i, _mm256_add_ps(ncx, nex), _mm256_add_ps(ncy, ney), _mm256_add_ps(ncz, nez));
+	}
+
+	for (; i < count; i++) {
+		vec3 c = (min[i] + max[i]) * 0.5f;
+		vec3 e = (max[i] - min[i]) * 0.5f;
+
+		vec3 nc(m[0 + 0 * 4] * c.x + m[0 + 1 * 4] * c.y + m[0 + 2 * 4] * c.z + m[0 + 3 * 4],
+				m[1 + 0 * 4] * c.x + m[1 + 1 * 4] * c.y + m[1 + 2 * 4] * c.z + m[1 + 3 * 4],
+				m[2 + 0 * 4] * c.x + m[2 + 1 * 4] * c.y + m[2 + 2 * 4] * c.z + m[2 + 3 * 4]);
+
+		vec3 ne(a[0 + 0 * 4] * e.x + a[0 + 1 * 4] * e.y + a[0 + 2 * 4] * e.z,
+				a[1 + 0 * 4] * e.x + a[1 + 1 * 4] * e.y + a[1 + 2 * 4] * e.z,
+				a[2 + 0 * 4] * e.x + a[2 + 1 * 4] * e.y + a[2 + 2 * 4] * e.z);
+
+		outMin[i] = nc - ne;
+		outMax[i] = nc + ne;
+	}
+}
+
+void TransformBatch::Multiply(const mat4& left, const mat4* right, mat4* out, uint_t count) {
+	__m128 col[4];
+
+	for (uint_t c = 0; c < 4; c++)
+		col[c] = _mm_loadu_ps(left.m + c * 4);
+
+	for (uint_t i = 0; i < count; i++) {
+		const float32* r = right[i].m;
+		__m128 res[4];
+
+		for (uint_t c = 0; c < 4; c++) {
+			__m128 v = _mm_mul_ps(col[0], _mm_set1_ps(r[0 + c * 4]));
+			v = _mm_fmadd_ps(col[1], _mm_set1_ps(r[1 + c * 4]), v);
+			v = _mm_fmadd_ps(col[2], _mm_set1_ps(r[2 + c * 4]), v);
+			res[c] = _mm_fmadd_ps(col[3], _mm_set1_ps(r[3 + c * 4]), v);
+		}
+
+		float32* o = out[i].m;
+
+		for (uint_t c = 0; c < 4; c++)
+			_mm_storeu_ps(o + c * 4, res[c]);
+	}
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "mathcommon.h"
+#include "vec3.h"
+#include "mat4.h"
+#include "quat.h"
+
+namespace FD {
+
+/*
+ All kernels work on 8 elements at a time (AVX2). The AoS overloads gather the input
+ into SoA registers, the SoA overloads read the component streams directly.
+ Remaining elements (count % 8) are processed with scalar code.
+
+ Rotations are either euler angles in degrees or unit quaternions and produce the
+ same matrix as mat4::Rotate.
+*/
+
+class FDUAPI TransformBatch {
+public:
+	// out[i] = Translate(position[i]) * Rotate(rotation[i]) * Scale(scale[i])
+	static void ComposeTRS(const vec3* position, const vec3* rotation, const vec3* scale, mat4* out, uint_t count);
+	static void ComposeTRS(const vec3* position, const quat* rotation, const vec3* scale, mat4* out, uint_t count);
+
+	// out[i] = matrix * points[i], out can be the same as points
+	static void TransformPoints(const mat4& matrix, const vec3* points, vec3* out, uint_t count);
+	static void TransformPoints(const mat4& matrix, const float32* x, const float32* y, const float32* z, float32* outX, float32* outY, float32* outZ, uint_t count);
+
+	// Transforms the boxes and writes the axis aligned box enclosing the result
+	static void TransformAABBs(const mat4& matrix, const vec3* min, const vec3* max, vec3* outMin, vec3* outMax, uint_t count);
+
+	// out[i] = left * right[i]
+	static void Multiply(const mat4& left, const mat4* right, mat4* out, uint_t count);
+
+	static mat4 ComposeTRS(const vec3& position, const vec3& rotation, const vec3& scale);
+	static mat4 ComposeTRS(const vec3& position, const quat& rotation, const vec3& scale);
+};
+
+}
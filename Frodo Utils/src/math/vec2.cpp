@@ -12,14 +12,14 @@ vec2& vec2::Add(const vec2& v) {
 	__m128 vxmm = _mm_set_ps(0, 0, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_add_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
 vec2& vec2::Add(float32 v) {
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_add_ps(xmm, _mm_set_ps(0, 0, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
@@ -27,14 +27,14 @@ vec2& vec2::Subtract(const vec2& v) {
 	__m128 vxmm = _mm_set_ps(0, 0, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_sub_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
 vec2& vec2::Subtract(float32 v) {
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_sub_ps(xmm, _mm_set_ps(0, 0, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
@@ -42,14 +42,14 @@ vec2& vec2::Multiply(const vec2& v) {
 	__m128 vxmm = _mm_set_ps(0, 0, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_mul_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
 vec2& vec2::Multiply(float32 v) {
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_mul_ps(xmm, _mm_set_ps(0, 0, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
@@ -57,14 +57,14 @@ vec2& vec2::Divide(const vec2& v) {
 	__m128 vxmm = _mm_set_ps(0, 0, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_div_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
 vec2& vec2::Divide(float32 v) {
 	__m128 xmm = _mm_set_ps(0, 0, y, x);
 	xmm = _mm_div_ps(xmm, _mm_set_ps(1, 1, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 2);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 2);
 	return *this;
 }
 
@@ -100,14 +100,14 @@ ivec2& ivec2::Add(const ivec2& v) {
 	__m128i vxmm = _mm_set_epi32(0, 0, v.y, v.x);
 	__m128i xmm = _mm_set_epi32(0, 0, y, x);
 	xmm = _mm_add_epi32(xmm, vxmm);
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 2);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 2);
 	return *this;
 }
 
 ivec2& ivec2::Add(int32 v) {
 	__m128i xmm = _mm_set_epi32(0, 0, y, x);
 	xmm = _mm_add_epi32(xmm, _mm_set_epi32(0, 0, v, v));
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 2);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 2);
 	return *this;
 }
 
@@ -115,14 +115,14 @@ ivec2& ivec2::Subtract(const ivec2& v) {
 	__m128i vxmm = _mm_set_epi32(0, 0, v.y, v.x);
 	__m128i xmm = _mm_set_epi32(0, 0, y, x);
 	xmm = _mm_sub_epi32(xmm, vxmm);
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 2);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 2);
 	return *this;
 }
 
 ivec2& ivec2::Subtract(int32 v) {
 	__m128i xmm = _mm_set_epi32(0, 0, y, x);
 	xmm = _mm_sub_epi32(xmm, _mm_set_epi32(0, 0, v, v));
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 2);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 2);
 	return *this;
 }
 
@@ -130,16 +130,16 @@ ivec2& ivec2::Multiply(const ivec2& v) {
 	__m128i vxmm = _mm_set_epi32(0, v.y, 0, v.x);
 	__m128i xmm = _mm_set_epi32(0, y, 0, x);
 	xmm = _mm_mul_epi32(xmm, vxmm);
-	x = xmm.m128i_i32[0];
-	y = xmm.m128i_i32[2];
+	x = FD_M128I_I32(xmm)[0];
+	y = FD_M128I_I32(xmm)[2];
 	return *this;
 }
 
 ivec2& ivec2::Multiply(int32 v) {
 	__m128i xmm = _mm_set_epi32(0, y, 0, x);
 	xmm = _mm_mul_epi32(xmm, _mm_set_epi32(0, v, 0, v));
-	x = xmm.m128i_i32[0];
-	y = xmm.m128i_i32[2];
+	x = FD_M128I_I32(xmm)[0];
+	y = FD_M128I_I32(xmm)[2];
 	return *this;
 }
 
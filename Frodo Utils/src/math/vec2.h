@@ -51,7 +51,9 @@ public:
 
 	__forceinline vec2 operator-() { return vec2(-x, -y); }
 
+#ifdef FD_PLATFORM_WINDOWS
 	__forceinline DirectX::XMFLOAT2 ToDX() const { return DirectX::XMFLOAT2(x, y); }
+#endif
 };
 
 
@@ -16,14 +16,14 @@ vec3& vec3::Add(const vec3& v) {
 	__m128 vxmm = _mm_set_ps(0, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_add_ps(xmm, vxmm);
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
 vec3& vec3::Add(float32 v) {
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_add_ps(xmm, _mm_set_ps(0, v, v, v));
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
@@ -31,14 +31,14 @@ vec3& vec3::Subtract(const vec3& v) {
 	__m128 vxmm = _mm_set_ps(0, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_sub_ps(xmm, vxmm);
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
 vec3& vec3::Subtract(float32 v) {
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_sub_ps(xmm, _mm_set_ps(0, v, v, v));
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
@@ -46,14 +46,14 @@ vec3& vec3::Multiply(const vec3& v) {
 	__m128 vxmm = _mm_set_ps(0, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_mul_ps(xmm, vxmm);
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
 vec3& vec3::Multiply(float32 v) {
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_mul_ps(xmm, _mm_set_ps(0, v, v, v));
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
@@ -61,7 +61,7 @@ vec3& vec3::Divide(const vec3& v) {
 	__m128 vxmm = _mm_set_ps(0, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_div_ps(xmm, vxmm);
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
@@ -80,14 +80,14 @@ float32 vec3::LengthSqrt() const {
 vec3& vec3::Divide(float32 v) {
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_div_ps(xmm, _mm_set_ps(1, v, v, v));
-	memcpy(this, (void*)xmm.m128_f32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128_F32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
 float32 vec3::Dot(const vec3& v) const {
 	__m128 xmm = _mm_set_ps(0, z, y, x);
 	xmm = _mm_mul_ps(xmm, _mm_set_ps(0, v.z, v.y, v.x));
-	return xmm.m128_f32[0] + xmm.m128_f32[1] + xmm.m128_f32[2];
+	return FD_M128_F32(xmm)[0] + FD_M128_F32(xmm)[1] + FD_M128_F32(xmm)[2];
 }
 
 vec3 vec3::Cross(const vec3& v) const {
@@ -158,14 +158,14 @@ ivec3& ivec3::Add(const ivec3& v) {
 	__m128i vxmm = _mm_set_epi32(0, v.z, v.y, v.x);
 	__m128i xmm = _mm_set_epi32(0, z, y, x);
 	xmm = _mm_add_epi32(xmm, vxmm);
-	memcpy(this, (void*)xmm.m128i_i32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128I_I32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
 ivec3& ivec3::Add(int32 v) {
 	__m128i xmm = _mm_set_epi32(0, z, y, x);
 	xmm = _mm_add_epi32(xmm, _mm_set_epi32(0, v, v, v));
-	memcpy(this, (void*)xmm.m128i_u32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128I_U32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
@@ -173,14 +173,14 @@ ivec3& ivec3::Subtract(const ivec3& v) {
 	__m128i vxmm = _mm_set_epi32(0, v.z, v.y, v.x);
 	__m128i xmm = _mm_set_epi32(0, z, y, x);
 	xmm = _mm_sub_epi32(xmm, vxmm);
-	memcpy(this, (void*)xmm.m128i_u32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128I_U32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
 ivec3& ivec3::Subtract(int32 v) {
 	__m128i xmm = _mm_set_epi32(0, z, y, x);
 	xmm = _mm_sub_epi32(xmm, _mm_set_epi32(0, v, v, v));
-	memcpy(this, (void*)xmm.m128i_u32, sizeof(int32) * 3);
+	memcpy(this, (void*)FD_M128I_U32(xmm), sizeof(int32) * 3);
 	return *this;
 }
 
@@ -188,18 +188,18 @@ ivec3& ivec3::Multiply(const ivec3& v) {
 	__m256i vxmm = _mm256_set_epi32(0, 0, 0, v.z, 0, v.y, 0, v.x);
 	__m256i xmm = _mm256_set_epi32(0, 0, 0, z, 0, y, 0, x);
 	xmm = _mm256_mul_epi32(xmm, vxmm);
-	x = xmm.m256i_i32[0];
-	y = xmm.m256i_i32[2];
-	z = xmm.m256i_i32[4];
+	x = FD_M256I_I32(xmm)[0];
+	y = FD_M256I_I32(xmm)[2];
+	z = FD_M256I_I32(xmm)[4];
 	return *this;
 }
 
 ivec3& ivec3::Multiply(int32 v) {
 	__m256i xmm = _mm256_set_epi32(0, 0, 0, z, 0, y, 0, x);
 	xmm = _mm256_mul_epi32(xmm, _mm256_set_epi32(0, 0, 0, v, 0, v, 0, v));
-	x = xmm.m256i_i32[0];
-	y = xmm.m256i_i32[2];
-	z = xmm.m256i_i32[4];
+	x = FD_M256I_I32(xmm)[0];
+	y = FD_M256I_I32(xmm)[2];
+	z = FD_M256I_I32(xmm)[4];
 	return *this;
 }
 
@@ -63,7 +63,9 @@ public:
 
 	__forceinline vec3 operator-() { return vec3(-x, -y, -z); }
 
+#ifdef FD_PLATFORM_WINDOWS
 	__forceinline DirectX::XMFLOAT3 ToDX() const { return DirectX::XMFLOAT3(x, y, z); }
+#endif
 };
 
 
@@ -19,14 +19,14 @@ vec4& vec4::Add(const vec4& v) {
 	__m128 vxmm = _mm_set_ps(v.w, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_add_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
 vec4& vec4::Add(float32 v) {
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_add_ps(xmm, _mm_set_ps(v, v, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
@@ -34,14 +34,14 @@ vec4& vec4::Subtract(const vec4& v) {
 	__m128 vxmm = _mm_set_ps(v.w, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_sub_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
 vec4& vec4::Subtract(float32 v) {
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_sub_ps(xmm, _mm_set_ps(v, v, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
@@ -49,14 +49,14 @@ vec4& vec4::Multiply(const vec4& v) {
 	__m128 vxmm = _mm_set_ps(v.w, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_mul_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
 vec4& vec4::Multiply(float32 v) {
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_mul_ps(xmm, _mm_set_ps(v, v, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
@@ -64,14 +64,14 @@ vec4& vec4::Divide(const vec4& v) {
 	__m128 vxmm = _mm_set_ps(v.w, v.z, v.y, v.x);
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_div_ps(xmm, vxmm);
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
 vec4& vec4::Divide(float32 v) {
 	__m128 xmm = _mm_set_ps(w, z, y, x);
 	xmm = _mm_div_ps(xmm, _mm_set_ps(v, v, v, v));
-	memcpy(this, xmm.m128_f32, sizeof(float32) * 4);
+	memcpy(this, FD_M128_F32(xmm), sizeof(float32) * 4);
 	return *this;
 }
 
@@ -112,14 +112,14 @@ ivec4& ivec4::Add(const ivec4& v) {
 	__m128i vxmm = _mm_set_epi32(v.w, v.z, v.y, v.x);
 	__m128i xmm = _mm_set_epi32(w, z, y, x);
 	xmm = _mm_add_epi32(xmm, vxmm);
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 4);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 4);
 	return *this;
 }
 
 ivec4& ivec4::Add(int32 v) {
 	__m128i xmm = _mm_set_epi32(w, z, y, x);
 	xmm = _mm_add_epi32(xmm, _mm_set_epi32(v, v, v, v));
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 4);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 4);
 	return *this;
 }
 
@@ -127,14 +127,14 @@ ivec4& ivec4::Subtract(const ivec4& v) {
 	__m128i vxmm = _mm_set_epi32(v.w, v.z, v.y, v.x);
 	__m128i xmm = _mm_set_epi32(w, z, y, x);
 	xmm = _mm_sub_epi32(xmm, vxmm);
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 4);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 4);
 	return *this;
 }
 
 ivec4& ivec4::Subtract(int32 v) {
 	__m128i xmm = _mm_set_epi32(w, z, y, x);
 	xmm = _mm_sub_epi32(xmm, _mm_set_epi32(v, v, v, v));
-	memcpy(this, xmm.m128i_i32, sizeof(int32) * 4);
+	memcpy(this, FD_M128I_I32(xmm), sizeof(int32) * 4);
 	return *this;
 }
 
@@ -142,20 +142,20 @@ ivec4& ivec4::Multiply(const ivec4& v) {
 	__m256i vxmm = _mm256_set_epi32(0, v.w, 0, v.z, 0, v.y, 0, v.x);
 	__m256i xmm = _mm256_set_epi32(0, w, 0, z, 0, y, 0, x);
 	xmm = _mm256_mul_epi32(xmm, vxmm);
-	x = xmm.m256i_i32[0];
-	y = xmm.m256i_i32[2];
-	z = xmm.m256i_i32[4];
-	w = xmm.m256i_i32[6];
+	x = FD_M256I_I32(xmm)[0];
+	y = FD_M256I_I32(xmm)[2];
+	z = FD_M256I_I32(xmm)[4];
+	w = FD_M256I_I32(xmm)[6];
 	return *this;
 }
 
 ivec4& ivec4::Multiply(int32 v) {
 	__m256i xmm = _mm256_set_epi32(0, w, 0, z, 0, y, 0, x);
 	xmm = _mm256_mul_epi32(xmm, _mm256_set_epi32(0, v, 0, v, 0, v, 0, v));
-	x = xmm.m256i_i32[0];
-	y = xmm.m256i_i32[2];
-	z = xmm.m256i_i32[4];
-	w = xmm.m256i_i32[6];
+	x = FD_M256I_I32(xmm)[0];
+	y = FD_M256I_I32(xmm)[2];
+	z = FD_M256I_I32(xmm)[4];
+	w = FD_M256I_I32(xmm)[6];
 	return *this;
 }
 
@@ -57,7 +57,9 @@ public:
 
 	__forceinline vec4 operator-() { return vec4(-x, -y, -z, -w); }
 
+#ifdef FD_PLATFORM_WINDOWS
 	__forceinline DirectX::XMFLOAT4 ToDX() const { return DirectX::XMFLOAT4(x, y, z, w); }
+#endif
 };
 
 
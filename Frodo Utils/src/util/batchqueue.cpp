@@ -0,0 +1,117 @@
+#include "batchqueue.h"
+#include <util/radixsort.h>
+#include <core/log.h>
+#include <string.h>
+
+namespace FD {
+
+#define FD_RENDER_KEY_MESH_SHIFT FD_RENDER_KEY_DEPTH_BITS
+#define FD_RENDER_KEY_MATERIAL_SHIFT (FD_RENDER_KEY_MESH_SHIFT + FD_RENDER_KEY_MESH_BITS)
+#define FD_RENDER_KEY_SHADER_SHIFT (FD_RENDER_KEY_MATERIAL_SHIFT + FD_RENDER_KEY_MATERIAL_BITS)
+#define FD_RENDER_KEY_PASS_SHIFT (FD_RENDER_KEY_SHADER_SHIFT + FD_RENDER_KEY_SHADER_BITS)
+
+static_assert(FD_RENDER_KEY_PASS_SHIFT + FD_RENDER_KEY_PASS_BITS == 64, "Render key fields don't add up to 64 bits");
+
+BatchQueue::BatchQueue() : items(256, 256), keys(256, 256), order(256, 256), tempKeys(256, 256), tempOrder(256, 256), batches(256, 256), numInstances(0), shaders(16), materials(64), meshes(64) {
+
+}
+
+uint64 BatchQueue::GetID(PointerTable& table, const void* item, uint32 bits) {
+	uint64 index = table.Insert(item);
+	uint64 max = (1ull << bits) - 1;
+
+	return index < max ? index : max;
+}
+
+uint64 BatchQueue::GetDepth(const vec3& position, const vec3& viewPosition) {
+	float32 x = position.x - viewPosition.x;
+	float32 y = position.y - viewPosition.y;
+	float32 z = position.z - viewPosition.z;
+
+	//The bits of a positive float sort like the float, the top ones are enough to order by
+	float32 distance = x * x + y * y + z * z;
+	uint32 bits;
+
+	memcpy(&bits, &distance, sizeof(uint32));
+
+	return bits >> (32 - FD_RENDER_KEY_DEPTH_BITS);
+}
+
+void BatchQueue::Clear() {
+	//Every item is written by Push, List::Clear would memset them first
+	items.Resize(0);
+	batches.Clear();
+	numInstances = 0;
+
+	shaders.Clear();
+	materials.Clear();
+	meshes.Clear();
+}
+
+void BatchQueue::Push(const BatchItem& item) {
+	FD_ASSERT_MSG(item.pass >= (1 << FD_RENDER_KEY_PASS_BITS), "[BatchQueue] Pass out of range");
+
+	items.Push_back(item);
+}
+
+void BatchQueue::Sort(const vec3& viewPosition) {
+	uint_t size = items.GetSize();
+
+	keys.Resize(size);
+	order.Resize(size);
+	tempKeys.Resize(size);
+	tempOrder.Resize(size);
+
+	for (uint_t i = 0; i < size; i++) {
+		const BatchItem& item = items[i];
+
+		uint64 key = (uint64)item.pass << FD_RENDER_KEY_PASS_SHIFT;
+
+		key |= GetID(shaders, item.shader, FD_RENDER_KEY_SHADER_BITS) << FD_RENDER_KEY_SHADER_SHIFT;
+		key |= GetID(materials, item.material, FD_RENDER_KEY_MATERIAL_BITS) << FD_RENDER_KEY_MATERIAL_SHIFT;
+		key |= GetID(meshes, item.mesh, FD_RENDER_KEY_MESH_BITS) << FD_RENDER_KEY_MESH_SHIFT;
+		key |= GetDepth(item.position, viewPosition);
+
+		keys[i] = key;
+		order[i] = (uint32)i;
+	}
+
+	FDRadixSort(keys.GetData(), order.GetData(), tempKeys.GetData(), tempOrder.GetData(), size);
+
+	BuildBatches();
+}
+
+void BatchQueue::BuildBatches() {
+	batches.Clear();
+	numInstances = 0;
+
+	uint_t size = items.GetSize();
+
+	for (uint_t i = 0; i < size; i++) {
+		const BatchItem& item = items[order[i]];
+
+		if (item.instanced && batches.GetSize() > 0) {
+			RenderBatch& last = batches[batches.GetSize() - 1];
+			const BatchItem& first = items[order[last.first]];
+
+			//Every field of the key but the depth, compared by pointer since the ids can be shared
+			if (first.instanced && first.pass == item.pass && first.shader == item.shader && first.material == item.material && first.mesh == item.mesh) {
+				last.count++;
+				numInstances++;
+				continue;
+			}
+		}
+
+		RenderBatch batch;
+
+		batch.first = (uint32)i;
+		batch.count = 1;
+		batch.firstInstance = item.instanced ? numInstances : 0;
+
+		batches.Push_back(batch);
+
+		if (item.instanced) numInstances++;
+	}
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <math/math.h>
+#include <util/list.h>
+#include <util/pointertable.h>
+
+//Sort key fields from the most significant bits down, 64 bits in total
+#define FD_RENDER_KEY_PASS_BITS 4
+#define FD_RENDER_KEY_SHADER_BITS 12
+#define FD_RENDER_KEY_MATERIAL_BITS 12
+#define FD_RENDER_KEY_MESH_BITS 12
+#define FD_RENDER_KEY_DEPTH_BITS 24
+
+namespace FD {
+
+//The state of one draw, the pointers are compared and never dereferenced
+struct BatchItem {
+	const void* shader;
+	const void* material;
+	const void* mesh;
+	//Lower passes are drawn first
+	uint32 pass;
+	//The shader takes per instance data
+	bool instanced;
+	//Sorted front to back from the view position
+	vec3 position;
+};
+
+//Sorted items drawn with one call
+struct RenderBatch {
+	uint32 first;
+	uint32 count;
+	//Where the batch's instances start in the instance data, instanced shaders only
+	uint32 firstInstance;
+};
+
+/*
+ Items submitted in any order, Sort builds a 64 bit key per item out of its pass, shader,
+ material, mesh and distance to the camera and radix sorts the keys. Items that share a
+ shader, material and mesh end up next to each other and are drawn front to back within
+ the group, so the renderer only has to change state where the key changes.
+
+ Instanced items that share the pass, shader, material and mesh are merged into one batch,
+ their instances are numbered in batch order. Everything else is a batch of one.
+
+ Shaders, materials and meshes get ids in the order they are first seen in the frame, when
+ a frame has more than a field can hold the rest share the last id. They still sort, just
+ not grouped, batches are only merged when the pointers match.
+*/
+class FDUAPI BatchQueue {
+private:
+	List<BatchItem> items;
+
+	List<uint64> keys;
+	List<uint32> order;
+	List<uint64> tempKeys;
+	List<uint32> tempOrder;
+
+	List<RenderBatch> batches;
+	uint32 numInstances;
+
+	//Distinct pointers this frame, the index is the id
+	PointerTable shaders;
+	PointerTable materials;
+	PointerTable meshes;
+
+	static uint64 GetID(PointerTable& table, const void* item, uint32 bits);
+	static uint64 GetDepth(const vec3& position, const vec3& viewPosition);
+
+	void BuildBatches();
+
+public:
+	BatchQueue();
+
+	void Clear();
+	void Push(const BatchItem& item);
+
+	//Sorts and builds the batches
+	void Sort(const vec3& viewPosition);
+
+	//Index in submit order of the item at index in sorted order
+	inline uint32 GetOrder(uint_t index) const { return order.Get(index); }
+	inline const BatchItem& operator[](uint_t index) { return items[order[index]]; }
+	inline uint64 GetKey(uint_t index) const { return keys.Get(index); }
+
+	inline uint_t GetSize() const { return items.GetSize(); }
+
+	inline const List<RenderBatch>& GetBatches() const { return batches; }
+	inline uint32 GetNumInstances() const { return numInstances; }
+};
+
+}
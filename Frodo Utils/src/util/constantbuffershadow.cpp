@@ -0,0 +1,95 @@
+#include "constantbuffershadow.h"
+#include <core/log.h>
+#include <string.h>
+
+namespace FD {
+
+ConstantBufferShadow::ConstantBufferShadow(uint32 size) : data(nullptr), size(0) {
+	Resize(size);
+}
+
+ConstantBufferShadow::~ConstantBufferShadow() {
+	Memory::Free(data);
+}
+
+void ConstantBufferShadow::Resize(uint32 size) {
+	Memory::Free(data);
+
+	this->size = size;
+	data = size == 0 ? nullptr : (byte*)Memory::Allocate(size, FD_MEMTAG_GENERAL);
+
+	if (data) memset(data, 0, size);
+
+	dirtyBegin = 0;
+	dirtyEnd = 0;
+	lastSource = nullptr;
+	lastVersion = 0;
+	set = false;
+}
+
+bool ConstantBufferShadow::Update(const void* source, uint32 version) {
+	if (version != 0 && set && source == lastSource && version == lastVersion) return false;
+
+	bool changed = Update(0, source, size);
+
+	lastSource = source;
+	lastVersion = version;
+
+	return changed;
+}
+
+bool ConstantBufferShadow::Update(uint32 offset, const void* source, uint32 size) {
+	FD_ASSERT_MSG(offset + size > this->size, "[ConstantBufferShadow] Update outside of the buffer");
+
+	if (size == 0) return false;
+
+	const byte* src = (const byte*)source - offset;
+	uint32 end = offset + size;
+
+	//Register aligned, clipped to the updated part
+	uint32 first = offset - offset % FD_CONSTANT_BUFFER_REGISTER_SIZE;
+	uint32 last = end - 1 - (end - 1) % FD_CONSTANT_BUFFER_REGISTER_SIZE;
+
+	if (set) {
+		while (first <= last) {
+			uint32 begin = first < offset ? offset : first;
+			uint32 stop = first + FD_CONSTANT_BUFFER_REGISTER_SIZE < end ? first + FD_CONSTANT_BUFFER_REGISTER_SIZE : end;
+
+			if (memcmp(data + begin, src + begin, stop - begin) != 0) break;
+
+			first += FD_CONSTANT_BUFFER_REGISTER_SIZE;
+		}
+
+		if (first > last) return false;
+
+		while (last > first) {
+			uint32 begin = last < offset ? offset : last;
+			uint32 stop = last + FD_CONSTANT_BUFFER_REGISTER_SIZE < end ? last + FD_CONSTANT_BUFFER_REGISTER_SIZE : end;
+
+			if (memcmp(data + begin, src + begin, stop - begin) != 0) break;
+
+			last -= FD_CONSTANT_BUFFER_REGISTER_SIZE;
+		}
+	}
+
+	uint32 begin = first < offset ? offset : first;
+	uint32 stop = last + FD_CONSTANT_BUFFER_REGISTER_SIZE < end ? last + FD_CONSTANT_BUFFER_REGISTER_SIZE : end;
+
+	memcpy(data + begin, src + begin, stop - begin);
+
+	if (dirtyBegin == dirtyEnd) {
+		dirtyBegin = begin;
+		dirtyEnd = stop;
+	} else {
+		if (begin < dirtyBegin) dirtyBegin = begin;
+		if (stop > dirtyEnd) dirtyEnd = stop;
+	}
+
+	//The version shortcut only holds for whole updates
+	lastSource = nullptr;
+	set = true;
+
+	return true;
+}
+
+}
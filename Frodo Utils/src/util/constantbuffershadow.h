@@ -0,0 +1,66 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <core/memory.h>
+
+//Constant buffers are made of 16 byte registers, changes are tracked per register
+#define FD_CONSTANT_BUFFER_REGISTER_SIZE 16
+
+namespace FD {
+
+/*
+ CPU side copy of a constant buffer. Update compares the new contents with the copy a
+ register at a time, copies only the registers that differ and grows the dirty range over
+ them, so setting the same contents again is a compare and no upload. Owners that already
+ know when their data changes pass a version with it, the same pointer and version skip the
+ compare too. Version 0 always compares.
+
+ The dirty range is cleared by whoever uploads the copy.
+*/
+class FDUAPI ConstantBufferShadow {
+private:
+	byte* data;
+	uint32 size;
+
+	//Bytes, dirtyBegin == dirtyEnd when nothing changed since the last upload
+	uint32 dirtyBegin;
+	uint32 dirtyEnd;
+
+	const void* lastSource;
+	uint32 lastVersion;
+
+	//False until the first Update, the copy is all zeros before that
+	bool set;
+
+public:
+	ConstantBufferShadow(uint32 size = 0);
+	~ConstantBufferShadow();
+
+	ConstantBufferShadow(const ConstantBufferShadow& shadow) = delete;
+	ConstantBufferShadow& operator=(const ConstantBufferShadow& shadow) = delete;
+
+	//Clears the copy, the next Update always reports a change
+	void Resize(uint32 size);
+
+	//Returns true when the contents changed (or on the first call), source has to be GetSize() bytes
+	bool Update(const void* source, uint32 version = 0);
+	//Part of the buffer, offset and size in bytes
+	bool Update(uint32 offset, const void* source, uint32 size);
+
+	inline void ClearDirty() { dirtyBegin = dirtyEnd = 0; }
+
+	inline bool IsDirty() const { return dirtyBegin != dirtyEnd; }
+	inline bool IsSet() const { return set; }
+
+	inline uint32 GetDirtyBegin() const { return dirtyBegin; }
+	inline uint32 GetDirtyEnd() const { return dirtyEnd; }
+
+	inline const byte* GetData() const { return data; }
+	inline uint32 GetSize() const { return size; }
+};
+
+}
@@ -1,13 +1,27 @@
 #include "fileutils.h"
 #include <stdio.h>
+#include <errno.h>
 #include <core/log.h>
 
+#ifdef _MSC_VER
+#include <direct.h>
+#define MKDIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MKDIR(path) mkdir(path, 0755)
+#endif
+
 #define FREAD(buff, size, file) fread(buff, size, 1, file)
 #define FWRITE(buff, size, file) fwrite(buff, size, 1, file)
 
 
+#ifdef _MSC_VER
 #define FTELL(file) _ftelli64(file)
 #define FSEEK(file, off, org) _fseeki64(file, off, org)
+#else
+#define FTELL(file) ftello(file)
+#define FSEEK(file, off, org) fseeko(file, off, org)
+#endif
 
 
 #define FSIZE(dst, file) FSEEK(file, 0, SEEK_END); \
@@ -27,17 +41,20 @@ String FDReadTextFile(const String& filename) {
 
 	FSIZE(uint_t length, file);
 
-	char* buff = new char[length + 1];
+	String result;
+
+	result.str = (char*)Memory::Allocate(length + 1, FD_MEMTAG_STRING);
+	result.length = length;
 
-	FREAD(buff, length, file);
+	FREAD(result.str, length, file);
 
-	buff[length] = '\0';
+	result.str[length] = '\0';
 	fclose(file);
 
-	return String(buff);
+	return result;
 }
 
-byte* FDReadBinaryFile(const String& filename, uint_t* fileSize) {
+byte* FDReadBinaryFile(const String& filename, uint_t* fileSize, FD_MEMTAG tag) {
 
 	FILE* file = fopen(*filename, "rb");
 
@@ -50,7 +67,7 @@ byte* FDReadBinaryFile(const String& filename, uint_t* fileSize) {
 
 	FSIZE(size, file);
 
-	byte* buff = new byte[size];
+	byte* buff = (byte*)Memory::Allocate(size, tag);
 
 	FREAD(buff, size, file);
 
@@ -101,4 +118,12 @@ uint_t FDWriteFile(FILE* file, const void* buffer, uint64 size, uint64* offset)
 	return FWRITE(buffer, size, file);
 }
 
+bool FDCreateDirectory(const String& path) {
+	if (MKDIR(*path) == 0 || errno == EEXIST) return true;
+
+	FD_WARNING("[FileUtils] Failed to create directory \"%s\"", *path);
+
+	return false;
+}
+
 }
\ No newline at end of file
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "string.h"
+#include <core/memory.h>
 #include <stdio.h>
 
 namespace FD {
 
 
 FDUAPI String FDReadTextFile(const String& filename);
-FDUAPI byte*  FDReadBinaryFile(const String& filename, uint_t* fileSize);
+//The returned buffer is released with Memory::Free
+FDUAPI byte*  FDReadBinaryFile(const String& filename, uint_t* fileSize, FD_MEMTAG tag = FD_MEMTAG_FILE);
 
 FDUAPI uint_t FDWriteFile(const String& filename, const void* buffer, uint64 size);
 FDUAPI uint_t FDWriteFile(const String& filename, const void* buffer, uint64 size, uint64 offset);
@@ -17,4 +19,7 @@ FDUAPI uint_t FDWriteFile(FILE* file, const void* buffer, uint64 size);
 FDUAPI uint_t FDWriteFile(FILE* file, const void* buffer, uint64 size, uint64 offset);
 FDUAPI uint_t FDWriteFile(FILE* file, const void* buffer, uint64 size, uint64* offset);
 
+//Only the last directory in the path is created, true when it exists afterwards
+FDUAPI bool FDCreateDirectory(const String& path);
+
 }
\ No newline at end of file
@@ -0,0 +1,910 @@
+#include "hlslreflection.h"
+#include <core/log.h>
+#include <string.h>
+
+namespace FD {
+
+enum FD_HLSL_TOKEN {
+	FD_HLSL_TOKEN_END,
+	FD_HLSL_TOKEN_IDENTIFIER,
+	FD_HLSL_TOKEN_NUMBER,
+	FD_HLSL_TOKEN_STRING,
+	FD_HLSL_TOKEN_SYMBOL
+};
+
+//Points into the source, nothing is copied until a name is stored
+struct HLSLToken {
+	FD_HLSL_TOKEN type;
+	const char* str;
+	uint32 length;
+	uint32 line;
+
+	inline bool Is(char symbol) const { return type == FD_HLSL_TOKEN_SYMBOL && *str == symbol; }
+	inline bool Is(const char* identifier) const { return type == FD_HLSL_TOKEN_IDENTIFIER && strncmp(str, identifier, length) == 0 && identifier[length] == 0; }
+	inline bool Is(const String& identifier) const { return type == FD_HLSL_TOKEN_IDENTIFIER && identifier.length == length && memcmp(str, identifier.str, length) == 0; }
+
+	inline String ToString() const { return String((char*)str, length); }
+};
+
+static inline bool IsAlpha(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static inline bool IsDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+//Reads digits until the first character that isn't one
+static uint32 ParseUint(const char* str, uint32 length) {
+	uint32 value = 0;
+
+	for (uint32 i = 0; i < length && IsDigit(str[i]); i++) value = value * 10 + (str[i] - '0');
+
+	return value;
+}
+
+static bool IsUint(const char* str, uint32 length) {
+	if (length == 0) return false;
+
+	for (uint32 i = 0; i < length; i++) {
+		if (!IsDigit(str[i])) return false;
+	}
+
+	return true;
+}
+
+class HLSLLexer {
+private:
+	const char* current;
+	const char* end;
+	uint32 line;
+	bool lineStart;
+
+	void SkipBlank() {
+		while (current < end) {
+			char c = *current;
+
+			if (c == '\n') {
+				line++;
+				lineStart = true;
+				current++;
+			} else if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+				current++;
+			} else if (c == '/' && current + 1 < end && current[1] == '/') {
+				while (current < end && *current != '\n') current++;
+			} else if (c == '/' && current + 1 < end && current[1] == '*') {
+				const char* close = current + 2;
+
+				while (close + 1 < end && !(close[0] == '*' && close[1] == '/')) {
+					if (*close == '\n') line++;
+					close++;
+				}
+
+				current = close + 1 < end ? close + 2 : end;
+			} else if (c == '#' && lineStart) {
+				//Preprocessor line, including lines continued with a backslash
+				while (current < end && *current != '\n') {
+					if (*current == '\\') {
+						const char* next = current + 1;
+
+						if (next < end && *next == '\r') next++;
+
+						if (next < end && *next == '\n') {
+							current = next + 1;
+							line++;
+							continue;
+						}
+					}
+
+					current++;
+				}
+			} else {
+				break;
+			}
+		}
+	}
+
+public:
+	HLSLLexer(const char* source, uint_t length) : current(source), end(source + length), line(1), lineStart(true) {}
+
+	HLSLToken Next() {
+		SkipBlank();
+
+		HLSLToken token;
+
+		token.str = current;
+		token.line = line;
+
+		if (current >= end) {
+			token.type = FD_HLSL_TOKEN_END;
+			token.length = 0;
+			return token;
+		}
+
+		lineStart = false;
+
+		char c = *current;
+
+		if (IsAlpha(c)) {
+			while (current < end && (IsAlpha(*current) || IsDigit(*current))) current++;
+
+			token.type = FD_HLSL_TOKEN_IDENTIFIER;
+		} else if (IsDigit(c) || (c == '.' && current + 1 < end && IsDigit(current[1]))) {
+			while (current < end) {
+				char d = *current;
+
+				if (IsAlpha(d) || IsDigit(d) || d == '.') {
+					current++;
+				} else if ((d == '+' || d == '-') && (current[-1] == 'e' || current[-1] == 'E')) {
+					current++;
+				} else {
+					break;
+				}
+			}
+
+			token.type = FD_HLSL_TOKEN_NUMBER;
+		} else if (c == '"') {
+			current++;
+
+			while (current < end && *current != '"') {
+				if (*current == '\\' && current + 1 < end) current++;
+				if (*current == '\n') line++;
+
+				current++;
+			}
+
+			if (current < end) current++;
+
+			token.type = FD_HLSL_TOKEN_STRING;
+		} else {
+			current++;
+
+			token.type = FD_HLSL_TOKEN_SYMBOL;
+		}
+
+		token.length = (uint32)(current - token.str);
+
+		return token;
+	}
+};
+
+struct HLSLScalarType {
+	const char* name;
+	FD_HLSL_TYPE type;
+};
+
+//half and the min precision types are 32 bits in a cbuffer
+static const HLSLScalarType scalarTypes[] = {
+	{ "float", FD_HLSL_TYPE_FLOAT },
+	{ "int", FD_HLSL_TYPE_INT },
+	{ "uint", FD_HLSL_TYPE_UINT },
+	{ "bool", FD_HLSL_TYPE_BOOL },
+	{ "half", FD_HLSL_TYPE_FLOAT },
+	{ "double", FD_HLSL_TYPE_DOUBLE },
+	{ "dword", FD_HLSL_TYPE_UINT },
+	{ "min16float", FD_HLSL_TYPE_FLOAT },
+	{ "min10float", FD_HLSL_TYPE_FLOAT },
+	{ "min16int", FD_HLSL_TYPE_INT },
+	{ "min12int", FD_HLSL_TYPE_INT },
+	{ "min16uint", FD_HLSL_TYPE_UINT }
+};
+
+struct HLSLResourceType {
+	const char* name;
+	FD_HLSL_RESOURCE_TYPE type;
+	bool readWrite;
+};
+
+static const HLSLResourceType resourceTypes[] = {
+	{ "Texture1D", FD_HLSL_RESOURCE_TYPE_TEXTURE1D, false },
+	{ "Texture2D", FD_HLSL_RESOURCE_TYPE_TEXTURE2D, false },
+	{ "Texture3D", FD_HLSL_RESOURCE_TYPE_TEXTURE3D, false },
+	{ "TextureCube", FD_HLSL_RESOURCE_TYPE_TEXTURECUBE, false },
+	{ "Texture1DArray", FD_HLSL_RESOURCE_TYPE_TEXTURE1D_ARRAY, false },
+	{ "Texture2DArray", FD_HLSL_RESOURCE_TYPE_TEXTURE2D_ARRAY, false },
+	{ "TextureCubeArray", FD_HLSL_RESOURCE_TYPE_TEXTURECUBE_ARRAY, false },
+	{ "Texture2DMS", FD_HLSL_RESOURCE_TYPE_TEXTURE2DMS, false },
+	{ "Texture2DMSArray", FD_HLSL_RESOURCE_TYPE_TEXTURE2DMS_ARRAY, false },
+	{ "Buffer", FD_HLSL_RESOURCE_TYPE_BUFFER, false },
+	{ "StructuredBuffer", FD_HLSL_RESOURCE_TYPE_STRUCTURED_BUFFER, false },
+	{ "ByteAddressBuffer", FD_HLSL_RESOURCE_TYPE_BYTEADDRESS_BUFFER, false },
+	{ "RWTexture1D", FD_HLSL_RESOURCE_TYPE_TEXTURE1D, true },
+	{ "RWTexture2D", FD_HLSL_RESOURCE_TYPE_TEXTURE2D, true },
+	{ "RWTexture3D", FD_HLSL_RESOURCE_TYPE_TEXTURE3D, true },
+	{ "RWTexture1DArray", FD_HLSL_RESOURCE_TYPE_TEXTURE1D_ARRAY, true },
+	{ "RWTexture2DArray", FD_HLSL_RESOURCE_TYPE_TEXTURE2D_ARRAY, true },
+	{ "RWBuffer", FD_HLSL_RESOURCE_TYPE_BUFFER, true },
+	{ "RWStructuredBuffer", FD_HLSL_RESOURCE_TYPE_STRUCTURED_BUFFER, true },
+	{ "RWByteAddressBuffer", FD_HLSL_RESOURCE_TYPE_BYTEADDRESS_BUFFER, true },
+	{ "AppendStructuredBuffer", FD_HLSL_RESOURCE_TYPE_STRUCTURED_BUFFER, true },
+	{ "ConsumeStructuredBuffer", FD_HLSL_RESOURCE_TYPE_STRUCTURED_BUFFER, true },
+	{ "SamplerState", FD_HLSL_RESOURCE_TYPE_SAMPLER, false },
+	{ "sampler", FD_HLSL_RESOURCE_TYPE_SAMPLER, false },
+	{ "SamplerComparisonState", FD_HLSL_RESOURCE_TYPE_SAMPLER_COMPARISON, false }
+};
+
+//Keywords in front of a member that don't change its layout
+static const char* memberModifiers[] = {
+	"const", "uniform", "volatile", "precise", "linear", "centroid", "nointerpolation",
+	"noperspective", "sample", "snorm", "unorm", "in", "out", "inout", "extern", "shared"
+};
+
+class HLSLParser {
+private:
+	HLSLReflection& reflection;
+	HLSLLexer lexer;
+	HLSLToken token;
+	bool error;
+
+	inline void Advance() { token = lexer.Next(); }
+
+	inline bool Accept(char symbol) {
+		if (!token.Is(symbol)) return false;
+
+		Advance();
+		return true;
+	}
+
+	void Error(const char* expected) {
+		if (!error) FD_WARNING("[HLSLReflection] Line %u: expected %s, found \"%.*s\"", token.line, expected, (int32)token.length, token.str);
+
+		error = true;
+	}
+
+	bool Expect(char symbol) {
+		if (Accept(symbol)) return true;
+
+		char expected[4] = { '\'', symbol, '\'', 0 };
+
+		Error(expected);
+		return false;
+	}
+
+	uint32 FindStruct() const {
+		const List<HLSLStruct*>& structs = reflection.structs;
+
+		for (uint_t i = 0; i < structs.GetSize(); i++) {
+			if (token.Is(structs.Get(i)->name)) return (uint32)i;
+		}
+
+		return (uint32)-1;
+	}
+
+	const HLSLResourceType* FindResourceType() const {
+		if (token.type != FD_HLSL_TOKEN_IDENTIFIER) return nullptr;
+
+		for (uint_t i = 0; i < sizeof(resourceTypes) / sizeof(HLSLResourceType); i++) {
+			if (token.Is(resourceTypes[i].name)) return &resourceTypes[i];
+		}
+
+		return nullptr;
+	}
+
+	bool IsModifier() const {
+		for (uint_t i = 0; i < sizeof(memberModifiers) / sizeof(const char*); i++) {
+			if (token.Is(memberModifiers[i])) return true;
+		}
+
+		return false;
+	}
+
+	//Stops on ',' or ';' outside of brackets without consuming it
+	void SkipInitializer() {
+		uint32 depth = 0;
+
+		while (token.type != FD_HLSL_TOKEN_END) {
+			if (depth == 0 && (token.Is(',') || token.Is(';'))) return;
+
+			if (token.Is('(') || token.Is('[') || token.Is('{')) {
+				depth++;
+			} else if ((token.Is(')') || token.Is(']') || token.Is('}')) && depth) {
+				depth--;
+			}
+
+			Advance();
+		}
+	}
+
+	//Anything that isn't reflected: functions, globals, typedefs
+	void SkipDeclaration() {
+		uint32 depth = 0;
+
+		while (token.type != FD_HLSL_TOKEN_END) {
+			if (token.Is('(') || token.Is('[') || token.Is('{')) {
+				depth++;
+			} else if (token.Is(')') || token.Is(']')) {
+				if (depth) depth--;
+			} else if (token.Is('}')) {
+				if (depth) depth--;
+
+				if (depth == 0) {
+					Advance();
+					Accept(';');
+					return;
+				}
+			} else if (token.Is(';') && depth == 0) {
+				Advance();
+				return;
+			}
+
+			Advance();
+		}
+	}
+
+	void SkipBlock() {
+		uint32 depth = 0;
+
+		do {
+			if (token.Is('{')) {
+				depth++;
+			} else if (token.Is('}')) {
+				depth--;
+			}
+
+			Advance();
+		} while (depth && token.type != FD_HLSL_TOKEN_END);
+	}
+
+	uint32 ParseArraySize() {
+		uint32 size = 0;
+
+		while (Accept('[')) {
+			uint32 num = 0;
+
+			if (token.type == FD_HLSL_TOKEN_NUMBER) {
+				num = ParseUint(token.str, token.length);
+				Advance();
+			} else if (!token.Is(']')) {
+				FD_WARNING("[HLSLReflection] Line %u: array size \"%.*s\" isn't a number, using 1", token.line, (int32)token.length, token.str);
+
+				while (token.type != FD_HLSL_TOKEN_END && !token.Is(']')) Advance();
+
+				num = 1;
+			}
+
+			if (!Expect(']')) return 0;
+
+			size = size ? size * num : num;
+		}
+
+		return size;
+	}
+
+	//register([profile,] t0[, space1])
+	void ParseRegister(int32* semRegister, uint32* space) {
+		Advance();
+
+		if (!Expect('(')) return;
+
+		uint32 depth = 0;
+
+		while (depth || !token.Is(')')) {
+			if (token.type == FD_HLSL_TOKEN_END) {
+				Error("')'");
+				return;
+			}
+
+			if (token.Is('(')) {
+				depth++;
+			} else if (token.Is(')')) {
+				depth--;
+			} else if (depth == 0 && token.type == FD_HLSL_TOKEN_IDENTIFIER) {
+				if (token.length > 5 && strncmp(token.str, "space", 5) == 0 && IsUint(token.str + 5, token.length - 5)) {
+					*space = ParseUint(token.str + 5, token.length - 5);
+				} else if (IsUint(token.str + 1, token.length - 1)) {
+					*semRegister = (int32)ParseUint(token.str + 1, token.length - 1);
+				}
+			}
+
+			Advance();
+		}
+
+		Advance();
+	}
+
+	//packoffset(c1.y), returns the offset in bytes
+	uint32 ParsePackOffset() {
+		Advance();
+
+		if (!Expect('(')) return (uint32)-1;
+
+		if (token.type != FD_HLSL_TOKEN_IDENTIFIER || token.str[0] != 'c' || !IsUint(token.str + 1, token.length - 1)) {
+			Error("packoffset register");
+			return (uint32)-1;
+		}
+
+		uint32 offset = ParseUint(token.str + 1, token.length - 1) * 16;
+
+		Advance();
+
+		if (Accept('.')) {
+			if (token.type != FD_HLSL_TOKEN_IDENTIFIER || token.length != 1) {
+				Error("packoffset component");
+				return (uint32)-1;
+			}
+
+			switch (token.str[0]) {
+				case 'x': case 'r': break;
+				case 'y': case 'g': offset += 4; break;
+				case 'z': case 'b': offset += 8; break;
+				case 'w': case 'a': offset += 12; break;
+				default:
+					Error("packoffset component");
+					return (uint32)-1;
+			}
+
+			Advance();
+		}
+
+		Expect(')');
+
+		return offset;
+	}
+
+	//float, float3, float4x4, min16uint2...
+	bool ParseScalarName(HLSLVariable* var) {
+		for (uint_t i = 0; i < sizeof(scalarTypes) / sizeof(HLSLScalarType); i++) {
+			uint32 length = (uint32)strlen(scalarTypes[i].name);
+
+			if (token.length < length || strncmp(token.str, scalarTypes[i].name, length) != 0) continue;
+
+			const char* suffix = token.str + length;
+			uint32 suffixLength = token.length - length;
+
+			if (suffixLength == 0) {
+				var->rows = 1;
+				var->columns = 1;
+			} else if (suffixLength == 1 && suffix[0] >= '1' && suffix[0] <= '4') {
+				var->rows = 1;
+				var->columns = suffix[0] - '0';
+			} else if (suffixLength == 3 && suffix[0] >= '1' && suffix[0] <= '4' && suffix[1] == 'x' && suffix[2] >= '1' && suffix[2] <= '4') {
+				var->rows = suffix[0] - '0';
+				var->columns = suffix[2] - '0';
+			} else {
+				continue;
+			}
+
+			var->type = scalarTypes[i].type;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	//vector<float, 3> and matrix<float, 4, 4>, without arguments they are float4 and float4x4
+	bool ParseTemplateType(HLSLVariable* var, bool matrix) {
+		Advance();
+
+		var->type = FD_HLSL_TYPE_FLOAT;
+		var->rows = matrix ? 4 : 1;
+		var->columns = 4;
+
+		if (!Accept('<')) return true;
+
+		HLSLVariable scalar;
+
+		if (!ParseScalarName(&scalar) || scalar.rows != 1 || scalar.columns != 1) {
+			Error("scalar type");
+			return false;
+		}
+
+		var->type = scalar.type;
+
+		Advance();
+
+		if (!Expect(',')) return false;
+
+		if (matrix) {
+			if (token.type != FD_HLSL_TOKEN_NUMBER) {
+				Error("matrix rows");
+				return false;
+			}
+
+			var->rows = ParseUint(token.str, token.length);
+
+			Advance();
+
+			if (!Expect(',')) return false;
+		}
+
+		if (token.type != FD_HLSL_TOKEN_NUMBER) {
+			Error("vector size");
+			return false;
+		}
+
+		var->columns = ParseUint(token.str, token.length);
+
+		Advance();
+
+		return Expect('>');
+	}
+
+	bool ParseType(HLSLVariable* var) {
+		if (token.type != FD_HLSL_TOKEN_IDENTIFIER) {
+			Error("type");
+			return false;
+		}
+
+		var->structIndex = (uint32)-1;
+
+		if (token.Is("vector")) return ParseTemplateType(var, false);
+		if (token.Is("matrix")) return ParseTemplateType(var, true);
+
+		if (!ParseScalarName(var)) {
+			var->structIndex = FindStruct();
+
+			if (var->structIndex == (uint32)-1) {
+				Error("known type");
+				return false;
+			}
+
+			var->type = FD_HLSL_TYPE_STRUCT;
+			var->rows = 1;
+			var->columns = 1;
+		}
+
+		Advance();
+
+		return true;
+	}
+
+	//type name[N] : semantic, name2; also nested struct definitions
+	bool ParseMember(List<HLSLVariable*>& members, List<uint32>& packOffsets) {
+		HLSLVariable proto;
+
+		proto.rowMajor = false;
+
+		bool isStatic = false;
+
+		while (token.type == FD_HLSL_TOKEN_IDENTIFIER) {
+			if (token.Is("row_major")) {
+				proto.rowMajor = true;
+			} else if (token.Is("column_major")) {
+				proto.rowMajor = false;
+			} else if (token.Is("static")) {
+				isStatic = true;
+			} else if (!IsModifier()) {
+				break;
+			}
+
+			Advance();
+		}
+
+		HLSLToken typeToken = token;
+
+		if (token.Is("struct")) {
+			proto.structIndex = ParseStruct();
+
+			if (error) return false;
+
+			if (proto.structIndex == (uint32)-1) {
+				Error("struct");
+				return false;
+			}
+
+			const String& name = reflection.structs[proto.structIndex]->name;
+
+			typeToken.str = name.str;
+			typeToken.length = (uint32)name.length;
+			proto.type = FD_HLSL_TYPE_STRUCT;
+			proto.rows = 1;
+			proto.columns = 1;
+		} else if (!ParseType(&proto)) {
+			return false;
+		}
+
+		do {
+			if (token.type != FD_HLSL_TOKEN_IDENTIFIER) {
+				Error("member name");
+				return false;
+			}
+
+			//Copying proto would also copy its empty Strings, which allocates
+			HLSLVariable* var = new HLSLVariable;
+
+			var->name = token.ToString();
+			var->typeName = typeToken.ToString();
+			var->type = proto.type;
+			var->rows = proto.rows;
+			var->columns = proto.columns;
+			var->rowMajor = proto.rowMajor;
+			var->structIndex = proto.structIndex;
+
+			Advance();
+
+			var->arraySize = ParseArraySize();
+
+			uint32 packOffset = (uint32)-1;
+
+			while (!error && Accept(':')) {
+				if (token.Is("packoffset")) {
+					packOffset = ParsePackOffset();
+				} else if (token.Is("register")) {
+					int32 semRegister;
+					uint32 space;
+
+					ParseRegister(&semRegister, &space);
+				} else if (token.type == FD_HLSL_TOKEN_IDENTIFIER) {
+					var->semantic = token.ToString();
+					Advance();
+				} else {
+					Error("semantic");
+				}
+			}
+
+			if (Accept('=')) SkipInitializer();
+
+			if (error || isStatic) {
+				delete var;
+			} else {
+				members.Push_back(var);
+				packOffsets.Push_back(packOffset);
+			}
+
+			if (error) return false;
+		} while (Accept(','));
+
+		return Expect(';');
+	}
+
+	//Members up to and including the closing brace
+	bool ParseMembers(List<HLSLVariable*>& members, List<uint32>& packOffsets) {
+		while (!token.Is('}')) {
+			if (token.type == FD_HLSL_TOKEN_END) {
+				Error("'}'");
+				return false;
+			}
+
+			if (!ParseMember(members, packOffsets)) return false;
+		}
+
+		Advance();
+
+		return true;
+	}
+
+	//struct Name { ... } or a reference to a declared struct, returns the index or -1
+	uint32 ParseStruct() {
+		Advance();
+
+		String name;
+
+		if (token.type == FD_HLSL_TOKEN_IDENTIFIER) {
+			uint32 index = FindStruct();
+
+			name = token.ToString();
+			Advance();
+
+			if (!token.Is('{')) return index;
+		}
+
+		if (!Expect('{')) return (uint32)-1;
+
+		HLSLStruct* def = new HLSLStruct;
+		List<uint32> packOffsets(8, 8);
+
+		def->name = name;
+
+		if (!ParseMembers(def->members, packOffsets)) {
+			delete def;
+			return (uint32)-1;
+		}
+
+		def->size = reflection.Pack(def->members, packOffsets);
+
+		reflection.structs.Push_back(def);
+
+		return (uint32)reflection.structs.GetSize() - 1;
+	}
+
+	void ParseConstantBuffer() {
+		Advance();
+
+		HLSLConstantBuffer* cbuffer = new HLSLConstantBuffer;
+
+		if (token.type == FD_HLSL_TOKEN_IDENTIFIER) {
+			cbuffer->name = token.ToString();
+			Advance();
+		}
+
+		while (Accept(':')) {
+			if (!token.Is("register")) {
+				Error("register");
+				break;
+			}
+
+			ParseRegister(&cbuffer->semRegister, &cbuffer->space);
+		}
+
+		List<uint32> packOffsets(8, 8);
+
+		if (error || !Expect('{') || !ParseMembers(cbuffer->members, packOffsets)) {
+			delete cbuffer;
+			return;
+		}
+
+		Accept(';');
+
+		cbuffer->size = (reflection.Pack(cbuffer->members, packOffsets) + 15) & ~15;
+
+		reflection.cbuffers.Push_back(cbuffer);
+	}
+
+	void ParseResource(const HLSLResourceType* type) {
+		Advance();
+
+		//Texture2D<float4>, the element type doesn't change the binding
+		if (Accept('<')) {
+			uint32 depth = 1;
+
+			while (depth && token.type != FD_HLSL_TOKEN_END && !token.Is(';')) {
+				if (token.Is('<')) depth++;
+				if (token.Is('>')) depth--;
+
+				Advance();
+			}
+		}
+
+		do {
+			if (token.type != FD_HLSL_TOKEN_IDENTIFIER) {
+				Error("resource name");
+				return;
+			}
+
+			HLSLResource resource;
+
+			resource.name = token.ToString();
+			resource.type = type->type;
+			resource.readWrite = type->readWrite;
+			resource.semRegister = -1;
+			resource.space = 0;
+
+			Advance();
+
+			resource.arraySize = ParseArraySize();
+
+			if (resource.arraySize == 0) resource.arraySize = 1;
+
+			while (!error && Accept(':')) {
+				if (token.Is("register")) {
+					ParseRegister(&resource.semRegister, &resource.space);
+				} else {
+					Advance();
+				}
+			}
+
+			bool stateBlock = token.Is('{');
+
+			if (stateBlock) SkipBlock();
+
+			if (Accept('=')) SkipInitializer();
+
+			if (error) return;
+
+			if (!stateBlock) {
+				bool sampler = type->type == FD_HLSL_RESOURCE_TYPE_SAMPLER || type->type == FD_HLSL_RESOURCE_TYPE_SAMPLER_COMPARISON;
+
+				(sampler ? reflection.samplers : reflection.textures).Push_back(new HLSLResource(resource));
+			}
+		} while (Accept(','));
+
+		Expect(';');
+	}
+
+public:
+	HLSLParser(HLSLReflection& reflection, const char* source, uint_t length) : reflection(reflection), lexer(source, length), error(false) {}
+
+	bool Parse() {
+		Advance();
+
+		while (token.type != FD_HLSL_TOKEN_END && !error) {
+			const HLSLResourceType* resourceType;
+
+			if (token.Is("uniform") || token.Is("globallycoherent")) {
+				Advance();
+			} else if (token.Is("struct")) {
+				ParseStruct();
+
+				//struct Name { ... } variable; declares a global which isn't reflected
+				if (!error && !Accept(';')) SkipDeclaration();
+			} else if (token.Is("cbuffer") || token.Is("tbuffer")) {
+				ParseConstantBuffer();
+			} else if ((resourceType = FindResourceType()) != nullptr) {
+				ParseResource(resourceType);
+			} else {
+				SkipDeclaration();
+			}
+		}
+
+		return !error;
+	}
+};
+
+uint32 HLSLReflection::Pack(List<HLSLVariable*>& members, const List<uint32>& packOffsets) const {
+	uint32 offset = 0;
+	uint32 end = 0;
+
+	for (uint_t i = 0; i < members.GetSize(); i++) {
+		HLSLVariable* var = members[i];
+
+		uint32 scalarSize = var->type == FD_HLSL_TYPE_DOUBLE ? 8 : 4;
+		uint32 elementSize;
+		bool newRow = var->arraySize > 0;
+
+		if (var->type == FD_HLSL_TYPE_STRUCT) {
+			elementSize = structs.Get(var->structIndex)->size;
+			newRow = true;
+		} else if (var->rows > 1) {
+			//Every column takes a 16 byte register, every row when it's row_major
+			uint32 registers = var->rowMajor ? var->rows : var->columns;
+			uint32 components = var->rowMajor ? var->columns : var->rows;
+
+			elementSize = 16 * (registers - 1) + components * scalarSize;
+			newRow = true;
+		} else {
+			elementSize = var->columns * scalarSize;
+		}
+
+		var->stride = var->arraySize ? (elementSize + 15) & ~15 : elementSize;
+		var->size = var->arraySize ? var->stride * (var->arraySize - 1) + elementSize : elementSize;
+
+		if (packOffsets.Get(i) != (uint32)-1) {
+			offset = packOffsets.Get(i);
+		} else {
+			offset = (offset + scalarSize - 1) & ~(scalarSize - 1);
+
+			if (newRow || (offset & 15) + var->size > 16) offset = (offset + 15) & ~15;
+		}
+
+		var->offset = offset;
+
+		offset += var->size;
+
+		if (offset > end) end = offset;
+	}
+
+	return end;
+}
+
+bool HLSLReflection::Parse(const String& source) {
+	return Parse(source.str, source.length);
+}
+
+bool HLSLReflection::Parse(const char* source, uint_t length) {
+	if (!source) return true;
+
+	HLSLParser parser(*this, source, length);
+
+	return parser.Parse();
+}
+
+void HLSLReflection::Clear() {
+	structs.Free();
+	cbuffers.Free();
+	textures.Free();
+	samplers.Free();
+
+	structs.Resize(0);
+	cbuffers.Resize(0);
+	textures.Resize(0);
+	samplers.Resize(0);
+}
+
+const HLSLStruct* HLSLReflection::GetStruct(const String& name) const {
+	for (uint_t i = 0; i < structs.GetSize(); i++) {
+		if (structs.Get(i)->name == name) return structs.Get(i);
+	}
+
+	return nullptr;
+}
+
+const HLSLConstantBuffer* HLSLReflection::GetConstantBuffer(const String& name) const {
+	for (uint_t i = 0; i < cbuffers.GetSize(); i++) {
+		if (cbuffers.Get(i)->name == name) return cbuffers.Get(i);
+	}
+
+	return nullptr;
+}
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/list.h>
+#include <util/string.h>
+
+namespace FD {
+
+enum FD_HLSL_TYPE {
+	FD_HLSL_TYPE_UNKNOWN,
+	FD_HLSL_TYPE_BOOL,
+	FD_HLSL_TYPE_INT,
+	FD_HLSL_TYPE_UINT,
+	FD_HLSL_TYPE_FLOAT,
+	FD_HLSL_TYPE_DOUBLE,
+	FD_HLSL_TYPE_STRUCT
+};
+
+enum FD_HLSL_RESOURCE_TYPE {
+	FD_HLSL_RESOURCE_TYPE_UNKNOWN,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE1D,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE2D,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE3D,
+	FD_HLSL_RESOURCE_TYPE_TEXTURECUBE,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE1D_ARRAY,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE2D_ARRAY,
+	FD_HLSL_RESOURCE_TYPE_TEXTURECUBE_ARRAY,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE2DMS,
+	FD_HLSL_RESOURCE_TYPE_TEXTURE2DMS_ARRAY,
+	FD_HLSL_RESOURCE_TYPE_BUFFER,
+	FD_HLSL_RESOURCE_TYPE_STRUCTURED_BUFFER,
+	FD_HLSL_RESOURCE_TYPE_BYTEADDRESS_BUFFER,
+	FD_HLSL_RESOURCE_TYPE_SAMPLER,
+	FD_HLSL_RESOURCE_TYPE_SAMPLER_COMPARISON
+};
+
+//A struct or cbuffer member
+struct HLSLVariable {
+	String name;
+	String typeName;
+	String semantic;
+
+	FD_HLSL_TYPE type;
+
+	//1x1 for scalars, 1xN for vectors
+	uint32 rows;
+	uint32 columns;
+	bool rowMajor;
+
+	//0 when it isn't an array, multi dimensional arrays are flattened
+	uint32 arraySize;
+
+	//Index in HLSLReflection::GetStructs when type is FD_HLSL_TYPE_STRUCT
+	uint32 structIndex;
+
+	//Bytes from the start of the struct or cbuffer with the cbuffer packing rules
+	uint32 offset;
+	//All elements including the padding between them
+	uint32 size;
+	//Distance between array elements, same as size when it isn't an array
+	uint32 stride;
+};
+
+struct HLSLStruct {
+	String name;
+	List<HLSLVariable*> members;
+
+	//Not rounded up, a struct in a cbuffer lets the next member start right after it
+	uint32 size;
+
+	HLSLStruct() : members(8, 8), size(0) {}
+	~HLSLStruct() { members.Free(); }
+};
+
+struct HLSLConstantBuffer {
+	String name;
+	List<HLSLVariable*> members;
+
+	//-1 without a register
+	int32 semRegister;
+	uint32 space;
+
+	//Rounded up to 16 bytes
+	uint32 size;
+
+	HLSLConstantBuffer() : members(8, 8), semRegister(-1), space(0), size(0) {}
+	~HLSLConstantBuffer() { members.Free(); }
+};
+
+struct HLSLResource {
+	String name;
+	FD_HLSL_RESOURCE_TYPE type;
+
+	//RW versions, bound to u registers
+	bool readWrite;
+
+	//-1 without a register
+	int32 semRegister;
+	uint32 space;
+
+	//1 when it isn't an array
+	uint32 arraySize;
+};
+
+/*
+ Structs, cbuffers, textures and samplers declared in an HLSL source. The source is tokenized
+ in one pass and the declarations are read by a small recursive descent parser, everything
+ else (functions, globals, preprocessor lines) is skipped.
+
+ Member offsets follow the cbuffer packing rules: a member doesn't cross a 16 byte boundary,
+ structs, arrays and matrices start on a new 16 byte row and array elements are 16 byte aligned.
+ packoffset overrides the offset. Matrices are column major unless declared row_major.
+ Samplers with an effect state block are skipped, the same as the old string based parser.
+*/
+class FDUAPI HLSLReflection {
+private:
+	friend class HLSLParser;
+	friend class ShaderLibrary;
+
+	List<HLSLStruct*> structs;
+	List<HLSLConstantBuffer*> cbuffers;
+	List<HLSLResource*> textures;
+	List<HLSLResource*> samplers;
+
+	//Computes offset, size and stride of every member and returns the unrounded size
+	uint32 Pack(List<HLSLVariable*>& members, const List<uint32>& packOffsets) const;
+
+public:
+	HLSLReflection() : structs(16, 16), cbuffers(16, 16), textures(16, 16), samplers(8, 8) {}
+	~HLSLReflection() { Clear(); }
+
+	HLSLReflection(const HLSLReflection& reflection) = delete;
+	HLSLReflection& operator=(const HLSLReflection& reflection) = delete;
+
+	//Adds the declarations in source, returns false on a syntax error.
+	//Whatever was read before the error is kept.
+	bool Parse(const String& source);
+	bool Parse(const char* source, uint_t length);
+	void Clear();
+
+	//nullptr when there is none with that name
+	const HLSLStruct* GetStruct(const String& name) const;
+	const HLSLConstantBuffer* GetConstantBuffer(const String& name) const;
+
+	inline const List<HLSLStruct*>& GetStructs() const { return structs; }
+	inline const List<HLSLConstantBuffer*>& GetConstantBuffers() const { return cbuffers; }
+	inline const List<HLSLResource*>& GetTextures() const { return textures; }
+	inline const List<HLSLResource*>& GetSamplers() const { return samplers; }
+};
+
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <fdu.h>
+#include <core/memory.h>
 #include <memory>
+#include <string.h>
 
 namespace FD {
 
@@ -11,6 +13,7 @@ private:
 	uint_t size;
 	uint_t allocated;
 	uint_t extraReserve;
+	FD_MEMTAG tag;
 
 public:
 	List() {
@@ -18,32 +21,37 @@ public:
 		size = 0;
 		allocated = 0;
 		extraReserve = 1;
+		tag = FD_MEMTAG_LIST;
 	}
 
-	List(uint_t reserve, uint_t extra_reserve = 1) {
-		data = new T[reserve];
+	List(uint_t reserve, uint_t extra_reserve = 1, FD_MEMTAG tag = FD_MEMTAG_LIST) {
+		data = Memory::NewArray<T>(reserve, tag);
 		size = 0;
 		allocated = reserve;
 		extraReserve = extra_reserve;
+		this->tag = tag;
 	}
 
 	List(const List<T>& list) {
 
-		data = new T[list.allocated];
+		data = Memory::NewArray<T>(list.allocated, list.tag);
 
 		size = list.size;
 		allocated = list.allocated;
+		extraReserve = list.extraReserve;
+		tag = list.tag;
 
-		memcpy(data, list.data, list.size * sizeof(T));
+		if (list.data) memcpy(data, list.data, list.size * sizeof(T));
 	}
 
 	List(List<T>&& list) {
 		data = nullptr;
+		extraReserve = list.extraReserve;
 		*this = std::move(list);
 	}
 
 	~List() {
-		delete[] data;
+		Memory::DeleteArray(data);
 	}
 
 	__forceinline T& operator[](uint_t index) {
@@ -56,24 +64,25 @@ public:
 
 	inline List<T>& operator=(const List<T>& list) {
 
-		delete[] data;
+		Memory::DeleteArray(data);
 
-		data = new T[list.allocated];
+		data = Memory::NewArray<T>(list.allocated, tag);
 
 		size = list.size;
 		allocated = list.allocated;
 
-		memcpy(data, list.data, list.size * sizeof(T));
+		if (list.data) memcpy(data, list.data, list.size * sizeof(T));
 
 		return *this;
 	}
 
 	__forceinline List<T>& operator=(List<T>&& list) {
 		if (this != &list) {
-			delete[] data;
+			Memory::DeleteArray(data);
 			data = list.data;
 			size = list.size;
 			allocated = list.allocated;
+			tag = list.tag;
 
 			list.data = nullptr;
 			list.size = 0;
@@ -115,10 +124,14 @@ public:
 
 		T* tmp = data;
 
-		data = new T[count];
-		memcpy(data, tmp, GetSizeInBytes());
+		data = Memory::NewArray<T>(count, tag);
 
-		delete[] tmp;
+		//memcpy from nullptr is undefined and lets gcc drop the null check in Free.
+		//The items were moved by the memcpy so the old array is freed without running destructors
+		if (tmp) {
+			memcpy(data, tmp, GetSizeInBytes());
+			Memory::Free(tmp);
+		}
 
 		allocated = count;
 	}
@@ -164,6 +177,8 @@ public:
 	}
 
 	inline void SetExtraReserve(uint_t extra) { this->extraReserve = extra; }
+	//Only affects allocations made after the call
+	inline void SetMemoryTag(FD_MEMTAG tag) { this->tag = tag; }
 
 	inline T* GetData() { return data; }
 	inline const uint_t GetSize() const { return size; }
@@ -172,6 +187,7 @@ public:
 	inline const uint_t GetAllocatedInBytes() const { return allocated * sizeof(T); }
 
 	inline const uint_t GetExtraReserve() const { return extraReserve; }
+	inline FD_MEMTAG GetMemoryTag() const { return tag; }
 };
 
 }
\ No newline at end of file
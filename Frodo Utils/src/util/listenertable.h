@@ -0,0 +1,91 @@
+#pragma once
+#include <fdu.h>
+#include <util/list.h>
+
+namespace FD {
+
+/*
+ Listeners grouped by the types they subscribe to, so a dispatcher only visits the listeners
+ of one type. T needs a uint32 GetEventMask() const where bit n subscribes to type n.
+ The per type lists are rebuilt on the next Dispatch after Add or MarkDirty.
+
+ Listeners can be added, removed or change their mask from inside Dispatch, also when the
+ dispatch is nested. Nothing is rebuilt until the outermost Dispatch has returned: removed
+ listeners are cleared from the lists right away and skipped, added ones get the next dispatch.
+ Single threaded.
+*/
+template<typename T, uint_t NUM_TYPES>
+class ListenerTable {
+private:
+	List<T*> listeners;
+	List<T*> types[NUM_TYPES];
+
+	bool dirty;
+	uint32 depth;
+
+	void Build() {
+		uint_t num = listeners.GetSize();
+
+		for (uint_t type = 0; type < NUM_TYPES; type++) {
+			List<T*>& table = types[type];
+			uint32 mask = 1u << type;
+
+			table.Resize(0);
+
+			for (uint_t i = 0; i < num; i++) {
+				if (listeners[i]->GetEventMask() & mask) table.Push_back(listeners[i]);
+			}
+		}
+
+		dirty = false;
+	}
+
+public:
+	ListenerTable() : dirty(false), depth(0) {}
+
+	void Add(T* listener) {
+		listeners.Push_back(listener);
+		dirty = true;
+	}
+
+	void Remove(T* listener) {
+		listeners.Remove(listener);
+
+		//Cleared instead of removed so a dispatch in progress doesn't skip the next listener
+		for (uint_t type = 0; type < NUM_TYPES; type++) {
+			List<T*>& table = types[type];
+			uint_t index = table.Find(listener);
+
+			if (index != (uint_t)-1) table[index] = nullptr;
+		}
+
+		dirty = true;
+	}
+
+	//Call when a listener changed its mask
+	inline void MarkDirty() { dirty = true; }
+
+	//Calls func(T*) for the listeners of type in the order they were added until it returns true
+	template<typename F>
+	void Dispatch(uint_t type, const F& func) {
+		if (dirty && depth == 0) Build();
+
+		List<T*>& table = types[type];
+		uint_t num = table.GetSize();
+
+		depth++;
+
+		for (uint_t i = 0; i < num; i++) {
+			T* listener = table[i];
+
+			if (listener && func(listener)) break;
+		}
+
+		depth--;
+	}
+
+	inline uint_t GetSize() const { return listeners.GetSize(); }
+	inline uint_t GetSize(uint_t type) const { return types[type].GetSize(); }
+};
+
+}
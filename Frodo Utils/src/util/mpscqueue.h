@@ -0,0 +1,86 @@
+#pragma once
+#include <fdu.h>
+#include <atomic>
+
+namespace FD {
+
+//Base for anything that goes through an MPSCQueue, a node can only be in one queue at a time
+struct MPSCNode {
+	std::atomic<MPSCNode*> next;
+
+	MPSCNode() : next(nullptr) {}
+	MPSCNode(const MPSCNode& node) : next(nullptr) {}
+	MPSCNode& operator=(const MPSCNode& node) { return *this; }
+};
+
+/*
+ Unbounded intrusive multi producer single consumer queue (Vyukov). Push is one atomic
+ exchange and never blocks or allocates, any thread can push. Only one thread may pop.
+ Nodes come out in the order their exchanges happened. Pop can return nullptr while a
+ producer is between its two stores even though the queue isn't empty, the node shows
+ up on a later Pop.
+*/
+template<typename T>
+class MPSCQueue {
+private:
+	alignas(64) std::atomic<MPSCNode*> head;
+	alignas(64) MPSCNode* tail;
+	MPSCNode stub;
+
+	inline void PushNode(MPSCNode* node) {
+		node->next.store(nullptr, std::memory_order_relaxed);
+
+		MPSCNode* prev = head.exchange(node, std::memory_order_acq_rel);
+
+		prev->next.store(node, std::memory_order_release);
+	}
+
+public:
+	MPSCQueue() : head(&stub), tail(&stub) {}
+
+	MPSCQueue(const MPSCQueue<T>& queue) = delete;
+	MPSCQueue<T>& operator=(const MPSCQueue<T>& queue) = delete;
+
+	inline void Push(T* item) {
+		PushNode(static_cast<MPSCNode*>(item));
+	}
+
+	inline T* Pop() {
+		MPSCNode* node = tail;
+		MPSCNode* next = node->next.load(std::memory_order_acquire);
+
+		if (node == &stub) {
+			if (!next) return nullptr;
+
+			tail = next;
+			node = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+
+		if (next) {
+			tail = next;
+			return static_cast<T*>(node);
+		}
+
+		//node is the last one, a producer may be linking a new node behind it
+		if (node != head.load(std::memory_order_acquire)) return nullptr;
+
+		PushNode(&stub);
+
+		next = node->next.load(std::memory_order_acquire);
+
+		if (next) {
+			tail = next;
+			return static_cast<T*>(node);
+		}
+
+		return nullptr;
+	}
+
+	//Only meaningful on the consumer thread
+	inline bool IsEmpty() const {
+		return tail == &stub && tail->next.load(std::memory_order_acquire) == nullptr;
+	}
+};
+
+}
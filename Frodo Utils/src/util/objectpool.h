@@ -0,0 +1,156 @@
+#pragma once
+#include <fdu.h>
+#include <core/memory.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+
+//Upper limit of chunks per pool, the pool holds at most chunkSize * FD_OBJECTPOOL_MAX_CHUNKS objects
+#define FD_OBJECTPOOL_MAX_CHUNKS 1024
+
+namespace FD {
+
+/*
+ Fixed-size object pool with a lock-free free list, Acquire/Release and New/Delete can be
+ called from any thread. Memory is allocated in chunks of chunkSize objects which are only
+ freed when the pool is destroyed, released objects are reused first.
+ Objects still alive when the pool is destroyed aren't destructed.
+ Chunks come from Memory::Allocate, T can't need more than 16 byte alignment.
+*/
+template<typename T>
+class ObjectPool {
+private:
+	struct Slot {
+		//First so a T* is also a Slot*
+		alignas(T) byte storage[sizeof(T)];
+		//Index + 1 of the next free slot, 0 ends the list
+		std::atomic<uint32> next;
+		uint32 index;
+	};
+
+	//Low 32 bits are the index + 1 of the first free slot, the high 32 bits count every change
+	//so a slot that is popped and pushed back between a load and the CAS isn't mistaken for the old head
+	std::atomic<uint64> head;
+
+	std::atomic<Slot*> chunks[FD_OBJECTPOOL_MAX_CHUNKS];
+	std::atomic<uint32> numChunks;
+	std::mutex growMutex;
+
+	uint32 chunkSize;
+	uint32 chunkShift;
+	FD_MEMTAG tag;
+
+	inline Slot* GetSlot(uint32 index) const {
+		return chunks[index >> chunkShift].load(std::memory_order_acquire) + (index & (chunkSize - 1));
+	}
+
+	inline void Push(Slot* first, Slot* last) {
+		uint64 old = head.load(std::memory_order_relaxed);
+		uint64 next;
+
+		do {
+			last->next.store((uint32)old, std::memory_order_relaxed);
+			next = ((old >> 32) + 1) << 32 | (first->index + 1);
+		} while (!head.compare_exchange_weak(old, next, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	inline Slot* Pop() {
+		uint64 old = head.load(std::memory_order_acquire);
+
+		while ((uint32)old) {
+			Slot* slot = GetSlot((uint32)old - 1);
+			uint64 next = ((old >> 32) + 1) << 32 | slot->next.load(std::memory_order_relaxed);
+
+			if (head.compare_exchange_weak(old, next, std::memory_order_acquire, std::memory_order_acquire)) return slot;
+		}
+
+		return nullptr;
+	}
+
+	bool Grow() {
+		std::lock_guard<std::mutex> lock(growMutex);
+
+		//Another thread may have grown the pool while this one waited
+		if ((uint32)head.load(std::memory_order_acquire)) return true;
+
+		uint32 chunk = numChunks.load(std::memory_order_relaxed);
+
+		if (chunk == FD_OBJECTPOOL_MAX_CHUNKS) return false;
+
+		Slot* slots = (Slot*)Memory::Allocate(sizeof(Slot) * chunkSize, tag);
+
+		if (!slots) return false;
+
+		for (uint32 i = 0; i < chunkSize; i++) {
+			new (&slots[i].next) std::atomic<uint32>(i + 1 < chunkSize ? chunk * chunkSize + i + 2 : 0);
+			slots[i].index = chunk * chunkSize + i;
+		}
+
+		chunks[chunk].store(slots, std::memory_order_release);
+		numChunks.store(chunk + 1, std::memory_order_release);
+
+		Push(slots, slots + chunkSize - 1);
+
+		return true;
+	}
+
+public:
+	//chunkSize is rounded up to a power of 2
+	ObjectPool(uint32 chunkSize = 256, FD_MEMTAG tag = FD_MEMTAG_GENERAL) : head(0), numChunks(0), chunkSize(1), chunkShift(0), tag(tag) {
+		while (this->chunkSize < chunkSize) {
+			this->chunkSize <<= 1;
+			chunkShift++;
+		}
+
+		for (uint32 i = 0; i < FD_OBJECTPOOL_MAX_CHUNKS; i++) chunks[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	ObjectPool(const ObjectPool<T>& pool) = delete;
+	ObjectPool<T>& operator=(const ObjectPool<T>& pool) = delete;
+
+	~ObjectPool() {
+		uint32 num = numChunks.load(std::memory_order_acquire);
+
+		for (uint32 i = 0; i < num; i++) Memory::Free(chunks[i].load(std::memory_order_relaxed));
+	}
+
+	//Uninitialized memory for one T, nullptr if the pool is full
+	inline T* Acquire() {
+		Slot* slot;
+
+		while ((slot = Pop()) == nullptr) {
+			if (!Grow()) return nullptr;
+		}
+
+		return (T*)slot->storage;
+	}
+
+	//Doesn't run the destructor
+	inline void Release(T* object) {
+		if (!object) return;
+
+		Slot* slot = (Slot*)object;
+
+		Push(slot, slot);
+	}
+
+	template<typename... Args>
+	inline T* New(Args&&... args) {
+		T* object = Acquire();
+
+		return object ? new (object) T(std::forward<Args>(args)...) : nullptr;
+	}
+
+	inline void Delete(T* object) {
+		if (!object) return;
+
+		object->~T();
+		Release(object);
+	}
+
+	inline uint32 GetCapacity() const { return numChunks.load(std::memory_order_relaxed) * chunkSize; }
+	inline uint32 GetChunkSize() const { return chunkSize; }
+};
+
+}
@@ -0,0 +1,74 @@
+#include "objparser.h"
+#include <core/log.h>
+#include <core/jobsystem.h>
+#include <stdio.h>
+
+namespace FD {
+
+void OBJParser::ReadFaces(const String& obj, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<OBJFace>& faces) {
+	List<String*> lines = obj.Split('\n');
+
+	uint_t numLines = lines.GetSize();
+	FD_DEBUG("[OBJParser] Parsing text");
+
+	for (uint_t i = 0; i < numLines; i++) {
+		const String& line = *lines[i];
+
+		if (line.StartsWith("v ")) {
+			vec3 vert;
+			sscanf(*line, "v %f %f %f", &vert.x, &vert.y, &vert.z);
+			vertices.Push_back(vert);
+		} else if (line.StartsWith("vt ")) {
+			vec2 tex;
+			sscanf(*line, "vt %f %f", &tex.x, &tex.y);
+			texCoords.Push_back(tex);
+		} else if (line.StartsWith("vn ")) {
+			vec3 norm;
+			sscanf(*line, "vn %f %f %f", &norm.x, &norm.y, &norm.z);
+			normals.Push_back(norm);
+		} else if (line.StartsWith("f ")) {
+			OBJFace face;
+			sscanf(*line, "f %u/%u/%u %u/%u/%u %u/%u/%u", &face[0].vertex, &face[0].texCoord, &face[0].normal, &face[1].vertex, &face[1].texCoord, &face[1].normal, &face[2].vertex, &face[2].texCoord, &face[2].normal);
+			faces.Push_back(face);
+		}
+	}
+
+	FD_DEBUG("[OBJParser] Found %u vertices %u normals %u uvs %u faces", (uint32)vertices.GetSize(), (uint32)normals.GetSize(), (uint32)texCoords.GetSize(), (uint32)faces.GetSize());
+
+	lines.Free();
+}
+
+void OBJParser::MakeFaces(const List<vec3>& fileVertices, const List<vec2>& fileTexCoords, const List<vec3>& fileNormals, const List<OBJFace>& faces, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<uint32>& indices) {
+	uint_t numFaces = faces.GetSize();
+
+	vertices.Resize(numFaces * 3);
+	texCoords.Resize(numFaces * 3);
+	normals.Resize(numFaces * 3);
+	indices.Resize(numFaces * 3);
+
+	JobSystem::ParallelFor(numFaces, 4096, [&](uint_t begin, uint_t end) {
+		for (uint_t i = begin; i < end; i++) {
+			OBJFace face = faces.Get(i);
+
+			for (uint_t j = 0; j < 3; j++) {
+				uint32 index = (uint32)(i * 3 + j);
+
+				indices[index] = index;
+				vertices[index] = fileVertices.Get(face[j].vertex - 1);
+				texCoords[index] = fileTexCoords.Get(face[j].texCoord - 1);
+				normals[index] = fileNormals.Get(face[j].normal - 1);
+			}
+		}
+	});
+}
+
+void OBJParser::Parse(const String& obj, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<uint32>& indices) {
+	List<OBJFace> faces;
+	List<vec3> fileVertices, fileNormals;
+	List<vec2> fileTexCoords;
+
+	ReadFaces(obj, fileVertices, fileTexCoords, fileNormals, faces);
+	MakeFaces(fileVertices, fileTexCoords, fileNormals, faces, vertices, texCoords, normals, indices);
+}
+
+}
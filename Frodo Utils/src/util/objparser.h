@@ -0,0 +1,39 @@
+#pragma once
+
+#include <fdu.h>
+#include <util/list.h>
+#include <util/string.h>
+#include <math/math.h>
+
+namespace FD {
+
+//1 based indices into the position, texture coordinate and normal lists of the file
+struct OBJFace {
+	struct Vertex {
+		uint32 vertex;
+		uint32 texCoord;
+		uint32 normal;
+	} v[3];
+
+	inline Vertex& operator[](uint_t index) { return v[index]; }
+	inline const Vertex& operator[](uint_t index) const { return v[index]; }
+};
+
+/*
+ Wavefront OBJ with triangulated faces in the v/vt/vn form, everything else is skipped.
+ ReadFaces only splits the text into the lists of the file, MakeFaces turns those into
+ one vertex per face corner with 0, 1, 2, ... as indices. MeshFactory builds its meshes
+ from this, the tangent path reads the faces itself.
+*/
+class FDUAPI OBJParser {
+public:
+	static void ReadFaces(const String& obj, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<OBJFace>& faces);
+
+	//Every face writes its own 3 slots, so the faces are split over the job system
+	static void MakeFaces(const List<vec3>& fileVertices, const List<vec2>& fileTexCoords, const List<vec3>& fileNormals, const List<OBJFace>& faces, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<uint32>& indices);
+
+	//ReadFaces and MakeFaces
+	static void Parse(const String& obj, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<uint32>& indices);
+};
+
+}
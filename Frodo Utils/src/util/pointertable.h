@@ -0,0 +1,92 @@
+#pragma once
+#include <fdu.h>
+#include <util/list.h>
+#include <string.h>
+#include <utility>
+
+namespace FD {
+
+/*
+ Gives pointers an index in the order they are first inserted. Open addressing with linear
+ probing, the slots double when they are half full. nullptr can't be inserted.
+ Clear keeps the slots for the next use.
+*/
+class PointerTable {
+private:
+	struct Slot {
+		const void* item;
+		uint32 index;
+	};
+
+	List<Slot> slots;
+	uint32 count;
+
+	static inline uint64 Hash(const void* item) {
+		//Finalizer of MurmurHash3, the low bits of a pointer are mostly alignment
+		uint64 x = (uint64)(uint_t)item;
+
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDull;
+		x ^= x >> 33;
+
+		return x;
+	}
+
+	uint32 Place(const void* item, uint32 index) {
+		uint_t mask = slots.GetSize() - 1;
+		uint_t i = (uint_t)Hash(item) & mask;
+
+		while (slots[i].item) {
+			if (slots[i].item == item) return slots[i].index;
+
+			i = (i + 1) & mask;
+		}
+
+		slots[i].item = item;
+		slots[i].index = index;
+
+		return index;
+	}
+
+	void Grow() {
+		List<Slot> old(std::move(slots));
+		uint_t size = old.GetSize();
+
+		slots = List<Slot>(size * 2, 1);
+		slots.Resize(size * 2);
+		memset(slots.GetData(), 0, slots.GetSizeInBytes());
+
+		for (uint_t i = 0; i < size; i++) {
+			if (old[i].item) Place(old[i].item, old[i].index);
+		}
+	}
+
+public:
+	//capacity must be a power of 2
+	PointerTable(uint32 capacity = 64) : slots(capacity, 1), count(0) {
+		slots.Resize(capacity);
+		memset(slots.GetData(), 0, slots.GetSizeInBytes());
+	}
+
+	//The index of item, the next free index when it's new
+	inline uint32 Insert(const void* item) {
+		if ((count + 1) * 2 > slots.GetSize()) Grow();
+
+		uint32 index = Place(item, count);
+
+		if (index == count) count++;
+
+		return index;
+	}
+
+	inline void Clear() {
+		if (count == 0) return;
+
+		memset(slots.GetData(), 0, slots.GetSizeInBytes());
+		count = 0;
+	}
+
+	inline uint32 GetSize() const { return count; }
+};
+
+}
@@ -0,0 +1,90 @@
+#include "radixsort.h"
+#include <string.h>
+
+namespace FD {
+
+#define FD_RADIX_BITS 8
+#define FD_RADIX_BUCKETS (1 << FD_RADIX_BITS)
+#define FD_RADIX_PASSES (64 / FD_RADIX_BITS)
+
+//Below this an insertion sort is faster than clearing the histograms
+#define FD_RADIX_MIN_COUNT 64
+
+static void InsertionSort(uint64* keys, uint32* values, uint_t count) {
+	for (uint_t i = 1; i < count; i++) {
+		uint64 key = keys[i];
+		uint32 value = values[i];
+		uint_t j = i;
+
+		for (; j > 0 && keys[j - 1] > key; j--) {
+			keys[j] = keys[j - 1];
+			values[j] = values[j - 1];
+		}
+
+		keys[j] = key;
+		values[j] = value;
+	}
+}
+
+void FDRadixSort(uint64* keys, uint32* values, uint64* tempKeys, uint32* tempValues, uint_t count) {
+	if (count <= FD_RADIX_MIN_COUNT) {
+		InsertionSort(keys, values, count);
+		return;
+	}
+
+	//Every histogram in one read
+	uint32 histograms[FD_RADIX_PASSES][FD_RADIX_BUCKETS];
+
+	memset(histograms, 0, sizeof(histograms));
+
+	for (uint_t i = 0; i < count; i++) {
+		uint64 key = keys[i];
+
+		for (uint32 pass = 0; pass < FD_RADIX_PASSES; pass++) {
+			histograms[pass][(key >> (pass * FD_RADIX_BITS)) & (FD_RADIX_BUCKETS - 1)]++;
+		}
+	}
+
+	uint64* srcKeys = keys;
+	uint32* srcValues = values;
+	uint64* dstKeys = tempKeys;
+	uint32* dstValues = tempValues;
+
+	for (uint32 pass = 0; pass < FD_RADIX_PASSES; pass++) {
+		uint32* histogram = histograms[pass];
+		uint32 shift = pass * FD_RADIX_BITS;
+
+		if (histogram[(srcKeys[0] >> shift) & (FD_RADIX_BUCKETS - 1)] == count) continue;
+
+		//Bucket counts to start offsets
+		uint32 offset = 0;
+
+		for (uint32 i = 0; i < FD_RADIX_BUCKETS; i++) {
+			uint32 size = histogram[i];
+			histogram[i] = offset;
+			offset += size;
+		}
+
+		for (uint_t i = 0; i < count; i++) {
+			uint32 index = histogram[(srcKeys[i] >> shift) & (FD_RADIX_BUCKETS - 1)]++;
+
+			dstKeys[index] = srcKeys[i];
+			dstValues[index] = srcValues[i];
+		}
+
+		uint64* tmpKeys = srcKeys;
+		uint32* tmpValues = srcValues;
+
+		srcKeys = dstKeys;
+		srcValues = dstValues;
+		dstKeys = tmpKeys;
+		dstValues = tmpValues;
+	}
+
+	if (srcKeys != keys) {
+		memcpy(keys, srcKeys, count * sizeof(uint64));
+		memcpy(values, srcValues, count * sizeof(uint32));
+	}
+}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <fdu.h>
+
+namespace FD {
+
+/*
+ Sorts keys ascending and moves values along with them, equal keys keep their order.
+ Least significant digit first, 8 bits per pass. Passes where every key has the same digit
+ are skipped, so keys that only use their top bits don't pay for the rest.
+
+ tempKeys and tempValues have to hold count items, the result always ends up in keys and
+ values. Counts are 32 bit, up to 4G items.
+*/
+FDUAPI void FDRadixSort(uint64* keys, uint32* values, uint64* tempKeys, uint32* tempValues, uint_t count);
+
+}
@@ -0,0 +1,317 @@
+#include "shadercache.h"
+#include "fileutils.h"
+#include <core/log.h>
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+
+namespace FD {
+
+#define FD_SHADER_CACHE_MAGIC 0x43534446
+
+struct ShaderCacheFileHeader {
+	uint32 magic;
+	uint32 version;
+	uint64 key;
+	uint64 sourceLength;
+	uint64 byteCodeSize;
+};
+
+std::mutex ShaderCache::mutex;
+
+ShaderCacheEntry* ShaderCache::head = nullptr;
+ShaderCacheEntry* ShaderCache::tail = nullptr;
+
+List<ShaderCacheEntry*> ShaderCache::table;
+uint32 ShaderCache::tableCount = 0;
+
+uint64 ShaderCache::memoryUsed = 0;
+uint64 ShaderCache::maxMemory = FD_SHADER_CACHE_SIZE;
+String ShaderCache::directory;
+
+uint64 ShaderCache::hits = 0;
+uint64 ShaderCache::diskHits = 0;
+uint64 ShaderCache::misses = 0;
+
+static inline uint64 GetEntrySize(const ShaderCacheEntry* entry) {
+	return sizeof(ShaderCacheEntry) + entry->source.length + entry->byteCodeSize;
+}
+
+static inline uint_t HashKey(uint64 key) {
+	//Finalizer of MurmurHash3, keys from MakeKey are already hashed but the low bits decide the slot
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDull;
+	key ^= key >> 33;
+
+	return (uint_t)key;
+}
+
+static void Place(List<ShaderCacheEntry*>& table, ShaderCacheEntry* entry) {
+	uint_t mask = table.GetSize() - 1;
+	uint_t i = HashKey(entry->key) & mask;
+
+	while (table[i]) i = (i + 1) & mask;
+
+	table[i] = entry;
+}
+
+String ShaderCache::GetFilename(uint64 key) {
+	char name[32];
+	sprintf(name, "/%016llx.fdshader", (unsigned long long)key);
+
+	return directory + name;
+}
+
+ShaderCacheEntry* ShaderCache::ReadEntry(uint64 key) {
+	String filename = GetFilename(key);
+
+	FILE* file = fopen(*filename, "rb");
+
+	if (!file) return nullptr;
+
+	ShaderCacheFileHeader header;
+	ShaderCacheEntry* entry = nullptr;
+
+	if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == FD_SHADER_CACHE_MAGIC && header.version == FD_SHADER_CACHE_VERSION && header.key == key) {
+		entry = new ShaderCacheEntry;
+
+		entry->key = key;
+		entry->source.str = (char*)Memory::Allocate(header.sourceLength + 1, FD_MEMTAG_STRING);
+		entry->source.str[header.sourceLength] = '\0';
+		entry->source.length = (uint_t)header.sourceLength;
+		entry->byteCode = (byte*)Memory::Allocate(header.byteCodeSize, FD_MEMTAG_ASSET);
+		entry->byteCodeSize = (uint_t)header.byteCodeSize;
+
+		bool read = (header.sourceLength == 0 || fread(entry->source.str, header.sourceLength, 1, file) == 1) && fread(entry->byteCode, header.byteCodeSize, 1, file) == 1;
+
+		if (!read) {
+			FD_WARNING("[ShaderCache] \"%s\" is truncated", *filename);
+			delete entry;
+			entry = nullptr;
+		}
+	}
+
+	fclose(file);
+
+	return entry;
+}
+
+void ShaderCache::WriteEntry(const ShaderCacheEntry* entry) {
+	String filename = GetFilename(entry->key);
+
+	FILE* file = fopen(*filename, "wb");
+
+	if (!file) {
+		FD_WARNING("[ShaderCache] Failed to write \"%s\"", *filename);
+		return;
+	}
+
+	ShaderCacheFileHeader header;
+
+	header.magic = FD_SHADER_CACHE_MAGIC;
+	header.version = FD_SHADER_CACHE_VERSION;
+	header.key = entry->key;
+	header.sourceLength = entry->source.length;
+	header.byteCodeSize = entry->byteCodeSize;
+
+	FDWriteFile(file, &header, sizeof(header));
+	FDWriteFile(file, entry->source.str, entry->source.length);
+	FDWriteFile(file, entry->byteCode, entry->byteCodeSize);
+
+	fclose(file);
+}
+
+ShaderCacheEntry* ShaderCache::Lookup(uint64 key) {
+	uint_t size = table.GetSize();
+
+	if (size == 0) return nullptr;
+
+	uint_t mask = size - 1;
+
+	for (uint_t i = HashKey(key) & mask; table[i]; i = (i + 1) & mask) {
+		if (table[i]->key == key) return table[i];
+	}
+
+	return nullptr;
+}
+
+void ShaderCache::AddToTable(ShaderCacheEntry* entry) {
+	if ((tableCount + 1) * 2 > table.GetSize()) {
+		List<ShaderCacheEntry*> old(std::move(table));
+		uint_t size = old.GetSize() ? old.GetSize() * 2 : 64;
+
+		table = List<ShaderCacheEntry*>(size, 1);
+		table.Resize(size);
+		memset(table.GetData(), 0, table.GetSizeInBytes());
+
+		for (uint_t i = 0; i < old.GetSize(); i++) {
+			if (old[i]) Place(table, old[i]);
+		}
+	}
+
+	Place(table, entry);
+	tableCount++;
+}
+
+void ShaderCache::RemoveFromTable(const ShaderCacheEntry* entry) {
+	uint_t mask = table.GetSize() - 1;
+	uint_t hole = HashKey(entry->key) & mask;
+
+	while (table[hole] != entry) hole = (hole + 1) & mask;
+
+	table[hole] = nullptr;
+	tableCount--;
+
+	//Entries after the hole that probed past it are moved back so lookups don't stop early
+	for (uint_t i = (hole + 1) & mask; table[i]; i = (i + 1) & mask) {
+		uint_t home = HashKey(table[i]->key) & mask;
+
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			table[hole] = table[i];
+			table[i] = nullptr;
+			hole = i;
+		}
+	}
+}
+
+void ShaderCache::Insert(ShaderCacheEntry* entry) {
+	entry->prev = nullptr;
+	entry->next = head;
+
+	if (head) head->prev = entry;
+	head = entry;
+
+	if (!tail) tail = entry;
+
+	memoryUsed += GetEntrySize(entry);
+
+	//The new entry stays even when it's bigger than the limit on its own
+	while (memoryUsed > maxMemory && tail != head) Evict(tail);
+}
+
+void ShaderCache::Unlink(ShaderCacheEntry* entry) {
+	if (entry->prev) entry->prev->next = entry->next;
+	else head = entry->next;
+
+	if (entry->next) entry->next->prev = entry->prev;
+	else tail = entry->prev;
+
+	entry->prev = nullptr;
+	entry->next = nullptr;
+
+	memoryUsed -= GetEntrySize(entry);
+}
+
+void ShaderCache::Evict(ShaderCacheEntry* entry) {
+	Unlink(entry);
+	RemoveFromTable(entry);
+
+	delete entry;
+}
+
+void ShaderCache::Init(uint64 maxMemory, const String& directory) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	ShaderCache::maxMemory = maxMemory;
+	ShaderCache::directory = directory;
+
+	if (!directory.IsNull() && !FDCreateDirectory(directory)) ShaderCache::directory = String();
+}
+
+void ShaderCache::Dispose() {
+	Clear();
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	directory = String();
+	maxMemory = FD_SHADER_CACHE_SIZE;
+}
+
+uint64 ShaderCache::MakeKey(uint64 sourceHash, uint64 variableHash, const char* profile) {
+	//FNV-1a over both hashes and the profile name
+	uint64 key = 14695981039346656037ull;
+
+	for (uint32 i = 0; i < 8; i++) {
+		key ^= (sourceHash >> (i * 8)) & 0xFF;
+		key *= 1099511628211ull;
+	}
+
+	for (uint32 i = 0; i < 8; i++) {
+		key ^= (variableHash >> (i * 8)) & 0xFF;
+		key *= 1099511628211ull;
+	}
+
+	for (const char* c = profile; *c; c++) {
+		key ^= (byte)*c;
+		key *= 1099511628211ull;
+	}
+
+	return key;
+}
+
+bool ShaderCache::Find(uint64 key, String* source, byte** byteCode, uint_t* byteCodeSize) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	ShaderCacheEntry* entry = Lookup(key);
+
+	if (entry) {
+		Unlink(entry);
+		Insert(entry);
+
+		hits++;
+	} else if (!directory.IsNull() && (entry = ReadEntry(key)) != nullptr) {
+		AddToTable(entry);
+		Insert(entry);
+
+		diskHits++;
+	} else {
+		misses++;
+		return false;
+	}
+
+	*source = entry->source;
+	*byteCode = (byte*)Memory::Allocate(entry->byteCodeSize, FD_MEMTAG_ASSET);
+	*byteCodeSize = entry->byteCodeSize;
+
+	memcpy(*byteCode, entry->byteCode, entry->byteCodeSize);
+
+	return true;
+}
+
+void ShaderCache::Add(uint64 key, const String& source, const void* byteCode, uint_t byteCodeSize) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (Lookup(key)) return;
+
+	ShaderCacheEntry* entry = new ShaderCacheEntry;
+
+	entry->key = key;
+	entry->source = source;
+	entry->byteCode = (byte*)Memory::Allocate(byteCodeSize, FD_MEMTAG_ASSET);
+	entry->byteCodeSize = byteCodeSize;
+
+	memcpy(entry->byteCode, byteCode, byteCodeSize);
+
+	if (!directory.IsNull()) WriteEntry(entry);
+
+	AddToTable(entry);
+	Insert(entry);
+}
+
+void ShaderCache::Clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	while (head) {
+		ShaderCacheEntry* entry = head;
+
+		Unlink(entry);
+		delete entry;
+	}
+
+	//The slots are kept for the next entries
+	if (tableCount) memset(table.GetData(), 0, table.GetSizeInBytes());
+
+	tableCount = 0;
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/string.h>
+#include <util/list.h>
+#include <mutex>
+
+//Bytes of source and bytecode kept in memory if ShaderCache::Init isn't called with a size
+#define FD_SHADER_CACHE_SIZE (32 << 20)
+//Bump when the file layout or the way keys are made changes, older files are ignored
+#define FD_SHADER_CACHE_VERSION 1
+
+namespace FD {
+
+//Generated source and compiled bytecode of one shader stage permutation
+struct ShaderCacheEntry {
+	uint64 key;
+
+	String source;
+	byte* byteCode;
+	uint_t byteCodeSize;
+
+	//Most recently used first
+	ShaderCacheEntry* prev;
+	ShaderCacheEntry* next;
+
+	ShaderCacheEntry() : key(0), byteCode(nullptr), byteCodeSize(0), prev(nullptr), next(nullptr) {}
+	~ShaderCacheEntry() { Memory::Free(byteCode); }
+};
+
+/*
+ Permutations keyed by MakeKey(template hash, ShaderGen variable hash, target profile).
+ In memory entries are found through a hash table on the key and kept in a least recently
+ used list, the oldest are dropped once their size goes over the limit. With a directory every added entry is also written to
+ <directory>/<key>.fdshader and a lookup that misses in memory reads it from there, so the
+ next run skips the compile too.
+
+ Works without Init with the default size and no directory. Any thread can use it.
+*/
+class FDUAPI ShaderCache {
+private:
+	static std::mutex mutex;
+
+	static ShaderCacheEntry* head;
+	static ShaderCacheEntry* tail;
+
+	//Open addressing with linear probing, the slots double when they are half full
+	static List<ShaderCacheEntry*> table;
+	static uint32 tableCount;
+
+	static uint64 memoryUsed;
+	static uint64 maxMemory;
+	static String directory;
+
+	static uint64 hits;
+	static uint64 diskHits;
+	static uint64 misses;
+
+	static String GetFilename(uint64 key);
+	static ShaderCacheEntry* ReadEntry(uint64 key);
+	static void WriteEntry(const ShaderCacheEntry* entry);
+
+	static ShaderCacheEntry* Lookup(uint64 key);
+	static void AddToTable(ShaderCacheEntry* entry);
+	static void RemoveFromTable(const ShaderCacheEntry* entry);
+
+	static void Insert(ShaderCacheEntry* entry);
+	static void Unlink(ShaderCacheEntry* entry);
+	static void Evict(ShaderCacheEntry* entry);
+
+public:
+	//An empty directory keeps the cache in memory only
+	static void Init(uint64 maxMemory = FD_SHADER_CACHE_SIZE, const String& directory = String());
+	static void Dispose();
+
+	static uint64 MakeKey(uint64 sourceHash, uint64 variableHash, const char* profile);
+
+	//Copies the entry out, byteCode is released with Memory::Free. False when it was never added.
+	static bool Find(uint64 key, String* source, byte** byteCode, uint_t* byteCodeSize);
+	static void Add(uint64 key, const String& source, const void* byteCode, uint_t byteCodeSize);
+
+	//Drops the in memory entries, files stay
+	static void Clear();
+
+	static inline uint64 GetMemoryUsed() { return memoryUsed; }
+	static inline uint64 GetHits() { return hits; }
+	static inline uint64 GetDiskHits() { return diskHits; }
+	static inline uint64 GetMisses() { return misses; }
+};
+
+}
@@ -0,0 +1,1089 @@
+#include "shadergen.h"
+#include <core/log.h>
+#include <string.h>
+#include <math.h>
+
+namespace FD {
+
+enum FD_SHADER_GEN_NODE_TYPE {
+	FD_SHADER_GEN_NODE_TEXT,
+	FD_SHADER_GEN_NODE_IF,
+	FD_SHADER_GEN_NODE_GENERATE,
+	FD_SHADER_GEN_NODE_ARITHMETIC
+};
+
+struct ShaderGenNode {
+	FD_SHADER_GEN_NODE_TYPE type;
+
+	ShaderGenNode(FD_SHADER_GEN_NODE_TYPE type) : type(type) {}
+	virtual ~ShaderGenNode() {}
+};
+
+//A variable name or an immediate value when name is null
+struct ShaderGenOperand {
+	String name;
+	float32 value;
+
+	ShaderGenOperand() : value(0) {}
+};
+
+struct ShaderGenTextNode : public ShaderGenNode {
+	//Into ShaderGen::source
+	uint_t start;
+	uint_t length;
+
+	//Variable names are replaced by their value, only inside blocks
+	bool substitute;
+
+	ShaderGenTextNode() : ShaderGenNode(FD_SHADER_GEN_NODE_TEXT), start(0), length(0), substitute(false) {}
+};
+
+struct ShaderGenCondition {
+	FD_SHADER_GEN_FUNCTION_TYPE function;
+	String variable;
+	ShaderGenOperand operand;
+
+	List<ShaderGenNode*> body;
+
+	ShaderGenCondition() : function(FD_FALSE), body(8, 8) {}
+	~ShaderGenCondition() { body.Free(); }
+};
+
+struct ShaderGenIfNode : public ShaderGenNode {
+	//if and the elifs in order, else is an FD_TRUE condition
+	List<ShaderGenCondition*> branches;
+
+	ShaderGenIfNode() : ShaderGenNode(FD_SHADER_GEN_NODE_IF), branches(4, 4) {}
+	~ShaderGenIfNode() { branches.Free(); }
+};
+
+struct ShaderGenGenerateNode : public ShaderGenNode {
+	String blockName;
+	//Resolved after parsing, blocks can be defined after they're used
+	const ShaderGenBlock* block;
+
+	//single when false
+	bool loop;
+	String variable;
+	ShaderGenOperand start;
+	FD_SHADER_GEN_FUNCTION_TYPE op;
+	ShaderGenOperand end;
+	ShaderGenOperand increment;
+
+	ShaderGenGenerateNode() : ShaderGenNode(FD_SHADER_GEN_NODE_GENERATE), block(nullptr), loop(false), op(FD_FALSE) {}
+};
+
+struct ShaderGenArithmeticNode : public ShaderGenNode {
+	char op;
+	String variable;
+	ShaderGenOperand operand;
+
+	ShaderGenArithmeticNode() : ShaderGenNode(FD_SHADER_GEN_NODE_ARITHMETIC), op('+') {}
+};
+
+ShaderGenBlock::~ShaderGenBlock() {
+	body.Free();
+}
+
+static const char sg_shadergen[] = "#shaderGen";
+static const char sg_endblock[] = "#shaderGen endblock";
+
+//Before these the value is written with its decimals, anywhere else they're cut off
+static const char arithmetic_chars[] = " =<>+-*/";
+
+enum FD_SHADER_GEN_DIRECTIVE {
+	FD_SHADER_GEN_DIRECTIVE_END,
+	FD_SHADER_GEN_DIRECTIVE_UNKNOWN,
+	FD_SHADER_GEN_DIRECTIVE_DEFINE,
+	FD_SHADER_GEN_DIRECTIVE_DEFINE_R,
+	FD_SHADER_GEN_DIRECTIVE_DEFINE_B,
+	FD_SHADER_GEN_DIRECTIVE_ENDBLOCK,
+	FD_SHADER_GEN_DIRECTIVE_IF,
+	FD_SHADER_GEN_DIRECTIVE_ELIF,
+	FD_SHADER_GEN_DIRECTIVE_ELSE,
+	FD_SHADER_GEN_DIRECTIVE_ENDIF,
+	FD_SHADER_GEN_DIRECTIVE_GENERATE
+};
+
+struct ShaderGenKeyword {
+	const char* name;
+	FD_SHADER_GEN_DIRECTIVE type;
+};
+
+static const ShaderGenKeyword keywords[] = {
+	{ "define", FD_SHADER_GEN_DIRECTIVE_DEFINE },
+	{ "define_r", FD_SHADER_GEN_DIRECTIVE_DEFINE_R },
+	{ "define_b", FD_SHADER_GEN_DIRECTIVE_DEFINE_B },
+	{ "endblock", FD_SHADER_GEN_DIRECTIVE_ENDBLOCK },
+	{ "if", FD_SHADER_GEN_DIRECTIVE_IF },
+	{ "elif", FD_SHADER_GEN_DIRECTIVE_ELIF },
+	{ "else", FD_SHADER_GEN_DIRECTIVE_ELSE },
+	{ "endif", FD_SHADER_GEN_DIRECTIVE_ENDIF },
+	{ "generate", FD_SHADER_GEN_DIRECTIVE_GENERATE }
+};
+
+//A #shaderGen line, the newline after it stays in the text
+struct ShaderGenDirective {
+	FD_SHADER_GEN_DIRECTIVE type;
+
+	uint_t start;
+	uint_t lineEnd;
+
+	//Everything after the keyword without the surrounding blanks
+	uint_t argsStart;
+	uint_t argsEnd;
+};
+
+static inline bool IsBlank(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool Match(const char* str, uint_t length, const char* name) {
+	return strncmp(str, name, length) == 0 && name[length] == 0;
+}
+
+static bool Compare(float32 a, float32 b, FD_SHADER_GEN_FUNCTION_TYPE function) {
+	switch (function) {
+		case FD_EQ: return a == b;
+		case FD_NEQ: return a != b;
+		case FD_GR: return a > b;
+		case FD_LS: return a < b;
+		case FD_GE: return a >= b;
+		case FD_LE: return a <= b;
+		default: return false;
+	}
+}
+
+class ShaderGenParser {
+private:
+	ShaderGen& gen;
+	const char* str;
+	uint_t length;
+	uint_t current;
+	bool error;
+
+	List<ShaderGenGenerateNode*> generates;
+
+	inline void Trim(uint_t& start, uint_t& end) const {
+		while (start < end && IsBlank(str[start])) start++;
+		while (end > start && IsBlank(str[end - 1])) end--;
+	}
+
+	inline String Slice(uint_t start, uint_t end) const {
+		Trim(start, end);
+
+		return String((char*)str + start, end - start);
+	}
+
+	uint_t FindChar(char c, uint_t start, uint_t end) const {
+		for (uint_t i = start; i < end; i++) {
+			if (str[i] == c) return i;
+		}
+
+		return (uint_t)-1;
+	}
+
+	bool NextDirective(ShaderGenDirective& directive) {
+		uint_t start = gen.source.Find(sg_shadergen, current);
+
+		if (start == (uint_t)-1) return false;
+
+		uint_t lineEnd = gen.source.Find('\n', start);
+		if (lineEnd == (uint_t)-1) lineEnd = length;
+
+		uint_t keyStart = start + sizeof(sg_shadergen) - 1;
+		while (keyStart < lineEnd && IsBlank(str[keyStart])) keyStart++;
+
+		uint_t keyEnd = keyStart;
+		while (keyEnd < lineEnd && !IsBlank(str[keyEnd])) keyEnd++;
+
+		directive.type = FD_SHADER_GEN_DIRECTIVE_UNKNOWN;
+
+		for (uint_t i = 0; i < sizeof(keywords) / sizeof(ShaderGenKeyword); i++) {
+			if (Match(str + keyStart, keyEnd - keyStart, keywords[i].name)) directive.type = keywords[i].type;
+		}
+
+		directive.start = start;
+		directive.lineEnd = lineEnd;
+		directive.argsStart = keyEnd;
+		directive.argsEnd = lineEnd;
+
+		Trim(directive.argsStart, directive.argsEnd);
+
+		if (directive.type == FD_SHADER_GEN_DIRECTIVE_UNKNOWN) {
+			FD_WARNING("[ShaderGen] Unknown directive \"%.*s\"", (int32)(keyEnd - keyStart), str + keyStart);
+			error = true;
+		}
+
+		return true;
+	}
+
+	void AddText(List<ShaderGenNode*>& body, uint_t start, uint_t end, bool substitute) {
+		if (start >= end) return;
+
+		ShaderGenTextNode* node = new ShaderGenTextNode;
+
+		node->start = start;
+		node->length = end - start;
+		node->substitute = substitute;
+
+		body.Push_back(node);
+	}
+
+	ShaderGenOperand ParseOperand(uint_t start, uint_t end) const {
+		ShaderGenOperand operand;
+
+		String text = Slice(start, end);
+
+		if (text.IsNull()) return operand;
+
+		char* numberEnd = nullptr;
+		float32 value = strtof(*text, &numberEnd);
+
+		if (numberEnd == *text + text.length) {
+			operand.value = value;
+		} else {
+			operand.name = text;
+		}
+
+		return operand;
+	}
+
+	//Splits "name(a, b, ...)" on the commas, returns the number of parameters or -1 without parentheses
+	uint_t ParseParameters(uint_t start, uint_t end, uint_t* starts, uint_t* ends, uint_t max) const {
+		uint_t open = FindChar('(', start, end);
+		uint_t close = open == (uint_t)-1 ? (uint_t)-1 : FindChar(')', open, end);
+
+		if (close == (uint_t)-1) return (uint_t)-1;
+
+		uint_t num = 0;
+		uint_t paramStart = open + 1;
+
+		while (num < max) {
+			uint_t comma = FindChar(',', paramStart, close);
+
+			starts[num] = paramStart;
+			ends[num++] = comma == (uint_t)-1 ? close : comma;
+
+			if (comma == (uint_t)-1) break;
+
+			paramStart = comma + 1;
+		}
+
+		return num;
+	}
+
+	ShaderGenCondition* ParseCondition(uint_t start, uint_t end) {
+		ShaderGenCondition* condition = new ShaderGenCondition;
+
+		uint_t nameEnd = FindChar('(', start, end);
+		if (nameEnd == (uint_t)-1) nameEnd = end;
+
+		uint_t nameStart = start;
+		Trim(nameStart, nameEnd);
+
+		FD_SHADER_GEN_FUNCTION_TYPE function = FD_FALSE;
+		bool found = false;
+
+		for (uint32 i = FD_TRUE; i <= FD_LE; i++) {
+			String name = ShaderGen::GetFunctionTypeString((FD_SHADER_GEN_FUNCTION_TYPE)i);
+
+			if (Match(str + nameStart, nameEnd - nameStart, *name)) {
+				function = (FD_SHADER_GEN_FUNCTION_TYPE)i;
+				found = true;
+			}
+		}
+
+		if (!found) {
+			FD_WARNING("[ShaderGen] Unknown function \"%.*s\"", (int32)(end - start), str + start);
+			error = true;
+			return condition;
+		}
+
+		condition->function = function;
+
+		if (function == FD_TRUE || function == FD_FALSE) return condition;
+
+		uint_t starts[2];
+		uint_t ends[2];
+		uint_t num = ParseParameters(start, end, starts, ends, 2);
+
+		uint_t required = function == FD_DEFINED ? 1 : 2;
+
+		if (num == (uint_t)-1 || num < required) {
+			FD_WARNING("[ShaderGen] Function \"%.*s\" needs %u parameters", (int32)(end - start), str + start, (uint32)required);
+			condition->function = FD_FALSE;
+			error = true;
+			return condition;
+		}
+
+		condition->variable = Slice(starts[0], ends[0]);
+
+		if (required == 2) condition->operand = ParseOperand(starts[1], ends[1]);
+
+		return condition;
+	}
+
+	void ParseDefine(const ShaderGenDirective& directive, bool runtime) {
+		uint_t nameEnd = directive.argsStart;
+		while (nameEnd < directive.argsEnd && !IsBlank(str[nameEnd])) nameEnd++;
+
+		String name = Slice(directive.argsStart, runtime ? directive.argsEnd : nameEnd);
+
+		if (name.IsNull()) {
+			FD_WARNING("[ShaderGen] \"define\" without a name");
+			error = true;
+			return;
+		}
+
+		if (gen.GetVariableInternal(name)) {
+			FD_WARNING("[ShaderGen] Variable \"%s\" re-definition, saving existing", *name);
+			return;
+		}
+
+		ShaderGenVariable* variable = new ShaderGenVariable;
+
+		variable->name = name;
+		variable->data = runtime ? 0.0f : (float32)atof(*Slice(nameEnd, directive.argsEnd));
+
+		gen.variables.Push_back(variable);
+	}
+
+	//Text between sg_add/sub/mul/div calls
+	void ParseBlockBody(List<ShaderGenNode*>& body, uint_t start, uint_t end) {
+		uint_t text = start;
+		uint_t i = start;
+
+		while (i + 7 <= end) {
+			if (str[i] != 's' || str[i + 1] != 'g' || str[i + 2] != '_' || str[i + 6] != '(') {
+				i++;
+				continue;
+			}
+
+			char op = 0;
+
+			if (strncmp(str + i + 3, "add", 3) == 0) op = '+';
+			else if (strncmp(str + i + 3, "sub", 3) == 0) op = '-';
+			else if (strncmp(str + i + 3, "mul", 3) == 0) op = '*';
+			else if (strncmp(str + i + 3, "div", 3) == 0) op = '/';
+
+			uint_t starts[2];
+			uint_t ends[2];
+			uint_t num = op ? ParseParameters(i, end, starts, ends, 2) : 0;
+
+			if (num == (uint_t)-1 || num < 2) {
+				if (op) {
+					FD_WARNING("[ShaderGen] \"%.6s\" needs 2 parameters", str + i);
+					error = true;
+				}
+
+				i++;
+				continue;
+			}
+
+			AddText(body, text, i, true);
+
+			ShaderGenArithmeticNode* node = new ShaderGenArithmeticNode;
+
+			node->op = op;
+			node->variable = Slice(starts[0], ends[0]);
+			node->operand = ParseOperand(starts[1], ends[1]);
+
+			body.Push_back(node);
+
+			i = ends[1] + 1;
+			text = i;
+		}
+
+		AddText(body, text, end, true);
+	}
+
+	void ParseBlock(const ShaderGenDirective& directive) {
+		uint_t end = gen.source.Find(sg_endblock, directive.lineEnd);
+
+		if (end == (uint_t)-1) {
+			FD_WARNING("[ShaderGen] No \"endblock\" after \"define_b\"");
+			error = true;
+			end = length;
+		}
+
+		current = end == length ? length : end + sizeof(sg_endblock) - 1;
+
+		String name = Slice(directive.argsStart, directive.argsEnd);
+
+		if (gen.GetBlock(name)) {
+			FD_WARNING("[ShaderGen] Block \"%s\" re-definition, saving existing", *name);
+			return;
+		}
+
+		ShaderGenBlock* block = new ShaderGenBlock;
+
+		block->name = name;
+		block->code = gen.source.SubString(directive.lineEnd, end);
+
+		ParseBlockBody(block->body, directive.lineEnd, end);
+
+		gen.blocks.Push_back(block);
+	}
+
+	void ParseIf(List<ShaderGenNode*>& body, const ShaderGenDirective& directive) {
+		ShaderGenIfNode* node = new ShaderGenIfNode;
+		body.Push_back(node);
+
+		ShaderGenCondition* condition = ParseCondition(directive.argsStart, directive.argsEnd);
+		node->branches.Push_back(condition);
+
+		ShaderGenDirective terminator;
+		ParseBody(condition->body, terminator);
+
+		while (terminator.type == FD_SHADER_GEN_DIRECTIVE_ELIF) {
+			condition = ParseCondition(terminator.argsStart, terminator.argsEnd);
+			node->branches.Push_back(condition);
+
+			ParseBody(condition->body, terminator);
+		}
+
+		if (terminator.type == FD_SHADER_GEN_DIRECTIVE_ELSE) {
+			condition = new ShaderGenCondition;
+			condition->function = FD_TRUE;
+			node->branches.Push_back(condition);
+
+			ParseBody(condition->body, terminator);
+
+			while (terminator.type == FD_SHADER_GEN_DIRECTIVE_ELIF || terminator.type == FD_SHADER_GEN_DIRECTIVE_ELSE) {
+				FD_WARNING("[ShaderGen] \"elif\" or \"else\" after \"else\"");
+				error = true;
+
+				ParseBody(condition->body, terminator);
+			}
+		}
+
+		if (terminator.type != FD_SHADER_GEN_DIRECTIVE_ENDIF) {
+			FD_WARNING("[ShaderGen] No \"endif\" after \"if\"");
+			error = true;
+		}
+	}
+
+	void ParseGenerate(List<ShaderGenNode*>& body, const ShaderGenDirective& directive) {
+		ShaderGenGenerateNode* node = new ShaderGenGenerateNode;
+		body.Push_back(node);
+		generates.Push_back(node);
+
+		uint_t nameStart = directive.argsStart;
+
+		if (strncmp(str + directive.argsStart, "for(", 4) == 0) {
+			uint_t starts[5];
+			uint_t ends[5];
+			uint_t num = ParseParameters(directive.argsStart, directive.argsEnd, starts, ends, 5);
+
+			if (num != 5) {
+				FD_WARNING("[ShaderGen] \"for\" needs 5 parameters, for(<variable>, <start>, <op>, <end>, <inc>)");
+				error = true;
+				return;
+			}
+
+			node->loop = true;
+			node->variable = Slice(starts[0], ends[0]);
+			node->start = ParseOperand(starts[1], ends[1]);
+			node->end = ParseOperand(starts[3], ends[3]);
+			node->increment = ParseOperand(starts[4], ends[4]);
+
+			String op = Slice(starts[2], ends[2]);
+
+			for (uint32 i = FD_EQ; i <= FD_LE; i++) {
+				if (op == ShaderGen::GetFunctionTypeString((FD_SHADER_GEN_FUNCTION_TYPE)i)) node->op = (FD_SHADER_GEN_FUNCTION_TYPE)i;
+			}
+
+			if (node->op == FD_FALSE) {
+				FD_WARNING("[ShaderGen] %s is not a valid operation for a \"for\" loop", *op);
+				node->loop = false;
+				error = true;
+				return;
+			}
+
+			nameStart = FindChar(')', starts[4], directive.argsEnd) + 1;
+		} else {
+			while (nameStart < directive.argsEnd && !IsBlank(str[nameStart])) nameStart++;
+
+			if (!Match(str + directive.argsStart, nameStart - directive.argsStart, "single")) {
+				FD_WARNING("[ShaderGen] Unknown generate function \"%.*s\"", (int32)(nameStart - directive.argsStart), str + directive.argsStart);
+				error = true;
+				return;
+			}
+		}
+
+		node->blockName = Slice(nameStart, directive.argsEnd);
+	}
+
+	//Until the end of the source or an elif, else or endif which is returned in terminator
+	void ParseBody(List<ShaderGenNode*>& body, ShaderGenDirective& terminator) {
+		ShaderGenDirective directive;
+
+		while (NextDirective(directive)) {
+			AddText(body, current, directive.start, false);
+
+			current = directive.lineEnd;
+
+			switch (directive.type) {
+				case FD_SHADER_GEN_DIRECTIVE_DEFINE:
+					ParseDefine(directive, false);
+					break;
+				case FD_SHADER_GEN_DIRECTIVE_DEFINE_R:
+					ParseDefine(directive, true);
+					break;
+				case FD_SHADER_GEN_DIRECTIVE_DEFINE_B:
+					ParseBlock(directive);
+					break;
+				case FD_SHADER_GEN_DIRECTIVE_IF:
+					ParseIf(body, directive);
+					break;
+				case FD_SHADER_GEN_DIRECTIVE_GENERATE:
+					ParseGenerate(body, directive);
+					break;
+				case FD_SHADER_GEN_DIRECTIVE_ELIF:
+				case FD_SHADER_GEN_DIRECTIVE_ELSE:
+				case FD_SHADER_GEN_DIRECTIVE_ENDIF:
+					terminator = directive;
+					return;
+				case FD_SHADER_GEN_DIRECTIVE_ENDBLOCK:
+					FD_WARNING("[ShaderGen] \"endblock\" without \"define_b\"");
+					error = true;
+					break;
+				default:
+					break;
+			}
+		}
+
+		AddText(body, current, length, false);
+
+		current = length;
+		terminator.type = FD_SHADER_GEN_DIRECTIVE_END;
+	}
+
+public:
+	ShaderGenParser(ShaderGen& gen) : gen(gen), str(*gen.source), length(gen.source.length), current(0), error(false), generates(16, 16) {}
+
+	bool Parse() {
+		ShaderGenDirective terminator;
+
+		ParseBody(gen.nodes, terminator);
+
+		while (terminator.type != FD_SHADER_GEN_DIRECTIVE_END) {
+			FD_WARNING("[ShaderGen] \"%.*s\" without \"if\"", (int32)(terminator.lineEnd - terminator.start), str + terminator.start);
+			error = true;
+
+			ParseBody(gen.nodes, terminator);
+		}
+
+		for (uint_t i = 0; i < generates.GetSize(); i++) {
+			ShaderGenGenerateNode* node = generates[i];
+
+			if (node->blockName.IsNull()) continue;
+
+			node->block = gen.GetBlock(node->blockName);
+
+			if (!node->block) {
+				FD_FATAL("[ShaderGen] Block \"%s\" not defined", *node->blockName);
+				error = true;
+			}
+		}
+
+		return !error;
+	}
+};
+
+struct ShaderGenValue {
+	const String* name;
+	float32 data;
+};
+
+class ShaderGenEvaluator {
+private:
+	const char* source;
+
+	//The variables followed by the for loop variables, searched from the back
+	List<ShaderGenValue> scope;
+	//Number of names in scope starting with each character, most text can skip the name compares
+	uint32 firstChars[256];
+
+	char* output;
+	uint_t length;
+	uint_t allocated;
+
+	void Write(const char* str, uint_t size) {
+		if (length + size + 1 > allocated) {
+			uint_t newAllocated = allocated * 2 > length + size + 1 ? allocated * 2 : length + size + 1;
+			char* tmp = output;
+
+			output = (char*)Memory::Allocate(newAllocated, FD_MEMTAG_STRING);
+			memcpy(output, tmp, length);
+			Memory::Free(tmp);
+
+			allocated = newAllocated;
+		}
+
+		memcpy(output + length, str, size);
+		length += size;
+	}
+
+	//Same text as "%f", loop counters are whole numbers and don't need sprintf
+	void WriteNumber(float32 value) {
+		char buf[128];
+		int32 size = 0;
+
+		bool decimals = length == 0 || strchr(arithmetic_chars, output[length - 1]) != nullptr;
+
+		if (value == (float32)(int32)value && value > -1e9f && value < 1e9f && !(value == 0 && signbit(value))) {
+			int32 integer = (int32)value;
+			uint32 digits = integer < 0 ? (uint32)-integer : (uint32)integer;
+			char tmp[16];
+			int32 num = 0;
+
+			do {
+				tmp[num++] = (char)('0' + digits % 10);
+				digits /= 10;
+			} while (digits);
+
+			if (integer < 0) buf[size++] = '-';
+			while (num) buf[size++] = tmp[--num];
+
+			if (decimals) {
+				memcpy(buf + size, ".000000", 7);
+				size += 7;
+			}
+		} else {
+			size = sprintf(buf, "%f", value);
+
+			if (!decimals) {
+				const char* point = strchr(buf, '.');
+				if (point) size = (int32)(point - buf);
+			}
+		}
+
+		Write(buf, (uint_t)size);
+	}
+
+	const ShaderGenValue* Find(const String& name) {
+		for (uint_t i = scope.GetSize(); i > 0; i--) {
+			const ShaderGenValue& value = scope[i - 1];
+			if (*value.name == name) return &value;
+		}
+
+		return nullptr;
+	}
+
+	bool Resolve(const ShaderGenOperand& operand, float32& value) {
+		if (operand.name.IsNull()) {
+			value = operand.value;
+			return true;
+		}
+
+		const ShaderGenValue* variable = Find(operand.name);
+
+		if (!variable) {
+			FD_WARNING("[ShaderGen] Variable \"%s\" not defined", *operand.name);
+			value = 0;
+			return false;
+		}
+
+		value = variable->data;
+
+		return true;
+	}
+
+	//Longest variable name at each position is replaced by its value
+	void WriteSubstituted(const char* str, uint_t size) {
+		uint_t text = 0;
+		uint_t i = 0;
+
+		while (i < size) {
+			if (!firstChars[(byte)str[i]]) {
+				i++;
+				continue;
+			}
+
+			const ShaderGenValue* match = nullptr;
+			uint_t matchLength = 0;
+
+			for (uint_t j = scope.GetSize(); j > 0; j--) {
+				const ShaderGenValue& value = scope[j - 1];
+				uint_t nameLength = value.name->length;
+
+				if (nameLength <= matchLength || nameLength > size - i || value.name->str[0] != str[i]) continue;
+
+				if (memcmp(str + i, value.name->str, nameLength) == 0) {
+					match = &value;
+					matchLength = nameLength;
+				}
+			}
+
+			if (!match) {
+				i++;
+				continue;
+			}
+
+			Write(str + text, i - text);
+			WriteNumber(match->data);
+
+			i += matchLength;
+			text = i;
+		}
+
+		Write(str + text, size - text);
+	}
+
+	inline void AddName(const String* name) {
+		if (name->length) firstChars[(byte)name->str[0]]++;
+	}
+
+	inline void RemoveName(const String* name) {
+		if (name->length) firstChars[(byte)name->str[0]]--;
+	}
+
+	bool Test(const ShaderGenCondition* condition) {
+		switch (condition->function) {
+			case FD_TRUE:
+				return true;
+			case FD_FALSE:
+				return false;
+			case FD_DEFINED:
+				return Find(condition->variable) != nullptr;
+			default:
+				break;
+		}
+
+		const ShaderGenValue* variable = Find(condition->variable);
+
+		if (!variable) {
+			FD_WARNING("[ShaderGen] Variable \"%s\" not defined", *condition->variable);
+			return false;
+		}
+
+		float32 operand = 0;
+		Resolve(condition->operand, operand);
+
+		return Compare(variable->data, operand, condition->function);
+	}
+
+	void Generate(const ShaderGenGenerateNode* node) {
+		if (!node->block) return;
+
+		if (!node->loop) {
+			Evaluate(node->block->body);
+			return;
+		}
+
+		float32 start = 0, end = 0, increment = 0;
+
+		Resolve(node->start, start);
+		Resolve(node->end, end);
+		Resolve(node->increment, increment);
+
+		ShaderGenValue loop;
+		loop.name = &node->variable;
+		loop.data = start;
+
+		uint_t index = scope.GetSize();
+		scope.Push_back(loop);
+		AddName(loop.name);
+
+		while (Compare(scope[index].data, end, node->op)) {
+			Evaluate(node->block->body);
+
+			float32 next = scope[index].data + increment;
+
+			if (next == scope[index].data) {
+				FD_WARNING("[ShaderGen] \"for\" loop over \"%s\" never ends", *node->blockName);
+				break;
+			}
+
+			scope[index].data = next;
+		}
+
+		scope.RemoveIndex(index);
+		RemoveName(loop.name);
+	}
+
+	void Arithmetic(const ShaderGenArithmeticNode* node) {
+		const ShaderGenValue* variable = Find(node->variable);
+
+		if (!variable) {
+			FD_WARNING("[ShaderGen] Variable \"%s\" not defined", *node->variable);
+			return;
+		}
+
+		float32 operand = 0;
+		Resolve(node->operand, operand);
+
+		float32 result = 0;
+
+		switch (node->op) {
+			case '+': result = variable->data + operand; break;
+			case '-': result = variable->data - operand; break;
+			case '*': result = variable->data * operand; break;
+			case '/': result = variable->data / operand; break;
+		}
+
+		WriteNumber(result);
+	}
+
+public:
+	ShaderGenEvaluator(const String& source, const List<ShaderGenVariable*>& variables) : source(*source), scope(variables.GetSize() + 4, 4), length(0), allocated(source.length + 256) {
+		memset(firstChars, 0, sizeof(firstChars));
+
+		for (uint_t i = 0; i < variables.GetSize(); i++) {
+			ShaderGenValue value;
+
+			value.name = &variables.Get(i)->name;
+			value.data = variables.Get(i)->data;
+
+			scope.Push_back(value);
+			AddName(value.name);
+		}
+
+		//Most of the output is template text, loops grow it from there
+		output = (char*)Memory::Allocate(allocated, FD_MEMTAG_STRING);
+	}
+
+	~ShaderGenEvaluator() {
+		Memory::Free(output);
+	}
+
+	void Evaluate(const List<ShaderGenNode*>& body) {
+		for (uint_t i = 0; i < body.GetSize(); i++) {
+			const ShaderGenNode* node = body.Get(i);
+
+			switch (node->type) {
+				case FD_SHADER_GEN_NODE_TEXT: {
+					const ShaderGenTextNode* text = static_cast<const ShaderGenTextNode*>(node);
+
+					if (text->substitute) {
+						WriteSubstituted(source + text->start, text->length);
+					} else {
+						Write(source + text->start, text->length);
+					}
+
+					break;
+				}
+				case FD_SHADER_GEN_NODE_IF: {
+					const List<ShaderGenCondition*>& branches = static_cast<const ShaderGenIfNode*>(node)->branches;
+
+					for (uint_t j = 0; j < branches.GetSize(); j++) {
+						if (Test(branches.Get(j))) {
+							Evaluate(branches.Get(j)->body);
+							break;
+						}
+					}
+
+					break;
+				}
+				case FD_SHADER_GEN_NODE_GENERATE:
+					Generate(static_cast<const ShaderGenGenerateNode*>(node));
+					break;
+				case FD_SHADER_GEN_NODE_ARITHMETIC:
+					Arithmetic(static_cast<const ShaderGenArithmeticNode*>(node));
+					break;
+			}
+		}
+	}
+
+	void GetOutput(String& string) const {
+		string = String(output, length);
+	}
+};
+
+ShaderGenVariable* ShaderGen::GetVariableInternal(const String& name) const {
+	for (uint_t i = 0; i < variables.GetSize(); i++) {
+		ShaderGenVariable* variable = variables.Get(i);
+		if (variable->name == name) return variable;
+	}
+
+	return nullptr;
+}
+
+bool ShaderGen::Parse(const String& source) {
+	Clear();
+
+	this->source = source;
+
+	sourceHash = 14695981039346656037ull;
+
+	for (uint_t i = 0; i < source.length; i++) {
+		sourceHash ^= (byte)source.str[i];
+		sourceHash *= 1099511628211ull;
+	}
+
+	ShaderGenParser parser(*this);
+
+	return parser.Parse();
+}
+
+void ShaderGen::Clear() {
+	nodes.Free();
+	nodes.Clear();
+	variables.Free();
+	variables.Clear();
+	blocks.Free();
+	blocks.Clear();
+	outputs.Free();
+	outputs.Clear();
+
+	source = String();
+	sourceHash = 0;
+}
+
+void ShaderGen::SetVariable(const String& name, float32 data) {
+	ShaderGenVariable* variable = GetVariableInternal(name);
+
+	if (variable) {
+		variable->data = data;
+		FD_DEBUG("[ShaderGen] Variable \"%s\" updated. DATA: %f", *name, data);
+		return;
+	}
+
+	variable = new ShaderGenVariable;
+	variable->name = name;
+	variable->data = data;
+
+	variables.Push_back(variable);
+
+	FD_DEBUG("[ShaderGen] Variable \"%s\" doesn't exist. Creating.... with DATA: %f", *name, data);
+}
+
+void ShaderGen::UndefVariable(const String& name) {
+	ShaderGenVariable* variable = GetVariableInternal(name);
+	if (variable == nullptr) return;
+
+	variables.Remove(variable);
+
+	delete variable;
+
+	FD_DEBUG("[ShaderGen] Undefined variable \"%s\"", *name);
+}
+
+const ShaderGenVariable* ShaderGen::GetVariable(const String& name) const {
+	return GetVariableInternal(name);
+}
+
+const ShaderGenBlock* ShaderGen::GetBlock(const String& name) const {
+	for (uint_t i = 0; i < blocks.GetSize(); i++) {
+		const ShaderGenBlock* block = blocks.Get(i);
+		if (block->name == name) return block;
+	}
+
+	return nullptr;
+}
+
+uint64 ShaderGen::GetVariableHash() const {
+	uint64 hash = 0;
+
+	for (uint_t i = 0; i < variables.GetSize(); i++) {
+		const ShaderGenVariable* variable = variables.Get(i);
+
+		//FNV-1a of the name and the value bits, mixed and summed so the order doesn't matter
+		uint64 h = 14695981039346656037ull;
+
+		for (uint_t j = 0; j < variable->name.length; j++) {
+			h ^= (byte)variable->name.str[j];
+			h *= 1099511628211ull;
+		}
+
+		uint32 bits;
+		memcpy(&bits, &variable->data, sizeof(uint32));
+
+		h ^= (uint64)bits << 16;
+
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+
+		hash += h;
+	}
+
+	return hash;
+}
+
+const String& ShaderGen::Generate() {
+	uint64 hash = GetVariableHash();
+
+	for (uint_t i = 0; i < outputs.GetSize(); i++) {
+		if (outputs[i]->hash == hash) return outputs[i]->source;
+	}
+
+	ShaderGenOutput* output = new ShaderGenOutput;
+	output->hash = hash;
+
+	Generate(output->source);
+
+	outputs.Push_back(output);
+
+	return output->source;
+}
+
+void ShaderGen::Generate(String& output) const {
+	ShaderGenEvaluator evaluator(source, variables);
+
+	evaluator.Evaluate(nodes);
+	evaluator.GetOutput(output);
+}
+
+String ShaderGen::GetFunctionTypeString(FD_SHADER_GEN_FUNCTION_TYPE type) {
+	switch (type) {
+	case FD_TRUE:
+		return "true";
+	case FD_FALSE:
+		return "false";
+	case FD_DEFINED:
+		return "defined";
+	case FD_EQ:
+		return "eq";
+	case FD_NEQ:
+		return "neq";
+	case FD_GR:
+		return "gr";
+	case FD_LS:
+		return "ls";
+	case FD_GE:
+		return "ge";
+	case FD_LE:
+		return "le";
+	}
+
+	FD_WARNING("[ShaderGen] Unknown function type %d", (int32)type);
+
+	return "UNKNOWN";
+}
+
+void ShaderGen::RemoveComments(String& source) {
+	//Compacted in place, the write position never passes the read position
+	char* str = source.str;
+	uint_t length = source.length;
+	uint_t read = 0;
+	uint_t write = 0;
+
+	while (read < length) {
+		if (str[read] == '/' && read + 1 < length) {
+			if (str[read + 1] == '/') {
+				while (read < length && str[read] != '\n') read++;
+				continue;
+			} else if (str[read + 1] == '*') {
+				read += 2;
+
+				while (read + 1 < length && !(str[read] == '*' && str[read + 1] == '/')) read++;
+
+				read += 2;
+				continue;
+			}
+		}
+
+		str[write++] = str[read++];
+	}
+
+	if (str) str[write] = '\0';
+
+	source.length = write;
+}
+
+}
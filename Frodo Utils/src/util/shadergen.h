@@ -0,0 +1,112 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/list.h>
+#include <util/string.h>
+
+namespace FD {
+
+enum FD_SHADER_GEN_FUNCTION_TYPE {
+	FD_TRUE,
+	FD_FALSE,
+	FD_DEFINED,
+
+	FD_EQ,
+	FD_NEQ,
+	FD_GR,
+	FD_LS,
+	FD_GE,
+	FD_LE
+};
+
+struct ShaderGenNode;
+
+struct ShaderGenVariable {
+	String name;
+	float32 data;
+};
+
+struct ShaderGenBlock {
+	String name;
+	String code;
+
+	//code parsed into text and sg_add/sub/mul/div nodes
+	List<ShaderGenNode*> body;
+
+	ShaderGenBlock() : body(8, 8) {}
+	~ShaderGenBlock();
+};
+
+struct ShaderGenOutput {
+	uint64 hash;
+	String source;
+};
+
+/*
+ A #shaderGen template (shader_gen_api.txt). Parse reads the source once into a tree of text,
+ if/elif/else, generate and arithmetic nodes, defines and blocks are hoisted out of it the same
+ way the old string rewriting did before evaluating anything. Generate walks the tree with the
+ current variables and keeps the output keyed by a hash of the variable set, generating the
+ same permutation again is a lookup.
+*/
+class FDUAPI ShaderGen {
+private:
+	friend class ShaderGenParser;
+
+	//Text nodes point into it
+	String source;
+	uint64 sourceHash;
+
+	List<ShaderGenNode*> nodes;
+	List<ShaderGenVariable*> variables;
+	List<ShaderGenBlock*> blocks;
+	List<ShaderGenOutput*> outputs;
+
+	ShaderGenVariable* GetVariableInternal(const String& name) const;
+
+public:
+	ShaderGen() : sourceHash(0), nodes(16, 16), variables(8, 8), blocks(8, 8), outputs(4, 4) {}
+	~ShaderGen() { Clear(); }
+
+	ShaderGen(const ShaderGen& shaderGen) = delete;
+	ShaderGen& operator=(const ShaderGen& shaderGen) = delete;
+
+	//Replaces the current template, returns false on a malformed directive.
+	//Everything but the malformed directive is kept.
+	bool Parse(const String& source);
+	void Clear();
+
+	void SetVariable(const String& name, float32 data);
+	void UndefVariable(const String& name);
+
+	//nullptr when it isn't defined
+	const ShaderGenVariable* GetVariable(const String& name) const;
+	const ShaderGenBlock* GetBlock(const String& name) const;
+
+	//Same for the same names and values in any order
+	uint64 GetVariableHash() const;
+
+	//The output for the current variables, generated on the first call for a variable set.
+	//Valid until the next Parse or Clear.
+	const String& Generate();
+	//Always walks the tree
+	void Generate(String& output) const;
+
+	inline const String& GetSource() const { return source; }
+	//FNV-1a of the template, with GetVariableHash it identifies a permutation across runs
+	inline uint64 GetSourceHash() const { return sourceHash; }
+
+	inline const List<ShaderGenVariable*>& GetVariables() const { return variables; }
+	inline const List<ShaderGenBlock*>& GetBlocks() const { return blocks; }
+
+	static String GetFunctionTypeString(FD_SHADER_GEN_FUNCTION_TYPE type);
+
+	//Strips // and /* */ comments in place. Shader does it before Parse, so GetSourceHash is of the stripped template.
+	static void RemoveComments(String& source);
+};
+
+}
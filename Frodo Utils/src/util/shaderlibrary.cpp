@@ -0,0 +1,368 @@
+#include "shaderlibrary.h"
+#include "fileutils.h"
+#include <core/log.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace FD {
+
+#define FD_SHADER_LIBRARY_MAGIC 0x4C534446
+
+struct ShaderLibraryFileHeader {
+	uint32 magic;
+	uint32 version;
+	uint64 numStages;
+};
+
+class ShaderLibraryWriter {
+public:
+	List<byte> data;
+
+	ShaderLibraryWriter() : data(1 << 16, 1 << 16, FD_MEMTAG_FILE) {}
+
+	void Write(const void* src, uint_t size) {
+		uint_t offset = data.GetSize();
+
+		data.Resize(offset + size);
+		memcpy(data.GetData() + offset, src, size);
+	}
+
+	template<typename T>
+	void Write(T value) {
+		Write(&value, sizeof(T));
+	}
+
+	void Write(const String& string) {
+		Write<uint32>((uint32)string.length);
+		Write(string.str, string.length);
+	}
+
+	void Write(const List<HLSLVariable*>& members) {
+		Write<uint32>((uint32)members.GetSize());
+
+		for (uint_t i = 0; i < members.GetSize(); i++) {
+			const HLSLVariable* var = members.Get(i);
+
+			Write(var->name);
+			Write(var->typeName);
+			Write(var->semantic);
+			Write<uint32>(var->type);
+			Write(var->rows);
+			Write(var->columns);
+			Write<uint32>(var->rowMajor);
+			Write(var->arraySize);
+			Write(var->structIndex);
+			Write(var->offset);
+			Write(var->size);
+			Write(var->stride);
+		}
+	}
+
+	void Write(const List<HLSLResource*>& resources) {
+		Write<uint32>((uint32)resources.GetSize());
+
+		for (uint_t i = 0; i < resources.GetSize(); i++) {
+			const HLSLResource* res = resources.Get(i);
+
+			Write(res->name);
+			Write<uint32>(res->type);
+			Write<uint32>(res->readWrite);
+			Write(res->semRegister);
+			Write(res->space);
+			Write(res->arraySize);
+		}
+	}
+};
+
+//Every read is bounds checked, a truncated file sets failed and reads zeros from there on
+class ShaderLibraryReader {
+public:
+	const byte* current;
+	const byte* end;
+	bool failed;
+
+	ShaderLibraryReader(const byte* data, uint_t size) : current(data), end(data + size), failed(false) {}
+
+	void Read(void* dst, uint_t size) {
+		if (failed || (uint_t)(end - current) < size) {
+			failed = true;
+			memset(dst, 0, size);
+			return;
+		}
+
+		memcpy(dst, current, size);
+		current += size;
+	}
+
+	template<typename T>
+	T Read() {
+		T value;
+		Read(&value, sizeof(T));
+
+		return value;
+	}
+
+	String ReadString() {
+		uint32 length = Read<uint32>();
+
+		if (failed || (uint_t)(end - current) < length) {
+			failed = true;
+			return String();
+		}
+
+		String string((char*)current, length);
+		current += length;
+
+		return string;
+	}
+
+	//A count can't be bigger than the bytes left, stops a corrupt count from allocating everything
+	uint32 ReadCount() {
+		uint32 count = Read<uint32>();
+
+		if ((uint_t)(end - current) < count) failed = true;
+
+		return failed ? 0 : count;
+	}
+
+	void Read(List<HLSLVariable*>& members) {
+		uint32 count = ReadCount();
+
+		for (uint32 i = 0; i < count; i++) {
+			HLSLVariable* var = new HLSLVariable;
+
+			var->name = ReadString();
+			var->typeName = ReadString();
+			var->semantic = ReadString();
+			var->type = (FD_HLSL_TYPE)Read<uint32>();
+			var->rows = Read<uint32>();
+			var->columns = Read<uint32>();
+			var->rowMajor = Read<uint32>() != 0;
+			var->arraySize = Read<uint32>();
+			var->structIndex = Read<uint32>();
+			var->offset = Read<uint32>();
+			var->size = Read<uint32>();
+			var->stride = Read<uint32>();
+
+			members.Push_back(var);
+		}
+	}
+
+	void Read(List<HLSLResource*>& resources) {
+		uint32 count = ReadCount();
+
+		for (uint32 i = 0; i < count; i++) {
+			HLSLResource* res = new HLSLResource;
+
+			res->name = ReadString();
+			res->type = (FD_HLSL_RESOURCE_TYPE)Read<uint32>();
+			res->readWrite = Read<uint32>() != 0;
+			res->semRegister = Read<int32>();
+			res->space = Read<uint32>();
+			res->arraySize = Read<uint32>();
+
+			resources.Push_back(res);
+		}
+	}
+};
+
+void ShaderLibrary::Add(ShaderLibraryStage* stage) {
+	uint_t size = stages.GetSize();
+	uint_t index = 0;
+
+	//Binary search for the insert position
+	uint_t count = size;
+
+	while (count > 0) {
+		uint_t half = count / 2;
+
+		if (stages[index + half]->key < stage->key) {
+			index += half + 1;
+			count -= half + 1;
+		} else {
+			count = half;
+		}
+	}
+
+	if (index < size && stages[index]->key == stage->key) {
+		delete stage;
+		return;
+	}
+
+	stages.Resize(size + 1);
+
+	ShaderLibraryStage** data = stages.GetData();
+
+	memmove(data + index + 1, data + index, (size - index) * sizeof(ShaderLibraryStage*));
+	data[index] = stage;
+}
+
+const ShaderLibraryStage* ShaderLibrary::Find(uint64 key) const {
+	uint_t first = 0;
+	uint_t last = stages.GetSize();
+
+	while (first < last) {
+		uint_t middle = (first + last) / 2;
+		ShaderLibraryStage* stage = stages.Get(middle);
+
+		if (stage->key == key) return stage;
+
+		if (stage->key < key) first = middle + 1;
+		else last = middle;
+	}
+
+	return nullptr;
+}
+
+bool ShaderLibrary::Write(const String& filename) const {
+	ShaderLibraryWriter writer;
+
+	ShaderLibraryFileHeader header;
+
+	header.magic = FD_SHADER_LIBRARY_MAGIC;
+	header.version = FD_SHADER_LIBRARY_VERSION;
+	header.numStages = stages.GetSize();
+
+	writer.Write(header);
+
+	for (uint_t i = 0; i < stages.GetSize(); i++) {
+		const ShaderLibraryStage* stage = stages.Get(i);
+		const HLSLReflection& reflection = stage->reflection;
+
+		writer.Write(stage->key);
+		writer.Write(stage->source);
+
+		writer.Write<uint32>((uint32)stage->byteCodeSize);
+		writer.Write(stage->byteCode, stage->byteCodeSize);
+
+		writer.Write<uint32>((uint32)reflection.structs.GetSize());
+
+		for (uint_t j = 0; j < reflection.structs.GetSize(); j++) {
+			const HLSLStruct* s = reflection.structs.Get(j);
+
+			writer.Write(s->name);
+			writer.Write(s->size);
+			writer.Write(s->members);
+		}
+
+		writer.Write<uint32>((uint32)reflection.cbuffers.GetSize());
+
+		for (uint_t j = 0; j < reflection.cbuffers.GetSize(); j++) {
+			const HLSLConstantBuffer* b = reflection.cbuffers.Get(j);
+
+			writer.Write(b->name);
+			writer.Write(b->semRegister);
+			writer.Write(b->space);
+			writer.Write(b->size);
+			writer.Write(b->members);
+		}
+
+		writer.Write(reflection.textures);
+		writer.Write(reflection.samplers);
+	}
+
+	FILE* file = fopen(*filename, "wb");
+
+	if (!file) {
+		FD_WARNING("[ShaderLibrary] Failed to write \"%s\"", *filename);
+		return false;
+	}
+
+	FDWriteFile(file, writer.data.GetData(), writer.data.GetSize());
+
+	fclose(file);
+
+	return true;
+}
+
+bool ShaderLibrary::Read(const String& filename) {
+	Clear();
+
+	//FDReadBinaryFile treats a missing file as fatal, a missing library isn't
+	FILE* file = fopen(*filename, "rb");
+
+	if (!file) return false;
+
+	fclose(file);
+
+	uint_t size = 0;
+	byte* data = FDReadBinaryFile(filename, &size);
+
+	ShaderLibraryReader reader(data, size);
+
+	ShaderLibraryFileHeader header = reader.Read<ShaderLibraryFileHeader>();
+
+	if (header.magic != FD_SHADER_LIBRARY_MAGIC || header.version != FD_SHADER_LIBRARY_VERSION) {
+		FD_WARNING("[ShaderLibrary] \"%s\" isn't a version %u shader library", *filename, FD_SHADER_LIBRARY_VERSION);
+		Memory::Free(data);
+		return false;
+	}
+
+	stages.Reserve((uint_t)header.numStages < size ? (uint_t)header.numStages : size);
+
+	for (uint64 i = 0; i < header.numStages && !reader.failed; i++) {
+		ShaderLibraryStage* stage = new ShaderLibraryStage;
+		HLSLReflection& reflection = stage->reflection;
+
+		stage->key = reader.Read<uint64>();
+		stage->source = reader.ReadString();
+
+		uint32 byteCodeSize = reader.ReadCount();
+
+		if (byteCodeSize) {
+			stage->byteCode = (byte*)Memory::Allocate(byteCodeSize, FD_MEMTAG_ASSET);
+			stage->byteCodeSize = byteCodeSize;
+
+			reader.Read(stage->byteCode, byteCodeSize);
+		}
+
+		uint32 numStructs = reader.ReadCount();
+
+		for (uint32 j = 0; j < numStructs; j++) {
+			HLSLStruct* s = new HLSLStruct;
+
+			s->name = reader.ReadString();
+			s->size = reader.Read<uint32>();
+			reader.Read(s->members);
+
+			reflection.structs.Push_back(s);
+		}
+
+		uint32 numCBuffers = reader.ReadCount();
+
+		for (uint32 j = 0; j < numCBuffers; j++) {
+			HLSLConstantBuffer* b = new HLSLConstantBuffer;
+
+			b->name = reader.ReadString();
+			b->semRegister = reader.Read<int32>();
+			b->space = reader.Read<uint32>();
+			b->size = reader.Read<uint32>();
+			reader.Read(b->members);
+
+			reflection.cbuffers.Push_back(b);
+		}
+
+		reader.Read(reflection.textures);
+		reader.Read(reflection.samplers);
+
+		//Written in key order so it's always added at the end
+		Add(stage);
+	}
+
+	Memory::Free(data);
+
+	if (reader.failed) {
+		FD_WARNING("[ShaderLibrary] \"%s\" is truncated", *filename);
+		Clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ShaderLibrary::Clear() {
+	stages.Free();
+	stages.Clear();
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/list.h>
+#include <util/string.h>
+#include <util/hlslreflection.h>
+
+//Bump when the file layout changes, older libraries are rejected by Read
+#define FD_SHADER_LIBRARY_VERSION 1
+
+namespace FD {
+
+//One shader stage permutation, generated and reflected offline
+struct ShaderLibraryStage {
+	//ShaderCache::MakeKey(template hash, ShaderGen variable hash, target profile)
+	uint64 key;
+
+	String source;
+	HLSLReflection reflection;
+
+	//nullptr when the library was built without a compiler (not on Windows)
+	byte* byteCode;
+	uint_t byteCodeSize;
+
+	ShaderLibraryStage() : key(0), byteCode(nullptr), byteCodeSize(0) {}
+	~ShaderLibraryStage() { Memory::Free(byteCode); }
+};
+
+/*
+ Permutations baked by FormatConverter's shader build, looked up with the same key as the
+ ShaderCache. The file stores the generated source, the reflection and the bytecode of every
+ stage as binary so Read only copies them out, nothing is parsed at load time.
+
+ Stages are kept sorted by key.
+*/
+class FDUAPI ShaderLibrary {
+private:
+	List<ShaderLibraryStage*> stages;
+
+public:
+	ShaderLibrary() : stages(64, 64) {}
+	~ShaderLibrary() { Clear(); }
+
+	ShaderLibrary(const ShaderLibrary& library) = delete;
+	ShaderLibrary& operator=(const ShaderLibrary& library) = delete;
+
+	//Takes ownership, a stage with a key that is already in the library is deleted
+	void Add(ShaderLibraryStage* stage);
+	//nullptr when it isn't in the library
+	const ShaderLibraryStage* Find(uint64 key) const;
+
+	bool Write(const String& filename) const;
+	//Replaces the current stages, false when the file is missing, truncated or from another version
+	bool Read(const String& filename);
+	void Clear();
+
+	inline const List<ShaderLibraryStage*>& GetStages() const { return stages; }
+};
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <fdu.h>
+#include <atomic>
+
+namespace FD {
+
+/*
+ Hands states from one writer thread to one reader thread without locking, e.g. the
+ simulation publishing what the renderer draws. The reader keeps the two latest states
+ it has seen so it can interpolate between them.
+
+ There are 4 states: the writer fills one, one is waiting to be picked up and the reader
+ holds the other 2. Publish and Acquire only swap indices. The state returned by
+ GetWriteState holds old data, overwrite all of it before publishing.
+*/
+template<typename T>
+class StateBuffer {
+private:
+	//Set in middle when it holds a state the reader hasn't picked up
+	static const uint32 FRESH = 0x4;
+
+	T states[4];
+	float64 times[4];
+
+	//Writer
+	uint32 back;
+	//Shared
+	std::atomic<uint32> middle;
+	//Reader
+	uint32 current;
+	uint32 previous;
+
+public:
+	StateBuffer() : back(0), middle(1), current(2), previous(3) {
+		for (uint32 i = 0; i < 4; i++) times[i] = 0.0;
+	}
+
+	StateBuffer(const StateBuffer<T>& buffer) = delete;
+	StateBuffer<T>& operator=(const StateBuffer<T>& buffer) = delete;
+
+	inline T& GetWriteState() { return states[back]; }
+
+	//time is when the state is valid, usually the simulation time after the step
+	inline void Publish(float64 time) {
+		times[back] = time;
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & 3;
+	}
+
+	//Picks up the latest published state, returns false if nothing new was published.
+	//States published in between are skipped.
+	inline bool Acquire() {
+		if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+
+		uint32 old = previous;
+
+		previous = current;
+		current = middle.exchange(old, std::memory_order_acq_rel) & 3;
+
+		return true;
+	}
+
+	inline const T& GetCurrent() const { return states[current]; }
+	inline const T& GetPrevious() const { return states[previous]; }
+	inline float64 GetCurrentTime() const { return times[current]; }
+	inline float64 GetPreviousTime() const { return times[previous]; }
+
+	//Blend factor from the previous to the current state for rendering at time, running one
+	//state behind the simulation so there is always something to interpolate towards
+	inline float32 GetAlpha(float64 time) const {
+		float64 length = times[current] - times[previous];
+
+		if (length <= 0.0) return 1.0f;
+
+		float64 alpha = (time - times[current]) / length;
+
+		return (float32)(alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha));
+	}
+};
+
+}
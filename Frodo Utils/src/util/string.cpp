@@ -5,14 +5,17 @@
 
 namespace FD {
 
-String::String(const char* string) {
+String::String(const char* string, FD_MEMTAG tag) {
+	this->tag = tag;
+
 	if (!string) {
 		length = 0;
 		str = nullptr;
+		noDelete = false;
 		return;
 	}
 	length = strlen(string);
-	str = new char[length + 1];
+	str = (char*)Memory::Allocate(length + 1, tag);
 	str[length] = '\0';
 	memcpy(str, string, length);
 
@@ -20,15 +23,18 @@ String::String(const char* string) {
 }
 
 String::String(const wchar_t* string) {
+	tag = FD_MEMTAG_STRING;
+
 	if (!string) {
 		length = 0;
 		str = nullptr;
+		noDelete = false;
 		return;
 	}
 
 	length = wcslen(string);
 
-	str = new char[length + 1];
+	str = (char*)Memory::Allocate(length + 1, tag);
 
 	sprintf(str, "%S", string);
 
@@ -37,10 +43,13 @@ String::String(const wchar_t* string) {
 	noDelete = false;
 }
 
-String::String(char* string, uint_t length, bool noCopy) {
+String::String(char* string, uint_t length, bool noCopy, FD_MEMTAG tag) {
+	this->tag = tag;
+
 	if (!string) {
 		this->length = 0;
 		str = nullptr;
+		noDelete = false;
 		return;
 	}
 	if (noCopy) {
@@ -49,7 +58,7 @@ String::String(char* string, uint_t length, bool noCopy) {
 		noDelete = true;
 	} else {
 		this->length = length;
-		str = new char[length + 1];
+		str = (char*)Memory::Allocate(length + 1, tag);
 		str[length] = '\0';
 		memcpy(str, string, length);
 
@@ -57,45 +66,41 @@ String::String(char* string, uint_t length, bool noCopy) {
 	}
 }
 
-String::String(const String& string) {
+String::String(const String& string) : String(string, FD_MEMTAG_STRING) {}
+
+String::String(const String& string, FD_MEMTAG tag) {
 	this->length = string.length;
+	this->tag = tag;
 
-	str = new char[length + 1];
+	str = (char*)Memory::Allocate(length + 1, tag);
 	str[length] = 0;
 	memcpy(str, string.str, length);
 
 	noDelete = false;
 }
 
-String::String(const String* string) {
-	this->length = string->length;
-
-	str = new char[length + 1];
-	str[length] = 0;
-	memcpy(str, string->str, length);
-
-	noDelete = false;
-}
+String::String(const String* string) : String(*string, FD_MEMTAG_STRING) {}
 
 String::String(String&& string) {
 	this->length = 0;
 	this->str = nullptr;
-	*this = std::move(string);
-
 	noDelete = false;
+	tag = FD_MEMTAG_STRING;
+	*this = std::move(string);
 }
 
 String::~String() {
-	if (!noDelete) delete[] str;
+	if (!noDelete) Memory::Free(str);
 	str = nullptr;
 }
 
+//Keeps the tag of this string, a frame string copied into a regular one stays on the heap
 String& String::operator=(const String& string) {
 	if (this != &string) {
-		delete[] str;
+		if (!noDelete) Memory::Free(str);
 		length = string.length;
 
-		str = new char[length + 1];
+		str = (char*)Memory::Allocate(length + 1, tag);
 		str[length] = 0;
 		memcpy(str, string.str, length);
 	}
@@ -105,32 +110,39 @@ String& String::operator=(const String& string) {
 	return *this;
 }
 
+//Frame memory is gone after the next EndFrame, taking it over would let the string outlive
+//it. Those are copied instead, into memory with the tag of this string.
 String& String::operator=(String&& string) {
+	if (string.tag == FD_MEMTAG_FRAME) return *this = (const String&)string;
+
 	if (this != &string) {
-		delete[] str;
+		if (!noDelete) Memory::Free(str);
 		length = string.length;
 
 		str = string.str;
+		//A borrowed buffer stays borrowed
+		noDelete = string.noDelete;
+		tag = string.tag;
 
 		string.length = 0;
 		string.str = nullptr;
+		string.noDelete = false;
 	}
 
-	noDelete = false;
-
 	return *this;
 }
 
 String& String::Append(const char character) {
 	char* tmpstr = str;
-	str = new char[length + 2];
+	str = (char*)Memory::Allocate(length + 2, tag);
 	str[length+1] = 0;
 	memcpy(str, tmpstr, length);
 	str[length] = character;
 
 	length++;
 
-	delete[] tmpstr;
+	if (!noDelete) Memory::Free(tmpstr);
+	noDelete = false;
 
 	return *this;
 }
@@ -138,13 +150,14 @@ String& String::Append(const char character) {
 String& String::Append(const String& string) {
 	uint_t newlen = length + string.length;
 	char* tmpstr = str;
-	str = new char[newlen + 1];
+	str = (char*)Memory::Allocate(newlen + 1, tag);
 	str[newlen] = 0;
 	memcpy(str, tmpstr, length);
 	memcpy(str + length, string.str, string.length);
 	length = newlen;
 
-	delete[] tmpstr;
+	if (!noDelete) Memory::Free(tmpstr);
+	noDelete = false;
 
 	return *this;
 }
@@ -185,14 +198,15 @@ String& String::Remove(uint_t start, uint_t end) {
 
 	char* tmp = str;
 
-	str = new char[newlen + 1];
+	str = (char*)Memory::Allocate(newlen + 1, tag);
 	memcpy(str, tmp, start);
 	memcpy(str + start, tmp + start + len, newlen - start);
 
 	length = newlen;
 	str[length] = '\0';
 
-	delete[] tmp;
+	if (!noDelete) Memory::Free(tmp);
+	noDelete = false;
 
 	return *this;
 }
@@ -226,8 +240,8 @@ String& String::RemoveBlankspace() {
 	return *this;
 }
 
-String String::SubString(uint_t start, uint_t end) const {
-	return String(str + start, end - start);
+String String::SubString(uint_t start, uint_t end, FD_MEMTAG tag) const {
+	return String(str + start, end - start, false, tag);
 }
 
 uint_t String::Count(const String& string, uint_t offset) const {
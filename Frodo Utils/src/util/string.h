@@ -1,9 +1,14 @@
 #pragma once
 #include <fdu.h>
+#include <core/memory.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 namespace FD {
 
+template<typename T>
+class List;
+
 class FDUAPI String {
 private:
 	template<typename T>
@@ -14,12 +19,16 @@ public:
 
 	bool noDelete;
 
+private:
+	FD_MEMTAG tag;
+
 public:
-	String() { str = nullptr; length = 0; }
-	String(const char* string);
+	String() { str = nullptr; length = 0; noDelete = false; tag = FD_MEMTAG_STRING; }
+	String(const char* string, FD_MEMTAG tag = FD_MEMTAG_STRING);
 	String(const wchar_t* string);
-	String(char* string, uint_t length, bool noCopy = false);
+	String(char* string, uint_t length, bool noCopy = false, FD_MEMTAG tag = FD_MEMTAG_STRING);
 	String(const String& string);
+	String(const String& string, FD_MEMTAG tag);
 	String(const String* string);
 	String(String&& string);
 	~String();
@@ -37,7 +46,7 @@ public:
 	String& Remove(uint_t start, uint_t end);
 	String& RemoveBlankspace();
 
-	String  SubString(uint_t start, uint_t end) const;
+	String  SubString(uint_t start, uint_t end, FD_MEMTAG tag = FD_MEMTAG_STRING) const;
 
 	uint_t Count(const String& string, uint_t offset = 0) const;
 
@@ -62,10 +71,13 @@ public:
 	inline char* operator*() const { return str; }
 
 	inline void SetNoDelete(bool nodelete) { this->noDelete = nodelete; }
+	//Only affects allocations made after the call
+	inline void SetMemoryTag(FD_MEMTAG tag) { this->tag = tag; }
+	inline FD_MEMTAG GetMemoryTag() const { return tag; }
 
 	inline wchar_t* GetWCHAR() const {
 		wchar_t* tmp = new wchar_t[length + 1];
-		swprintf_s(tmp, length + 1, L"%S", str);
+		mbstowcs(tmp, str, length + 1);
 		tmp[length] = '\0';
 		return tmp;
 	}
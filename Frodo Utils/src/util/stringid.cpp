@@ -0,0 +1,96 @@
+#include "stringid.h"
+#include "list.h"
+#include <core/log.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+namespace FD {
+
+struct StringIDEntry {
+	uint64 hash;
+	String name;
+};
+
+//Sorted by hash, destroyed with the other statics
+struct StringIDTable {
+	std::mutex mutex;
+	List<StringIDEntry*> entries;
+
+	StringIDTable() : entries(256, 256) {}
+	~StringIDTable() { entries.Free(); }
+
+	//Index of the first entry with a hash >= hash
+	uint_t LowerBound(uint64 hash) const {
+		uint_t index = 0;
+		uint_t count = entries.GetSize();
+
+		while (count > 0) {
+			uint_t half = count / 2;
+
+			if (entries.Get(index + half)->hash < hash) {
+				index += half + 1;
+				count -= half + 1;
+			} else {
+				count = half;
+			}
+		}
+
+		return index;
+	}
+};
+
+static StringIDTable& GetTable() {
+	static StringIDTable table;
+
+	return table;
+}
+
+StringID StringID::Intern(const String& name) {
+	StringID id(name);
+	StringIDTable& table = GetTable();
+
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	uint_t size = table.entries.GetSize();
+	uint_t index = table.LowerBound(id.hash);
+
+	if (index < size && table.entries[index]->hash == id.hash) {
+		if (table.entries[index]->name != name) FD_WARNING("[StringID] \"%s\" and \"%s\" have the same ID", *table.entries[index]->name, *name);
+
+		return id;
+	}
+
+	StringIDEntry* entry = new StringIDEntry;
+
+	entry->hash = id.hash;
+	entry->name = name;
+
+	table.entries.Resize(size + 1);
+
+	StringIDEntry** data = table.entries.GetData();
+
+	memmove(data + index + 1, data + index, (size - index) * sizeof(StringIDEntry*));
+	data[index] = entry;
+
+	return id;
+}
+
+String StringID::GetString(StringID id) {
+	StringIDTable& table = GetTable();
+
+	{
+		std::lock_guard<std::mutex> lock(table.mutex);
+
+		uint_t index = table.LowerBound(id.hash);
+
+		if (index < table.entries.GetSize() && table.entries[index]->hash == id.hash) return table.entries[index]->name;
+	}
+
+	char hex[19];
+	snprintf(hex, sizeof(hex), "0x%016llx", (unsigned long long)id.hash);
+
+	return String(hex);
+}
+
+}
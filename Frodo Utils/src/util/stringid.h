@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4251)
+#endif
+
+#include <fdu.h>
+#include <util/string.h>
+#include <type_traits>
+
+//ID of a string literal, always hashed at compile time because the hash is a template argument
+#define FD_SID(str) (FD::StringID(std::integral_constant<uint64, FD::StringID::Hash(str)>::value))
+
+namespace FD {
+
+/*
+ 64 bit FNV-1a hash of a name, names are hashed once (FD_SID in code, Intern where reflection
+ creates them) and compared as integers after that. Only construction from a hash or an
+ explicit String is allowed so it never converts from a slot index or a literal by accident.
+
+ Intern keeps the name for GetString and warns when two different names hash to the same ID.
+ Any thread can use it.
+*/
+class FDUAPI StringID {
+private:
+	uint64 hash;
+
+public:
+	constexpr StringID() : hash(0) {}
+	constexpr explicit StringID(uint64 hash) : hash(hash) {}
+	//Hashed at runtime, isn't interned
+	explicit StringID(const String& name) : hash(Hash(name.str, name.length)) {}
+
+	constexpr bool operator==(const StringID& other) const { return hash == other.hash; }
+	constexpr bool operator!=(const StringID& other) const { return hash != other.hash; }
+	constexpr bool operator<(const StringID& other) const { return hash < other.hash; }
+
+	constexpr uint64 GetHash() const { return hash; }
+
+	static constexpr uint64 Hash(const char* str) {
+		uint64 result = 14695981039346656037ull;
+
+		while (*str) {
+			result ^= (byte)*str++;
+			result *= 1099511628211ull;
+		}
+
+		return result;
+	}
+
+	static constexpr uint64 Hash(const char* str, uint_t length) {
+		uint64 result = 14695981039346656037ull;
+
+		for (uint_t i = 0; i < length; i++) {
+			result ^= (byte)str[i];
+			result *= 1099511628211ull;
+		}
+
+		return result;
+	}
+
+	static StringID Intern(const String& name);
+	//The interned name, the hash in hex when it was never interned
+	static String GetString(StringID id);
+};
+
+}
@@ -36,8 +36,8 @@ void VFS::UnMount(const String& name) {
 	mountPoints.Remove(name);
 }
 
-byte* VFS::ReadFile(const String& filename, uint_t* fileSize) {
-	return FDReadBinaryFile(ResolvePath(filename), fileSize);
+byte* VFS::ReadFile(const String& filename, uint_t* fileSize, FD_MEMTAG tag) {
+	return FDReadBinaryFile(ResolvePath(filename), fileSize, tag);
 }
 
 String VFS::ReadTextFile(const String& filename) {
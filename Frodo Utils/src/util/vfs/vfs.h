@@ -1,8 +1,9 @@
 #pragma once
 
+#ifdef _MSC_VER
 #pragma warning(disable : 4251)
+#endif
 
-#include <Windows.h>
 #include <fdu.h>
 #include <util/string.h>
 #include <util/list.h>
@@ -33,7 +34,8 @@ public:
 
 	void Mount(const String& name, const String& path);
 	void UnMount(const String& name);
-	byte* ReadFile(const String& filename, uint_t* fileSize = nullptr);
+	//The returned buffer is released with Memory::Free
+	byte* ReadFile(const String& filename, uint_t* fileSize = nullptr, FD_MEMTAG tag = FD_MEMTAG_FILE);
 	String ReadTextFile(const String& filename);
 
 	String ResolvePath(const String& vpath);
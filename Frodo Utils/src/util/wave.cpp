@@ -37,26 +37,38 @@ inline bool VerifyWave(WAVE* w) {
 
 WAVE* FDReadWaveFile(const String& filename) {
 
-	uint_t waveSize;
+	uint_t waveSize = 0;
 
 	byte* waveFile = VFS::Get()->ReadFile(filename, &waveSize);
 
+	//audioData is padded to 8 bytes on x64, the header in the file is not
+	uint_t headerSize = sizeof(WAVE_RIFF) + sizeof(WAVE_FORMAT) + sizeof(WAVE_DATA);
+
+	if (waveSize < headerSize) {
+		FD_FATAL("Invalid WAVE file: %s", *filename);
+		Memory::Free(waveFile);
+		return nullptr;
+	}
+
 	WAVE* wave = new WAVE;
 
-	memcpy(wave, waveFile, (uint_t)OFFSETOF(WAVE, audioData));
+	memcpy(&wave->riff, waveFile, sizeof(WAVE_RIFF));
+	memcpy(&wave->format, waveFile + sizeof(WAVE_RIFF), sizeof(WAVE_FORMAT));
+	memcpy(&wave->data, waveFile + sizeof(WAVE_RIFF) + sizeof(WAVE_FORMAT), sizeof(WAVE_DATA));
+	wave->audioData = nullptr;
 
-	if (!VerifyWave(wave)) {
+	if (!VerifyWave(wave) || wave->data.SubChunkSize > waveSize - headerSize) {
 		FD_FATAL("Couldn't verify WAVE header: %s", *filename);
-		delete[] waveFile;
+		Memory::Free(waveFile);
 		delete wave;
 		return nullptr;
 	}
 	
-	wave->audioData = new byte[wave->data.SubChunkSize];
+	wave->audioData = (byte*)Memory::Allocate(wave->data.SubChunkSize, FD_MEMTAG_AUDIO);
 
-	memcpy(wave->audioData, waveFile + (uint_t)OFFSETOF(WAVE, audioData), wave->data.SubChunkSize);
+	memcpy(wave->audioData, waveFile + headerSize, wave->data.SubChunkSize);
 
-	delete[] waveFile;
+	Memory::Free(waveFile);
 
 	return wave;
 }
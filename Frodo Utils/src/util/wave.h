@@ -2,6 +2,7 @@
 
 #include <fdu.h>
 #include <util/string.h>
+#include <core/memory.h>
 
 namespace FD {
 
@@ -33,7 +34,7 @@ struct WAVE {
 	WAVE_DATA data;
 	byte* audioData;
 
-	~WAVE() { delete[] audioData; }
+	~WAVE() { Memory::Free(audioData); }
 };
 
 
@@ -1,10 +1,13 @@
 #include "audio.h"
 #include <fdutils.h>
 #include <core/log.h>
+#include <core/profiler.h>
 
 namespace FD {
 
 Audio::Audio(const String& filename) {
+	FD_PROFILE_SCOPE("Audio::Audio");
+
 	sourceVoice = nullptr;
 	wave = FDReadWaveFile(filename);
 
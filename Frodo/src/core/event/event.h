@@ -1,5 +1,11 @@
 #pragma once
 
+#include <fd.h>
+#include <util/mpscqueue.h>
+
+//Largest event type that can be created with new, see Event::operator new
+#define FD_EVENT_MAX_SIZE 32
+
 namespace FD {
 
 enum FD_EVENT_ACTION {
@@ -46,10 +52,22 @@ enum FD_EVENT_TYPE {
 	FD_KEYBOARD_EVENT,
 	FD_KEYBOARD_ACTION_KEY_PRESSED,
 	FD_KEYBOARD_ACTION_KEY_RELEASED,
-	FD_KEYBOARD_ACTION_KEY_HOLD
+	FD_KEYBOARD_ACTION_KEY_HOLD,
+
+	FD_EVENT_TYPE_COUNT
 };
 
-class Event {
+//Listeners subscribe to a set of event types, see EventListener
+#define FD_EVENT_MASK(type) (1u << (type))
+
+#define FD_EVENT_MASK_MOUSE (FD_EVENT_MASK(FD_MOUSE_ACTION_MOVE) | FD_EVENT_MASK(FD_MOUSE_ACTION_MOVE_ABSOLUTE) | FD_EVENT_MASK(FD_MOUSE_ACTION_MOVE_RELATIVE) | FD_EVENT_MASK(FD_MOUSE_ACTION_BUTTON_PRESSED) | FD_EVENT_MASK(FD_MOUSE_ACTION_BUTTON_RELEASED) | FD_EVENT_MASK(FD_MOUSE_ACTION_BUTTON_HOLD))
+#define FD_EVENT_MASK_WINDOW (FD_EVENT_MASK(FD_WINDOW_ACTION_RESIZE) | FD_EVENT_MASK(FD_WINDOW_ACTION_MOVE) | FD_EVENT_MASK(FD_WINDOW_STATE_MINIMIZED) | FD_EVENT_MASK(FD_WINDOW_STATE_MAXIMIZED) | FD_EVENT_MASK(FD_WINDOW_STATE_FOCUS_GAINED) | FD_EVENT_MASK(FD_WINDOW_STATE_FOCUS_LOST))
+#define FD_EVENT_MASK_WINDOW_STATE (FD_EVENT_MASK(FD_WINDOW_STATE_MINIMIZED) | FD_EVENT_MASK(FD_WINDOW_STATE_MAXIMIZED) | FD_EVENT_MASK(FD_WINDOW_STATE_FOCUS_GAINED) | FD_EVENT_MASK(FD_WINDOW_STATE_FOCUS_LOST))
+#define FD_EVENT_MASK_KEYBOARD (FD_EVENT_MASK(FD_KEYBOARD_ACTION_KEY_PRESSED) | FD_EVENT_MASK(FD_KEYBOARD_ACTION_KEY_RELEASED) | FD_EVENT_MASK(FD_KEYBOARD_ACTION_KEY_HOLD))
+#define FD_EVENT_MASK_ALL 0xFFFFFFFF
+
+//MPSCNode links the event into EventDispatcher's queue when dispatch is queued
+class Event : public MPSCNode {
 protected:
 	FD_EVENT_TYPE type;
 
@@ -57,6 +75,10 @@ public:
 	Event(FD_EVENT_TYPE type) { this->type = type; }
 
 	inline FD_EVENT_TYPE GetEventType() const { return type; }
+
+	//Events are created at input rate and deleted by EventDispatcher, they come from a pool of FD_EVENT_MAX_SIZE slots
+	FDAPI static void* operator new(size_t size);
+	FDAPI static void operator delete(void* event);
 };
 
 }
\ No newline at end of file
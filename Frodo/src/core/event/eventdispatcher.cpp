@@ -1,12 +1,38 @@
 #include "eventdispatcher.h"
 #include "eventlistener.h"
+#include <util/objectpool.h>
+#include <core/log.h>
 
 namespace FD {
 
-List<EventListener*> EventDispatcher::listeners;
+struct EventSlot {
+	alignas(16) byte data[FD_EVENT_MAX_SIZE];
+};
+
+static ObjectPool<EventSlot> eventPool(256);
+
+void* Event::operator new(size_t size) {
+	FD_ASSERT_MSG(size > FD_EVENT_MAX_SIZE, "Event type larger than FD_EVENT_MAX_SIZE");
+
+	void* event = eventPool.Acquire();
+
+	FD_ASSERT_MSG(event == nullptr, "Event pool is full, events are not being deleted");
+
+	return event;
+}
+
+void Event::operator delete(void* event) {
+	eventPool.Release((EventSlot*)event);
+}
+
+ListenerTable<EventListener, FD_EVENT_TYPE_COUNT> EventDispatcher::listeners;
+
+MPSCQueue<Event> EventDispatcher::queue;
+std::atomic<uint32> EventDispatcher::queuedEvents(0);
+std::atomic<bool> EventDispatcher::queued(false);
 
 void EventDispatcher::AddListener(EventListener* listener) {
-	listeners.Push_back(listener);
+	listeners.Add(listener);
 }
 
 void EventDispatcher::RemoveListener(EventListener* listener) {
@@ -14,96 +40,168 @@ void EventDispatcher::RemoveListener(EventListener* listener) {
 }
 
 void EventDispatcher::DispatchEvent(const Event* event) {
-	uint_t num = listeners.GetSize();
-
-	for (uint_t i = 0; i < num; i++) {
-		EventListener* listener = listeners[i];
-		listener->OnEvent(event);
-
-		bool ret = false;
-
-		static const EventKeyboardActionKey* keyboardActionKey;
-		static const EventWindowState* windowState;
-		static const EventWindowActionMove* windowActionMove;
-		static const EventWindowActionResize* windowActionResize;
-		static const EventMouseActionMove* mouseActionMove;
-		static const EventMouseActionButton* mouseActionButton;
-
-		switch (event->GetEventType()) {
-			case FD_MOUSE_ACTION_MOVE:
-			case FD_MOUSE_ACTION_MOVE_ABSOLUTE:
-			case FD_MOUSE_ACTION_MOVE_RELATIVE: {
-				mouseActionMove = (const EventMouseActionMove*)event;
-				listener->OnEvent(mouseActionMove);
-				ivec2 pos = mouseActionMove->GetPosition();
-				ret = listener->OnMouseActionMove(pos);
-				switch (mouseActionMove->GetAction()) {
-				case FD_ABSOLUTE:
-					listener->OnMouseActionMoveAbsolute(pos);
-						break;
-				case FD_RELATIVE:
-					listener->OnMouseActionMoveRelative(pos);
-					break;
+	if (queued.load(std::memory_order_acquire)) {
+		PostEvent((Event*)event);
+		return;
+	}
+
+	Dispatch(event);
+}
+
+void EventDispatcher::PostEvent(Event* event) {
+	//Counted after the push so DispatchQueuedEvents never expects an event that isn't in the queue yet
+	queue.Push(event);
+	queuedEvents.fetch_add(1, std::memory_order_release);
+}
+
+void EventDispatcher::DispatchQueuedEvents() {
+	//Events posted by the listeners wait for the next frame
+	uint32 count = queuedEvents.load(std::memory_order_acquire);
+
+	for (uint32 i = 0; i < count; i++) {
+		Event* event = queue.Pop();
+
+		//A producer is still linking its event, it's dispatched next frame
+		if (!event) break;
+
+		queuedEvents.fetch_sub(1, std::memory_order_relaxed);
+
+		Dispatch(event);
+	}
+}
+
+void EventDispatcher::SetQueued(bool queued) {
+	EventDispatcher::queued.store(queued, std::memory_order_release);
+
+	//Don't leave anything behind when switching back to immediate dispatch
+	if (!queued) DispatchQueuedEvents();
+}
+
+void EventDispatcher::Dispatch(const Event* event) {
+	FD_EVENT_TYPE type = event->GetEventType();
+	uint_t tableType = type < FD_EVENT_TYPE_COUNT ? type : FD_EVENT_TYPE_UNKNOWN;
+
+	switch (type) {
+		case FD_MOUSE_ACTION_MOVE:
+		case FD_MOUSE_ACTION_MOVE_ABSOLUTE:
+		case FD_MOUSE_ACTION_MOVE_RELATIVE: {
+			const EventMouseActionMove* mouseActionMove = (const EventMouseActionMove*)event;
+			ivec2 pos = mouseActionMove->GetPosition();
+			FD_EVENT_ACTION action = mouseActionMove->GetAction();
+
+			listeners.Dispatch(tableType, [&](EventListener* listener) {
+				bool ret = listener->OnEvent(event);
+				ret |= listener->OnEvent(mouseActionMove);
+				ret |= listener->OnMouseActionMove(pos);
+
+				if (action == FD_ABSOLUTE) {
+					ret |= listener->OnMouseActionMoveAbsolute(pos);
+				} else if (action == FD_RELATIVE) {
+					ret |= listener->OnMouseActionMoveRelative(pos);
 				}
-				break;
-			}
-			case FD_MOUSE_ACTION_BUTTON_RELEASED:
-			case FD_MOUSE_ACTION_BUTTON_PRESSED:
-			case FD_MOUSE_ACTION_BUTTON_HOLD:
-				mouseActionButton = (const EventMouseActionButton*)event;
-				listener->OnEvent(mouseActionButton);
-				switch (mouseActionButton->GetAction()) {
-					case FD_PRESSED:
-						ret = listener->OnMouseActionButtonPressed(mouseActionButton->GetButton());
+
+				return ret;
+			});
+			break;
+		}
+		case FD_MOUSE_ACTION_BUTTON_RELEASED:
+		case FD_MOUSE_ACTION_BUTTON_PRESSED:
+		case FD_MOUSE_ACTION_BUTTON_HOLD: {
+			const EventMouseActionButton* mouseActionButton = (const EventMouseActionButton*)event;
+			uint32 button = mouseActionButton->GetButton();
+
+			listeners.Dispatch(tableType, [&](EventListener* listener) {
+				bool ret = listener->OnEvent(event);
+				ret |= listener->OnEvent(mouseActionButton);
+
+				switch (type) {
+					case FD_MOUSE_ACTION_BUTTON_PRESSED:
+						ret |= listener->OnMouseActionButtonPressed(button);
 						break;
-					case FD_RELEASED:
-						ret = listener->OnMouseActionButtonReleased(mouseActionButton->GetButton());
+					case FD_MOUSE_ACTION_BUTTON_RELEASED:
+						ret |= listener->OnMouseActionButtonReleased(button);
 						break;
-					case FD_HOLD:
-						ret = listener->OnMouseActionButtonHold(mouseActionButton->GetButton());
+					default:
+						ret |= listener->OnMouseActionButtonHold(button);
 						break;
 				}
-				break;
-
-			case FD_WINDOW_ACTION_RESIZE:
-				windowActionResize = (const EventWindowActionResize*)event;
-				listener->OnEvent(windowActionResize);
-				ret = listener->OnWindowActionResize(windowActionResize->GetSize());
-				break;
-			case FD_WINDOW_ACTION_MOVE:
-				windowActionMove = (const EventWindowActionMove*)event;
-				listener->OnEvent(windowActionMove);
-				ret = listener->OnWindowActionMove(windowActionMove->GetPosition());
-				break;
-
-			case FD_WINDOW_STATE_MINIMIZED:
-			case FD_WINDOW_STATE_MAXIMIZED:
-			case FD_WINDOW_STATE_FOCUS_GAINED:
-			case FD_WINDOW_STATE_FOCUS_LOST:
-				windowState = (const EventWindowState*)event;
-				listener->OnEvent(windowState);
-				ret = listener->OnWindowStateChanged(windowState->GetAction());
-				break;
-
-
-			case FD_KEYBOARD_ACTION_KEY_RELEASED:
-			case FD_KEYBOARD_ACTION_KEY_PRESSED:
-			case FD_KEYBOARD_ACTION_KEY_HOLD:
-				keyboardActionKey = (const EventKeyboardActionKey*)event;
-				listener->OnEvent(keyboardActionKey);
-				switch (keyboardActionKey->GetAction()) {
-					case FD_PRESSED:
-						ret = listener->OnKeyboardActionKeyPressed(keyboardActionKey->GetKey());
+
+				return ret;
+			});
+			break;
+		}
+
+		case FD_WINDOW_ACTION_RESIZE: {
+			const EventWindowActionResize* windowActionResize = (const EventWindowActionResize*)event;
+
+			listeners.Dispatch(tableType, [&](EventListener* listener) {
+				bool ret = listener->OnEvent(event);
+				ret |= listener->OnEvent(windowActionResize);
+				ret |= listener->OnWindowActionResize(windowActionResize->GetSize());
+
+				return ret;
+			});
+			break;
+		}
+		case FD_WINDOW_ACTION_MOVE: {
+			const EventWindowActionMove* windowActionMove = (const EventWindowActionMove*)event;
+
+			listeners.Dispatch(tableType, [&](EventListener* listener) {
+				bool ret = listener->OnEvent(event);
+				ret |= listener->OnEvent(windowActionMove);
+				ret |= listener->OnWindowActionMove(windowActionMove->GetPosition());
+
+				return ret;
+			});
+			break;
+		}
+
+		case FD_WINDOW_STATE_MINIMIZED:
+		case FD_WINDOW_STATE_MAXIMIZED:
+		case FD_WINDOW_STATE_FOCUS_GAINED:
+		case FD_WINDOW_STATE_FOCUS_LOST: {
+			const EventWindowState* windowState = (const EventWindowState*)event;
+
+			listeners.Dispatch(tableType, [&](EventListener* listener) {
+				bool ret = listener->OnEvent(event);
+				ret |= listener->OnEvent(windowState);
+				ret |= listener->OnWindowStateChanged(windowState->GetAction());
+
+				return ret;
+			});
+			break;
+		}
+
+		case FD_KEYBOARD_ACTION_KEY_RELEASED:
+		case FD_KEYBOARD_ACTION_KEY_PRESSED:
+		case FD_KEYBOARD_ACTION_KEY_HOLD: {
+			const EventKeyboardActionKey* keyboardActionKey = (const EventKeyboardActionKey*)event;
+			FD_KEY key = keyboardActionKey->GetKey();
+
+			listeners.Dispatch(tableType, [&](EventListener* listener) {
+				bool ret = listener->OnEvent(event);
+				ret |= listener->OnEvent(keyboardActionKey);
+
+				switch (type) {
+					case FD_KEYBOARD_ACTION_KEY_PRESSED:
+						ret |= listener->OnKeyboardActionKeyPressed(key);
 						break;
-					case FD_RELEASED:
-						ret = listener->OnKeyboardActionKeyReleased(keyboardActionKey->GetKey());
+					case FD_KEYBOARD_ACTION_KEY_RELEASED:
+						ret |= listener->OnKeyboardActionKeyReleased(key);
 						break;
-					case FD_HOLD:
-						ret = listener->OnKeyboardActionKeyHold(keyboardActionKey->GetKey());
+					default:
+						ret |= listener->OnKeyboardActionKeyHold(key);
 						break;
 				}
-				break;
+
+				return ret;
+			});
+			break;
 		}
+
+		default:
+			listeners.Dispatch(tableType, [&](EventListener* listener) { return listener->OnEvent(event); });
+			break;
 	}
 
 	delete event;
@@ -1,24 +1,54 @@
 #pragma once
 
 #include <fd.h>
-#include <util/list.h>
+#include <util/listenertable.h>
+#include <util/mpscqueue.h>
+#include <atomic>
 
 #include "event.h"
 
 namespace FD {
 
+class EventListener;
+
+/*
+ Events are dispatched to the listeners subscribed to their type and deleted afterwards.
+ By default DispatchEvent does that right away on the calling thread. With queued dispatch
+ on, events are pushed to a lock-free queue from any thread and DispatchQueuedEvents
+ hands them to the listeners on the main thread once per frame.
+
+ Every event type has its own list of subscribed listeners, rebuilt before the next dispatch
+ when listeners are added or change their mask. Listeners get the event in the order they
+ were added until one of their handlers returns true. Listeners can be added and removed by
+ the handlers, see ListenerTable.
+*/
 class FDAPI EventDispatcher {
 private:
 	friend class EventListener;
 private:
-	static List<EventListener*> listeners;
+	static ListenerTable<EventListener, FD_EVENT_TYPE_COUNT> listeners;
+
+	static MPSCQueue<Event> queue;
+	static std::atomic<uint32> queuedEvents;
+	static std::atomic<bool> queued;
+
+	static void Dispatch(const Event* event);
 
 public:
 
 	static void AddListener(EventListener* listener);
 	static void RemoveListener(EventListener* listener);
 
+	//Takes ownership of the event, queues it instead when queued dispatch is on
 	static void DispatchEvent(const Event* event);
+
+	//Safe from any thread, the event is dispatched by the next DispatchQueuedEvents
+	static void PostEvent(Event* event);
+	//Main thread, dispatches the events posted before the call. Called by Input::UpdateInputAndDispatchEvents
+	static void DispatchQueuedEvents();
+
+	static void SetQueued(bool queued);
+	static inline bool IsQueued() { return queued.load(std::memory_order_relaxed); }
 };
 
 }
\ No newline at end of file
@@ -10,10 +10,19 @@
 namespace FD {
 
 class FDAPI EventListener {
+private:
+	friend class EventDispatcher;
+
+	uint32 eventMask;
+
 public:
-	EventListener() { EventDispatcher::AddListener(this); }
+	//eventMask is a combination of FD_EVENT_MASK values, the listener only gets those event types
+	EventListener(uint32 eventMask = FD_EVENT_MASK_ALL) : eventMask(eventMask) { EventDispatcher::AddListener(this); }
 	~EventListener() { EventDispatcher::RemoveListener(this); }
 
+	inline void SetEventMask(uint32 eventMask) { this->eventMask = eventMask; EventDispatcher::listeners.MarkDirty(); }
+	inline uint32 GetEventMask() const { return eventMask; }
+
 	virtual bool OnEvent(const Event* event) { return false; }
 
 	virtual bool OnEvent(const EventMouseActionMove* event) { return false; }
@@ -47,7 +47,7 @@ private:
 	uint32 button;
 	FD_EVENT_ACTION action;
 public:
-	EventMouseActionButton(FD_EVENT_ACTION action, uint32 button) : EventMouse(action == FD_PRESSED ? FD_MOUSE_ACTION_BUTTON_PRESSED : action == FD_RELEASED ? FD_MOUSE_ACTION_BUTTON_RELEASED : FD_MOUSE_ACTION_BUTTON_HOLD) { this->action = action; }
+	EventMouseActionButton(FD_EVENT_ACTION action, uint32 button) : EventMouse(action == FD_PRESSED ? FD_MOUSE_ACTION_BUTTON_PRESSED : action == FD_RELEASED ? FD_MOUSE_ACTION_BUTTON_RELEASED : FD_MOUSE_ACTION_BUTTON_HOLD) { this->button = button; this->action = action; }
 
 	inline uint32 GetButton() const { return button; }
 	inline FD_EVENT_ACTION GetAction() const { return action; }
@@ -2,6 +2,7 @@
 #include "event/eventdispatcher.h"
 #include "event/eventkeyboard.h"
 #include "event/eventmouse.h"
+#include <core/profiler.h>
 
 namespace FD {
 
@@ -264,8 +265,12 @@ void Input::HandleKeyboardEvents() {
 }
 
 void Input::UpdateInputAndDispatchEvents() {
+	FD_PROFILE_SCOPE("Input::UpdateInputAndDispatchEvents");
+
 	if (mouse.device && mouse.acquired) HandleMouseEvents();
 	if (keyboard.device && keyboard.acquired) HandleKeyboardEvents();
+
+	if (EventDispatcher::IsQueued()) EventDispatcher::DispatchQueuedEvents();
 }
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "scene.h"
 #include <graphics/pbr/render/pbrrenderer.h>
+#include <core/frameallocator.h>
+#include <core/jobsystem.h>
 
 namespace FD {
 
@@ -25,14 +27,33 @@ void Scene::Update(float delta) {
 }
 
 void Scene::Render() {
-	List<Light*> stack;
+	FrameList<Light*> stack(1, 1);
 	stack.Push_back(lights[0]);
 
 	renderer->Begin(camera);
 	renderer->Submit(stack);
 
-	for (uint_t i = 0; i < entities.GetSize(); i++) {
-		renderer->Submit(entities[i]);
+	uint_t numEntities = entities.GetSize();
+
+	positions.Resize(numEntities);
+	orientations.Resize(numEntities);
+	scales.Resize(numEntities);
+	transforms.Resize(numEntities);
+
+	//Batches are a multiple of 8 so only the last one has a scalar tail in ComposeTRS
+	JobSystem::ParallelFor(numEntities, 256, [this](uint_t begin, uint_t end) {
+		for (uint_t i = begin; i < end; i++) {
+			Entity3D* e = entities[i];
+			positions[i] = e->GetPosition();
+			orientations[i] = e->GetOrientation();
+			scales[i] = e->GetScale();
+		}
+
+		TransformBatch::ComposeTRS(positions.GetData() + begin, orientations.GetData() + begin, scales.GetData() + begin, transforms.GetData() + begin, end - begin);
+	});
+
+	for (uint_t i = 0; i < numEntities; i++) {
+		renderer->Submit(entities[i]->GetMesh(), transforms[i]);
 	}
 
 	renderer->End();
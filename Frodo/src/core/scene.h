@@ -17,6 +17,11 @@ protected:
 	List<Entity3D*> entities;
 	List<Light*> lights;
 
+	List<vec3> positions;
+	List<quat> orientations;
+	List<vec3> scales;
+	List<mat4> transforms;
+
 public:
 	Scene(Window* window);
 	virtual ~Scene();
@@ -5,7 +5,7 @@
 
 namespace FD {
 
-UIHandler::UIHandler() {
+UIHandler::UIHandler() : EventListener(FD_EVENT_MASK(FD_MOUSE_ACTION_BUTTON_PRESSED) | FD_EVENT_MASK(FD_MOUSE_ACTION_BUTTON_RELEASED) | FD_EVENT_MASK(FD_MOUSE_ACTION_MOVE_ABSOLUTE) | FD_EVENT_MASK(FD_KEYBOARD_ACTION_KEY_PRESSED)) {
 	inFocus = nullptr;
 }
 
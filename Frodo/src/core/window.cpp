@@ -1,6 +1,7 @@
 #include "window.h"
 #include "input.h"
 #include <core/event/eventdispatcher.h>
+#include <core/profiler.h>
 
 #define FD_USE_LEGACY_INPUT 0
 
@@ -125,7 +126,7 @@ LRESULT Window::WndProc(HWND hwnd, UINT msg, WPARAM w, LPARAM l) {
 	return DefWindowProc(hwnd, msg, w, l);
 }
 
-Window::Window(const String& title, FD_WINDOW_PROPERTIES prop, D3DAdapter* adapter, D3DOutput* output) : title(title) {
+Window::Window(const String& title, FD_WINDOW_PROPERTIES prop, D3DAdapter* adapter, D3DOutput* output) : EventListener(FD_EVENT_MASK(FD_WINDOW_ACTION_RESIZE)), title(title) {
 	if (adapter == nullptr) {
 		adapter = D3DFactory::GetFirstAdapter();
 	}
@@ -229,6 +230,7 @@ void Window::SwapBuffers() {
 		DispatchMessage(&msg);
 	}
 
+	FD_PROFILE_SCOPE("D3DContext::Present");
 	D3DContext::Present(vSync, 0);
 }
 
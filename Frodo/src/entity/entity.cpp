@@ -0,0 +1,28 @@
+#include "entity.h"
+#include <util/objectpool.h>
+#include <core/log.h>
+
+namespace FD {
+
+static ObjectPool<Entity3D> entityPool(256);
+
+void* Entity3D::operator new(size_t size) {
+	if (size != sizeof(Entity3D)) return ::operator new(size);
+
+	void* entity = entityPool.Acquire();
+
+	FD_ASSERT_MSG(entity == nullptr, "Entity pool is full");
+
+	return entity;
+}
+
+void Entity3D::operator delete(void* entity, size_t size) {
+	if (size != sizeof(Entity3D)) {
+		::operator delete(entity);
+		return;
+	}
+
+	entityPool.Release((Entity3D*)entity);
+}
+
+}
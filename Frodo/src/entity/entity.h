@@ -36,19 +36,27 @@ protected:
 	Mesh* mesh;
 
 	vec3 rotation;
+	quat orientation;
 	vec3 scale;
 
 public:
-	Entity3D(const vec3& position, const vec3& rotation, const vec3& scale = vec3(1, 1, 1)) : Entity(position), rotation(rotation), scale(scale) { mesh = nullptr; }
+	Entity3D(const vec3& position, const vec3& rotation, const vec3& scale = vec3(1, 1, 1)) : Entity(position), rotation(rotation), orientation(quat::FromEuler(rotation)), scale(scale) { mesh = nullptr; }
+	Entity3D(const vec3& position, const quat& orientation, const vec3& scale = vec3(1, 1, 1)) : Entity(position), rotation(orientation.ToEuler()), orientation(orientation), scale(scale) { mesh = nullptr; }
+
+	//Entity3D comes from a pool, derived classes of a different size use the heap
+	static void* operator new(size_t size);
+	static void operator delete(void* entity, size_t size);
 
 	inline void SetMesh(Mesh* mesh) { this->mesh = mesh; }
 
-	inline void SetRotation(const vec3& rotation) { this->rotation = rotation; }
+	inline void SetRotation(const vec3& rotation) { this->rotation = rotation; orientation = quat::FromEuler(rotation); }
+	inline void SetRotation(const quat& orientation) { this->orientation = orientation; rotation = orientation.ToEuler(); }
 	inline void SetScale(const vec3& scale) { this->scale = scale; }
 
 	inline Mesh* GetMesh() const { return mesh; }
-	inline mat4 GetTransform() const { return mat4::Translate(position) * mat4::Rotate(rotation) * mat4::Scale(scale); }
+	inline mat4 GetTransform() const { return TransformBatch::ComposeTRS(position, orientation, scale); }
 	inline const vec3& GetRotation() const { return rotation; }
+	inline const quat& GetOrientation() const { return orientation; }
 	inline const vec3& GetScale() const { return scale; }
 
 };
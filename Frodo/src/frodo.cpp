@@ -1,9 +1,9 @@
 #include <frodo.h>
-#include <ctime>
+#include <chrono>
 
 namespace FD {
 
-Application::Application() {
+Application::Application() : updateTime(0.0), useSimulationThread(false), simulationThread(nullptr), simulationRunning(false), lastUpdate(0) {
 	SetUPS(0);
 }
 
@@ -11,8 +11,15 @@ Application::~Application() {
 	OnExit();
 	delete window;
 
+	JobSystem::Dispose();
 	VFS::Dispose();
 	TextureManager::Dispose();
+	Profiler::Dispose();
+
+	//Statics and anything the application didn't delete are still alive at this point
+	Memory::ReportLeaks();
+
+	Logger::Dispose();
 }
 
 //void Application::OnInit() {}
@@ -23,47 +30,150 @@ void Application::OnUpdate(float32 delta) {}
 
 void Application::OnRender() {}
 
+void Application::OnRender(float32 alpha) {
+	OnRender();
+}
+
 void Application::OnExit() {}
 
 void Application::Run() {
+	Logger::Init();
+	FrameAllocator::Init();
+	JobSystem::Init();
 	VFS::Init();
+	ShaderCache::Init(FD_SHADER_CACHE_SIZE, "shadercache");
+	if (shaderLibrary.Read("shaders.fdshaderlib")) Shader::SetLibrary(&shaderLibrary);
 	D3DFactory::CreateFactory();
 	OnCreateWindow();
+	ConstantBufferRing::Init();
 	TextureManager::Init();
 	AudioManager::Init();
 	OnInit();
 	Window& w = *window;
-	uint32 lastTime = clock();
-	uint32 lastTime2 = clock();
-	uint32 lastTime3 = clock();
 
-	float32 delta = 0;
+	Profiler::SetThreadName("Main");
+
+	float64 lastTime = FixedTimestep::Now();
+	float64 lastTick = lastTime;
+
+	if (useSimulationThread) {
+		if (timestep.GetStep() <= 0.0) {
+			FD_WARNING("[Application] The simulation thread needs a fixed rate, using 60 updates per second");
+			timestep.SetStep(1.0 / 60.0);
+		}
+
+		lastUpdate.store(FixedTimestep::NowNanoseconds(), std::memory_order_relaxed);
+		simulationRunning.store(true, std::memory_order_release);
+		simulationThread = new std::thread(&Application::RunSimulation, this);
+	}
 
 	while (w.IsOpen()) {
-		D3DContext::Clear();
+		Profiler::BeginFrame();
+		FrameStats::BeginFrame();
+
+		{
+			FD_PROFILE_SCOPE("Application::Run");
 
-		uint32 now = clock();
+			D3DContext::Clear();
+
+			float64 now = FixedTimestep::Now();
+			float32 alpha;
+
+			if (simulationThread) {
+				int64 sinceUpdate = (int64)(FixedTimestep::NowNanoseconds() - lastUpdate.load(std::memory_order_acquire));
+
+				alpha = (float32)(sinceUpdate / 1000000000.0 / timestep.GetStep());
+				alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+			} else {
+				uint32 steps = timestep.Advance(now - lastTime);
+
+				FrameStats::BeginTimer(FD_FRAMESTATS_TIMER_UPDATE);
+				Update(now, steps);
+				FrameStats::EndTimer(FD_FRAMESTATS_TIMER_UPDATE);
+
+				alpha = (float32)timestep.GetAlpha();
+			}
 
-			
-		if ((delta = float32(now - lastTime)) > ups) {
 			lastTime = now;
-			OnUpdate(delta / 1000.0f);
-		}
 
-		Input::UpdateInputAndDispatchEvents();
+			Input::UpdateInputAndDispatchEvents();
+
+			{
+				FD_PROFILE_SCOPE("Application::OnRender");
+				FrameStats::BeginTimer(FD_FRAMESTATS_TIMER_RENDER);
+				OnRender(alpha);
+				FrameStats::EndTimer(FD_FRAMESTATS_TIMER_RENDER);
+			}
 
-		OnRender();
+			if (now - lastTick >= 1.0) {
+				lastTick += 1.0;
+				OnTick();
+			}
 
-		if (clock() - lastTime2 >= 1000) {
-			lastTime2 += 1000;
-			OnTick();
+			w.SwapBuffers();
 		}
 
-		w.SwapBuffers();
+		FrameStats::EndFrame();
+		Profiler::EndFrame();
+		FrameAllocator::EndFrame();
+	}
+
+	if (simulationThread) {
+		simulationRunning.store(false, std::memory_order_release);
+		simulationThread->join();
+
+		delete simulationThread;
+		simulationThread = nullptr;
 	}
 
 	OnExit();
 	AudioManager::Release();
+	ConstantBufferRing::Dispose();
+	RenderStateCache::Dispose();
 	D3DFactory::Release();
+	Shader::SetLibrary(nullptr);
+	ShaderCache::Dispose();
+}
+
+void Application::Update(float64 now, uint32 steps) {
+	if (steps == 0) return;
+
+	FD_PROFILE_SCOPE("Application::OnUpdate");
+
+	float64 step = timestep.GetDelta();
+
+	//The last step ends at now minus the time left in the accumulator
+	float64 end = now - timestep.GetAlpha() * timestep.GetStep();
+
+	for (uint32 i = 0; i < steps; i++) {
+		updateTime = end - (steps - 1 - i) * step;
+		OnUpdate((float32)step);
+	}
+}
+
+void Application::RunSimulation() {
+	Profiler::SetThreadName("Simulation");
+
+	float64 step = timestep.GetStep();
+	float64 lastTime = FixedTimestep::Now();
+
+	timestep.Reset();
+
+	while (simulationRunning.load(std::memory_order_acquire)) {
+		float64 now = FixedTimestep::Now();
+		uint32 steps = timestep.Advance(now - lastTime);
+
+		lastTime = now;
+
+		if (steps) {
+			Update(now, steps);
+			lastUpdate.store((uint64)(updateTime * 1000000000.0), std::memory_order_release);
+		}
+
+		//Sleep until the next step is due, the accumulator absorbs oversleeping
+		float64 wait = (1.0 - timestep.GetAlpha()) * step - (FixedTimestep::Now() - now);
+
+		if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<float64>(wait));
+	}
 }
 }
\ No newline at end of file
@@ -6,6 +6,15 @@
 #include <audio/audiomixer.h>
 
 #include <fdutils.h>
+#include <core/profiler.h>
+#include <core/frameallocator.h>
+#include <core/jobsystem.h>
+#include <core/framestats.h>
+#include <core/memory.h>
+#include <core/timestep.h>
+#include <util/shadercache.h>
+#include <util/shaderlibrary.h>
+#include <util/constantbuffershadow.h>
 #include <core/window.h>
 #include <core/input.h>
 
@@ -26,10 +35,13 @@
 #include <graphics/d3dadapter.h>
 #include <graphics/d3dfactory.h>
 #include <graphics/d3doutput.h>
+#include <graphics/renderstate.h>
+#include <graphics/renderstatecache.h>
 
 #include <graphics/buffer/bufferlayout.h>
 #include <graphics/buffer/vertexbuffer.h>
 #include <graphics/buffer/indexbuffer.h>
+#include <graphics/buffer/constantbufferring.h>
 
 #include <graphics/shader/shader.h>
 #include <graphics/shader/shaderfactory.h>
@@ -73,20 +85,35 @@
 #include <util/string.h>
 
 #include <util/vfs/vfs.h>
+#include <util/statebuffer.h>
 
 #include <util/asset/package.h>
 #include <util/asset/asset.h>
 #include <util/asset/assetmanager.h>
 
 #include <fd.h>
+#include <atomic>
+#include <thread>
 
 namespace FD {
 
 class FDAPI Application {
 private:
 	void Run();
+	void RunSimulation();
+	void Update(float64 now, uint32 steps);
 
-	float32 ups;
+	FixedTimestep timestep;
+	float64 updateTime;
+
+	bool useSimulationThread;
+	std::thread* simulationThread;
+	std::atomic<bool> simulationRunning;
+	//Time of the last finished update on the simulation thread in nanoseconds
+	std::atomic<uint64> lastUpdate;
+
+	//Built by FormatConverter, shaders compile at startup without it
+	ShaderLibrary shaderLibrary;
 
 protected:
 	Window* window;
@@ -94,10 +121,16 @@ protected:
 	virtual void OnCreateWindow() = 0;
 	virtual void OnInit() = 0;
 	virtual void OnTick();
+	//Called every step with the step length in seconds, on the simulation thread if it's enabled
 	virtual void OnUpdate(float32 delta);
 	virtual void OnRender();
+	//alpha is how far the frame is between the last two updates, in [0, 1]. Calls OnRender() by default
+	virtual void OnRender(float32 alpha);
 	virtual void OnExit();
 
+	//Time the current update is simulating, pass it to StateBuffer::Publish
+	inline float64 GetUpdateTime() const { return updateTime; }
+
 	Application();
 public:
 	virtual ~Application();
@@ -105,7 +138,13 @@ public:
 
 	inline void Start() { Run(); }
 
-	inline void SetUPS(float32 timesPerSec) { this->ups = timesPerSec == 0 ? 0.0f : 1000.0f / timesPerSec; }
+	//0 updates once per frame with the frame time
+	inline void SetUPS(float32 timesPerSec) { timestep.SetStep(timesPerSec == 0 ? 0.0 : 1.0 / timesPerSec); }
+
+	//Runs OnUpdate on its own thread at a fixed rate, call before Start. OnUpdate can't use
+	//the renderer, FrameAllocator or anything else that belongs to the main thread then,
+	//hand the results to OnRender through a StateBuffer.
+	inline void SetSimulationThread(bool enabled) { useSimulationThread = enabled; }
 };
 
 }
\ No newline at end of file
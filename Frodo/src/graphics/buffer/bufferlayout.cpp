@@ -25,25 +25,42 @@ BufferLayout::~BufferLayout() {
 }
 
 void BufferLayout::PushElement(const String& name, uint32 size) {
-	elements.Push_back(new BufferLayoutAttrib({ name, (DXGI_FORMAT)0, 0, size, offset }));
+	StringID id = StringID::Intern(name);
+
+	elements.Push_back(new BufferLayoutAttrib({ name, (DXGI_FORMAT)0, 0, size, offset, id, 0 }));
+	ids.Push_back(id);
 	offset += size;
 }
 
 void BufferLayout::PushElementAtOffset(const String& name, uint32 size, uint32 offset) {
-	elements.Push_back(new BufferLayoutAttrib({ name, (DXGI_FORMAT)0, 0, size, offset }));
+	StringID id = StringID::Intern(name);
+
+	elements.Push_back(new BufferLayoutAttrib({ name, (DXGI_FORMAT)0, 0, size, offset, id, 0 }));
+	ids.Push_back(id);
+}
+
+const BufferLayout::BufferLayoutAttrib* BufferLayout::GetElement(StringID id) const {
+	uint_t index = ids.Find(id);
+
+	return index == (uint_t)-1 ? nullptr : elements.Get(index);
 }
 
 uint32 BufferLayout::GetElementOffset(const String& name) const {
-	uint_t size = elements.GetSize();
-	for (uint_t i = 0; i < size; i++) {
-		const BufferLayoutAttrib& attrib = *elements.Get(i);
-		if (attrib.name == name) return attrib.offset;
-	}
+	const BufferLayoutAttrib* attrib = GetElement(StringID(name));
+	if (attrib) return attrib->offset;
 
 	FD_WARNING("[BufferLayout] No element in buffer named \"%s\"", *name);
 	return -1;
 }
 
+uint32 BufferLayout::GetElementOffset(StringID id) const {
+	const BufferLayoutAttrib* attrib = GetElement(id);
+	if (attrib) return attrib->offset;
+
+	FD_WARNING("[BufferLayout] No element in buffer named \"%s\"", *StringID::GetString(id));
+	return -1;
+}
+
 uint32 BufferLayout::GetElementOffset(uint32 index) const {
 	if (index >= elements.GetSize()) {
 		FD_WARNING("[BufferLayout] Index out of bounds %u", index);
@@ -53,16 +70,21 @@ uint32 BufferLayout::GetElementOffset(uint32 index) const {
 }
 
 uint32 BufferLayout::GetElementSize(const String& name) const {
-	uint_t size = elements.GetSize();
-	for (uint_t i = 0; i < size; i++) {
-		const BufferLayoutAttrib& attrib = *elements.Get(i);
-		if (attrib.name == name) return attrib.size;
-	}
+	const BufferLayoutAttrib* attrib = GetElement(StringID(name));
+	if (attrib) return attrib->size;
 
 	FD_WARNING("[BufferLayout] No element in buffer named \"%s\"", *name);
 	return -1;
 }
 
+uint32 BufferLayout::GetElementSize(StringID id) const {
+	const BufferLayoutAttrib* attrib = GetElement(id);
+	if (attrib) return attrib->size;
+
+	FD_WARNING("[BufferLayout] No element in buffer named \"%s\"", *StringID::GetString(id));
+	return -1;
+}
+
 uint32 BufferLayout::GetElementSize(uint32 index) const {
 	if (index >= elements.GetSize()) {
 		FD_WARNING("[BufferLayout] Index out of bounds %u", index);
@@ -71,12 +93,17 @@ uint32 BufferLayout::GetElementSize(uint32 index) const {
 	return elements.Get(index)->size;
 }
 
-void BufferLayout::Push(const String& name, DXGI_FORMAT format, uint32 slot) {
+void BufferLayout::Push(const String& name, DXGI_FORMAT format, uint32 slot, uint32 semanticIndex) {
 	uint32 size = get_size_from_format(format);
 	FD_ASSERT(size == 0);
-	elements.Push_back(new BufferLayoutAttrib({name, format, slot, size, offset}));
 
-	offset += size;
+	StringID id = StringID::Intern(name);
+	uint32& current = slot > 0 ? instanceOffset : offset;
+
+	elements.Push_back(new BufferLayoutAttrib({name, format, slot, size, current, id, semanticIndex}));
+	ids.Push_back(id);
+
+	current += size;
 }
 
 void BufferLayout::CreateInputLayout(Shader* shader) {
@@ -96,13 +123,13 @@ void BufferLayout::CreateInputLayout(Shader* shader) {
 			input = D3D11_INPUT_PER_VERTEX_DATA;
 		}
 
-		desc[i] = { *a.name, 0, a.format, a.slot, a.offset, input, stepRate };
+		desc[i] = { *a.name, a.semanticIndex, a.format, a.slot, a.offset, input, stepRate };
 	}
 
 	ID3D11InputLayout* tmp = nullptr;
 	D3DContext::GetDevice()->CreateInputLayout(desc, (uint32)elements.GetSize(), shader->GetVSBufferPointer(), shader->GetVSBufferSize(), &tmp);
 
-	shader->SetInputLayout(tmp);
+	shader->SetInputLayout(tmp, instanceOffset);
 
 	delete[] desc;
 }
@@ -4,8 +4,12 @@
 #include <graphics/d3dcontext.h>
 #include <util/list.h>
 #include <util/string.h>
+#include <util/stringid.h>
 #include <math/math.h>
 
+//Vertex buffer slot that per instance elements go to by default, slot 0 is per vertex
+#define FD_BUFFER_LAYOUT_INSTANCE_SLOT 1
+
 namespace FD {
 
 class FDAPI BufferLayout {
@@ -18,28 +22,42 @@ public:
 		uint32 slot;
 		uint32 size;
 		uint32 offset;
+		StringID id;
+		//Matrices are split into rows with the same name and increasing indices
+		uint32 semanticIndex;
 	};
 
 private:
 	List<BufferLayoutAttrib*> elements;
+	//Same order as elements, scanned without touching the elements
+	List<StringID> ids;
 
 	uint32 offset;
+	//Elements in slots above 0 are per instance and laid out on their own
+	uint32 instanceOffset;
 
-	void Push(const String& name, DXGI_FORMAT format, uint32 slot);
+	void Push(const String& name, DXGI_FORMAT format, uint32 slot, uint32 semanticIndex = 0);
 
 public:
-	BufferLayout() { offset = 0; elements.Reserve(32); }
+	BufferLayout() { offset = 0; instanceOffset = 0; elements.Reserve(32); ids.Reserve(32); }
 	~BufferLayout();
 
 	void CreateInputLayout(Shader* shader);
 
 	void PushElement(const String& name, uint32 size);
 	void PushElementAtOffset(const String& name, uint32 size, uint32 offset);
+	//nullptr when there is no element with the ID
+	const BufferLayoutAttrib* GetElement(StringID id) const;
+
 	uint32 GetElementOffset(const String& name) const;
+	uint32 GetElementOffset(StringID id) const;
 	uint32 GetElementOffset(uint32 index) const;
 	uint32 GetElementSize(const String& name) const;
+	uint32 GetElementSize(StringID id) const;
 	uint32 GetElementSize(uint32 index) const;
 	uint32 GetSize() const { return offset; }
+	//Bytes per instance, 0 without per instance elements
+	uint32 GetInstanceStride() const { return instanceOffset; }
 
 	inline const List<BufferLayoutAttrib*>& GetElements() const { return elements; }
 
@@ -52,6 +70,11 @@ public:
 	template<> inline void Push<vec2>(const char* name, uint32 slot) { Push(name, DXGI_FORMAT_R32G32_FLOAT, slot); }
 	template<> inline void Push<vec3>(const char* name, uint32 slot) { Push(name, DXGI_FORMAT_R32G32B32_FLOAT, slot); }
 	template<> inline void Push<vec4>(const char* name, uint32 slot) { Push(name, DXGI_FORMAT_R32G32B32A32_FLOAT, slot); }
+	template<> inline void Push<mat4>(const char* name, uint32 slot) { for (uint32 i = 0; i < 4; i++) Push(name, DXGI_FORMAT_R32G32B32A32_FLOAT, slot, i); }
+
+	//Slot FD_BUFFER_LAYOUT_INSTANCE_SLOT, stepped once per instance
+	template<typename T>
+	inline void PushInstanced(const char* name) { Push<T>(name, FD_BUFFER_LAYOUT_INSTANCE_SLOT); }
 
 };
 
@@ -0,0 +1,197 @@
+#include "constantbufferring.h"
+#include <core/log.h>
+#include <core/framestats.h>
+
+namespace FD {
+
+ID3D11Buffer* ConstantBufferRing::buffer = nullptr;
+ID3D11DeviceContext* ConstantBufferRing::immediate = nullptr;
+ID3D11DeviceContext1* ConstantBufferRing::context = nullptr;
+
+uint32 ConstantBufferRing::size = 0;
+uint32 ConstantBufferRing::offset = 0;
+
+ConstantBufferRing::Binding ConstantBufferRing::bindings[3][D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+
+static inline uint32 Align(uint32 size) {
+	return (size + FD_CONSTANT_BUFFER_RING_ALIGNMENT - 1) & ~(FD_CONSTANT_BUFFER_RING_ALIGNMENT - 1);
+}
+
+ConstantBufferRing::Binding* ConstantBufferRing::GetBinding(FD_SHADER_TYPE type, uint32 slot) {
+	switch (type) {
+		case FD_SHADER_TYPE_VERTEXSHADER: return &bindings[0][slot];
+		case FD_SHADER_TYPE_PIXELSHADER: return &bindings[1][slot];
+		case FD_SHADER_TYPE_GEOMETRYSHADER: return &bindings[2][slot];
+	}
+
+	return nullptr;
+}
+
+void ConstantBufferRing::SetConstantBuffer(FD_SHADER_TYPE type, uint32 slot, uint32 offset, uint32 size) {
+	UINT first = offset / FD_CONSTANT_BUFFER_REGISTER_SIZE;
+	UINT count = Align(size) / FD_CONSTANT_BUFFER_REGISTER_SIZE;
+
+	switch (type) {
+		case FD_SHADER_TYPE_VERTEXSHADER:
+			context->VSSetConstantBuffers1(slot, 1, &buffer, &first, &count);
+			break;
+		case FD_SHADER_TYPE_PIXELSHADER:
+			context->PSSetConstantBuffers1(slot, 1, &buffer, &first, &count);
+			break;
+		case FD_SHADER_TYPE_GEOMETRYSHADER:
+			context->GSSetConstantBuffers1(slot, 1, &buffer, &first, &count);
+			break;
+	}
+}
+
+bool ConstantBufferRing::Write(const ConstantBufferShadow* shadow, D3D11_MAP map, uint32* offset) {
+	uint32 aligned = Align(shadow->GetSize());
+
+	if (ConstantBufferRing::offset + aligned > size) return false;
+
+	D3D11_MAPPED_SUBRESOURCE sub;
+
+	context->Map(buffer, 0, map, 0, &sub);
+	memcpy((byte*)sub.pData + ConstantBufferRing::offset, shadow->GetData(), shadow->GetSize());
+	context->Unmap(buffer, 0);
+
+	*offset = ConstantBufferRing::offset;
+	ConstantBufferRing::offset += aligned;
+
+	return true;
+}
+
+void ConstantBufferRing::Wrap() {
+	D3D11_MAPPED_SUBRESOURCE sub;
+
+	context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &sub);
+
+	offset = 0;
+
+	//The discarded memory is gone for the next draws, everything still bound moves to the start
+	for (uint32 type = 0; type < 3; type++) {
+		for (uint32 slot = 0; slot < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; slot++) {
+			Binding& binding = bindings[type][slot];
+
+			if (!binding.shadow) continue;
+
+			memcpy((byte*)sub.pData + offset, binding.shadow->GetData(), binding.shadow->GetSize());
+
+			binding.offset = offset;
+			offset += Align(binding.shadow->GetSize());
+
+			FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_UPLOADS);
+			FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_BYTES, binding.shadow->GetSize());
+		}
+	}
+
+	context->Unmap(buffer, 0);
+
+	static const FD_SHADER_TYPE types[3] = { FD_SHADER_TYPE_VERTEXSHADER, FD_SHADER_TYPE_PIXELSHADER, FD_SHADER_TYPE_GEOMETRYSHADER };
+
+	for (uint32 type = 0; type < 3; type++) {
+		for (uint32 slot = 0; slot < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; slot++) {
+			const Binding& binding = bindings[type][slot];
+
+			if (binding.shadow) SetConstantBuffer(types[type], slot, binding.offset, binding.shadow->GetSize());
+		}
+	}
+}
+
+void ConstantBufferRing::Init(uint32 size) {
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+	ZeroMemory(&options, sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS));
+
+	D3DContext::GetDevice()->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS));
+
+	if (!options.ConstantBufferOffsetting) {
+		FD_DEBUG("[ConstantBufferRing] Constant buffer offsetting isn't supported, every cbuffer uses its own buffer");
+		return;
+	}
+
+	immediate = D3DContext::GetDeviceContext();
+
+	if (FAILED(immediate->QueryInterface(__uuidof(ID3D11DeviceContext1), (void**)&context))) {
+		immediate = nullptr;
+		return;
+	}
+
+	D3D11_BUFFER_DESC desc;
+	ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
+
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	desc.ByteWidth = size;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+
+	D3DContext::GetDevice()->CreateBuffer(&desc, 0, &buffer);
+
+	if (!buffer) {
+		FD_WARNING("[ConstantBufferRing] Failed to create a %u byte buffer", size);
+		Dispose();
+		return;
+	}
+
+	ConstantBufferRing::size = size;
+
+	//The first write has to discard
+	offset = size;
+
+	memset(bindings, 0, sizeof(bindings));
+}
+
+void ConstantBufferRing::Dispose() {
+	DX_FREE(buffer);
+	DX_FREE(context);
+
+	immediate = nullptr;
+	size = 0;
+	offset = 0;
+
+	memset(bindings, 0, sizeof(bindings));
+}
+
+void ConstantBufferRing::Upload(FD_SHADER_TYPE type, uint32 slot, const ConstantBufferShadow* shadow) {
+	Binding* binding = GetBinding(type, slot);
+
+	uint32 at = 0;
+
+	//Unbound first so Wrap doesn't write the old contents of this slot
+	binding->shadow = nullptr;
+
+	if (!Write(shadow, D3D11_MAP_WRITE_NO_OVERWRITE, &at)) {
+		Wrap();
+		Write(shadow, D3D11_MAP_WRITE_NO_OVERWRITE, &at);
+	}
+
+	binding->shadow = shadow;
+	binding->offset = at;
+
+	SetConstantBuffer(type, slot, at, shadow->GetSize());
+}
+
+void ConstantBufferRing::Unbind(FD_SHADER_TYPE type, uint32 slot) {
+	Binding* binding = GetBinding(type, slot);
+
+	if (binding) binding->shadow = nullptr;
+}
+
+void ConstantBufferRing::Forget(const ConstantBufferShadow* shadow) {
+	for (uint32 type = 0; type < 3; type++) {
+		for (uint32 slot = 0; slot < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; slot++) {
+			if (bindings[type][slot].shadow == shadow) bindings[type][slot].shadow = nullptr;
+		}
+	}
+}
+
+bool ConstantBufferRing::IsBound(FD_SHADER_TYPE type, uint32 slot, const ConstantBufferShadow* shadow) {
+	const Binding* binding = GetBinding(type, slot);
+
+	return binding && binding->shadow == shadow;
+}
+
+bool ConstantBufferRing::IsActive() {
+	return buffer != nullptr && D3DContext::GetDeviceContext() == immediate;
+}
+
+}
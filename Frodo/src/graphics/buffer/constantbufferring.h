@@ -0,0 +1,69 @@
+#pragma once
+#include <fd.h>
+#include <graphics/d3dcontext.h>
+#include <graphics/shader/shader.h>
+#include <util/constantbuffershadow.h>
+#include <d3d11_1.h>
+
+//Bytes in the ring, it's discarded and starts over when full
+#define FD_CONSTANT_BUFFER_RING_SIZE (4 << 20)
+//VSSetConstantBuffers1 offsets and sizes are multiples of 16 registers
+#define FD_CONSTANT_BUFFER_RING_ALIGNMENT 256
+
+namespace FD {
+
+/*
+ One large dynamic constant buffer that Shader appends constant buffer contents to instead of
+ mapping each cbuffer's own buffer with D3D11_MAP_WRITE_DISCARD. Every upload is written with
+ D3D11_MAP_WRITE_NO_OVERWRITE after the previous one and bound with an offset
+ (*SetConstantBuffers1, D3D11.1). When it's full it's discarded and the ranges that are
+ still bound are written again from their shadow copies, so a bound range never goes stale.
+
+ Needs the device to support constant buffer offsetting, IsActive is false without it and
+ while a context other than the immediate one is active. Shader falls back to the cbuffer's
+ own buffer then.
+*/
+class FDAPI ConstantBufferRing {
+private:
+	struct Binding {
+		const ConstantBufferShadow* shadow;
+		uint32 offset;
+	};
+
+	static ID3D11Buffer* buffer;
+	static ID3D11DeviceContext* immediate;
+	static ID3D11DeviceContext1* context;
+
+	static uint32 size;
+	static uint32 offset;
+
+	//Vertex, pixel and geometry
+	static Binding bindings[3][D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+
+	static Binding* GetBinding(FD_SHADER_TYPE type, uint32 slot);
+	static void SetConstantBuffer(FD_SHADER_TYPE type, uint32 slot, uint32 offset, uint32 size);
+
+	//Writes the shadow at the current offset, false when it doesn't fit
+	static bool Write(const ConstantBufferShadow* shadow, D3D11_MAP map, uint32* offset);
+	//Maps with discard and writes every bound shadow again
+	static void Wrap();
+
+public:
+	//After the device has been created, does nothing when offsetting isn't supported
+	static void Init(uint32 size = FD_CONSTANT_BUFFER_RING_SIZE);
+	static void Dispose();
+
+	//Copies the shadow into the ring and binds that range to the slot
+	static void Upload(FD_SHADER_TYPE type, uint32 slot, const ConstantBufferShadow* shadow);
+
+	//The slot was bound to something else
+	static void Unbind(FD_SHADER_TYPE type, uint32 slot);
+	//The shadow is going away, clears every binding of it
+	static void Forget(const ConstantBufferShadow* shadow);
+
+	//The slot still has the shadow's last upload bound
+	static bool IsBound(FD_SHADER_TYPE type, uint32 slot, const ConstantBufferShadow* shadow);
+	static bool IsActive();
+};
+
+}
@@ -1,5 +1,6 @@
 #include "indexbuffer.h"
 #include <core/log.h>
+#include <graphics/renderstate.h>
 
 namespace FD {
 
@@ -55,7 +56,7 @@ IndexBuffer::IndexBuffer(int16* data, uint32 count) : IndexBuffer(data, count *
 
 
 void IndexBuffer::Bind() {
-	D3DContext::GetDeviceContext()->IASetIndexBuffer(buffer, format, 0);
+	RenderState::SetIndexBuffer(buffer, format);
 }
 
 }
\ No newline at end of file
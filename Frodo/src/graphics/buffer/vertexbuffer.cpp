@@ -1,5 +1,6 @@
 #include "vertexbuffer.h"
 #include <core/log.h>
+#include <graphics/renderstate.h>
 
 namespace FD {
 
@@ -56,13 +57,11 @@ void VertexBuffer::Unmap() {
 }
 
 void VertexBuffer::Bind() {
-	uint32 offset = 0;
-	D3DContext::GetDeviceContext()->IASetVertexBuffers(0, 1, &buffer, &stride, &offset);
+	RenderState::SetVertexBuffer(0, buffer, stride);
 }
 
 void VertexBuffer::Bind(uint32 slot) {
-	uint32 offset = 0;
-	D3DContext::GetDeviceContext()->IASetVertexBuffers(slot, 1, &buffer, &stride, &offset);
+	RenderState::SetVertexBuffer(slot, buffer, stride);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "d3dcommandlist.h"
+#include "renderstate.h"
+#include <graphics/shader/shader.h>
+#include <core/log.h>
+
+namespace FD {
+
+D3DCommandList::D3DCommandList() : context(nullptr), commandList(nullptr) {
+	D3DContext::GetDevice()->CreateDeferredContext(0, &context);
+
+	FD_ASSERT_MSG(context == nullptr, "[D3DCommandList] Failed to create deferred context");
+}
+
+D3DCommandList::~D3DCommandList() {
+	DX_FREE(commandList);
+	DX_FREE(context);
+}
+
+void D3DCommandList::Begin() {
+	FD_ASSERT_MSG(commandList != nullptr, "[D3DCommandList] Begin before the last recording was executed");
+
+	D3DContext::SetThreadDeviceContext(context);
+
+	context->OMSetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, D3DContext::GetActiveRenderTargets(), D3DContext::GetActiveDepthStencilView());
+	context->RSSetViewports(1, &D3DContext::GetActiveViewPort());
+
+	RenderState::Apply(context);
+}
+
+void D3DCommandList::End() {
+	context->FinishCommandList(FALSE, &commandList);
+
+	D3DContext::SetThreadDeviceContext(nullptr);
+}
+
+void D3DCommandList::Execute() {
+	if (!commandList) return;
+
+	D3DContext::GetImmediateDeviceContext()->ExecuteCommandList(commandList, TRUE);
+
+	DX_FREE(commandList);
+
+	Shader::InvalidateConstantBuffers();
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <fd.h>
+#include <core/commandlist.h>
+#include <graphics/d3dcontext.h>
+
+namespace FD {
+
+/*
+ CommandList on a deferred context. Begin makes it the device context of the calling thread
+ and carries over the render targets, viewport and the states RenderState knows about, so
+ the recording draws into what the frame had bound. Execute runs the list on the immediate
+ context and restores its state after, what RenderState and the ConstantBufferRing track is
+ still bound. The constant buffers the lists wrote aren't current anymore.
+*/
+class FDAPI D3DCommandList : public CommandList {
+private:
+	ID3D11DeviceContext* context;
+	ID3D11CommandList* commandList;
+
+public:
+	D3DCommandList();
+	~D3DCommandList();
+
+	void Begin() override;
+	void End() override;
+	void Execute() override;
+};
+
+}
@@ -1,4 +1,5 @@
 #include "d3dcontext.h"
+#include "renderstate.h"
 #include <core/window.h>
 #include <core/log.h>
 
@@ -6,6 +7,8 @@ namespace FD {
 
 D3DContext* D3DContext::pContext = nullptr;
 
+static thread_local ID3D11DeviceContext* threadContext = nullptr;
+
 D3DContext::D3DContext() {
 	device = nullptr;
 	context = nullptr;
@@ -16,6 +19,11 @@ D3DContext::D3DContext() {
 	window = nullptr;
 	adapter = nullptr;
 	monitor = nullptr;
+	activeDepthStencilView = nullptr;
+	numThreadContexts = 0;
+
+	ZeroMemory(activeRenderTargets, sizeof(activeRenderTargets));
+	ZeroMemory(&activeViewport, sizeof(D3D11_VIEWPORT));
 }
 
 D3DContext::~D3DContext() {
@@ -53,6 +61,8 @@ void D3DContext::CreateDevice(D3DAdapter* adapter) {
 
 	pContext->activeContext = pContext->context;
 	pContext->adapter = adapter;
+
+	RenderState::Invalidate();
 }
 
 void D3DContext::CreateSwapChain(Window* window, D3DOutput* output) {
@@ -112,7 +122,7 @@ void D3DContext::CreateSwapChain(Window* window, D3DOutput* output) {
 
 	pContext->window = window;
 	pContext->monitor = output;
-	pContext->context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	SetTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
 void D3DContext::CreateContext(Window* window, D3DAdapter* adapter, D3DOutput* monitor) {
@@ -164,6 +174,9 @@ void D3DContext::SetRenderTarget(ID3D11RenderTargetView* target) {
 void D3DContext::SetRenderTargets(uint16 numRenderTargets, ID3D11RenderTargetView** target, ID3D11DepthStencilView* depthView) {
 	GetDeviceContext()->OMSetRenderTargets(numRenderTargets, target, depthView);
 
+	//Targets that were bound as shader resources got unbound
+	RenderState::InvalidateResources();
+
 	ID3D11RenderTargetView** activeTargets = GetContext()->activeRenderTargets;
 
 	for (uint16 i = numRenderTargets; i < 8; i++)
@@ -189,12 +202,24 @@ void D3DContext::SetViewPort(float32 topLeftX, float32 topLeftY, float32 width,
 	v.MinDepth = 0.0f;
 	v.MaxDepth = 1.0f;
 
-
 	GetDeviceContext()->RSSetViewports(1, &v);
+
+	GetContext()->activeViewport = v;
 }
 
 void D3DContext::SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
-	GetDeviceContext()->IASetPrimitiveTopology(topology);
+	RenderState::SetTopology(topology);
+}
+
+void D3DContext::SetThreadDeviceContext(ID3D11DeviceContext* context) {
+	if (context && !threadContext) pContext->numThreadContexts.fetch_add(1, std::memory_order_relaxed);
+	else if (!context && threadContext) pContext->numThreadContexts.fetch_sub(1, std::memory_order_relaxed);
+
+	threadContext = context;
+}
+
+ID3D11DeviceContext* D3DContext::GetThreadDeviceContext() {
+	return threadContext ? threadContext : pContext->activeContext;
 }
 
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include <Windows.h>
 
+#include <atomic>
+
 #include "d3dfactory.h"
 #include "d3dadapter.h"
 #include "d3doutput.h"
@@ -24,6 +26,10 @@ private:
 private:
 	ID3D11RenderTargetView* activeRenderTargets[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
 	ID3D11DepthStencilView* activeDepthStencilView;
+	D3D11_VIEWPORT activeViewport;
+
+	//Threads that have a deferred context set with SetThreadDeviceContext
+	std::atomic<uint32> numThreadContexts;
 
 	ID3D11Device* device;
 	ID3D11DeviceContext* context;
@@ -67,12 +73,20 @@ public:
 	inline static ID3D11RenderTargetView* GetDefaultRenderTarget() { return D3DContext::GetContext()->renderTarget; }
 
 	inline static ID3D11RenderTargetView* GetActiveRenderTarget() { return pContext->activeRenderTargets[0]; }
+	inline static ID3D11RenderTargetView* const* GetActiveRenderTargets() { return pContext->activeRenderTargets; }
+	inline static ID3D11DepthStencilView* GetActiveDepthStencilView() { return pContext->activeDepthStencilView; }
+	inline static const D3D11_VIEWPORT& GetActiveViewPort() { return pContext->activeViewport; }
+
+	//While a thread records a command list GetDeviceContext returns its deferred context on that thread, nullptr ends it
+	static void SetThreadDeviceContext(ID3D11DeviceContext* context);
+	static ID3D11DeviceContext* GetThreadDeviceContext();
 
 	inline static Window* GetWindow() { return pContext->window; }
 
 	__forceinline static D3DContext* GetContext() { return pContext; }
 	__forceinline static ID3D11Device* GetDevice() { return pContext->device; }
-	__forceinline static ID3D11DeviceContext* GetDeviceContext() { return pContext->activeContext; }
+	__forceinline static ID3D11DeviceContext* GetDeviceContext() { return pContext->numThreadContexts.load(std::memory_order_relaxed) ? GetThreadDeviceContext() : pContext->activeContext; }
+	__forceinline static ID3D11DeviceContext* GetImmediateDeviceContext() { return pContext->context; }
 	__forceinline static IDXGISwapChain* GetSwapChain() { return  pContext->swapChain; }
 
 
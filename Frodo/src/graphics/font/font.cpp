@@ -2,6 +2,7 @@
 #include <core/log.h>
 #include <util/fileutils.h>
 #include <util/vfs/vfs.h>
+#include <core/profiler.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -51,7 +52,7 @@ Texture2D* GetCharFromFont(const String& fontName, uint32 character) {
 
 Font::Font(const String& fontFile, uint32 size, ivec2 dpi, FD_RANGE<>* range, uint32 num_ranges) {
 	uint_t memory_size = 0;
-	data = VFS::Get()->ReadFile(fontFile, &memory_size);
+	data = VFS::Get()->ReadFile(fontFile, &memory_size, FD_MEMTAG_FONT);
 
 	this->num_ranges = num_ranges;
 
@@ -70,7 +71,7 @@ Font::Font(void* memory, uint32 memory_size, uint32 size, ivec2 dpi, FD_RANGE<>*
 	ranges = new FD_RANGE<>[num_ranges];
 	memcpy(ranges, range, num_ranges * sizeof(FD_RANGE<>));
 	
-	data = new byte[memory_size];
+	data = (byte*)Memory::Allocate(memory_size, FD_MEMTAG_FONT);
 	memcpy(data, memory, memory_size);
 
 	if (!(initialized = LoadFontFileInternal(data, memory_size, size, dpi, range, num_ranges))) {
@@ -79,7 +80,7 @@ Font::Font(void* memory, uint32 memory_size, uint32 size, ivec2 dpi, FD_RANGE<>*
 }
 
 Font::~Font() {
-	delete[] data;
+	Memory::Free(data);
 	delete texture;
 	delete[] ranges;
 	FT_Done_Face(face);
@@ -87,6 +88,8 @@ Font::~Font() {
 }
 
 bool Font::LoadFontFileInternal(byte* memory, uint32 memory_size, uint32 size, ivec2 dpi, FD_RANGE<>* ranges, uint32 num_ranges) {
+	FD_PROFILE_SCOPE("Font::LoadFontFileInternal");
+
 	this->size = size;
 	uint32 numCharacters = 0;
 
@@ -135,7 +138,7 @@ bool Font::LoadFontFileInternal(byte* memory, uint32 memory_size, uint32 size, i
 
 			uint32 bitmap_size = bitmap.rows * bitmap.width;
 
-			glyph.bitmap = new byte[bitmap_size];
+			glyph.bitmap = (byte*)Memory::Allocate(bitmap_size, FD_MEMTAG_FONT);
 
 			memcpy(glyph.bitmap, bitmap.buffer, bitmap_size);
 
@@ -150,7 +153,7 @@ bool Font::LoadFontFileInternal(byte* memory, uint32 memory_size, uint32 size, i
 	uint32 bitmapWidth = bitmapSquareSize * segmentWidth;
 	uint32 bitmapHeight = bitmapSquareSize * segmentHeight;
 
-	byte* bitmapData = new byte[bitmapWidth * bitmapHeight];
+	byte* bitmapData = (byte*)Memory::Allocate(bitmapWidth * bitmapHeight, FD_MEMTAG_FONT);
 	memset(bitmapData, 0, bitmapWidth * bitmapHeight);
 
 	float32 xStep = (float32)segmentWidth / (float32)bitmapWidth;
@@ -184,13 +187,14 @@ bool Font::LoadFontFileInternal(byte* memory, uint32 memory_size, uint32 size, i
 			}
 
 			currentGlyph++;
-			delete[] glyph.bitmap;
+			Memory::Free(glyph.bitmap);
+			glyph.bitmap = nullptr;
 		}
 	}
 
 	texture = new Texture2D(bitmapData, bitmapWidth, bitmapHeight, FD_TEXTURE_FORMAT_UINT_8);
 
-	delete[] bitmapData;
+	Memory::Free(bitmapData);
 
 	return true;
 }
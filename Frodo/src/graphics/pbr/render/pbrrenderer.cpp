@@ -3,18 +3,19 @@
 namespace FD {
 
 void PBRStaticRenderer::Submit(const RenderCommand& cmd) {
-	commandQueue.Push_back(cmd);
+	commandQueue.Push(cmd);
 }
 
 void PBRStaticRenderer::Submit(Entity3D* e) {
 	Submit(e->GetMesh(), e->GetTransform());
 }
 
-void PBRStaticRenderer::Submit(Mesh* mesh, mat4 transform) {
+void PBRStaticRenderer::Submit(Mesh* mesh, const mat4& transform) {
 	RenderCommand cmd;
 	cmd.mesh = mesh;
 	cmd.shader = mesh->GetMaterial()->GetShader();
 	cmd.transform = transform;
+	cmd.pass = 0;
 	Submit(cmd);
 }
 
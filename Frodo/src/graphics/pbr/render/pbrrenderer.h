@@ -4,23 +4,34 @@
 #include <graphics/render/light/light.h>
 #include <graphics/shader/shader.h>
 #include <graphics/render/renderer/renderer.h>
+#include <graphics/render/renderer/renderqueue.h>
 #include <graphics/render/camera/camera.h>
 #include <entity/entity.h>
+#include <core/commandlist.h>
 
-namespace FD {
+//Fewer batches than this are drawn on the main thread, more are split into chunks at least this big
+#define FD_PBR_RECORD_CHUNK_SIZE 128
 
-struct RenderCommand {
-	Mesh* mesh;
-	mat4 transform;
-	Shader* shader;
-};
+namespace FD {
 
 class FDAPI PBRStaticRenderer : public Renderer {
 private:
 	Shader::ConstantBufferSlot light;
 	Shader::ConstantBufferSlot camera;
 
-	List<RenderCommand> commandQueue;
+	RenderQueue commandQueue;
+	vec3 viewPosition;
+
+	//Transforms of the instanced batches, rewritten every frame and grown when it's too small
+	VertexBuffer* instanceBuffer;
+	uint32 instanceCapacity;
+
+	//A D3DCommandList per worker, batches are recorded on the job system and executed in order
+	ParallelRecorder recorder;
+
+	void UploadInstances();
+	//Binds everything from scratch, the batches can be recorded on any thread
+	void DrawBatches(uint_t begin, uint_t end);
 public:
 	PBRStaticRenderer(Window* window);
 	~PBRStaticRenderer();
@@ -31,9 +42,9 @@ public:
 	void Submit(const List<Light*>& lights) override;
 	void Submit(Entity3D* entity) override;
 	void Submit(const RenderCommand& cmd);
-	void Submit(Mesh* mesh, mat4 transform);
+	void Submit(Mesh* mesh, const mat4& transform) override;
 	void End() override;
 
-	inline List<RenderCommand> GetCommandQueue() const { return commandQueue; }
+	inline RenderQueue& GetCommandQueue() { return commandQueue; }
 };
 }
\ No newline at end of file
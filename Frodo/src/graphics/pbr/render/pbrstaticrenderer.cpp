@@ -1,5 +1,8 @@
 #include "pbrrenderer.h"
 #include <core/window.h>
+#include <core/profiler.h>
+#include <core/jobsystem.h>
+#include <graphics/d3dcommandlist.h>
 
 namespace FD {
 
@@ -11,7 +14,7 @@ struct Ca {
 	mat4 proj;
 };
 
-PBRStaticRenderer::PBRStaticRenderer(Window* window) : Renderer(window) {
+PBRStaticRenderer::PBRStaticRenderer(Window* window) : Renderer(window), instanceBuffer(nullptr), instanceCapacity(0) {
 	light.semRegister = 6;
 	light.structSize = sizeof(PointLight);
 	light.data = new byte[light.structSize];
@@ -25,20 +28,27 @@ PBRStaticRenderer::PBRStaticRenderer(Window* window) : Renderer(window) {
 	camera.semRegister = 1;
 	camera.structSize = l.GetSize();
 	camera.data = new byte[camera.structSize];
-	
+
+	uint32 workers = JobSystem::GetNumWorkers();
+
+	if (workers > 1) {
+		for (uint32 i = 0; i < workers; i++) recorder.AddList(new D3DCommandList);
+	}
 }
 
 PBRStaticRenderer::~PBRStaticRenderer() {
 	delete light.data;
 	delete camera.data;
+	delete instanceBuffer;
 }
 
 void PBRStaticRenderer::Begin(Camera* cam) {
 	commandQueue.Clear();
+	viewPosition = cam->GetPosition();
 
-	camera.SetElement("c_Position", (void*)&cam->GetPosition());
-	camera.SetElement("c_ViewMatrix", (void*)cam->GetViewMatrix().GetData());
-	camera.SetElement("c_ProjectionMatrix", (void*)cam->GetProjectionMatrix().GetData());
+	camera.SetElement(FD_SID("c_Position"), (void*)&cam->GetPosition());
+	camera.SetElement(FD_SID("c_ViewMatrix"), (void*)cam->GetViewMatrix().GetData());
+	camera.SetElement(FD_SID("c_ProjectionMatrix"), (void*)cam->GetProjectionMatrix().GetData());
 }
 
 void PBRStaticRenderer::Submit(const List<Light*>& lights) {
@@ -55,15 +65,83 @@ void PBRStaticRenderer::End() {
 
 }
 
+void PBRStaticRenderer::UploadInstances() {
+	uint32 numInstances = commandQueue.GetNumInstances();
+
+	if (numInstances == 0) return;
+
+	if (numInstances > instanceCapacity) {
+		delete instanceBuffer;
+
+		instanceCapacity = numInstances + (numInstances >> 1);
+		instanceBuffer = new VertexBuffer(sizeof(mat4), instanceCapacity);
+	}
+
+	commandQueue.WriteInstances((mat4*)instanceBuffer->Map(FD_MAP_WRITE_DISCARD));
+	instanceBuffer->Unmap();
+}
+
+void PBRStaticRenderer::DrawBatches(uint_t begin, uint_t end) {
+	Shader* shader = nullptr;
+	Material* material = nullptr;
+	Mesh* mesh = nullptr;
+
+	if (commandQueue.GetNumInstances() > 0) instanceBuffer->Bind(FD_BUFFER_LAYOUT_INSTANCE_SLOT);
+
+	//Sorted by shader, material and mesh, each only changes where the key does
+	const List<RenderBatch>& batches = commandQueue.GetBatches();
+
+	for (uint_t i = begin; i < end; i++) {
+		const RenderBatch& batch = batches.Get(i);
+		const RenderCommand& cmd = commandQueue[batch.first];
+
+		if (cmd.shader != shader) {
+			shader = cmd.shader;
+			shader->SetVSConstantBuffer(camera);
+			shader->SetVSConstantBuffer(light);
+
+			FD_ASSERT_MSG(shader->IsInstanced() && shader->GetInstanceStride() != sizeof(mat4), "[PBRStaticRenderer] Instanced shaders take the model matrix as their only instance data");
+
+			material = nullptr;
+		}
+
+		if (cmd.mesh->GetMaterial() != material) {
+			material = cmd.mesh->GetMaterial();
+			material->Bind(shader);
+		}
+
+		if (cmd.mesh != mesh) {
+			mesh = cmd.mesh;
+			mesh->Bind();
+		}
+
+		if (shader->IsInstanced()) {
+			mesh->DrawInstanced(batch.count, batch.firstInstance);
+		} else {
+			shader->SetVSConstantBuffer(FD_SID("Model"), (void*)cmd.transform.GetData());
+			mesh->Draw();
+		}
+	}
+}
+
 void PBRStaticRenderer::Present() {
-	
-	uint_t size = commandQueue.GetSize();
-	for (uint_t i = 0; i < size; i++) {
-		const RenderCommand& cmd = commandQueue[i];
-		cmd.shader->SetVSConstantBuffer(camera);
-		cmd.shader->SetVSConstantBuffer(light);
-		cmd.shader->SetVSConstantBuffer("Model", (void*)cmd.transform.GetData());
-		cmd.mesh->Render();
+	FD_PROFILE_SCOPE("PBRStaticRenderer::Present");
+
+	commandQueue.Sort(viewPosition);
+
+	UploadInstances();
+
+	uint_t size = commandQueue.GetBatches().GetSize();
+
+	if (recorder.GetNumLists() == 0 || size < FD_PBR_RECORD_CHUNK_SIZE * 2) {
+		DrawBatches(0, size);
+		return;
 	}
+
+	recorder.Record(size, FD_PBR_RECORD_CHUNK_SIZE, [this](CommandList* list, uint_t begin, uint_t end) {
+		DrawBatches(begin, end);
+	});
+
+	recorder.Execute();
 }
 }
\ No newline at end of file
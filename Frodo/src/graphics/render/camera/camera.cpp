@@ -3,7 +3,7 @@
 namespace FD {
 
 void Camera::UpdateViewMatrix() {
-	viewMatrix = mat4::Rotate(rotation) * mat4::Translate(-position);
+	viewMatrix = mat4::Rotate(orientation) * mat4::Translate(-position);
 }
 
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ class FDAPI Camera {
 protected:
 	vec3 position;
 	vec3 rotation;
+	quat orientation;
 	vec3 velocity;
 
 	mat4 viewMatrix;
@@ -18,16 +19,18 @@ protected:
 	virtual void UpdateViewMatrix();
 
 public:
-	Camera(const vec3& position, const vec3& rotation = vec3(0, 0, 0)) : position(position), rotation(rotation) { UpdateViewMatrix(); }
+	Camera(const vec3& position, const vec3& rotation = vec3(0, 0, 0)) : position(position), rotation(rotation), orientation(quat::FromEuler(rotation)) { UpdateViewMatrix(); }
 
 	inline void SetPosition(const vec3& position) { this->position = position; UpdateViewMatrix(); }
-	inline void SetRotation(const vec3& rotation) { this->rotation = rotation; UpdateViewMatrix(); }
+	inline void SetRotation(const vec3& rotation) { this->rotation = rotation; orientation = quat::FromEuler(rotation); UpdateViewMatrix(); }
+	inline void SetRotation(const quat& orientation) { this->orientation = orientation; rotation = orientation.ToEuler(); UpdateViewMatrix(); }
 	inline void SetProjection(const mat4& matrix) { this->projectionMatrix = matrix; }
 
 	inline mat4 GetProjectionMatrix() const { return projectionMatrix; }
 	inline mat4 GetViewMatrix() { return viewMatrix; }
 	inline vec3 GetPosition() const { return position; }
 	inline vec3 GetRotation() const { return rotation; }
+	inline quat GetOrientation() const { return orientation; }
 	inline vec3 GetVelocity() const { return velocity; }
 
 	inline vec3 GetRight() const {
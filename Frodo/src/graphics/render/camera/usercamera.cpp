@@ -91,6 +91,8 @@ bool UserCamera::OnMouseActionMoveRelative(ivec2 position) {
 	rotation.x -= (float32)position.y * SENSE;
 	rotation.y += (float32)position.x * SENSE;
 
+	orientation = quat::FromEuler(rotation);
+
 	return false;
 }
 
@@ -12,7 +12,7 @@ private:
 	float32 x, y;
 
 public:
-	UserCamera(const vec3& position, const vec3& rotation) : Camera(position, rotation) {}
+	UserCamera(const vec3& position, const vec3& rotation) : Camera(position, rotation), EventListener(FD_EVENT_MASK(FD_KEYBOARD_ACTION_KEY_PRESSED) | FD_EVENT_MASK(FD_KEYBOARD_ACTION_KEY_RELEASED) | FD_EVENT_MASK(FD_MOUSE_ACTION_MOVE_RELATIVE) | FD_EVENT_MASK_WINDOW_STATE) {}
 	~UserCamera() {}
 
 	virtual void Update(float32 delta);
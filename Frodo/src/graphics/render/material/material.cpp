@@ -1,5 +1,7 @@
 #include "material.h"
 #include <core/log.h>
+#include <core/framestats.h>
+#include <graphics/renderstate.h>
 
 namespace FD {
 
@@ -65,6 +67,8 @@ void Material::Bind(Shader* shader) {
 		pair.data->Bind(pair.key);
 	}
 
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_TEXTURE_BINDS, size);
+
 	size = samplers.GetKeyList().GetSize();
 
 	for (uint_t i = 0; i < size; i++) {
@@ -75,10 +79,8 @@ void Material::Bind(Shader* shader) {
 	shader->Bind();
 }
 
-ID3D11ShaderResourceView* views[128];
-
 void Material::UnBindTextures() {
-	D3DContext::GetDeviceContext()->PSSetShaderResources(0, textures.GetItems(), views);
+	RenderState::SetPSResources(0, textures.GetItems(), nullptr);
 }
 
 void Material::SetTexture(const String& name, const Texture* texture) {
@@ -109,6 +111,8 @@ void Material::SetVCBuffer(const String& name, const void* data) {
 
 	if (data) memcpy(vCBuffer.data, data, toCopy);
 	else memset(vCBuffer.data, 0, toCopy);
+
+	vCBuffer.Changed();
 }
 
 void Material::SetPCBuffer(const String& name, const void* data) {
@@ -131,22 +135,38 @@ void Material::SetPCBuffer(const String& name, const void* data) {
 
 	if (data) memcpy(pCBuffer.data, data, toCopy);
 	else memset(pCBuffer.data, 0, toCopy);
+
+	pCBuffer.Changed();
 }
 
 void Material::SetVCBufferElement(const String& name, void* data) {
 	vCBuffer.SetElement(name, data);
+	vCBuffer.Changed();
 }
 
 void Material::SetPCBufferElement(const String& name, void* data) {
 	pCBuffer.SetElement(name, data);
+	pCBuffer.Changed();
+}
+
+void Material::SetVCBufferElement(StringID id, void* data) {
+	vCBuffer.SetElement(id, data);
+	vCBuffer.Changed();
+}
+
+void Material::SetPCBufferElement(StringID id, void* data) {
+	pCBuffer.SetElement(id, data);
+	pCBuffer.Changed();
 }
 
 void Material::SetVCBufferElement(uint32 index, void* data) {
 	vCBuffer.SetElement(index, data);
+	vCBuffer.Changed();
 }
 
 void Material::SetPCBufferElement(uint32 index, void* data) {
 	pCBuffer.SetElement(index, data);
+	pCBuffer.Changed();
 }
 
 }
\ No newline at end of file
@@ -49,6 +49,20 @@ public:
 	inline void SetVCBufferElement(const String& name, mat3 data) { SetVCBufferElement(name, &data); }
 	inline void SetPCBufferElement(const String& name, mat4 data) { SetPCBufferElement(name, &data); }
 
+	void SetVCBufferElement(StringID id, void* data);
+	void SetPCBufferElement(StringID id, void* data);
+
+	inline void SetVCBufferElement(StringID id, float32 data) { SetVCBufferElement(id, &data); }
+	inline void SetPCBufferElement(StringID id, float32 data) { SetPCBufferElement(id, &data); }
+	inline void SetVCBufferElement(StringID id, vec2 data) { SetVCBufferElement(id, &data); }
+	inline void SetPCBufferElement(StringID id, vec2 data) { SetPCBufferElement(id, &data); }
+	inline void SetVCBufferElement(StringID id, vec3 data) { SetVCBufferElement(id, &data); }
+	inline void SetPCBufferElement(StringID id, vec3 data) { SetPCBufferElement(id, &data); }
+	inline void SetVCBufferElement(StringID id, vec4 data) { SetVCBufferElement(id, &data); }
+	inline void SetPCBufferElement(StringID id, vec4 data) { SetPCBufferElement(id, &data); }
+	inline void SetVCBufferElement(StringID id, mat3 data) { SetVCBufferElement(id, &data); }
+	inline void SetPCBufferElement(StringID id, mat4 data) { SetPCBufferElement(id, &data); }
+
 	void SetVCBufferElement(uint32 index, void* data);
 	void SetPCBufferElement(uint32 index, void* data);
 
@@ -1,4 +1,5 @@
 #include "mesh.h"
+#include <core/framestats.h>
 
 namespace FD {
 
@@ -9,6 +10,9 @@ void Mesh::Render() {
 	iBuffer->Bind();
 	D3DContext::GetDeviceContext()->DrawIndexed(iBuffer->GetCount(), 0, 0);
 
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_VERTICES, iBuffer->GetCount());
+
 }
 
 void Mesh::Render(Shader* shader) {
@@ -18,13 +22,35 @@ void Mesh::Render(Shader* shader) {
 	iBuffer->Bind();
 	D3DContext::GetDeviceContext()->DrawIndexed(iBuffer->GetCount(), 0, 0);
 
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_VERTICES, iBuffer->GetCount());
+
 	if (material) material->UnBindTextures();
 }
 
 void Mesh::RenderWithoutMaterial() {
+	Bind();
+	Draw();
+}
+
+void Mesh::Bind() {
 	vBuffer->Bind();
 	iBuffer->Bind();
+}
+
+void Mesh::Draw() {
 	D3DContext::GetDeviceContext()->DrawIndexed(iBuffer->GetCount(), 0, 0);
+
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_VERTICES, iBuffer->GetCount());
+}
+
+void Mesh::DrawInstanced(uint32 count, uint32 first) {
+	D3DContext::GetDeviceContext()->DrawIndexedInstanced(iBuffer->GetCount(), count, 0, 0, first);
+
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_VERTICES, (uint64)iBuffer->GetCount() * count);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_INSTANCES, count);
 }
 
 }
\ No newline at end of file
@@ -22,6 +22,12 @@ public:
 	void Render(Shader* shader);
 	void RenderWithoutMaterial();
 
+	//The buffers and the draw on their own, for renderers that bind the material themselves
+	void Bind();
+	void Draw();
+	//Instances first to first + count - 1 of the bound instance buffer
+	void DrawInstanced(uint32 count, uint32 first);
+
 	inline VertexBuffer* GetVertexBuffer() { return vBuffer; }
 	inline IndexBuffer* GetIndexBuffer() { return iBuffer; }
 	inline Material* GetMaterial() { return material; }
@@ -3,6 +3,7 @@
 #include <util/fileutils.h>
 #include <core/log.h>
 #include <util/vfs/vfs.h>
+#include <core/profiler.h>
 
 namespace FD {
 
@@ -224,23 +225,30 @@ Mesh* MeshFactory::CreateCube(float32 width, float32 height, float32 depth, Mate
 }
 
 Mesh* MeshFactory::LoadFromFile(const String& filename, Material* material, bool generateTangents) {
+	FD_PROFILE_SCOPE("MeshFactory::LoadFromFile");
 
 	if (filename.EndsWith(".obj")) {
 		List<vec3> vertices, normals, tangents;
 		List<vec2> texCoords;
 		List<uint32> indices;
 
+		vertices.SetMemoryTag(FD_MEMTAG_MESH);
+		normals.SetMemoryTag(FD_MEMTAG_MESH);
+		tangents.SetMemoryTag(FD_MEMTAG_MESH);
+		texCoords.SetMemoryTag(FD_MEMTAG_MESH);
+		indices.SetMemoryTag(FD_MEMTAG_MESH);
+
 		FD_DEBUG("[MeshFactory] Loading \"%s\"", *filename);
 		FD_DEBUG("[MeshFactory] Loading text file");
 		String text = VFS::Get()->ReadTextFile(filename);
 
 		//TODO: better implementation
 		if (!generateTangents) {
-			ParseOBJ(text, vertices, texCoords, normals, indices);
+			OBJParser::Parse(text, vertices, texCoords, normals, indices);
 
 			uint_t vertNum = vertices.GetSize();
 
-			VertexT* vert = new VertexT[vertNum];
+			VertexT* vert = Memory::NewArray<VertexT>(vertNum, FD_MEMTAG_MESH);
 
 			FD_DEBUG("[MeshFactory] Moving data");
 			for (uint_t i = 0; i < vertNum; i++) {
@@ -255,6 +263,8 @@ Mesh* MeshFactory::LoadFromFile(const String& filename, Material* material, bool
 			VertexBuffer* vbo = new VertexBuffer(vert, vertNum * sizeof(VertexT), sizeof(VertexT));
 			IndexBuffer* ibo = new IndexBuffer(indices.GetData(), (uint32)indices.GetSize());
 
+			Memory::DeleteArray(vert);
+
 			FD_DEBUG("[MeshFactory] Loading complete!\n");
 			return new Mesh(vbo, ibo, material);
 		} else {
@@ -262,7 +272,7 @@ Mesh* MeshFactory::LoadFromFile(const String& filename, Material* material, bool
 
 			uint_t vertNum = vertices.GetSize();
 
-			VertexT* vert = new VertexT[vertNum];
+			VertexT* vert = Memory::NewArray<VertexT>(vertNum, FD_MEMTAG_MESH);
 
 			FD_DEBUG("[MeshFactory] Moving data");
 			for (uint_t i = 0; i < vertNum; i++) {
@@ -277,6 +287,8 @@ Mesh* MeshFactory::LoadFromFile(const String& filename, Material* material, bool
 			VertexBuffer* vbo = new VertexBuffer(vert, vertNum * sizeof(VertexT), sizeof(VertexT));
 			IndexBuffer* ibo = new IndexBuffer(indices.GetData(), (uint32)indices.GetSize());
 
+			Memory::DeleteArray(vert);
+
 			FD_DEBUG("[MeshFactory] Loading complete!\n");
 			return new Mesh(vbo, ibo, material);
 		}
@@ -289,86 +301,14 @@ Mesh* MeshFactory::LoadFromFile(const String& filename, Material* material, bool
 
 }
 
-void MeshFactory::ParseOBJ(const String obj, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<uint32>& indices) {
-
-	List<Face<3>> faces;
-	List<String*> lines = obj.Split('\n');
-	List<vec3> tmpVertices, tmpNormals;
-	List<vec2> tmpTexCoords;
-
-
-
-	uint_t numLines = lines.GetSize();
-	FD_DEBUG("[MeshFactory] Parsing text");
-
-	for (int32 i = 0; i < numLines; i++) {
-		String line = lines[i];
-
-		if (line.StartsWith("v ")) {
-			vec3 vert;
-			sscanf(*line, "v %f %f %f", &vert.x, &vert.y, &vert.z);
-			tmpVertices.Push_back(vert);
-		} else if (line.StartsWith("vt ")) {
-			vec2 tex;
-			sscanf(*line, "vt %f %f", &tex.x, &tex.y);
-			tmpTexCoords.Push_back(tex);
-		} else if (line.StartsWith("vn ")) {
-			vec3 norm;
-			sscanf(*line, "vn %f %f %f", &norm.x, &norm.y, &norm.z);
-			tmpNormals.Push_back(norm);
-		} else if (line.StartsWith("f ")) {
-			Face<3> face;
-			sscanf(*line, "f %u/%u/%u %u/%u/%u %u/%u/%u", &face[0].vertex, &face[0].texCoord, &face[0].normal, &face[1].vertex, &face[1].texCoord, &face[1].normal, &face[2].vertex, &face[2].texCoord, &face[2].normal);
-			faces.Push_back(face);
-		}
-	}
-
-	FD_DEBUG("[MeshFactory] Found %u vertices %u normals %u uvs %u faces", tmpVertices.GetSize(), tmpNormals.GetSize(), tmpTexCoords.GetSize(), faces.GetSize());
-	FD_DEBUG("[MeshFactory] Allocating space");
-	texCoords.Resize(faces.GetSize() * 3);
-	normals.Resize(faces.GetSize() * 3);
-	vertices.Resize(faces.GetSize() * 3);
-
-	FD_DEBUG("[MeshFactory] Making faces");
-	MakeFacesOBJ(vertices, tmpVertices, texCoords, tmpTexCoords, normals, tmpNormals, indices, faces);
-
-	lines.Free();
-}
-
 void MeshFactory::ParseOBJT(const String obj, List<vec3>& vertices, List<vec2>& texCoords, List<vec3>& normals, List<vec3>& tangents, List<uint32>& indices) {
 
-	List<Face<3>> faces;
-	List<String*> lines = obj.Split('\n');
+	List<OBJFace> faces;
 	List<vec3> tmpVertices, tmpNormals;
 	List<vec2> tmpTexCoords;
 
+	OBJParser::ReadFaces(obj, tmpVertices, tmpTexCoords, tmpNormals, faces);
 
-	uint_t numLines = lines.GetSize();
-	FD_DEBUG("[MeshFactory] Parsing text");
-
-	for (int32 i = 0; i < numLines; i++) {
-		String line = lines[i];
-
-		if (line.StartsWith("v ")) {
-			vec3 vert;
-			sscanf(*line, "v %f %f %f", &vert.x, &vert.y, &vert.z);
-			tmpVertices.Push_back(vert);
-		} else if (line.StartsWith("vt ")) {
-			vec2 tex;
-			sscanf(*line, "vt %f %f", &tex.x, &tex.y);
-			tmpTexCoords.Push_back(tex);
-		} else if (line.StartsWith("vn ")) {
-			vec3 norm;
-			sscanf(*line, "vn %f %f %f", &norm.x, &norm.y, &norm.z);
-			tmpNormals.Push_back(norm);
-		} else if (line.StartsWith("f ")) {
-			Face<3> face;
-			sscanf(*line, "f %u/%u/%u %u/%u/%u %u/%u/%u", &face[0].vertex, &face[0].texCoord, &face[0].normal, &face[1].vertex, &face[1].texCoord, &face[1].normal, &face[2].vertex, &face[2].texCoord, &face[2].normal);
-			faces.Push_back(face);
-		}
-	}
-
-	FD_DEBUG("[MeshFactory] Found %u vertices %u normals %u uvs %u faces", tmpVertices.GetSize(), tmpNormals.GetSize(), tmpTexCoords.GetSize(), faces.GetSize());
 	FD_DEBUG("[MeshFactory] Allocating space");
 	texCoords.Resize(faces.GetSize() * 3);
 	normals.Resize(faces.GetSize() * 3);
@@ -377,33 +317,9 @@ void MeshFactory::ParseOBJT(const String obj, List<vec3>& vertices, List<vec2>&
 
 	FD_DEBUG("[MeshFactory] Making faces");
 	MakeFacesOBJT(vertices, tmpVertices, texCoords, tmpTexCoords, normals, tmpNormals, tangents, indices, faces);
-
-	lines.Free();
 }
 
-
-void MeshFactory::MakeFacesOBJ(List<vec3>& vertices, List<vec3>& tmpVertices, List<vec2>& texCoords, List<vec2>& tmpTexCoords, List<vec3>& normals, List<vec3>& tmpNormals, List<uint32>& indices, List<Face<3>> faces) {
-
-	uint_t numFaces = faces.GetSize();
-
-	indices.Reserve(numFaces * 3);
-#pragma omp for
-	for (int32 i = 0; i < numFaces; i++) {
-		Face<3> face = faces[i];
-		for (int32 j = 0; j < 3; j++) {
-			uint32 index = i * 3 + j;//indices.GetSize();
-
-			indices.Push_back(index);
-			vertices[index] = tmpVertices[face[j].vertex - 1];
-			texCoords[index] = tmpTexCoords[face[j].texCoord - 1];
-			normals[index] = tmpNormals[face[j].normal - 1];
-		}
-	}
-}
-
-
-
-void MeshFactory::MakeFacesOBJT(List<vec3>& vertices, List<vec3>& tmpVertices, List<vec2>& texCoords, List<vec2>& tmpTexCoords, List<vec3>& normals, List<vec3>& tmpNormals, List<vec3>& tangents, List<uint32>& indices, List<Face<3>> faces) {
+void MeshFactory::MakeFacesOBJT(List<vec3>& vertices, List<vec3>& tmpVertices, List<vec2>& texCoords, List<vec2>& tmpTexCoords, List<vec3>& normals, List<vec3>& tmpNormals, List<vec3>& tangents, List<uint32>& indices, List<OBJFace>& faces) {
 
 	uint_t numFaces = faces.GetSize();
 
@@ -436,7 +352,7 @@ void MeshFactory::MakeFacesOBJT(List<vec3>& vertices, List<vec3>& tmpVertices, L
 	uint32 index = 0;
 
 	for (int32 i = 0; i < numFaces; i++) {
-		Face<3> face = faces[i];
+		OBJFace face = faces[i];
 		
 		//vertex 0
 		//uint32 index0 = i * 3 + 0;
@@ -1,17 +1,21 @@
 #include "batchrenderer.h"
 
 #include <graphics/shader/shaderfactory.h>
+#include <core/profiler.h>
+#include <core/framestats.h>
+#include <graphics/renderstate.h>
+#include <graphics/renderstatecache.h>
 
 namespace FD {
 
 
 void BatchRenderer::SetBlendingInternal(bool enable_blending) {
 	float32 factor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	D3DContext::GetDeviceContext()->OMSetBlendState(blendState[enable_blending ? 1 : 0], factor, 0xFFFFFFFF);
+	RenderState::SetBlendState(blendState[enable_blending ? 1 : 0], factor, 0xFFFFFFFF);
 }
 
 void BatchRenderer::SetDepthInternal(bool enable_depthtesting) {
-	D3DContext::GetDeviceContext()->OMSetDepthStencilState(depthState[enable_depthtesting ? 1 : 0], 0);
+	RenderState::SetDepthStencilState(depthState[enable_depthtesting ? 1 : 0], 0);
 }
 
 void BatchRenderer::CreateBlendStates() {
@@ -31,7 +35,7 @@ void BatchRenderer::CreateBlendStates() {
 	desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&desc, &blendState[0]);
+	blendState[0] = RenderStateCache::GetBlendState(desc);
 
 	// ENABLED
 
@@ -46,7 +50,7 @@ void BatchRenderer::CreateBlendStates() {
 	desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&desc, &blendState[1]);
+	blendState[1] = RenderStateCache::GetBlendState(desc);
 }
 
 
@@ -63,7 +67,7 @@ void BatchRenderer::CreateDepthStates() {
 
 	desc.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&desc, &depthState[1]);
+	depthState[1] = RenderStateCache::GetDepthStencilState(desc);
 
 	ZeroMemory(&desc, sizeof(D3D11_DEPTH_STENCIL_DESC));
 
@@ -78,7 +82,7 @@ void BatchRenderer::CreateDepthStates() {
 
 	desc.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&desc, &depthState[0]);
+	depthState[0] = RenderStateCache::GetDepthStencilState(desc);
 }
 
 
@@ -141,13 +145,11 @@ BatchRenderer::~BatchRenderer() {
 	delete vbo;
 	delete shader;
 
-	DX_FREE(blendState[0]);
-	DX_FREE(blendState[1]);
-	DX_FREE(depthState[0]);
-	DX_FREE(depthState[1]);
 }
 
 void BatchRenderer::Present() {
+	FD_PROFILE_SCOPE("BatchRenderer::Present");
+
 	SetBlendingInternal(blending);
 	SetDepthInternal(depthTesting);
 
@@ -163,6 +165,9 @@ void BatchRenderer::Present() {
 
 	D3DContext::GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
 
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_VERTICES, indexCount);
+
 	SetBlendingInternal(false);
 	SetDepthInternal(true);
 }
@@ -2,14 +2,16 @@
 #include <core/window.h>
 #include <graphics/shader/shaderfactory.h>
 #include <graphics/buffer/bufferlayout.h>
+#include <graphics/renderstate.h>
+#include <graphics/renderstatecache.h>
 
 
 void DeferredRenderer::SetBlendingInternal(bool blending) {
-	D3DContext::GetDeviceContext()->OMSetBlendState(blending ? blendState[1] : blendState[0], nullptr, 0xFFFFFFFF);
+	RenderState::SetBlendState(blending ? blendState[1] : blendState[0], nullptr, 0xFFFFFFFF);
 }
 
 void DeferredRenderer::SetDepthInternal(bool depth) {
-	D3DContext::GetDeviceContext()->OMSetDepthStencilState(depth ? depthState[1] : depthState[0], 0);
+	RenderState::SetDepthStencilState(depth ? depthState[1] : depthState[0], 0);
 }
 
 void DeferredRenderer::CreateDepthStates() {
@@ -25,7 +27,7 @@ void DeferredRenderer::CreateDepthStates() {
 
 	desc.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&desc, &depthState[1]);
+	depthState[1] = RenderStateCache::GetDepthStencilState(desc);
 
 	ZeroMemory(&desc, sizeof(D3D11_DEPTH_STENCIL_DESC));
 
@@ -40,7 +42,7 @@ void DeferredRenderer::CreateDepthStates() {
 
 	desc.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&desc, &depthState[0]);
+	depthState[0] = RenderStateCache::GetDepthStencilState(desc);
 }
 
 void DeferredRenderer::CreateBlendStates() {
@@ -55,7 +57,7 @@ void DeferredRenderer::CreateBlendStates() {
 	desc.RenderTarget[0].BlendEnable = false;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&desc, &blendState[0]);
+	blendState[0] = RenderStateCache::GetBlendState(desc);
 
 
 	// ENABLED
@@ -71,7 +73,7 @@ void DeferredRenderer::CreateBlendStates() {
 	desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&desc, &blendState[1]);
+	blendState[1] = RenderStateCache::GetBlendState(desc);
 }
 
 void DeferredRenderer::CreateShaders() {
@@ -115,6 +117,8 @@ void DeferredRenderer::CreateShaders() {
 }
 
 DeferredRenderer::DeferredRenderer(Window* window) : Renderer(window, nullptr) {
+	SetEventMask(FD_EVENT_MASK(FD_WINDOW_ACTION_RESIZE));
+
 	CreateDepthStates();
 	CreateBlendStates();
 	
@@ -151,10 +155,6 @@ DeferredRenderer::~DeferredRenderer() {
 	delete pointLightShader;
 	delete spotLightShader;
 
-	DX_FREE(depthState[0]);
-	DX_FREE(blendState[0]);
-	DX_FREE(depthState[1]);
-	DX_FREE(blendState[1]);
 }
 
 void DeferredRenderer::SetProjectionMatrix(const mat4& matrix) {
@@ -278,9 +278,7 @@ void DeferredRenderer::Render() {
 		D3DContext::GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
 	}
 
-	ID3D11ShaderResourceView* v[3]{nullptr, nullptr, nullptr};
-
-	D3DContext::GetDeviceContext()->PSSetShaderResources(0, 3, v);
+	RenderState::SetPSResources(0, 3, nullptr);
 }
 
 bool DeferredRenderer::OnWindowActionResize(ivec2 size) {
@@ -145,7 +145,7 @@ void FontRenderer::SubmitTextAlignRight(const String& text, Font* font, vec2 pos
 	if (lineLength == (uint_t)-1) {
 		lineLength = (uint_t)font->GetFontMetrics(text, scale).x;
 	} else {
-		lineLength = (uint_t)font->GetFontMetrics(text.SubString(0, lineLength + 1), scale).x;
+		lineLength = (uint_t)font->GetFontMetrics(text.SubString(0, lineLength + 1, FD_MEMTAG_FRAME), scale).x;
 	}
 
 	float32 xPos = position.x - lineLength;
@@ -162,9 +162,9 @@ void FontRenderer::SubmitTextAlignRight(const String& text, Font* font, vec2 pos
 			lineLength = text.Find("\n", lastNewLine);
 
 			if (lineLength == (uint_t)-1) {
-				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, textLength - lastNewLine), scale).x;
+				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, textLength - lastNewLine, FD_MEMTAG_FRAME), scale).x;
 			} else {
-				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, lineLength + 1), scale).x;
+				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, lineLength + 1, FD_MEMTAG_FRAME), scale).x;
 			}
 
 			lastNewLine = lineLength + 1;
@@ -223,7 +223,7 @@ void FontRenderer::SubmitTextAlignCenter(const String& text, Font* font, vec2 po
 	if (lineLength == (uint_t)-1) {
 		lineLength = (uint_t)font->GetFontMetrics(text, scale).x;
 	} else {
-		lineLength = (uint_t)font->GetFontMetrics(text.SubString(0, lineLength + 1), scale).x;
+		lineLength = (uint_t)font->GetFontMetrics(text.SubString(0, lineLength + 1, FD_MEMTAG_FRAME), scale).x;
 	}
 
 	float32 xPos = position.x - (lineLength >> 1);
@@ -240,9 +240,9 @@ void FontRenderer::SubmitTextAlignCenter(const String& text, Font* font, vec2 po
 			lineLength = text.Find("\n", lastNewLine);
 
 			if (lineLength == (uint_t)-1) {
-				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, textLength - lastNewLine), scale).x;
+				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, textLength - lastNewLine, FD_MEMTAG_FRAME), scale).x;
 			} else {
-				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, lineLength + 1), scale).x;
+				lineLength = (uint_t)font->GetFontMetrics(text.SubString(lastNewLine, lineLength + 1, FD_MEMTAG_FRAME), scale).x;
 			}
 
 			lastNewLine = lineLength + 1;
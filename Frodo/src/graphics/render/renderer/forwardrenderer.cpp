@@ -1,5 +1,7 @@
 #include "forwardrenderer.h"
 #include <graphics/buffer/bufferlayout.h>
+#include <graphics/renderstate.h>
+#include <graphics/renderstatecache.h>
 
 #define FD_ENABLE_BLEDNING \
 if (!oneLightRendered) { \
@@ -41,7 +43,7 @@ void ForwardRenderer::CreateBlendStates() {
 	desc.RenderTarget[0].BlendEnable = false;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&desc, &blendState[0]);
+	blendState[0] = RenderStateCache::GetBlendState(desc);
 
 	desc.RenderTarget[0].BlendEnable = true;
 	desc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
@@ -52,7 +54,7 @@ void ForwardRenderer::CreateBlendStates() {
 	desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&desc, &blendState[1]);
+	blendState[1] = RenderStateCache::GetBlendState(desc);
 
 }
 
@@ -65,23 +67,23 @@ void ForwardRenderer::CreateDepthStates() {
 	desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
 	desc.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&desc, &depthState[0]);
+	depthState[0] = RenderStateCache::GetDepthStencilState(desc);
 
 	desc.DepthEnable = true;
 	desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
 	desc.DepthFunc = D3D11_COMPARISON_EQUAL;
 	desc.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&desc, &depthState[1]);
+	depthState[1] = RenderStateCache::GetDepthStencilState(desc);
 
 }
 
 void ForwardRenderer::SetBlendingInternal(bool blend) {
-	D3DContext::GetDeviceContext()->OMSetBlendState(blendState[blend ? 1 : 0], nullptr, 0xFFFFFFFF);
+	RenderState::SetBlendState(blendState[blend ? 1 : 0], nullptr, 0xFFFFFFFF);
 }
 
 void ForwardRenderer::SetDepthInternal(bool depth) {
-	D3DContext::GetDeviceContext()->OMSetDepthStencilState(depthState[depth ? 0 : 1], 0);
+	RenderState::SetDepthStencilState(depthState[depth ? 0 : 1], 0);
 }
 
 ForwardRenderer::ForwardRenderer(Window* window) : Renderer(window, nullptr), oneLightRendered(false) {
@@ -112,10 +114,6 @@ ForwardRenderer::~ForwardRenderer(){
 	delete directionalLightShader;
 	delete pointLightShader;
 
-	DX_FREE(depthState[0]);
-	DX_FREE(depthState[1]);
-	DX_FREE(blendState[0]);
-	DX_FREE(blendState[1]);
 }
 
 void ForwardRenderer::Add(Entity* entity) { 
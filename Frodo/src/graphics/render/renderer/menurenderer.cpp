@@ -1,6 +1,7 @@
 #include "menurenderer.h"
 #include <graphics/shader/shaderfactory.h>
 #include <core/ui/uitext.h>
+#include <core/profiler.h>
 
 namespace FD {
 
@@ -120,6 +121,8 @@ void MenuRenderer::End() {
 }
 
 void MenuRenderer::Present() {
+	FD_PROFILE_SCOPE("MenuRenderer::Present");
+
 	BatchRenderer::Present();
 	fontRenderer->Present();
 }
@@ -12,7 +12,8 @@ class FDAPI Renderer : public EventListener {
 protected:
 	Window* window;
 
-	Renderer(Window* window) { this->window = window; }
+	//Renderers subscribe to the events they handle themselves
+	Renderer(Window* window) : EventListener(0) { this->window = window; }
 public:
 	virtual ~Renderer() {}
 
@@ -20,6 +21,7 @@ public:
 	virtual void Submit(const List<Light*>& lights) { FD_WARNING("Func: \"%s\" not implemented", __FUNCSIG__); }
 	virtual void Submit(Light* light) { FD_WARNING("Func: \"%s\" not implemented", __FUNCSIG__); }
 	virtual void Submit(Entity3D* e) { FD_WARNING("Func: \"%s\" not implemented", __FUNCSIG__); }
+	virtual void Submit(Mesh* mesh, const mat4& transform) { FD_WARNING("Func: \"%s\" not implemented", __FUNCSIG__); }
 	virtual void End() { FD_WARNING("Func: \"%s\" not implemented", __FUNCSIG__); }
 	virtual void Present() = 0;
 
@@ -0,0 +1,42 @@
+#include "renderqueue.h"
+
+namespace FD {
+
+RenderQueue::RenderQueue() : commands(256, 256) {
+
+}
+
+void RenderQueue::Clear() {
+	commands.Clear();
+	queue.Clear();
+}
+
+void RenderQueue::Push(const RenderCommand& cmd) {
+	const float32* m = cmd.transform.GetData();
+
+	BatchItem item;
+
+	item.shader = cmd.shader;
+	item.material = cmd.mesh->GetMaterial();
+	item.mesh = cmd.mesh;
+	item.pass = cmd.pass;
+	item.instanced = cmd.shader->IsInstanced();
+	item.position = vec3(m[12], m[13], m[14]);
+
+	queue.Push(item);
+	commands.Push_back(cmd);
+}
+
+void RenderQueue::Sort(const vec3& viewPosition) {
+	queue.Sort(viewPosition);
+}
+
+void RenderQueue::WriteInstances(mat4* instances) {
+	uint_t size = commands.GetSize();
+
+	for (uint_t i = 0; i < size; i++) {
+		if (queue[i].instanced) *instances++ = commands[queue.GetOrder(i)].transform;
+	}
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <fd.h>
+#include <graphics/render/mesh/mesh.h>
+#include <math/math.h>
+#include <util/list.h>
+#include <util/batchqueue.h>
+
+namespace FD {
+
+struct RenderCommand {
+	Mesh* mesh;
+	mat4 transform;
+	Shader* shader;
+	//Lower passes are drawn first
+	uint32 pass;
+};
+
+/*
+ Commands submitted in any order and sorted into batches by a BatchQueue, with the mesh's
+ material and the shader's Shader::IsInstanced as the rest of the state. Commands that share
+ the pass, shader, material and mesh and whose shader is instanced are one batch,
+ WriteInstances lays out their transforms in batch order. None of this touches the device,
+ the renderer does the binds and draws.
+*/
+class FDAPI RenderQueue {
+private:
+	List<RenderCommand> commands;
+	BatchQueue queue;
+
+public:
+	RenderQueue();
+
+	void Clear();
+	void Push(const RenderCommand& cmd);
+
+	//Sorts and builds the batches
+	void Sort(const vec3& viewPosition);
+
+	//GetNumInstances transforms
+	void WriteInstances(mat4* instances);
+
+	//In sorted order after Sort
+	inline const RenderCommand& operator[](uint_t index) { return commands[queue.GetOrder(index)]; }
+	inline uint64 GetKey(uint_t index) const { return queue.GetKey(index); }
+
+	inline uint_t GetSize() const { return commands.GetSize(); }
+
+	inline const List<RenderBatch>& GetBatches() const { return queue.GetBatches(); }
+	inline uint32 GetNumInstances() const { return queue.GetNumInstances(); }
+};
+
+}
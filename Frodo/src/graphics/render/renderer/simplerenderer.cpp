@@ -1,6 +1,9 @@
 #include "simplerenderer.h"
 #include <graphics/render/mesh/meshfactory.h>
 #include <graphics/debug/debug.h>
+#include <core/profiler.h>
+#include <graphics/renderstate.h>
+#include <graphics/renderstatecache.h>
 
 static const char* lVertexShader =
 #include <graphics/shader/shaders/forward/lVertex.hlsl>
@@ -49,12 +52,12 @@ void SimpleRenderer::CreateDepthAndBlendStates() {
 	d.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
 	d.StencilEnable = false;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&d, &depthState[FD_RENDERER_DEPTH_DEFAULT]);
+	depthState[FD_RENDERER_DEPTH_DEFAULT] = RenderStateCache::GetDepthStencilState(d);
 
 	//Light pass
 	d.DepthFunc = D3D11_COMPARISON_EQUAL;
 
-	D3DContext::GetDevice()->CreateDepthStencilState(&d, &depthState[FD_RENDERER_DEPTH_EQUAL]);
+	depthState[FD_RENDERER_DEPTH_EQUAL] = RenderStateCache::GetDepthStencilState(d);
 
 
 	D3D11_BLEND_DESC b = { 0 };
@@ -72,12 +75,12 @@ void SimpleRenderer::CreateDepthAndBlendStates() {
 	b.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ONE;
 	b.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	D3DContext::GetDevice()->CreateBlendState(&b, &blendState[FD_RENDERER_BLEND_DEFAULT]);
+	blendState[FD_RENDERER_BLEND_DEFAULT] = RenderStateCache::GetBlendState(b);
 
 	//Light pass
 	b.RenderTarget[0].BlendEnable = true;
 
-	D3DContext::GetDevice()->CreateBlendState(&b, &blendState[FD_RENDERER_BLEND_ENABLED]);
+	blendState[FD_RENDERER_BLEND_ENABLED] = RenderStateCache::GetBlendState(b);
 }
 
 void SimpleRenderer::InitializeShaders() {
@@ -119,14 +122,14 @@ void SimpleRenderer::InitializeShaders() {
 
 void SimpleRenderer::SetDepth(FD_RENDERER_DEPTH_STATE state) {
 	FD_ASSERT(state >= FD_RENDERER_DEPTH_NUM_STATES);
-	D3DContext::GetDeviceContext()->OMSetDepthStencilState(depthState[state], 0); 
+	RenderState::SetDepthStencilState(depthState[state], 0); 
 }
 
 float factor[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
 
 void SimpleRenderer::SetBlend(FD_RENDERER_BLEND_STATE state) {
 	FD_ASSERT(state >= FD_RENDERER_BLEND_NUM_STATES);
-	D3DContext::GetDeviceContext()->OMSetBlendState(blendState[state], factor, 0xFFFFFFFF);
+	RenderState::SetBlendState(blendState[state], factor, 0xFFFFFFFF);
 }
 
 SimpleRenderer::SimpleRenderer(Window* window) : Renderer(window) {
@@ -149,18 +152,13 @@ SimpleRenderer::~SimpleRenderer() {
 	delete shadowMap2D;
 	delete shadowMapCube;
 	delete baseMaterial;
-	 
-	DX_FREE(depthState[0]);
-	DX_FREE(depthState[1]);
-	DX_FREE(blendState[0]);
-	DX_FREE(blendState[1]);
 }
 
 void SimpleRenderer::Begin(Camera* camera) {
 	this->camera = camera;
-	cameraBuffer.SetElement("c_Position", (void*)&camera->GetPosition());
-	cameraBuffer.SetElement("c_ViewMatrix", (void*)camera->GetViewMatrix().GetData());
-	cameraBuffer.SetElement("c_ProjectionMatrix", (void*)camera->GetProjectionMatrix().GetData());
+	cameraBuffer.SetElement(FD_SID("c_Position"), (void*)&camera->GetPosition());
+	cameraBuffer.SetElement(FD_SID("c_ViewMatrix"), (void*)camera->GetViewMatrix().GetData());
+	cameraBuffer.SetElement(FD_SID("c_ProjectionMatrix"), (void*)camera->GetProjectionMatrix().GetData());
 } 
 
 void SimpleRenderer::Submit(Light* light) {
@@ -204,6 +202,8 @@ void SimpleRenderer::Remove(Entity3D* entity) {
 
 
 void SimpleRenderer::Present() {
+	FD_PROFILE_SCOPE("SimpleRenderer::Present");
+
 	uint_t numLights = lights.GetSize();
 	if (numLights == 0) return;
 	SetDepth(FD_RENDERER_DEPTH_DEFAULT);
@@ -244,8 +244,8 @@ void SimpleRenderer::Present() {
 
 		for (uint_t i = 0; i < numEntities; i++) {
 			Entity3D* entity = entities[i];
-			light->shader->SetPSConstantBuffer("Light", light->light);
-			light->shader->SetVSConstantBuffer("Model", entity->GetTransform().GetData());
+			light->shader->SetPSConstantBuffer(FD_SID("Light"), light->light);
+			light->shader->SetVSConstantBuffer(FD_SID("Model"), entity->GetTransform().GetData());
 			entity->GetMesh()->Render(light->shader); 
 		}
 	}
@@ -291,8 +291,8 @@ void SimpleRenderer::Present() {
 
 			for (uint_t i = 0; i < numEntities; i++) {
 				Entity3D* entity = entities[i];
-				light->shader->SetPSConstantBuffer("Light", light->light);
-				light->shader->SetVSConstantBuffer("Model", entity->GetTransform().GetData());
+				light->shader->SetPSConstantBuffer(FD_SID("Light"), light->light);
+				light->shader->SetVSConstantBuffer(FD_SID("Model"), entity->GetTransform().GetData());
 				entity->GetMesh()->Render(light->shader);
 			}
 		}
@@ -305,20 +305,20 @@ void SimpleRenderer::Present() {
 void SimpleRenderer::SR_DirectionalLight::SetupShadowShader(Entity3D* e, Camera* camera) const {
 	//lightMatrix = projection * mat4::LookAt(-((DirectionalLight*)light)->GetDirection(), vec3(0, 0, 0), vec3(0, 1, 0));
 	lightMatrix = projection * mat4::LookAt(camera->GetPosition(), camera->GetPosition() + ((DirectionalLight*)light)->GetDirection(), vec3(0, 1, 0));
-	shadowShader->SetVSConstantBuffer("MVP", (lightMatrix * e->GetTransform()).GetData());
+	shadowShader->SetVSConstantBuffer(FD_SID("MVP"), (lightMatrix * e->GetTransform()).GetData());
 }
 
 void SimpleRenderer::SR_DirectionalLight::SetupShader(Entity3D* e, Camera* camera) const {
-	shader->SetVSConstantBuffer("LightMatrix", lightMatrix.GetData());
-	shader->SetPSConstantBuffer("Light", light);
-	shader->SetVSConstantBuffer("Model", e->GetTransform().GetData());
+	shader->SetVSConstantBuffer(FD_SID("LightMatrix"), lightMatrix.GetData());
+	shader->SetPSConstantBuffer(FD_SID("Light"), light);
+	shader->SetVSConstantBuffer(FD_SID("Model"), e->GetTransform().GetData());
 }
 
 void SimpleRenderer::SR_PointLight::SetupShadowShader(Entity3D* e, Camera* camera) const {
 	vec3& lightPos = ((PointLight*)light)->GetPosition();
-	shadowShader->SetVSConstantBuffer("Model", e->GetTransform().GetData());
-	shadowShader->SetPSConstantBuffer("ProjectionDepth", &maxDepth);
-	shadowShader->SetPSConstantBuffer("LightPosition", &lightPos);
+	shadowShader->SetVSConstantBuffer(FD_SID("Model"), e->GetTransform().GetData());
+	shadowShader->SetPSConstantBuffer(FD_SID("ProjectionDepth"), &maxDepth);
+	shadowShader->SetPSConstantBuffer(FD_SID("LightPosition"), &lightPos);
 
 	mat4 views[6]{
 		projection * mat4::LookAt(lightPos, lightPos + vec3(1, 0, 0),  vec3( 0,  1,  0)),
@@ -337,12 +337,12 @@ void SimpleRenderer::SR_PointLight::SetupShadowShader(Entity3D* e, Camera* camer
 	views[4] = projection * mat4::Rotate(vec3(  0,   0, 0)) * mat4::Translate(-lightPos);
 	views[5] = projection * mat4::Rotate(vec3(  0, 180, 0)) * mat4::Translate(-lightPos);
 
-	shadowShader->SetGSConstantBuffer("LightMatrix", views);
+	shadowShader->SetGSConstantBuffer(FD_SID("LightMatrix"), views);
 }
 
 void SimpleRenderer::SR_PointLight::SetupShader(Entity3D* e, Camera* camera) const {
-	shader->SetPSConstantBuffer("Light", light);
-	shader->SetVSConstantBuffer("Model", e->GetTransform().GetData());
+	shader->SetPSConstantBuffer(FD_SID("Light"), light);
+	shader->SetVSConstantBuffer(FD_SID("Model"), e->GetTransform().GetData());
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "renderstate.h"
+#include <core/framestats.h>
+#include <core/log.h>
+
+namespace FD {
+
+RenderState::Bindings RenderState::bindings;
+
+bool RenderState::Changed(bool changed) {
+	FrameStats::Count(changed ? FD_FRAMESTATS_COUNTER_STATE_CHANGES : FD_FRAMESTATS_COUNTER_STATE_SKIPPED);
+
+	return changed;
+}
+
+void RenderState::Invalidate() {
+	//No call passes these, all ones is never a valid pointer, topology or format and the blend factor is NaN
+	memset(&bindings, 0xFF, sizeof(Bindings));
+}
+
+void RenderState::InvalidateResources() {
+	memset(bindings.psResources, 0xFF, sizeof(bindings.psResources));
+}
+
+void RenderState::SetBlendState(ID3D11BlendState* state, const float32* factor, uint32 sampleMask) {
+	static const float32 defaultFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	if (!factor) factor = defaultFactor;
+
+	if (IsTracking()) {
+		if (!Changed(bindings.blendState != state || bindings.sampleMask != sampleMask || memcmp(bindings.blendFactor, factor, sizeof(bindings.blendFactor)) != 0)) return;
+
+		bindings.blendState = state;
+		bindings.sampleMask = sampleMask;
+		memcpy(bindings.blendFactor, factor, sizeof(bindings.blendFactor));
+	}
+
+	D3DContext::GetDeviceContext()->OMSetBlendState(state, factor, sampleMask);
+}
+
+void RenderState::SetDepthStencilState(ID3D11DepthStencilState* state, uint32 stencilRef) {
+	if (IsTracking()) {
+		if (!Changed(bindings.depthStencilState != state || bindings.stencilRef != stencilRef)) return;
+
+		bindings.depthStencilState = state;
+		bindings.stencilRef = stencilRef;
+	}
+
+	D3DContext::GetDeviceContext()->OMSetDepthStencilState(state, stencilRef);
+}
+
+void RenderState::SetRasterizerState(ID3D11RasterizerState* state) {
+	if (IsTracking()) {
+		if (!Changed(bindings.rasterizerState != state)) return;
+
+		bindings.rasterizerState = state;
+	}
+
+	D3DContext::GetDeviceContext()->RSSetState(state);
+}
+
+void RenderState::SetInputLayout(ID3D11InputLayout* layout) {
+	if (IsTracking()) {
+		if (!Changed(bindings.inputLayout != layout)) return;
+
+		bindings.inputLayout = layout;
+	}
+
+	D3DContext::GetDeviceContext()->IASetInputLayout(layout);
+}
+
+void RenderState::SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
+	if (IsTracking()) {
+		if (!Changed(bindings.topology != topology)) return;
+
+		bindings.topology = topology;
+	}
+
+	D3DContext::GetDeviceContext()->IASetPrimitiveTopology(topology);
+}
+
+void RenderState::SetVertexShader(ID3D11VertexShader* shader) {
+	if (IsTracking()) {
+		if (!Changed(bindings.vertexShader != shader)) return;
+
+		bindings.vertexShader = shader;
+	}
+
+	D3DContext::GetDeviceContext()->VSSetShader(shader, 0, 0);
+}
+
+void RenderState::SetPixelShader(ID3D11PixelShader* shader) {
+	if (IsTracking()) {
+		if (!Changed(bindings.pixelShader != shader)) return;
+
+		bindings.pixelShader = shader;
+	}
+
+	D3DContext::GetDeviceContext()->PSSetShader(shader, 0, 0);
+}
+
+void RenderState::SetGeometryShader(ID3D11GeometryShader* shader) {
+	if (IsTracking()) {
+		if (!Changed(bindings.geometryShader != shader)) return;
+
+		bindings.geometryShader = shader;
+	}
+
+	D3DContext::GetDeviceContext()->GSSetShader(shader, 0, 0);
+}
+
+void RenderState::SetPSResource(uint32 slot, ID3D11ShaderResourceView* view) {
+	if (IsTracking()) {
+		if (!Changed(bindings.psResources[slot] != view)) return;
+
+		bindings.psResources[slot] = view;
+	}
+
+	D3DContext::GetDeviceContext()->PSSetShaderResources(slot, 1, &view);
+}
+
+void RenderState::SetPSResources(uint32 firstSlot, uint32 count, ID3D11ShaderResourceView* const* views) {
+	static ID3D11ShaderResourceView* const nullViews[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = { 0 };
+
+	FD_ASSERT_MSG(firstSlot + count > D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, "[RenderState] Shader resource slots out of range");
+
+	if (!views) views = nullViews;
+
+	if (IsTracking()) {
+		//Only the part that differs is set
+		uint32 first = 0;
+		uint32 last = count;
+
+		while (first < last && bindings.psResources[firstSlot + first] == views[first]) first++;
+		while (last > first && bindings.psResources[firstSlot + last - 1] == views[last - 1]) last--;
+
+		if (!Changed(first < last)) return;
+
+		memcpy(bindings.psResources + firstSlot + first, views + first, (last - first) * sizeof(ID3D11ShaderResourceView*));
+
+		firstSlot += first;
+		views += first;
+		count = last - first;
+	}
+
+	D3DContext::GetDeviceContext()->PSSetShaderResources(firstSlot, count, views);
+}
+
+void RenderState::SetPSSampler(uint32 slot, ID3D11SamplerState* sampler) {
+	if (IsTracking()) {
+		if (!Changed(bindings.psSamplers[slot] != sampler)) return;
+
+		bindings.psSamplers[slot] = sampler;
+	}
+
+	D3DContext::GetDeviceContext()->PSSetSamplers(slot, 1, &sampler);
+}
+
+void RenderState::SetVertexBuffer(uint32 slot, ID3D11Buffer* buffer, uint32 stride, uint32 offset) {
+	if (IsTracking()) {
+		if (!Changed(bindings.vertexBuffers[slot] != buffer || bindings.vertexStrides[slot] != stride || bindings.vertexOffsets[slot] != offset)) return;
+
+		bindings.vertexBuffers[slot] = buffer;
+		bindings.vertexStrides[slot] = stride;
+		bindings.vertexOffsets[slot] = offset;
+	}
+
+	D3DContext::GetDeviceContext()->IASetVertexBuffers(slot, 1, &buffer, &stride, &offset);
+}
+
+void RenderState::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, uint32 offset) {
+	if (IsTracking()) {
+		if (!Changed(bindings.indexBuffer != buffer || bindings.indexFormat != format || bindings.indexOffset != offset)) return;
+
+		bindings.indexBuffer = buffer;
+		bindings.indexFormat = format;
+		bindings.indexOffset = offset;
+	}
+
+	D3DContext::GetDeviceContext()->IASetIndexBuffer(buffer, format, offset);
+}
+
+void RenderState::Apply(ID3D11DeviceContext* context) {
+	Bindings unknown;
+	memset(&unknown, 0xFF, sizeof(Bindings));
+
+	if (bindings.blendState != unknown.blendState) context->OMSetBlendState(bindings.blendState, bindings.blendFactor, bindings.sampleMask);
+	if (bindings.depthStencilState != unknown.depthStencilState) context->OMSetDepthStencilState(bindings.depthStencilState, bindings.stencilRef);
+	if (bindings.rasterizerState != unknown.rasterizerState) context->RSSetState(bindings.rasterizerState);
+	if (bindings.topology != unknown.topology) context->IASetPrimitiveTopology(bindings.topology);
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <fd.h>
+#include <graphics/d3dcontext.h>
+
+namespace FD {
+
+/*
+ Front for the pipeline state calls on the immediate context. It remembers what is bound
+ and drops calls that would bind the same thing again, the rest go to the context.
+ Calls made while another context is active (a deferred context) always go through and
+ aren't tracked.
+
+ Anything that changes state without going through here has to call Invalidate after.
+ Binding render targets unbinds them as shader resources, D3DContext::SetRenderTargets
+ calls InvalidateResources for that.
+*/
+class FDAPI RenderState {
+private:
+	struct Bindings {
+		ID3D11BlendState* blendState;
+		float32 blendFactor[4];
+		uint32 sampleMask;
+
+		ID3D11DepthStencilState* depthStencilState;
+		uint32 stencilRef;
+
+		ID3D11RasterizerState* rasterizerState;
+
+		ID3D11InputLayout* inputLayout;
+		D3D11_PRIMITIVE_TOPOLOGY topology;
+
+		ID3D11VertexShader* vertexShader;
+		ID3D11PixelShader* pixelShader;
+		ID3D11GeometryShader* geometryShader;
+
+		ID3D11ShaderResourceView* psResources[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+		ID3D11SamplerState* psSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+
+		ID3D11Buffer* vertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		uint32 vertexStrides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		uint32 vertexOffsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+
+		ID3D11Buffer* indexBuffer;
+		DXGI_FORMAT indexFormat;
+		uint32 indexOffset;
+	};
+
+	static Bindings bindings;
+
+	//False while a context other than the immediate one is active
+	static inline bool IsTracking() { return D3DContext::GetDeviceContext() == D3DContext::GetImmediateDeviceContext(); }
+
+	//Counts the call as made or skipped, true when it has to be made
+	static bool Changed(bool changed);
+
+public:
+	//Nothing is known to be bound after this, the next call of every kind goes through
+	static void Invalidate();
+	static void InvalidateResources();
+
+	//factor nullptr is 1, 1, 1, 1
+	static void SetBlendState(ID3D11BlendState* state, const float32* factor = nullptr, uint32 sampleMask = 0xFFFFFFFF);
+	static void SetDepthStencilState(ID3D11DepthStencilState* state, uint32 stencilRef = 0);
+	static void SetRasterizerState(ID3D11RasterizerState* state);
+
+	static void SetInputLayout(ID3D11InputLayout* layout);
+	static void SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+
+	static void SetVertexShader(ID3D11VertexShader* shader);
+	static void SetPixelShader(ID3D11PixelShader* shader);
+	static void SetGeometryShader(ID3D11GeometryShader* shader);
+
+	static void SetPSResource(uint32 slot, ID3D11ShaderResourceView* view);
+	//views nullptr unbinds the range
+	static void SetPSResources(uint32 firstSlot, uint32 count, ID3D11ShaderResourceView* const* views);
+	static void SetPSSampler(uint32 slot, ID3D11SamplerState* sampler);
+
+	static void SetVertexBuffer(uint32 slot, ID3D11Buffer* buffer, uint32 stride, uint32 offset = 0);
+	static void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, uint32 offset = 0);
+
+	//Sets the known blend, depth stencil and rasterizer states and topology on another context.
+	//A deferred context starts out with the defaults, this carries over what the frame has set up.
+	static void Apply(ID3D11DeviceContext* context);
+};
+
+}
@@ -0,0 +1,117 @@
+#include "renderstatecache.h"
+#include <core/log.h>
+
+namespace FD {
+
+std::mutex RenderStateCache::mutex;
+
+List<RenderStateCache::Entry<D3D11_BLEND_DESC, ID3D11BlendState>> RenderStateCache::blendStates;
+List<RenderStateCache::Entry<D3D11_DEPTH_STENCIL_DESC, ID3D11DepthStencilState>> RenderStateCache::depthStencilStates;
+List<RenderStateCache::Entry<D3D11_RASTERIZER_DESC, ID3D11RasterizerState>> RenderStateCache::rasterizerStates;
+List<RenderStateCache::Entry<D3D11_SAMPLER_DESC, ID3D11SamplerState>> RenderStateCache::samplerStates;
+
+uint64 RenderStateCache::hits = 0;
+uint64 RenderStateCache::misses = 0;
+
+static uint64 HashDesc(const void* desc, uint_t size) {
+	const byte* bytes = (const byte*)desc;
+	uint64 hash = 14695981039346656037ull;
+
+	for (uint_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+template<typename DESC, typename STATE, typename CREATE>
+STATE* RenderStateCache::Find(List<Entry<DESC, STATE>>& entries, const DESC& desc, CREATE create) {
+	uint64 hash = HashDesc(&desc, sizeof(DESC));
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint_t size = entries.GetSize();
+
+	for (uint_t i = 0; i < size; i++) {
+		const Entry<DESC, STATE>& entry = entries[i];
+
+		if (entry.hash == hash && memcmp(&entry.desc, &desc, sizeof(DESC)) == 0) {
+			hits++;
+			return entry.state;
+		}
+	}
+
+	Entry<DESC, STATE> entry;
+
+	entry.hash = hash;
+	entry.desc = desc;
+	entry.state = nullptr;
+
+	create(&desc, &entry.state);
+
+	if (!entry.state) {
+		FD_WARNING("[RenderStateCache] Failed to create a state");
+		return nullptr;
+	}
+
+	entries.Push_back(entry);
+	misses++;
+
+	return entry.state;
+}
+
+template<typename DESC, typename STATE>
+void RenderStateCache::Release(List<Entry<DESC, STATE>>& entries) {
+	for (uint_t i = 0; i < entries.GetSize(); i++) {
+		DX_FREE(entries[i].state);
+	}
+
+	entries.Clear();
+}
+
+void RenderStateCache::Dispose() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Release(blendStates);
+	Release(depthStencilStates);
+	Release(rasterizerStates);
+	Release(samplerStates);
+
+	FD_DEBUG("[RenderStateCache] %llu requests, %llu states created", hits + misses, misses);
+
+	hits = 0;
+	misses = 0;
+}
+
+ID3D11BlendState* RenderStateCache::GetBlendState(const D3D11_BLEND_DESC& desc) {
+	return Find(blendStates, desc, [](const D3D11_BLEND_DESC* desc, ID3D11BlendState** state) {
+		D3DContext::GetDevice()->CreateBlendState(desc, state);
+	});
+}
+
+ID3D11DepthStencilState* RenderStateCache::GetDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc) {
+	return Find(depthStencilStates, desc, [](const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** state) {
+		D3DContext::GetDevice()->CreateDepthStencilState(desc, state);
+	});
+}
+
+ID3D11RasterizerState* RenderStateCache::GetRasterizerState(const D3D11_RASTERIZER_DESC& desc) {
+	return Find(rasterizerStates, desc, [](const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** state) {
+		D3DContext::GetDevice()->CreateRasterizerState(desc, state);
+	});
+}
+
+ID3D11SamplerState* RenderStateCache::GetSamplerState(const D3D11_SAMPLER_DESC& desc) {
+	return Find(samplerStates, desc, [](const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** state) {
+		D3DContext::GetDevice()->CreateSamplerState(desc, state);
+	});
+}
+
+uint_t RenderStateCache::GetNumStates() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return blendStates.GetSize() + depthStencilStates.GetSize() + rasterizerStates.GetSize() + samplerStates.GetSize();
+}
+
+}
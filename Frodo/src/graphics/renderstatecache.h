@@ -0,0 +1,56 @@
+#pragma once
+#include <fd.h>
+#include <graphics/d3dcontext.h>
+#include <util/list.h>
+#include <mutex>
+
+namespace FD {
+
+/*
+ Blend, depth stencil, rasterizer and sampler states shared by everything that asks for the
+ same descriptor. States are looked up by a hash of the descriptor bytes (compared in full on
+ a hash match) and created on the first request. The cache owns them, callers don't release
+ what they get, Dispose releases everything once the renderers are gone.
+
+ Zero the descriptors before filling them in, unused bytes are part of the key.
+*/
+class FDAPI RenderStateCache {
+private:
+	template<typename DESC, typename STATE>
+	struct Entry {
+		uint64 hash;
+		DESC desc;
+		STATE* state;
+	};
+
+	static std::mutex mutex;
+
+	static List<Entry<D3D11_BLEND_DESC, ID3D11BlendState>> blendStates;
+	static List<Entry<D3D11_DEPTH_STENCIL_DESC, ID3D11DepthStencilState>> depthStencilStates;
+	static List<Entry<D3D11_RASTERIZER_DESC, ID3D11RasterizerState>> rasterizerStates;
+	static List<Entry<D3D11_SAMPLER_DESC, ID3D11SamplerState>> samplerStates;
+
+	static uint64 hits;
+	static uint64 misses;
+
+	template<typename DESC, typename STATE, typename CREATE>
+	static STATE* Find(List<Entry<DESC, STATE>>& entries, const DESC& desc, CREATE create);
+
+	template<typename DESC, typename STATE>
+	static void Release(List<Entry<DESC, STATE>>& entries);
+
+public:
+	static void Dispose();
+
+	static ID3D11BlendState* GetBlendState(const D3D11_BLEND_DESC& desc);
+	static ID3D11DepthStencilState* GetDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc);
+	static ID3D11RasterizerState* GetRasterizerState(const D3D11_RASTERIZER_DESC& desc);
+	static ID3D11SamplerState* GetSamplerState(const D3D11_SAMPLER_DESC& desc);
+
+	static uint_t GetNumStates();
+	//Requests that found an existing state and requests that created one
+	static inline uint64 GetHits() { return hits; }
+	static inline uint64 GetMisses() { return misses; }
+};
+
+}
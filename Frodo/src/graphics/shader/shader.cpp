@@ -1,36 +1,18 @@
 #include "shader.h"
 #include <d3dcompiler.h>
 #include <core/log.h>
+#include <core/profiler.h>
+#include <core/framestats.h>
 #include <util/vfs/vfs.h>
+#include <util/shadercache.h>
+#include <graphics/buffer/constantbufferring.h>
+#include <graphics/renderstate.h>
 #include <math/math.h>
 
 namespace FD {
 
 String Shader::GetFunctionTypeString(FD_SHADER_GEN_FUNCTION_TYPE type) {
-	switch (type) {
-	case FD_TRUE:
-		return "true";
-	case FD_FALSE:
-		return "false";
-	case FD_DEFINED:
-		return "defined";
-	case FD_EQ:
-		return "eq";
-	case FD_NEQ:
-		return "neq";
-	case FD_GR:
-		return "gr";
-	case FD_LS:
-		return "ls";
-	case FD_GE:
-		return "ge";
-	case FD_LE:
-		return "le";
-	}
-
-	FD_WARNING("[Shader] Unknown function type %d", (int32)type);
-
-	return "UNKNOWN";
+	return ShaderGen::GetFunctionTypeString(type);
 }
 
 void Shader::CreateBuffers() {
@@ -38,6 +20,9 @@ void Shader::CreateBuffers() {
 	for (uint_t i = 0; i < vCBuffers.GetSize(); i++) {
 		ShaderStructInfo* cbuffer = vCBuffers[i];
 
+		cbuffer->shadow.Resize(cbuffer->structSize);
+		cbuffer->bufferGeneration = 0;
+
 		D3D11_BUFFER_DESC desc;
 		ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
 
@@ -54,6 +39,9 @@ void Shader::CreateBuffers() {
 	for (uint_t i = 0; i < pCBuffers.GetSize(); i++) {
 		ShaderStructInfo* cbuffer = pCBuffers[i];
 
+		cbuffer->shadow.Resize(cbuffer->structSize);
+		cbuffer->bufferGeneration = 0;
+
 		D3D11_BUFFER_DESC desc;
 		ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
 
@@ -70,6 +58,9 @@ void Shader::CreateBuffers() {
 	for (uint_t i = 0; i < gCBuffers.GetSize(); i++) {
 		ShaderStructInfo* cbuffer = gCBuffers[i];
 
+		cbuffer->shadow.Resize(cbuffer->structSize);
+		cbuffer->bufferGeneration = 0;
+
 		D3D11_BUFFER_DESC desc;
 		ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
 
@@ -84,53 +75,116 @@ void Shader::CreateBuffers() {
 	}
 }
 
-void Shader::Compile(String vSource, String pSource, String gSource, bool geometry) {
-	inputLayout = nullptr;
-	vByteCode = nullptr;
-	pByteCode = nullptr;
-	gByteCode = nullptr;
-	vertexShader = nullptr;
-	pixelShader = nullptr;
-	geometryShader = nullptr;
+const ShaderLibrary* Shader::library = nullptr;
+const Shader* Shader::current = nullptr;
+uint32 Shader::generation = 1;
 
-	ParseStructs(vSource, FD_SHADER_TYPE_VERTEXSHADER);
-	ParseStructs(pSource, FD_SHADER_TYPE_PIXELSHADER);
-	if (geometry) ParseStructs(gSource, FD_SHADER_TYPE_GEOMETRYSHADER);
+Shader::ShaderStructInfo::~ShaderStructInfo() {
+	DX_FREE(buffer);
 
-	ParseTextures(pSource);
+	ConstantBufferRing::Forget(&shadow);
+}
 
-	ID3DBlob* error = nullptr;
+ID3DBlob* Shader::CompileStage(ShaderGen& gen, String& source, const char* entry, const char* profile, const char* stageName, const HLSLReflection** reflection) {
+	uint64 key = ShaderCache::MakeKey(gen.GetSourceHash(), gen.GetVariableHash(), profile);
 
-	D3DCompile(*vSource, vSource.length, 0, 0, 0, "vsMain", "vs_5_0", 0, 0, &vByteCode, &error);
+	ID3DBlob* byteCode = nullptr;
+	const ShaderLibraryStage* stage = library ? library->Find(key) : nullptr;
 
-	if (error) {
-		FD_FATAL("VertexShader ERROR: %s", error->GetBufferPointer());
-		DX_FREE(error);
-		FD_ASSERT_MSG(vByteCode == nullptr, "VertexShader failed to compile");
+	*reflection = stage ? &stage->reflection : nullptr;
+
+	if (stage && stage->byteCode) {
+		source = stage->source;
+
+		D3DCreateBlob(stage->byteCodeSize, &byteCode);
+		memcpy(byteCode->GetBufferPointer(), stage->byteCode, stage->byteCodeSize);
+
+		return byteCode;
+	}
+
+	byte* cached = nullptr;
+	uint_t cachedSize = 0;
+
+	if (ShaderCache::Find(key, &source, &cached, &cachedSize)) {
+		D3DCreateBlob(cachedSize, &byteCode);
+		memcpy(byteCode->GetBufferPointer(), cached, cachedSize);
+
+		Memory::Free(cached);
+
+		return byteCode;
 	}
 
-	DX_FREE(error);
+	//A library built without a compiler still saves the generation
+	source = stage ? stage->source : gen.Generate();
+
+	ID3DBlob* error = nullptr;
 
-	D3DCompile(*pSource, pSource.length, 0, 0, 0, "psMain", "ps_5_0", 0, 0, &pByteCode, &error);
+	D3DCompile(*source, source.length, 0, 0, 0, entry, profile, 0, 0, &byteCode, &error);
 
 	if (error) {
-		FD_FATAL("PixelShader ERROR: %s", error->GetBufferPointer());
+		FD_FATAL("%s ERROR: %s", stageName, error->GetBufferPointer());
 		DX_FREE(error);
-		FD_ASSERT_MSG(pByteCode == nullptr, "PixelShader failed to compile");
 	}
 
-	DX_FREE(error);
+	if (byteCode) ShaderCache::Add(key, source, byteCode->GetBufferPointer(), byteCode->GetBufferSize());
+
+	return byteCode;
+}
+
+void Shader::ReleaseStages() {
+	DX_FREE(vertexShader);
+	DX_FREE(pixelShader);
+	DX_FREE(geometryShader);
+	DX_FREE(vByteCode);
+	DX_FREE(pByteCode);
+	DX_FREE(gByteCode);
+
+	vStructs.Free();
+	vStructs.Clear();
+	pStructs.Free();
+	pStructs.Clear();
+	gStructs.Free();
+	gStructs.Clear();
+
+	vCBuffers.Free();
+	vCBuffers.Clear();
+	pCBuffers.Free();
+	pCBuffers.Clear();
+	gCBuffers.Free();
+	gCBuffers.Clear();
+
+	pTextures.Free();
+	pTextures.Clear();
+	pSamplers.Free();
+	pSamplers.Clear();
+}
+
+void Shader::Compile(bool geometry) {
+	FD_PROFILE_SCOPE("Shader::Compile");
+
+	//The input layout is kept, permutations of a shader take the same vertex input
+	ReleaseStages();
+
+	const HLSLReflection* reflection = nullptr;
+
+	vByteCode = CompileStage(vShaderGen, vSource, "vsMain", "vs_5_0", "VertexShader", &reflection);
+
+	FD_ASSERT_MSG(vByteCode == nullptr, "VertexShader failed to compile");
+
+	Reflect(vSource, reflection, FD_SHADER_TYPE_VERTEXSHADER);
+
+	pByteCode = CompileStage(pShaderGen, pSource, "psMain", "ps_5_0", "PixelShader", &reflection);
+
+	FD_ASSERT_MSG(pByteCode == nullptr, "PixelShader failed to compile");
+
+	Reflect(pSource, reflection, FD_SHADER_TYPE_PIXELSHADER);
 
 	if (geometry) {
-		D3DCompile(*gSource, gSource.length, 0, 0, 0, "gsMain", "gs_5_0", 0, 0, &gByteCode, &error);
+		gByteCode = CompileStage(gShaderGen, gSource, "gsMain", "gs_5_0", "GeometryShader", &reflection);
 
-		if (error) {
-			FD_FATAL("GeometryShader ERROR: %s", error->GetBufferPointer());
-			DX_FREE(error);
-			FD_ASSERT_MSG(pByteCode == nullptr, "GeometryShader failed to compile");
-		}
+		FD_ASSERT_MSG(gByteCode == nullptr, "GeometryShader failed to compile");
 
-		DX_FREE(error);
+		Reflect(gSource, reflection, FD_SHADER_TYPE_GEOMETRYSHADER);
 
 		D3DContext::GetDevice()->CreateGeometryShader(gByteCode->GetBufferPointer(), gByteCode->GetBufferSize(), 0, &geometryShader);
 
@@ -149,6 +203,15 @@ void Shader::Compile(String vSource, String pSource, String gSource, bool geomet
 }
 
 Shader::Shader(const String& vertexFilename, const String& pixelFilename, const String& geometryFilename, bool src) {
+	inputLayout = nullptr;
+	instanceStride = 0;
+	vByteCode = nullptr;
+	pByteCode = nullptr;
+	gByteCode = nullptr;
+	vertexShader = nullptr;
+	pixelShader = nullptr;
+	geometryShader = nullptr;
+
 	if (src) {
 		vSource = vertexFilename;
 		pSource = pixelFilename;
@@ -163,130 +226,211 @@ Shader::Shader(const String& vertexFilename, const String& pixelFilename, const
 	pSourceOriginal = pSource;
 	gSourceOriginal = gSource;
 
-	RemoveComments(vSource);
-	RemoveComments(pSource);
-	RemoveComments(gSource);
+	ShaderGen::RemoveComments(vSource);
+	ShaderGen::RemoveComments(pSource);
+	ShaderGen::RemoveComments(gSource);
 
-	ShaderGenParseDefinitions(vSource, FD_SHADER_TYPE_VERTEXSHADER);
-	ShaderGenParseDefinitions(pSource, FD_SHADER_TYPE_PIXELSHADER);
-	ShaderGenParseDefinitions(gSource, FD_SHADER_TYPE_GEOMETRYSHADER);
+	vShaderGen.Parse(vSource);
+	pShaderGen.Parse(pSource);
+	gShaderGen.Parse(gSource);
 }
 
 Shader::~Shader() {
 	DX_FREE(inputLayout);
-	DX_FREE(vertexShader);
-	DX_FREE(pixelShader);
-	DX_FREE(vByteCode);
-	DX_FREE(pByteCode);
 
-	vStructs.Free();
-	pStructs.Free();
+	ReleaseStages();
 
-	vCBuffers.Free();
-	pCBuffers.Free();
-
-	pTextures.Free();
-	pSamplers.Free();
-
-	variables.Free();
-	blocks.Free();
+	if (current == this) current = nullptr;
 }
 
 void Shader::Bind() {
-	D3DContext::GetDeviceContext()->IASetInputLayout(inputLayout);
+	RenderState::SetInputLayout(inputLayout);
+
+	RenderState::SetVertexShader(vertexShader);
+	RenderState::SetPixelShader(pixelShader);
+	RenderState::SetGeometryShader(geometryShader);
 
-	D3DContext::GetDeviceContext()->VSSetShader(vertexShader, 0, 0);
-	D3DContext::GetDeviceContext()->PSSetShader(pixelShader, 0, 0);
-	D3DContext::GetDeviceContext()->GSSetShader(geometryShader, 0, 0);
+	if (D3DContext::GetDeviceContext() != D3DContext::GetImmediateDeviceContext()) {
+		for (uint_t i = 0; i < vCBuffers.GetSize(); i++) SetDeviceConstantBuffer(vCBuffers[i], FD_SHADER_TYPE_VERTEXSHADER);
+		for (uint_t i = 0; i < pCBuffers.GetSize(); i++) SetDeviceConstantBuffer(pCBuffers[i], FD_SHADER_TYPE_PIXELSHADER);
+		for (uint_t i = 0; i < gCBuffers.GetSize(); i++) SetDeviceConstantBuffer(gCBuffers[i], FD_SHADER_TYPE_GEOMETRYSHADER);
+
+		return;
+	}
 
+	current = this;
+
+	bool ring = ConstantBufferRing::IsActive();
 
 	for (uint_t i = 0; i < vCBuffers.GetSize(); i++) {
-		ShaderStructInfo& cb = *vCBuffers[i];
-		D3DContext::GetDeviceContext()->VSSetConstantBuffers(cb.semRegister, 1, &cb.buffer);
+		BindConstantBuffer(vCBuffers[i], FD_SHADER_TYPE_VERTEXSHADER, ring);
 	}
 
 	for (uint_t i = 0; i < pCBuffers.GetSize(); i++) {
-		ShaderStructInfo& cb = *pCBuffers[i];
-		D3DContext::GetDeviceContext()->PSSetConstantBuffers(cb.semRegister, 1, &cb.buffer);
+		BindConstantBuffer(pCBuffers[i], FD_SHADER_TYPE_PIXELSHADER, ring);
 	}
 
 	for (uint_t i = 0; i < gCBuffers.GetSize(); i++) {
-		ShaderStructInfo& cb = *gCBuffers[i];
-		D3DContext::GetDeviceContext()->GSSetConstantBuffers(cb.semRegister, 1, &cb.buffer);
+		BindConstantBuffer(gCBuffers[i], FD_SHADER_TYPE_GEOMETRYSHADER, ring);
 	}
 }
 
-void Shader::SetVSConstantBufferSlotInternal(uint32 slot, const void* data) const{
-	ShaderStructInfo& cb = *vCBuffers.Get(slot);
-	D3D11_MAPPED_SUBRESOURCE sub;
-	ZeroMemory(&sub, sizeof(D3D11_MAPPED_SUBRESOURCE));
+void Shader::BindConstantBuffer(ShaderStructInfo* cb, FD_SHADER_TYPE type, bool ring) const {
+	if (cb->shadow.IsSet()) {
+		if (ring) {
+			//Upload binds the range
+			if (cb->shadow.IsDirty() || !ConstantBufferRing::IsBound(type, cb->semRegister, &cb->shadow)) UploadConstantBuffer(cb, type, true);
+			return;
+		}
 
-	D3DContext::GetDeviceContext()->Map((ID3D11Resource*)cb.buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &sub);
-	memcpy(sub.pData, data, cb.structSize);
-	D3DContext::GetDeviceContext()->Unmap((ID3D11Resource*)cb.buffer, 0);
+		if (cb->shadow.IsDirty() || !cb->IsBufferCurrent()) UploadConstantBuffer(cb, type, false);
+	} else if (ring) {
+		ConstantBufferRing::Unbind(type, cb->semRegister);
+	}
+
+	SetDeviceConstantBuffer(cb, type);
 }
 
-void Shader::SetPSConstantBufferSlotInternal(uint32 slot, const void* data) const {
-	ShaderStructInfo& cb = *pCBuffers.Get(slot);
+void Shader::SetDeviceConstantBuffer(const ShaderStructInfo* cb, FD_SHADER_TYPE type) {
+	switch (type) {
+		case FD_SHADER_TYPE_VERTEXSHADER:
+			D3DContext::GetDeviceContext()->VSSetConstantBuffers(cb->semRegister, 1, &cb->buffer);
+			break;
+		case FD_SHADER_TYPE_PIXELSHADER:
+			D3DContext::GetDeviceContext()->PSSetConstantBuffers(cb->semRegister, 1, &cb->buffer);
+			break;
+		case FD_SHADER_TYPE_GEOMETRYSHADER:
+			D3DContext::GetDeviceContext()->GSSetConstantBuffers(cb->semRegister, 1, &cb->buffer);
+			break;
+	}
+}
+
+void Shader::WriteDeferredConstantBuffer(const ShaderStructInfo* cb, FD_SHADER_TYPE type, const void* data) {
 	D3D11_MAPPED_SUBRESOURCE sub;
 	ZeroMemory(&sub, sizeof(D3D11_MAPPED_SUBRESOURCE));
 
-	D3DContext::GetDeviceContext()->Map((ID3D11Resource*)cb.buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &sub);
-	memcpy(sub.pData, data, cb.structSize);
-	D3DContext::GetDeviceContext()->Unmap((ID3D11Resource*)cb.buffer, 0);
+	//Every command list gets its own copy of a dynamic buffer mapped with discard
+	D3DContext::GetDeviceContext()->Map((ID3D11Resource*)cb->buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &sub);
+	memcpy(sub.pData, data, cb->structSize);
+	D3DContext::GetDeviceContext()->Unmap((ID3D11Resource*)cb->buffer, 0);
+
+	SetDeviceConstantBuffer(cb, type);
+
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_UPLOADS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_BYTES, cb->structSize);
 }
 
-void Shader::SetGSConstantBufferSlotInternal(uint32 slot, const void* data) const {
-	ShaderStructInfo& cb = *gCBuffers.Get(slot);
-	D3D11_MAPPED_SUBRESOURCE sub;
-	ZeroMemory(&sub, sizeof(D3D11_MAPPED_SUBRESOURCE));
+void Shader::InvalidateConstantBuffers() {
+	//0 is what new buffers start with
+	if (++generation == 0) generation = 1;
+}
+
+void Shader::UploadConstantBuffer(ShaderStructInfo* cb, FD_SHADER_TYPE type, bool ring) const {
+	if (ring) {
+		ConstantBufferRing::Upload(type, cb->semRegister, &cb->shadow);
+		cb->bufferGeneration = 0;
+	} else {
+		D3D11_MAPPED_SUBRESOURCE sub;
+		ZeroMemory(&sub, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+		D3DContext::GetDeviceContext()->Map((ID3D11Resource*)cb->buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &sub);
+		memcpy(sub.pData, cb->shadow.GetData(), cb->structSize);
+		D3DContext::GetDeviceContext()->Unmap((ID3D11Resource*)cb->buffer, 0);
 
-	D3DContext::GetDeviceContext()->Map((ID3D11Resource*)cb.buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &sub);
-	memcpy(sub.pData, data, cb.structSize);
-	D3DContext::GetDeviceContext()->Unmap((ID3D11Resource*)cb.buffer, 0);
+		cb->bufferGeneration = generation;
+
+		//The ring's copy is older now
+		if (ConstantBufferRing::IsBound(type, cb->semRegister, &cb->shadow)) ConstantBufferRing::Unbind(type, cb->semRegister);
+	}
+
+	cb->shadow.ClearDirty();
+
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_UPLOADS);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_BYTES, cb->structSize);
 }
 
-void Shader::SetVSConstantBuffer(const String& bufferName, const void* data) const {
-	uint_t size = vCBuffers.GetSize();
+Shader::ShaderStructInfo* Shader::FindConstantBuffer(const List<ShaderStructInfo*>& cbuffers, StringID id) {
+	uint_t size = cbuffers.GetSize();
+
 	for (uint_t i = 0; i < size; i++) {
-		if (vCBuffers.Get(i)->name == bufferName) {
-			SetVSConstantBufferSlotInternal((uint32)i, data);
-			return;
-		}
+		ShaderStructInfo* cb = cbuffers.Get(i);
+		if (cb->id == id) return cb;
 	}
 
-	FD_WARNING("[Shader] Buffer not found \"%s\"", *bufferName);
+	return nullptr;
 }
 
-void Shader::SetPSConstantBuffer(const String& bufferName, const void* data) const {
-	uint_t size = pCBuffers.GetSize();
-	for (uint_t i = 0; i < size; i++) {
-		if (pCBuffers.Get(i)->name == bufferName) {
-			SetPSConstantBufferSlotInternal((uint32)i, data);
-			return;
-		}
+void Shader::SetConstantBufferInternal(ShaderStructInfo* cb, FD_SHADER_TYPE type, const void* data, uint32 version) const {
+	//Other threads record at the same time, the shadow and the ring belong to the immediate context
+	if (D3DContext::GetDeviceContext() != D3DContext::GetImmediateDeviceContext()) {
+		WriteDeferredConstantBuffer(cb, type, data);
+		return;
+	}
+
+	bool changed = cb->shadow.Update(data, version);
+	bool ring = ConstantBufferRing::IsActive();
+
+	if (ring && current != this) {
+		//Binding a range now would replace a buffer of the bound shader, Bind uploads it
+		if (!changed) FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_SKIPPED);
+		return;
+	}
+
+	if (!cb->shadow.IsDirty() && (ring ? ConstantBufferRing::IsBound(type, cb->semRegister, &cb->shadow) : cb->IsBufferCurrent())) {
+		FrameStats::Count(FD_FRAMESTATS_COUNTER_CONSTANT_BUFFER_SKIPPED);
+		return;
 	}
 
-	FD_WARNING("[Shader] Buffer not found \"%s\"", *bufferName);
+	UploadConstantBuffer(cb, type, ring);
+}
+
+void Shader::SetVSConstantBuffer(const String& bufferName, const void* data) const {
+	ShaderStructInfo* cb = FindConstantBuffer(vCBuffers, StringID(bufferName));
+
+	if (cb) SetConstantBufferInternal(cb, FD_SHADER_TYPE_VERTEXSHADER, data, 0);
+	else FD_WARNING("[Shader] Buffer not found \"%s\"", *bufferName);
+}
+
+void Shader::SetPSConstantBuffer(const String& bufferName, const void* data) const {
+	ShaderStructInfo* cb = FindConstantBuffer(pCBuffers, StringID(bufferName));
+
+	if (cb) SetConstantBufferInternal(cb, FD_SHADER_TYPE_PIXELSHADER, data, 0);
+	else FD_WARNING("[Shader] Buffer not found \"%s\"", *bufferName);
 }
 
 void Shader::SetGSConstantBuffer(const String& bufferName, const void* data) const {
-	uint_t size = gCBuffers.GetSize();
-	for (uint_t i = 0; i < size; i++) {
-		if (gCBuffers.Get(i)->name == bufferName) {
-			SetGSConstantBufferSlotInternal((uint32)i, data);
-			return;
-		}
-	}
+	ShaderStructInfo* cb = FindConstantBuffer(gCBuffers, StringID(bufferName));
+
+	if (cb) SetConstantBufferInternal(cb, FD_SHADER_TYPE_GEOMETRYSHADER, data, 0);
+	else FD_WARNING("[Shader] Buffer not found \"%s\"", *bufferName);
+}
+
+void Shader::SetVSConstantBuffer(StringID id, const void* data) const {
+	ShaderStructInfo* cb = FindConstantBuffer(vCBuffers, id);
+
+	if (cb) SetConstantBufferInternal(cb, FD_SHADER_TYPE_VERTEXSHADER, data, 0);
+	else FD_WARNING("[Shader] Buffer not found \"%s\"", *StringID::GetString(id));
+}
+
+void Shader::SetPSConstantBuffer(StringID id, const void* data) const {
+	ShaderStructInfo* cb = FindConstantBuffer(pCBuffers, id);
 
-	FD_WARNING("[Shader] Buffer not found \"%s\"", *bufferName);
+	if (cb) SetConstantBufferInternal(cb, FD_SHADER_TYPE_PIXELSHADER, data, 0);
+	else FD_WARNING("[Shader] Buffer not found \"%s\"", *StringID::GetString(id));
 }
 
-void Shader::SetVSConstantBuffer(uint32 slot, const void* data) const {
+void Shader::SetGSConstantBuffer(StringID id, const void* data) const {
+	ShaderStructInfo* cb = FindConstantBuffer(gCBuffers, id);
+
+	if (cb) SetConstantBufferInternal(cb, FD_SHADER_TYPE_GEOMETRYSHADER, data, 0);
+	else FD_WARNING("[Shader] Buffer not found \"%s\"", *StringID::GetString(id));
+}
+
+void Shader::SetVSConstantBuffer(uint32 slot, const void* data, uint32 version) const {
 	uint_t size = vCBuffers.GetSize();
 	for (uint_t i = 0; i < size; i++) {
 		if (vCBuffers.Get(i)->semRegister == slot) {
-			SetVSConstantBufferSlotInternal((uint32)i, data);
+			SetConstantBufferInternal(vCBuffers.Get(i), FD_SHADER_TYPE_VERTEXSHADER, data, version);
 			return;
 		}
 	}
@@ -294,11 +438,11 @@ void Shader::SetVSConstantBuffer(uint32 slot, const void* data) const {
 	FD_WARNING("[Shader] No buffer at slot %u", slot);
 }
 
-void Shader::SetPSConstantBuffer(uint32 slot, const void* data) const {
+void Shader::SetPSConstantBuffer(uint32 slot, const void* data, uint32 version) const {
 	uint_t size = pCBuffers.GetSize();
 	for (uint_t i = 0; i < size; i++) {
 		if (pCBuffers.Get(i)->semRegister == slot) {
-			SetPSConstantBufferSlotInternal((uint32)i, data);
+			SetConstantBufferInternal(pCBuffers.Get(i), FD_SHADER_TYPE_PIXELSHADER, data, version);
 			return;
 		}
 	}
@@ -306,11 +450,11 @@ void Shader::SetPSConstantBuffer(uint32 slot, const void* data) const {
 	FD_WARNING("[Shader] No buffer at slot %u", slot);
 }
 
-void Shader::SetGSConstantBuffer(uint32 slot, const void* data) const {
+void Shader::SetGSConstantBuffer(uint32 slot, const void* data, uint32 version) const {
 	uint_t size = gCBuffers.GetSize();
 	for (uint_t i = 0; i < size; i++) {
 		if (gCBuffers.Get(i)->semRegister == slot) {
-			SetGSConstantBufferSlotInternal((uint32)i, data);
+			SetConstantBufferInternal(gCBuffers.Get(i), FD_SHADER_TYPE_GEOMETRYSHADER, data, version);
 			return;
 		}
 	}
@@ -319,20 +463,21 @@ void Shader::SetGSConstantBuffer(uint32 slot, const void* data) const {
 }
 
 void Shader::SetVSConstantBuffer(const Shader::ConstantBufferSlot vCBuffer) const{
-	SetVSConstantBuffer(vCBuffer.semRegister, vCBuffer.data);
+	SetVSConstantBuffer(vCBuffer.semRegister, vCBuffer.data, vCBuffer.version);
 }
 
 void Shader::SetPSConstantBuffer(const Shader::ConstantBufferSlot pCBuffer) const {
-	SetPSConstantBuffer(pCBuffer.semRegister, pCBuffer.data);
+	SetPSConstantBuffer(pCBuffer.semRegister, pCBuffer.data, pCBuffer.version);
 }
 
 void Shader::SetGSConstantBuffer(const Shader::ConstantBufferSlot gCBuffer) const {
-	SetGSConstantBuffer(gCBuffer.semRegister, gCBuffer.data);
+	SetGSConstantBuffer(gCBuffer.semRegister, gCBuffer.data, gCBuffer.version);
 }
 
 void Shader::SetTexture(uint32 slot, const Texture* tex) const {
-	ID3D11ShaderResourceView* view = tex == nullptr ? nullptr : tex->GetResourceView();
-	D3DContext::GetDeviceContext()->PSSetShaderResources(slot, 1, &view);
+	RenderState::SetPSResource(slot, tex == nullptr ? nullptr : tex->GetResourceView());
+
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_TEXTURE_BINDS);
 }
 
 void Shader::SetSampler(uint32 slot, const Sampler* sampler) const {
@@ -435,9 +580,25 @@ uint32 Shader::GetPSTextureSlotByName(const String& textureName) const {
 }
 
 void Shader::ConstantBufferSlot::SetElement(const String& name, const void* data) const {
-	uint32 offset = layout.GetElementOffset(name);
-	if (offset == (uint32)-1) return;
-	memcpy(this->data + offset, data, layout.GetElementSize(name));
+	const BufferLayout::BufferLayoutAttrib* attrib = layout.GetElement(StringID(name));
+
+	if (!attrib) {
+		FD_WARNING("[BufferLayout] No element in buffer named \"%s\"", *name);
+		return;
+	}
+
+	memcpy(this->data + attrib->offset, data, attrib->size);
+}
+
+void Shader::ConstantBufferSlot::SetElement(StringID id, const void* data) const {
+	const BufferLayout::BufferLayoutAttrib* attrib = layout.GetElement(id);
+
+	if (!attrib) {
+		FD_WARNING("[BufferLayout] No element in buffer named \"%s\"", *StringID::GetString(id));
+		return;
+	}
+
+	memcpy(this->data + attrib->offset, data, attrib->size);
 }
 
 void Shader::ConstantBufferSlot::SetElement(uint32 index, const void* data) const {
@@ -446,4 +607,13 @@ void Shader::ConstantBufferSlot::SetElement(uint32 index, const void* data) cons
 	memcpy(this->data + offset, data, layout.GetElementSize(index));
 }
 
-}
\ No newline at end of file
+void Shader::ConstantBufferSlot::Changed() {
+	static uint32 nextVersion = 0;
+
+	//Skips 0 when it wraps, 0 means no version
+	if (++nextVersion == 0) nextVersion = 1;
+
+	version = nextVersion;
+}
+
+}
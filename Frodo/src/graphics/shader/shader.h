@@ -5,6 +5,11 @@
 #include <graphics/texture/sampler.h>
 #include <util/string.h>
 #include <util/list.h>
+#include <util/stringid.h>
+#include <util/hlslreflection.h>
+#include <util/shadergen.h>
+#include <util/shaderlibrary.h>
+#include <util/constantbuffershadow.h>
 #include <graphics/buffer/bufferlayout.h>
 
 namespace FD {
@@ -27,51 +32,15 @@ enum FD_SHADER_TEXTURE_TYPE {
 	FD_SHADER_TEXTURE_TYPE_TEXTURECUBE_ARRAY
 };
 
-enum FD_SHADER_GEN_FUNCTION_TYPE {
-	FD_TRUE,
-	FD_FALSE,
-	FD_DEFINED,
-
-	FD_EQ,
-	FD_NEQ,
-	FD_GR,
-	FD_LS,
-	FD_GE,
-	FD_LE
-};
-
-
-
 class FDAPI Shader {
 private:
-	struct ShaderGenVariable {
-		String name;
-
-		float32 data;
-
-		FD_SHADER_TYPE shader;
-	};
+	//Parsed once in the constructor, ShaderGenComplete only walks them for permutations that aren't cached
+	ShaderGen vShaderGen;
+	ShaderGen pShaderGen;
+	ShaderGen gShaderGen;
 
-	struct ShaderGenBlock {
-		String name;
-		String code;
-
-		FD_SHADER_TYPE shader;
-	};
-
-	List<ShaderGenVariable*> variables;
-	List<ShaderGenBlock*> blocks;
-
-	ShaderGenVariable* ShaderGenGetVariableInternal(const String& name, FD_SHADER_TYPE type) const;
-	void ShaderGenParseDefinitions(String& source, FD_SHADER_TYPE type);
-	void ShaderGenProcessConditions(String& source, FD_SHADER_TYPE type);
-	void ShaderGenProcessGeneration(String& source, FD_SHADER_TYPE type);
-	bool ShaderGenProcessFunction(String function, FD_SHADER_TYPE type);
-	bool ShaderGenIsVariableDefined(const String& name, FD_SHADER_TYPE type);
-	bool ShaderGenIsBlockDefined(const String& name, FD_SHADER_TYPE type);
-	void ShaderGenGetParametersFromFunction(const String& function, uint_t offset...);
-	void ShaderGenAddVariableData(String& source, FD_SHADER_TYPE type);
-	void ShaderGenProcessArithmeticOperations(String& source, FD_SHADER_TYPE type);
+	ShaderGen* GetShaderGen(FD_SHADER_TYPE type);
+	const ShaderGen* GetShaderGen(FD_SHADER_TYPE type) const;
 
 public:
 	struct StructDefinition {
@@ -84,7 +53,7 @@ public:
 
 	class ConstantBufferSlot {
 	public:
-		ConstantBufferSlot(uint32 reg = 0, uint32 size = 0, byte* data = nullptr, BufferLayout layout = BufferLayout()) : semRegister(reg), structSize(size), data(data), layout(layout) {}
+		ConstantBufferSlot(uint32 reg = 0, uint32 size = 0, byte* data = nullptr, BufferLayout layout = BufferLayout()) : semRegister(reg), structSize(size), data(data), layout(layout), version(0) {}
 
 		uint32 semRegister;
 		uint32 structSize;
@@ -92,8 +61,16 @@ public:
 
 		BufferLayout layout;
 
+		//0 compares data with the shader's copy on every set, owners that call Changed after
+		//every write let an unchanged slot skip the compare
+		uint32 version;
+
 		void SetElement(const String& name, const void* data) const;
+		void SetElement(StringID id, const void* data) const;
 		void SetElement(uint32 index, const void* data) const;
+
+		//New version, unique across all slots
+		void Changed();
 	};
 
 	struct TextureSlot {
@@ -107,6 +84,7 @@ public:
 private:
 	struct ShaderStructInfo {
 		String name;
+		StringID id;
 		uint32 semRegister;
 		uint32 structSize;
 
@@ -114,7 +92,14 @@ private:
 
 		ID3D11Buffer* buffer = nullptr;
 
-		~ShaderStructInfo() { DX_FREE(buffer); }
+		//Last contents set, buffer only holds them when bufferGeneration is the shader's generation.
+		//With the ConstantBufferRing they are uploaded to the ring instead.
+		ConstantBufferShadow shadow;
+		uint32 bufferGeneration = 0;
+
+		inline bool IsBufferCurrent() const { return bufferGeneration == generation; }
+
+		~ShaderStructInfo();
 	};
 
 	struct ShaderTextureInfo {
@@ -126,25 +111,11 @@ private:
 
 	typedef ShaderTextureInfo ShaderSamplerInfo;
 
-	enum FD_STRUCT_FIELD_TYPE {
-		FD_STRUCT_FIELD_TYPE_UNKNOWN,
-		FD_STRUCT_FIELD_TYPE_PRIMITVE,
-		FD_STRUCT_FIELD_TYPE_STRUCT
-	};
-
-	struct ShaderStructFieldType {
-		FD_STRUCT_FIELD_TYPE type;
-
-		uint32 size;
-
-		BufferLayout layout;
-	};
-
-	ShaderStructFieldType GetStructFieldType(const String& typeName, FD_SHADER_TYPE type);
-	void RemoveComments(String& source);
-	void ParseStructs(String source, FD_SHADER_TYPE type);
-	void CalcStructSize(String fields, uint32* size, BufferLayout* layout, FD_SHADER_TYPE type);
-	void ParseTextures(String source);
+	//Structs and cbuffers of the stage, textures and samplers too for the pixel shader.
+	//source is only parsed when there is no reflection from the ShaderLibrary.
+	void Reflect(const String& source, const HLSLReflection* reflection, FD_SHADER_TYPE type);
+	//Adds every member, array element and struct member with its packed offset
+	void CreateLayout(const HLSLReflection& reflection, const List<HLSLVariable*>& members, uint32 offset, const String& prefix, BufferLayout* layout);
 	void CreateBuffers();
 
 
@@ -176,25 +147,59 @@ private:
 	List<ShaderSamplerInfo*> pSamplers;
 
 	ID3D11InputLayout* inputLayout;
+	//Bytes per instance the input layout expects in slot FD_BUFFER_LAYOUT_INSTANCE_SLOT, 0 when it isn't instanced
+	uint32 instanceStride;
 
-	void SetVSConstantBufferSlotInternal(uint32 slot, const void* data) const;
-	void SetPSConstantBufferSlotInternal(uint32 slot, const void* data) const;
-	void SetGSConstantBufferSlotInternal(uint32 slot, const void* data) const;
+	static ShaderStructInfo* FindConstantBuffer(const List<ShaderStructInfo*>& cbuffers, StringID id);
 
-	void Compile(String vSource, String pSource, String gSource, bool geometry);
+	//Updates the shadow copy and uploads it when it changed
+	void SetConstantBufferInternal(ShaderStructInfo* cb, FD_SHADER_TYPE type, const void* data, uint32 version) const;
+	void UploadConstantBuffer(ShaderStructInfo* cb, FD_SHADER_TYPE type, bool ring) const;
+	void BindConstantBuffer(ShaderStructInfo* cb, FD_SHADER_TYPE type, bool ring) const;
+	//Binds cb->buffer itself to its slot
+	static void SetDeviceConstantBuffer(const ShaderStructInfo* cb, FD_SHADER_TYPE type);
+	//On a deferred context, writes data straight into the buffer without touching the shadow
+	static void WriteDeferredConstantBuffer(const ShaderStructInfo* cb, FD_SHADER_TYPE type, const void* data);
+
+	//Bytecode of the current permutation of a stage, the generated source is written to source.
+	//Only generated and compiled when the permutation isn't in the ShaderLibrary or the ShaderCache,
+	//reflection is set to the library's when it's in the library.
+	ID3DBlob* CompileStage(ShaderGen& gen, String& source, const char* entry, const char* profile, const char* stageName, const HLSLReflection** reflection);
+	//Shaders, bytecode and reflection of the current permutation
+	void ReleaseStages();
+
+	//Can be called again after changing ShaderGen variables
+	void Compile(bool geometry);
+
+	static const ShaderLibrary* library;
+
+	//Last bound, ring uploads of other shaders wait for their Bind
+	static const Shader* current;
+
+	//Bumped when something else wrote the buffers, none of them is current after that
+	static uint32 generation;
 
 public:
 	Shader(const String& vertexFilename, const String& pixelFilename, const String& geometryFilename, bool src = false);
 	~Shader();
 
+	//On a deferred context the buffers only hold what was set in the same command list,
+	//everything the draws read has to be set after Bind
 	void Bind();
 
+	//Executed command lists wrote the buffers, call after executing them
+	static void InvalidateConstantBuffers();
+
 	void SetVSConstantBuffer(const String& bufferName, const void* data) const;
 	void SetPSConstantBuffer(const String& bufferName, const void* data) const;
 	void SetGSConstantBuffer(const String& bufferName, const void* data) const;
-	void SetVSConstantBuffer(uint32 slot, const void* data) const;
-	void SetPSConstantBuffer(uint32 slot, const void* data) const;
-	void SetGSConstantBuffer(uint32 slot, const void* data) const;
+	//FD_SID("name"), no string compares
+	void SetVSConstantBuffer(StringID id, const void* data) const;
+	void SetPSConstantBuffer(StringID id, const void* data) const;
+	void SetGSConstantBuffer(StringID id, const void* data) const;
+	void SetVSConstantBuffer(uint32 slot, const void* data, uint32 version = 0) const;
+	void SetPSConstantBuffer(uint32 slot, const void* data, uint32 version = 0) const;
+	void SetGSConstantBuffer(uint32 slot, const void* data, uint32 version = 0) const;
 	void SetVSConstantBuffer(const ConstantBufferSlot vCBuffer) const;
 	void SetPSConstantBuffer(const ConstantBufferSlot pCBuffer) const;
 	void SetGSConstantBuffer(const ConstantBufferSlot pCBuffer) const;
@@ -219,15 +224,24 @@ public:
 	float32  ShaderGenGetVariable(const String& name, FD_SHADER_TYPE type) const;
 	String ShaderGenGetBlock(const String& name, FD_SHADER_TYPE typ) const;
 
+	//Compiles the current variables, a permutation compiled before comes from the ShaderCache.
+	//Can be called again after changing variables.
 	void ShaderGenComplete();
 
 	inline const void* GetVSBufferPointer() const { return vByteCode->GetBufferPointer(); }
 	inline uint_t GetVSBufferSize() const { return vByteCode->GetBufferSize(); }
 	inline ID3D11InputLayout* GetInputLayout() const { return inputLayout; }
 
-	inline void SetInputLayout(ID3D11InputLayout* layout) { DX_FREE(inputLayout); inputLayout = layout; }
+	inline void SetInputLayout(ID3D11InputLayout* layout, uint32 instanceStride = 0) { DX_FREE(inputLayout); inputLayout = layout; this->instanceStride = instanceStride; }
+
+	inline uint32 GetInstanceStride() const { return instanceStride; }
+	inline bool IsInstanced() const { return instanceStride != 0; }
 
 	static String GetFunctionTypeString(FD_SHADER_GEN_FUNCTION_TYPE type);
+
+	//Permutations baked by FormatConverter, looked up before the ShaderCache. Not owned, nullptr to stop using it.
+	static inline void SetLibrary(const ShaderLibrary* library) { Shader::library = library; }
+	static inline const ShaderLibrary* GetLibrary() { return library; }
 };
 
 }
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include "framebuffer.h"
+#include <graphics/renderstate.h>
 
 namespace FD {
 
 void Framebuffer::Bind(uint32 slot) const {
 
-	D3DContext::GetDeviceContext()->PSSetShaderResources(slot, 1, &resourceView);
+	RenderState::SetPSResource(slot, resourceView);
 }
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "sampler.h"
 #include <core/log.h>
+#include <graphics/renderstatecache.h>
+#include <graphics/renderstate.h>
 
 namespace FD {
 
@@ -25,19 +27,18 @@ D3D11_SAMPLER_DESC Sampler::GetDefaultDesc() {
 Sampler::Sampler() : Sampler(GetDefaultDesc()) { }
 
 Sampler::Sampler(D3D11_SAMPLER_DESC sd) {
-	samplerState = nullptr;
-
-	D3DContext::GetDevice()->CreateSamplerState(&sd, &samplerState);
+	samplerState = RenderStateCache::GetSamplerState(sd);
 
 	FD_ASSERT(samplerState == nullptr);
 }
 
+//Owned by RenderStateCache, other samplers with the same desc share it
 Sampler::~Sampler() {
-	DX_FREE(samplerState);
+
 }
 
 void Sampler::Bind(uint32 slot) const {
-	D3DContext::GetDeviceContext()->PSSetSamplers(slot, 1, &samplerState);
+	RenderState::SetPSSampler(slot, samplerState);
 }
 
 }
\ No newline at end of file
@@ -1,17 +1,33 @@
 #include "texture.h"
 #include <core/log.h>
 #include <util/vfs/vfs.h>
+#include <core/profiler.h>
+#include <core/jobsystem.h>
 #include <FreeImage.h>
 
 
 namespace FD {
 
+//Pixels are 32 bit, large images are split over the job system
+static void SwapRedBlue(byte* pixels, uint_t numPixels) {
+	JobSystem::ParallelFor(numPixels, 64 * 1024, [pixels](uint_t begin, uint_t end) {
+		for (uint_t i = begin; i < end; i++) {
+			byte* pixel = pixels + i * 4;
+			byte tmp = pixel[0];
+			pixel[0] = pixel[2];
+			pixel[2] = tmp;
+		}
+	});
+}
+
 Texture::Texture() {
 	resource = nullptr;
 	resourceView = nullptr;
 }
 
 byte* Texture::Load(const String& filename, uint32* width, uint32* height, uint32* bits, bool flipY) {
+	FD_PROFILE_SCOPE("Texture::Load");
+
 	FD_ASSERT_MSG(width == nullptr,"width parameter nullptr");
 	FD_ASSERT_MSG(height == nullptr,"height parameter nullptr");
 	FD_ASSERT_MSG(bits == nullptr, "bits parameter nullptr");
@@ -34,6 +50,8 @@ byte* Texture::Load(const String& filename, uint32* width, uint32* height, uint3
 			*width = 0;
 			*height = 0;
 			*bits = 0;
+			FreeImage_CloseMemory(data);
+			Memory::Free(rawData);
 			return nullptr;
 		}
 	}
@@ -55,7 +73,7 @@ byte* Texture::Load(const String& filename, uint32* width, uint32* height, uint3
 	*bits = 32;// FreeImage_GetBPP(bitmap);
 	
 	uint_t imageSize = *width * *height * (*bits / 8);
-	byte* pixels = new byte[imageSize];
+	byte* pixels = (byte*)Memory::Allocate(imageSize, FD_MEMTAG_TEXTURE);
 
 	if (flipY) {
 		FreeImage_FlipVertical(bitmap);
@@ -64,24 +82,21 @@ byte* Texture::Load(const String& filename, uint32* width, uint32* height, uint3
 	memcpy(pixels, FreeImage_GetBits(bitmap), imageSize);
 
 	if (FreeImage_GetRedMask(bitmap) == 0xFF0000) {
-		//Swap red and blue
-		for (uint_t i = 0; i < imageSize; i += (*bits / 8)) {
-			byte* pixel = pixels + i;
-			byte tmp = pixel[0];
-			pixel[0] = pixel[2];
-			pixel[2] = tmp;
-		}
+		SwapRedBlue(pixels, *width * *height);
 	}
 
 
 	FreeImage_Unload(bitmap);
 	FreeImage_CloseMemory(data);
+	Memory::Free(rawData);
 
 
 	return pixels;
 }
 
 byte* Texture::Load(void* memory, uint32* width, uint32* height, uint32* bits, bool flipY) {
+	FD_PROFILE_SCOPE("Texture::Load");
+
 	FD_ASSERT_MSG(width == nullptr, "width parameter nullptr");
 	FD_ASSERT_MSG(height == nullptr, "height parameter nullptr");
 	FD_ASSERT_MSG(bits == nullptr, "bits parameter nullptr");
@@ -121,7 +136,7 @@ byte* Texture::Load(void* memory, uint32* width, uint32* height, uint32* bits, b
 	*bits = 32;// FreeImage_GetBPP(bitmap);
 
 	uint_t imageSize = *width * *height * (*bits / 8);
-	byte* pixels = new byte[imageSize];
+	byte* pixels = (byte*)Memory::Allocate(imageSize, FD_MEMTAG_TEXTURE);
 
 	if (flipY) {
 		FreeImage_FlipVertical(bitmap);
@@ -130,13 +145,7 @@ byte* Texture::Load(void* memory, uint32* width, uint32* height, uint32* bits, b
 	memcpy(pixels, FreeImage_GetBits(bitmap), imageSize);
 
 	if (FreeImage_GetRedMask(bitmap) == 0xFF0000) {
-		//Swap red and blue
-		for (uint_t i = 0; i < imageSize; i += (*bits / 8)) {
-			byte* pixel = pixels + i;
-			byte tmp = pixel[0];
-			pixel[0] = pixel[2];
-			pixel[2] = tmp;
-		}
+		SwapRedBlue(pixels, *width * *height);
 	}
 
 
@@ -38,6 +38,7 @@ public:
 	inline ID3D11ShaderResourceView* GetResourceView() const { return resourceView; }
 	
 
+	//The returned pixels are released with Memory::Free
 	static byte* Load(const String& filename, uint32* width, uint32* height, uint32* bits, bool flipY = false);
 	static byte* Load(void* memory, uint32* width, uint32* height, uint32* bits, bool flipY = false);
 };
@@ -1,6 +1,7 @@
 #include "texture2d.h"
 #include <core/log.h>
 #include <util/vfs/vfs.h>
+#include <graphics/renderstate.h>
 
 namespace FD {
 
@@ -39,6 +40,8 @@ Texture2D::Texture2D(const String& filename)  {
 
 	D3DContext::GetDevice()->CreateTexture2D(&d, &r, (ID3D11Texture2D**)&resource);
 
+	Memory::Free(data);
+
 	FD_ASSERT(resource == nullptr);
 
 	D3DContext::GetDevice()->CreateShaderResourceView(resource, &s, &resourceView);
@@ -101,7 +104,7 @@ Texture2D::~Texture2D() {
 }
 
 void Texture2D::Bind(uint32 slot) const {
-	D3DContext::GetDeviceContext()->PSSetShaderResources(slot, 1, &resourceView);
+	RenderState::SetPSResource(slot, resourceView);
 }
 
 }
\ No newline at end of file
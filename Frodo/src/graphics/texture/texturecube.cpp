@@ -1,6 +1,8 @@
 #include "texturecube.h"
 #include <util/string.h>
 #include <core/log.h>
+#include <core/jobsystem.h>
+#include <graphics/renderstate.h>
 
 namespace FD {
 
@@ -90,7 +92,7 @@ void TextureCube::LoadSingleFile(const String& filename) {
 		delete[] newData[i];
 
 	delete[] newData;
-	delete[] data;
+	Memory::Free(data);
 	
 }
 
@@ -108,11 +110,18 @@ void TextureCube::LoadMultipleFiles(const String* filePaths) {
 	uint32 h = 0;
 	uint32 b = 0;
 
+	//The faces are decoded in parallel
+	JobSystem::ParallelFor(6, 1, [&](uint_t begin, uint_t end) {
+		for (uint_t i = begin; i < end; i++) {
+			FD_IMAGE_FILE& file = files[i];
+
+			file.data = Texture::Load(*filePaths[i], &file.width, &file.height, &file.bits);
+		}
+	});
+
 	for (uint_t i = 0; i < 6; i++) {
 		FD_IMAGE_FILE& file = files[i];
 
-		file.data = Texture::Load(*filePaths[i], &file.width, &file.height, &file.bits);
-
 		if (i == 0) {
 			w = file.width;
 			h = file.height;
@@ -168,7 +177,7 @@ void TextureCube::LoadMultipleFiles(const String* filePaths) {
 	FD_ASSERT(resourceView == nullptr);
 
 	for (uint_t i = 0; i < 6; i++) {
-		delete[] files[i].data;
+		Memory::Free(files[i].data);
 	}
 
 }
@@ -186,7 +195,7 @@ TextureCube::~TextureCube() {
 }
 
 void TextureCube::Bind(uint32 slot) const {
-	D3DContext::GetDeviceContext()->PSSetShaderResources(slot, 1, &resourceView);
+	RenderState::SetPSResource(slot, resourceView);
 }
 
 }
\ No newline at end of file
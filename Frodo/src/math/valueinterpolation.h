@@ -60,4 +60,9 @@ void ValueInterpolation<vec4>::Interpolate(float percent) {
 	*value = ((maxValue - minValue) * percent) + minValue;
 }
 
+template<>
+void ValueInterpolation<quat>::Interpolate(float percent) {
+	*value = quat::Slerp(minValue, maxValue, percent);
+}
+
 }
\ No newline at end of file
@@ -11,7 +11,7 @@ Asset::Asset(const Asset* asset) {
 	type = asset->type;
 
 	size = asset->size;
-	data = new byte[size];
+	data = Memory::Allocate(size, FD_MEMTAG_ASSET);
 
 	memcpy(data, asset->data, size);
 }
@@ -59,10 +59,15 @@ Texture* Asset::GetTexture() const {
 
 		if (b != 32) {
 			FD_FATAL("[Asset]: Failed to create texture2d \"%s\", Only 32 bit textues supported atm!", *name);
+			Memory::Free(data);
 			return nullptr;
 		}
 
-		return new Texture2D(data, w, h, FD_TEXTURE_FORMAT_UINT_8_8_8_8);
+		Texture2D* texture = new Texture2D(data, w, h, FD_TEXTURE_FORMAT_UINT_8_8_8_8);
+
+		Memory::Free(data);
+
+		return texture;
 	} else if (type == FD_ASSET_TYPE_TEXTURECUBE) {
 		//TODO: implement
 		FD_WARNING("[Asset]: TODO Implement %s!!!" __FUNCSIG__);
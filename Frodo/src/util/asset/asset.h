@@ -3,6 +3,7 @@
 #include <fd.h>
 
 #include <util/string.h>
+#include <core/memory.h>
 #include <graphics/font/font.h>
 #include <graphics/shader/shader.h>
 #include <graphics/texture/texture.h>
@@ -35,7 +36,7 @@ public:
 	Asset() { size = 0; data = nullptr; }
 	Asset(const Asset* asset);
 
-	~Asset() { delete[] data; }
+	~Asset() { Memory::Free(data); }
 
 	String GetString() const;
 	Font* GetFont(uint32 size, ivec2 dpi, Font::FD_RANGE<>* range, uint32 num_ranges) const;
@@ -1,5 +1,6 @@
 #include "assetmanager.h"
 #include <util/fileutils.h>
+#include <core/profiler.h>
 
 namespace FD {
 
@@ -27,6 +28,7 @@ void AssetManager::LoadPackage(const Package* package) {
 }
 
 bool AssetManager::LoadPackage(const String& filename, String* packageNameOut) {
+	FD_PROFILE_SCOPE("AssetManager::LoadPackage");
 
 	uint_t fileSize = 0;
 
@@ -40,6 +42,7 @@ bool AssetManager::LoadPackage(const String& filename, String* packageNameOut) {
 	PACKAGE_HEADER* hdr = (PACKAGE_HEADER*)data;
 
 	if (!ValidatePackageHeader(hdr, filename)) {
+		Memory::Free(data);
 		return false;
 	}
 
@@ -62,7 +65,7 @@ bool AssetManager::LoadPackage(const String& filename, String* packageNameOut) {
 		asset->type = e->type;
 		asset->size = e->size;
 
-		asset->data = new byte[asset->size];
+		asset->data = Memory::Allocate(asset->size, FD_MEMTAG_ASSET);
 		memcpy(asset->data, data + e->dataOffset, asset->size);
 
 		totalSize += asset->size;
@@ -70,7 +73,7 @@ bool AssetManager::LoadPackage(const String& filename, String* packageNameOut) {
 
 	FD_DEBUG("[AssetManager] Loaded package: Name: \"%s\" Size: %llu Assets: %u", *packageName, totalSize, hdr->numberOfAssets);
 
-	delete[] data;
+	Memory::Free(data);
 
 	return true;
 }
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Compares two FrodoBench JSON result files.
+
+Usage: compare.py baseline.json current.json [--threshold 0.10] [--metric real_time|cpu_time]
+
+Prints the relative change for every benchmark present in both files and exits
+with status 1 if any benchmark got slower than the threshold allows.
+When the files contain repetition aggregates only the median is compared.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+	with open(path) as f:
+		data = json.load(f)
+
+	results = {}
+	hasAggregates = any(b.get("run_type") == "aggregate" for b in data["benchmarks"])
+
+	for b in data["benchmarks"]:
+		if hasAggregates:
+			if b.get("run_type") != "aggregate" or b.get("aggregate_name") != "median":
+				continue
+			name = b["run_name"]
+		else:
+			name = b["name"]
+
+		results[name] = b[metric]
+
+	return results
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Compare two FrodoBench result files")
+	parser.add_argument("baseline")
+	parser.add_argument("current")
+	parser.add_argument("--threshold", type=float, default=0.10, help="allowed slowdown, 0.10 = 10%%")
+	parser.add_argument("--metric", default="real_time", choices=["real_time", "cpu_time"])
+	args = parser.parse_args()
+
+	baseline = load(args.baseline, args.metric)
+	current = load(args.current, args.metric)
+
+	names = [n for n in current if n in baseline]
+	if not names:
+		print("No common benchmarks found")
+		return 1
+
+	width = max(len(n) for n in names)
+	regressions = []
+
+	print("%-*s %14s %14s %9s" % (width, "Benchmark", "Baseline", "Current", "Change"))
+	for name in names:
+		old = baseline[name]
+		new = current[name]
+		delta = (new - old) / old if old > 0 else 0.0
+
+		mark = ""
+		if delta > args.threshold:
+			mark = "  REGRESSION"
+			regressions.append(name)
+		elif delta < -args.threshold:
+			mark = "  improved"
+
+		print("%-*s %14.2f %14.2f %+8.1f%%%s" % (width, name, old, new, delta * 100.0, mark))
+
+	for name in sorted(set(baseline) - set(current)):
+		print("%-*s only in baseline" % (width, name))
+	for name in sorted(set(current) - set(baseline)):
+		print("%-*s only in current" % (width, name))
+
+	if regressions:
+		print("\n%d benchmark(s) regressed by more than %.0f%%" % (len(regressions), args.threshold * 100.0))
+		return 1
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
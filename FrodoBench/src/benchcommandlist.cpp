@@ -0,0 +1,54 @@
+#include "benchcommon.h"
+#include <core/commandlist.h>
+#include <core/jobsystem.h>
+
+namespace FD {
+namespace Bench {
+
+/*
+ ParallelRecorder with the recording backend, range(0) draws of a few commands each split
+ over range(1) command lists and executed into one list. One list records on the calling
+ thread, the difference to more lists is what the fan out gains or costs.
+*/
+
+static void RecordDraw(RecordingCommandList* list, uint_t index) {
+	list->Record(1, index);
+	list->Record(2, index * 3);
+	list->Record(3, index ^ 0x55);
+}
+
+static void BM_CommandListRecord(benchmark::State& state) {
+	JobSystem::Init();
+
+	uint_t count = (uint_t)state.range(0);
+	uint_t numLists = (uint_t)state.range(1);
+
+	List<RecordedCommand> executed(count * 3, 1);
+	ParallelRecorder recorder;
+
+	for (uint_t i = 0; i < numLists; i++) recorder.AddList(new RecordingCommandList(&executed));
+
+	auto record = [](CommandList* list, uint_t begin, uint_t end) {
+		for (uint_t i = begin; i < end; i++) RecordDraw((RecordingCommandList*)list, i);
+	};
+
+	//The lists keep their size, like they do from one frame to the next
+	recorder.Record(count, 64, record);
+	recorder.Execute();
+
+	for (auto _ : state) {
+		executed.Clear();
+
+		recorder.Record(count, 64, record);
+		recorder.Execute();
+
+		benchmark::DoNotOptimize(executed.GetData());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["workers"] = JobSystem::GetNumWorkers();
+}
+BENCHMARK(BM_CommandListRecord)->Args({ 4096, 1 })->Args({ 4096, 8 })->Args({ 65536, 1 })->Args({ 65536, 8 });
+
+}
+}
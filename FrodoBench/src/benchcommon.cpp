@@ -0,0 +1,88 @@
+#include "benchcommon.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+namespace FD {
+namespace Bench {
+
+String MakeIdentifier(Random& random, uint_t length) {
+	String res("");
+
+	for (uint_t i = 0; i < length; i++)
+		res.Append((char)('a' + random.Next() % 26));
+
+	return res;
+}
+
+String MakeShaderSource(uint_t numStructs) {
+	Random random;
+	//Built in a std::string, String::Append reallocates on every call
+	std::string source("/* Generated shader */\n");
+
+	char line[256];
+
+	for (uint_t i = 0; i < numStructs; i++) {
+		sprintf(line, "// Struct %u\nstruct Struct%u {\n", (uint32)i, (uint32)i);
+		source.append(line);
+
+		for (uint_t j = 0; j < 6; j++) {
+			sprintf(line, "\tfloat4 %s; // field\n", *MakeIdentifier(random, 8));
+			source.append(line);
+		}
+
+		source.append("};\n\n/*\n block comment\n*/\n");
+	}
+
+	source.append("float4 vsMain(float4 position : POSITION) : SV_POSITION {\n\treturn position; // passthrough\n}\n");
+
+	return String(source.c_str());
+}
+
+String MakeOBJ(uint_t numFaces) {
+	Random random;
+	std::string obj("# Generated obj\n");
+
+	char line[256];
+
+	uint_t numVertices = numFaces * 3;
+
+	for (uint_t i = 0; i < numVertices; i++) {
+		sprintf(line, "v %f %f %f\n", random.Float(-1, 1), random.Float(-1, 1), random.Float(-1, 1));
+		obj.append(line);
+	}
+
+	for (uint_t i = 0; i < numVertices; i++) {
+		sprintf(line, "vt %f %f\n", random.Float(0, 1), random.Float(0, 1));
+		obj.append(line);
+	}
+
+	for (uint_t i = 0; i < numVertices; i++) {
+		sprintf(line, "vn %f %f %f\n", random.Float(-1, 1), random.Float(-1, 1), random.Float(-1, 1));
+		obj.append(line);
+	}
+
+	for (uint_t i = 0; i < numFaces; i++) {
+		uint32 a = (uint32)(i * 3 + 1);
+		sprintf(line, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, a + 1, a + 1, a + 1, a + 2, a + 2, a + 2);
+		obj.append(line);
+	}
+
+	return String(obj.c_str());
+}
+
+String GetTempDirectory() {
+#ifdef FD_PLATFORM_WINDOWS
+	const char* tmp = getenv("TEMP");
+	String dir(tmp ? tmp : ".");
+	dir.Append('\\');
+#else
+	const char* tmp = getenv("TMPDIR");
+	String dir(tmp ? tmp : "/tmp");
+	dir.Append('/');
+#endif
+	return dir;
+}
+
+}
+}
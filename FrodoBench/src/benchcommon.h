@@ -0,0 +1,37 @@
+#pragma once
+
+#include <fdutils.h>
+#include <math/math.h>
+#include <benchmark/benchmark.h>
+
+namespace FD {
+namespace Bench {
+
+//Deterministic inputs so results are comparable between runs and commits
+class Random {
+private:
+	uint32 state;
+
+public:
+	Random(uint32 seed = 0x12345678) : state(seed) {}
+
+	inline uint32 Next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	inline float32 Float(float32 min, float32 max) { return min + (max - min) * (float32)(Next() & 0xFFFFFF) / (float32)0xFFFFFF; }
+	inline vec3 Vec3(float32 min, float32 max) { return vec3(Float(min, max), Float(min, max), Float(min, max)); }
+};
+
+String MakeIdentifier(Random& random, uint_t length);
+String MakeShaderSource(uint_t numStructs);
+String MakeOBJ(uint_t numFaces);
+
+//Directory for files written by the benchmarks, ends with a slash
+String GetTempDirectory();
+
+}
+}
@@ -0,0 +1,71 @@
+#include "benchcommon.h"
+#include <util/constantbuffershadow.h>
+#include <string.h>
+
+namespace FD {
+namespace Bench {
+
+/*
+ ConstantBufferShadow::Update on a buffer of range(0) bytes, what Shader does on every
+ constant buffer set before deciding whether to upload. Unchanged compares the whole buffer,
+ OneRegister changes the last register every iteration and Versioned is the shortcut
+ Material takes when its slot didn't change.
+*/
+
+static void BM_ConstantBufferUnchanged(benchmark::State& state) {
+	uint32 size = (uint32)state.range(0);
+	List<byte> data(size, 1);
+	data.Resize(size);
+	memset(data.GetData(), 1, size);
+
+	ConstantBufferShadow shadow(size);
+	shadow.Update(data.GetData());
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(shadow.Update(data.GetData()));
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ConstantBufferUnchanged)->Range(64, 4096);
+
+static void BM_ConstantBufferOneRegister(benchmark::State& state) {
+	uint32 size = (uint32)state.range(0);
+	List<byte> data(size, 1);
+	data.Resize(size);
+	memset(data.GetData(), 1, size);
+
+	ConstantBufferShadow shadow(size);
+	shadow.Update(data.GetData());
+
+	byte* last = data.GetData() + size - FD_CONSTANT_BUFFER_REGISTER_SIZE;
+
+	for (auto _ : state) {
+		(*last)++;
+		benchmark::DoNotOptimize(shadow.Update(data.GetData()));
+		shadow.ClearDirty();
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ConstantBufferOneRegister)->Range(64, 4096);
+
+static void BM_ConstantBufferVersioned(benchmark::State& state) {
+	uint32 size = (uint32)state.range(0);
+	List<byte> data(size, 1);
+	data.Resize(size);
+	memset(data.GetData(), 1, size);
+
+	ConstantBufferShadow shadow(size);
+	shadow.Update(data.GetData(), 1);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(shadow.Update(data.GetData(), 1));
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ConstantBufferVersioned)->Range(64, 4096);
+
+}
+}
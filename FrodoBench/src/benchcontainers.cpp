@@ -0,0 +1,120 @@
+#include "benchcommon.h"
+
+namespace FD {
+namespace Bench {
+
+static void BM_ListPushBack(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		List<uint32> list;
+
+		for (uint_t i = 0; i < count; i++)
+			list.Push_back((uint32)i);
+
+		benchmark::DoNotOptimize(list.GetData());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ListPushBack)->Range(64, 16 << 10);
+
+static void BM_ListPushBackReserved(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		List<uint32> list(count);
+
+		for (uint_t i = 0; i < count; i++)
+			list.Push_back((uint32)i);
+
+		benchmark::DoNotOptimize(list.GetData());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ListPushBackReserved)->Range(64, 16 << 10);
+
+static void BM_ListFind(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	List<uint32> list(count);
+
+	for (uint_t i = 0; i < count; i++)
+		list.Push_back((uint32)i);
+
+	Random random;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(list.Find(random.Next() % (uint32)count));
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ListFind)->Range(64, 16 << 10);
+
+static void BM_ListRemoveIndex(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	List<uint32> list(count);
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		list.Clear();
+		for (uint_t i = 0; i < count; i++)
+			list.Push_back((uint32)i);
+		state.ResumeTiming();
+
+		while (list.GetSize())
+			list.RemoveIndex(0);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ListRemoveIndex)->Range(64, 4 << 10);
+
+static void BM_MapAddRetrieve(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		Map<uint32, uint32> map((uint32)count);
+
+		for (uint_t i = 0; i < count; i++)
+			map.Add((uint32)i, (uint32)i * 2);
+
+		for (uint_t i = 0; i < count; i++)
+			benchmark::DoNotOptimize(map.Retrieve((uint32)i));
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_MapAddRetrieve)->Range(16, 4 << 10);
+
+static void BM_MapRetrieveString(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	Random random;
+	List<String*> keys(count);
+	Map<String, uint32> map((uint32)count);
+
+	for (uint_t i = 0; i < count; i++) {
+		String* key = new String(MakeIdentifier(random, 16));
+		keys.Push_back(key);
+		map.Add(*key, (uint32)i);
+	}
+
+	uint_t index = 0;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map.Retrieve(*keys[index]));
+		index = (index + 1) % count;
+	}
+
+	keys.Free();
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapRetrieveString)->Range(16, 1 << 10);
+
+}
+}
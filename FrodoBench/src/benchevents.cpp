@@ -0,0 +1,142 @@
+#include "benchcommon.h"
+#include <util/listenertable.h>
+
+namespace FD {
+namespace Bench {
+
+/*
+ Mouse move dispatch through the ListenerTable EventDispatcher uses, with the handler calls of
+ its mouse move case. The listeners stand in for EventListener, which is part of the engine.
+ The fan-out version calls every handler on every listener like the dispatcher did before it
+ had per type tables.
+*/
+
+enum EventType {
+	EVENT_MOUSE_MOVE_ABSOLUTE,
+	EVENT_MOUSE_MOVE_RELATIVE,
+	EVENT_KEY_PRESSED,
+	EVENT_WINDOW_RESIZE,
+
+	EVENT_TYPE_COUNT
+};
+
+#define EVENT_MASK(type) (1u << (type))
+
+struct MouseMoveEvent {
+	EventType type;
+	ivec2 position;
+};
+
+class Listener {
+public:
+	uint32 eventMask;
+	uint32 moves;
+
+	Listener(uint32 eventMask) : eventMask(eventMask), moves(0) {}
+	virtual ~Listener() {}
+
+	inline uint32 GetEventMask() const { return eventMask; }
+
+	virtual bool OnEvent(const MouseMoveEvent*) { return false; }
+	virtual bool OnMouseActionMove(ivec2) { return false; }
+	virtual bool OnMouseActionMoveAbsolute(ivec2) { return false; }
+	virtual bool OnMouseActionMoveRelative(ivec2) { return false; }
+};
+
+//What UserCamera does with relative moves
+class CameraListener : public Listener {
+public:
+	CameraListener() : Listener(EVENT_MASK(EVENT_MOUSE_MOVE_RELATIVE) | EVENT_MASK(EVENT_KEY_PRESSED)) {}
+
+	bool OnMouseActionMoveRelative(ivec2 position) override {
+		moves += (uint32)(position.x + position.y);
+		return false;
+	}
+};
+
+class ResizeListener : public Listener {
+public:
+	ResizeListener() : Listener(EVENT_MASK(EVENT_WINDOW_RESIZE)) {}
+};
+
+struct Listeners {
+	List<Listener*> listeners;
+	ListenerTable<Listener, EVENT_TYPE_COUNT> table;
+
+	Listeners(uint_t count, uint_t numCameras) {
+		for (uint_t i = 0; i < count; i++) {
+			if (i % (count / numCameras) == 0) {
+				listeners.Push_back(new CameraListener);
+			} else {
+				listeners.Push_back(new ResizeListener);
+			}
+		}
+
+		for (uint_t i = 0; i < count; i++) table.Add(listeners[i]);
+	}
+
+	~Listeners() {
+		for (uint_t i = 0; i < listeners.GetSize(); i++) delete listeners[i];
+	}
+};
+
+static void DispatchFanOut(Listeners& l, const MouseMoveEvent* event) {
+	uint_t num = l.listeners.GetSize();
+
+	for (uint_t i = 0; i < num; i++) {
+		Listener* listener = l.listeners[i];
+
+		listener->OnEvent(event);
+		listener->OnMouseActionMove(event->position);
+
+		if (event->type == EVENT_MOUSE_MOVE_ABSOLUTE) {
+			listener->OnMouseActionMoveAbsolute(event->position);
+		} else {
+			listener->OnMouseActionMoveRelative(event->position);
+		}
+	}
+}
+
+static void DispatchTable(Listeners& l, const MouseMoveEvent* event) {
+	l.table.Dispatch(event->type, [&](Listener* listener) {
+		bool ret = listener->OnEvent(event);
+		ret |= listener->OnMouseActionMove(event->position);
+
+		if (event->type == EVENT_MOUSE_MOVE_ABSOLUTE) {
+			ret |= listener->OnMouseActionMoveAbsolute(event->position);
+		} else {
+			ret |= listener->OnMouseActionMoveRelative(event->position);
+		}
+
+		return ret;
+	});
+}
+
+//A frame of raw mouse input, 1000 listeners of which 4 want relative moves
+template<void(*DISPATCH)(Listeners&, const MouseMoveEvent*)>
+static void BM_EventDispatchMouseMove(benchmark::State& state) {
+	Listeners listeners(1000, 4);
+	Random random;
+
+	MouseMoveEvent events[256];
+
+	for (uint_t i = 0; i < 256; i++) {
+		events[i].type = EVENT_MOUSE_MOVE_RELATIVE;
+		events[i].position = ivec2((int32)(random.Next() & 15) - 8, (int32)(random.Next() & 15) - 8);
+	}
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < 256; i++) DISPATCH(listeners, &events[i]);
+
+		benchmark::ClobberMemory();
+	}
+
+	benchmark::DoNotOptimize(listeners.listeners[0]->moves);
+
+	state.SetItemsProcessed(state.iterations() * 256);
+}
+BENCHMARK_TEMPLATE(BM_EventDispatchMouseMove, DispatchFanOut);
+BENCHMARK_TEMPLATE(BM_EventDispatchMouseMove, DispatchTable);
+
+}
+}
@@ -0,0 +1,125 @@
+#include "benchcommon.h"
+#include <util/vfs/vfs.h>
+#include <util/wave.h>
+#include <util/fileutils.h>
+
+namespace FD {
+namespace Bench {
+
+//Mounts the temp directory as /bench/ and writes the files used below
+static void InitFiles() {
+	static bool initialized = false;
+
+	if (initialized) return;
+
+	initialized = true;
+
+	String dir = GetTempDirectory();
+
+	if (!VFS::Get()) VFS::Init();
+	VFS::Get()->Mount("bench", dir);
+
+	Random random;
+
+	uint_t textSize = 256 << 10;
+	char* text = new char[textSize];
+
+	for (uint_t i = 0; i < textSize; i++)
+		text[i] = (i % 80) == 79 ? '\n' : (char)('a' + random.Next() % 26);
+
+	FDWriteFile(dir + "frodobench.txt", text, textSize);
+
+	delete[] text;
+
+	uint32 numSamples = 44100;
+
+	WAVE wave;
+	wave.riff.ChunkID = 'R' | 'I' << 8 | 'F' << 16 | 'F' << 24;
+	wave.riff.Format = 'W' | 'A' << 8 | 'V' << 16 | 'E' << 24;
+	wave.riff.ChunkSize = 36 + numSamples * 4;
+	wave.format.SubChunkID = 'f' | 'm' << 8 | 't' << 16 | ' ' << 24;
+	wave.format.SubChunkSize = 16;
+	wave.format.AudioFormat = 1;
+	wave.format.NumChannels = 2;
+	wave.format.SampleRate = 44100;
+	wave.format.ByteRate = 44100 * 4;
+	wave.format.BlockAlign = 4;
+	wave.format.BitsPerSample = 16;
+	wave.data.SubChunkID = 'd' | 'a' << 8 | 't' << 16 | 'a' << 24;
+	wave.data.SubChunkSize = numSamples * 4;
+	wave.audioData = (byte*)Memory::Allocate(wave.data.SubChunkSize, FD_MEMTAG_AUDIO);
+
+	for (uint32 i = 0; i < wave.data.SubChunkSize; i++)
+		wave.audioData[i] = (byte)random.Next();
+
+	FILE* file = fopen(*(dir + "frodobench.wav"), "wb");
+	FDWriteFile(file, &wave, sizeof(WAVE_RIFF) + sizeof(WAVE_FORMAT) + sizeof(WAVE_DATA));
+	FDWriteFile(file, wave.audioData, wave.data.SubChunkSize);
+	fclose(file);
+}
+
+static void BM_VFSResolvePath(benchmark::State& state) {
+	InitFiles();
+
+	String path("/bench/textures/frodobench.txt");
+
+	for (auto _ : state) {
+		String resolved = VFS::Get()->ResolvePath(path);
+		benchmark::DoNotOptimize(resolved.str);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VFSResolvePath);
+
+static void BM_VFSReadFile(benchmark::State& state) {
+	InitFiles();
+
+	String path("/bench/frodobench.txt");
+	uint_t size = 0;
+
+	for (auto _ : state) {
+		byte* data = VFS::Get()->ReadFile(path, &size);
+		benchmark::DoNotOptimize(data);
+		Memory::Free(data);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_VFSReadFile);
+
+static void BM_VFSReadTextFile(benchmark::State& state) {
+	InitFiles();
+
+	String path("/bench/frodobench.txt");
+	uint_t size = 0;
+
+	for (auto _ : state) {
+		String text = VFS::Get()->ReadTextFile(path);
+		size = text.length;
+		benchmark::DoNotOptimize(text.str);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_VFSReadTextFile);
+
+static void BM_ReadWaveFile(benchmark::State& state) {
+	InitFiles();
+
+	String path("/bench/frodobench.wav");
+	uint_t size = 0;
+
+	for (auto _ : state) {
+		WAVE* wave = FDReadWaveFile(path);
+		size = wave->data.SubChunkSize;
+		benchmark::DoNotOptimize(wave->audioData);
+		delete wave;
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ReadWaveFile);
+
+}
+}
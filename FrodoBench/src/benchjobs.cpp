@@ -0,0 +1,122 @@
+#include "benchcommon.h"
+#include <core/jobsystem.h>
+
+namespace FD {
+namespace Bench {
+
+//The benchmark thread becomes worker 0
+static void InitJobSystem() {
+	static bool initialized = false;
+
+	if (!initialized) {
+		JobSystem::Init();
+		initialized = true;
+	}
+}
+
+static void EmptyJob(void* data, uint_t, uint_t) {
+	benchmark::DoNotOptimize(data);
+}
+
+//Scheduling overhead, count empty jobs and a wait
+static void BM_JobRunWait(benchmark::State& state) {
+	InitJobSystem();
+
+	uint_t count = (uint_t)state.range(0);
+	Job* jobs = new Job[count];
+
+	for (uint_t i = 0; i < count; i++) jobs[i] = { EmptyJob, nullptr, 0, 0, nullptr };
+
+	for (auto _ : state) {
+		JobCounter counter;
+
+		JobSystem::Run(jobs, count, &counter);
+		JobSystem::Wait(&counter);
+	}
+
+	delete[] jobs;
+
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["workers"] = JobSystem::GetNumWorkers();
+}
+BENCHMARK(BM_JobRunWait)->Arg(1)->Arg(64)->Arg(1024);
+
+//A chain of jobs, each waiting on the previous one through a dependency
+static void BM_JobDependencyChain(benchmark::State& state) {
+	InitJobSystem();
+
+	uint_t length = (uint_t)state.range(0);
+	JobCounter* counters = new JobCounter[length];
+	Job job = { EmptyJob, nullptr, 0, 0, nullptr };
+
+	for (auto _ : state) {
+		JobSystem::Run(job, &counters[0]);
+
+		for (uint_t i = 1; i < length; i++) JobSystem::Run(job, &counters[i], &counters[i - 1]);
+
+		JobSystem::Wait(&counters[length - 1]);
+	}
+
+	delete[] counters;
+
+	state.SetItemsProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_JobDependencyChain)->Arg(64);
+
+struct TransformInput {
+	List<vec3> positions;
+	List<quat> orientations;
+	List<vec3> scales;
+	List<mat4> transforms;
+
+	TransformInput(uint_t count) {
+		Random random;
+
+		positions.Resize(count);
+		orientations.Resize(count);
+		scales.Resize(count);
+		transforms.Resize(count);
+
+		for (uint_t i = 0; i < count; i++) {
+			positions[i] = random.Vec3(-100, 100);
+			orientations[i] = quat::FromEuler(random.Vec3(-180, 180));
+			scales[i] = random.Vec3(0.5f, 2);
+		}
+	}
+};
+
+//Scene::Render's transform building, one batch on the calling thread
+static void BM_TransformsSerial(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformInput in(count);
+
+	for (auto _ : state) {
+		TransformBatch::ComposeTRS(in.positions.GetData(), in.orientations.GetData(), in.scales.GetData(), in.transforms.GetData(), count);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformsSerial)->Range(1 << 10, 64 << 10);
+
+static void BM_TransformsParallelFor(benchmark::State& state) {
+	InitJobSystem();
+
+	uint_t count = (uint_t)state.range(0);
+	TransformInput in(count);
+
+	for (auto _ : state) {
+		JobSystem::ParallelFor(count, 256, [&](uint_t begin, uint_t end) {
+			TransformBatch::ComposeTRS(in.positions.GetData() + begin, in.orientations.GetData() + begin, in.scales.GetData() + begin, in.transforms.GetData() + begin, end - begin);
+		});
+
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["workers"] = JobSystem::GetNumWorkers();
+}
+BENCHMARK(BM_TransformsParallelFor)->Range(1 << 10, 64 << 10);
+
+}
+}
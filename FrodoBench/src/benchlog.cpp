@@ -0,0 +1,41 @@
+#include "benchcommon.h"
+#include <core/log.h>
+
+namespace FD {
+namespace Bench {
+
+class NullLogSink : public LogSink {
+public:
+	uint_t bytes = 0;
+
+	void Write(byte, const char*, uint_t length) override { bytes += length; }
+};
+
+//Console output would dominate and spam the report, the sinks are swapped for one that only counts
+static void BM_Log(benchmark::State& state) {
+	NullLogSink sink;
+
+	Logger::RemoveSink(Logger::GetConsoleSink());
+	Logger::AddSink(&sink);
+
+	if (state.range(0)) Logger::Init();
+
+	uint32 i = 0;
+
+	for (auto _ : state) {
+		FDLog(FD_LOG_LEVEL_DEBUG, "[Bench] Parsing struct \"%s\" member %u offset %u", "Material", i, i * 4);
+		i++;
+	}
+
+	Logger::Flush();
+	Logger::Dispose();
+
+	Logger::RemoveSink(&sink);
+	Logger::AddSink(Logger::GetConsoleSink());
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Log)->Arg(0)->Arg(1);
+
+}
+}
@@ -0,0 +1,305 @@
+#include "benchcommon.h"
+
+namespace FD {
+namespace Bench {
+
+static void BM_Vec3Arithmetic(benchmark::State& state) {
+	Random random;
+	vec3 a = random.Vec3(-10, 10);
+	vec3 b = random.Vec3(-10, 10);
+
+	for (auto _ : state) {
+		vec3 c = (a + b) * 0.5f - a;
+		benchmark::DoNotOptimize(c);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Vec3Arithmetic);
+
+static void BM_Vec3NormalizeCross(benchmark::State& state) {
+	Random random;
+	vec3 a = random.Vec3(-10, 10);
+	vec3 b = random.Vec3(-10, 10);
+
+	for (auto _ : state) {
+		vec3 c = a.Cross(b).Normalize();
+		benchmark::DoNotOptimize(c);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Vec3NormalizeCross);
+
+static void BM_Mat4Multiply(benchmark::State& state) {
+	Random random;
+	mat4 a = mat4::Rotate(random.Vec3(-180, 180));
+	mat4 b = mat4::Translate(random.Vec3(-10, 10));
+
+	for (auto _ : state) {
+		mat4 c = a * b;
+		benchmark::DoNotOptimize(c);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4Multiply);
+
+static void BM_Mat4MultiplyVec3(benchmark::State& state) {
+	Random random;
+	mat4 a = mat4::Rotate(random.Vec3(-180, 180));
+	vec3 v = random.Vec3(-10, 10);
+
+	for (auto _ : state) {
+		vec3 c = a * v;
+		benchmark::DoNotOptimize(c);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4MultiplyVec3);
+
+static void BM_Mat4Rotate(benchmark::State& state) {
+	Random random;
+	vec3 r = random.Vec3(-180, 180);
+
+	for (auto _ : state) {
+		mat4 m = mat4::Rotate(r);
+		benchmark::DoNotOptimize(m);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4Rotate);
+
+static void BM_Mat4TRS(benchmark::State& state) {
+	Random random;
+	vec3 p = random.Vec3(-10, 10);
+	vec3 r = random.Vec3(-180, 180);
+	vec3 s = random.Vec3(0.5f, 2);
+
+	for (auto _ : state) {
+		mat4 m = mat4::Translate(p) * mat4::Rotate(r) * mat4::Scale(s);
+		benchmark::DoNotOptimize(m);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4TRS);
+
+static void BM_ComposeTRSEuler(benchmark::State& state) {
+	Random random;
+	vec3 p = random.Vec3(-10, 10);
+	vec3 r = random.Vec3(-180, 180);
+	vec3 s = random.Vec3(0.5f, 2);
+
+	for (auto _ : state) {
+		mat4 m = TransformBatch::ComposeTRS(p, r, s);
+		benchmark::DoNotOptimize(m);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_ComposeTRSEuler);
+
+static void BM_ComposeTRSQuat(benchmark::State& state) {
+	Random random;
+	vec3 p = random.Vec3(-10, 10);
+	quat r = quat::FromEuler(random.Vec3(-180, 180));
+	vec3 s = random.Vec3(0.5f, 2);
+
+	for (auto _ : state) {
+		mat4 m = TransformBatch::ComposeTRS(p, r, s);
+		benchmark::DoNotOptimize(m);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_ComposeTRSQuat);
+
+static void BM_QuatSlerp(benchmark::State& state) {
+	Random random;
+	quat a = quat::FromEuler(random.Vec3(-180, 180));
+	quat b = quat::FromEuler(random.Vec3(-180, 180));
+	float32 t = 0.0f;
+
+	for (auto _ : state) {
+		quat q = quat::Slerp(a, b, t);
+		benchmark::DoNotOptimize(q);
+		t = t > 1.0f ? 0.0f : t + 0.01f;
+	}
+}
+BENCHMARK(BM_QuatSlerp);
+
+static void BM_Mat4Inverse(benchmark::State& state) {
+	Random random;
+	mat4 m = TransformBatch::ComposeTRS(random.Vec3(-10, 10), random.Vec3(-180, 180), random.Vec3(0.5f, 2));
+
+	for (auto _ : state) {
+		mat4 r = mat4::Inverse(m);
+		benchmark::DoNotOptimize(r);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4Inverse);
+
+static void BM_Mat4InverseAffine(benchmark::State& state) {
+	Random random;
+	mat4 m = TransformBatch::ComposeTRS(random.Vec3(-10, 10), random.Vec3(-180, 180), random.Vec3(0.5f, 2));
+
+	for (auto _ : state) {
+		mat4 r = mat4::InverseAffine(m);
+		benchmark::DoNotOptimize(r);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4InverseAffine);
+
+static void BM_Mat4InverseRigid(benchmark::State& state) {
+	Random random;
+	mat4 m = TransformBatch::ComposeTRS(random.Vec3(-10, 10), random.Vec3(-180, 180), vec3(1, 1, 1));
+
+	for (auto _ : state) {
+		mat4 r = mat4::InverseRigid(m);
+		benchmark::DoNotOptimize(r);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Mat4InverseRigid);
+
+//Up to a scene of about 100k entities, 100000 itself is run as well to read off the frame cost
+#define FD_BENCH_TRANSFORM_MAX (128 << 10)
+
+struct TransformData {
+	List<vec3> positions;
+	List<vec3> rotations;
+	List<quat> orientations;
+	List<vec3> scales;
+	List<mat4> transforms;
+
+	TransformData(uint_t count) {
+		Random random;
+
+		positions.Resize(count);
+		rotations.Resize(count);
+		orientations.Resize(count);
+		scales.Resize(count);
+		transforms.Resize(count);
+
+		for (uint_t i = 0; i < count; i++) {
+			positions[i] = random.Vec3(-100, 100);
+			rotations[i] = random.Vec3(-180, 180);
+			orientations[i] = quat::FromEuler(rotations[i]);
+			scales[i] = random.Vec3(0.5f, 2);
+		}
+	}
+};
+
+static void BM_ComposeTRSScalarLoop(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < count; i++)
+			d.transforms[i] = mat4::Translate(d.positions[i]) * mat4::Rotate(d.rotations[i]) * mat4::Scale(d.scales[i]);
+
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ComposeTRSScalarLoop)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+static void BM_ComposeTRSBatchEuler(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+
+	for (auto _ : state) {
+		TransformBatch::ComposeTRS(d.positions.GetData(), d.rotations.GetData(), d.scales.GetData(), d.transforms.GetData(), count);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ComposeTRSBatchEuler)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+static void BM_ComposeTRSBatchQuat(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+
+	for (auto _ : state) {
+		TransformBatch::ComposeTRS(d.positions.GetData(), d.orientations.GetData(), d.scales.GetData(), d.transforms.GetData(), count);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ComposeTRSBatchQuat)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+static void BM_TransformPointsScalarLoop(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+	mat4 m = TransformBatch::ComposeTRS(vec3(1, 2, 3), vec3(10, 20, 30), vec3(1, 1, 1));
+
+	List<vec3> out;
+	out.Resize(count);
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < count; i++)
+			out[i] = m * d.positions[i];
+
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPointsScalarLoop)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+static void BM_TransformPointsBatch(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+	mat4 m = TransformBatch::ComposeTRS(vec3(1, 2, 3), vec3(10, 20, 30), vec3(1, 1, 1));
+
+	List<vec3> out;
+	out.Resize(count);
+
+	for (auto _ : state) {
+		TransformBatch::TransformPoints(m, d.positions.GetData(), out.GetData(), count);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPointsBatch)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+static void BM_TransformAABBsBatch(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+	mat4 m = TransformBatch::ComposeTRS(vec3(1, 2, 3), vec3(10, 20, 30), vec3(1, 1, 1));
+
+	List<vec3> outMin, outMax;
+	outMin.Resize(count);
+	outMax.Resize(count);
+
+	for (auto _ : state) {
+		TransformBatch::TransformAABBs(m, d.positions.GetData(), d.scales.GetData(), outMin.GetData(), outMax.GetData(), count);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformAABBsBatch)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+static void BM_MultiplyBatch(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	TransformData d(count);
+	mat4 view = TransformBatch::ComposeTRS(vec3(1, 2, 3), vec3(10, 20, 30), vec3(1, 1, 1));
+
+	TransformBatch::ComposeTRS(d.positions.GetData(), d.rotations.GetData(), d.scales.GetData(), d.transforms.GetData(), count);
+
+	List<mat4> out;
+	out.Resize(count);
+
+	for (auto _ : state) {
+		TransformBatch::Multiply(view, d.transforms.GetData(), out.GetData(), count);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_MultiplyBatch)->Range(64, FD_BENCH_TRANSFORM_MAX)->Arg(100000);
+
+}
+}
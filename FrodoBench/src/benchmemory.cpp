@@ -0,0 +1,116 @@
+#include "benchcommon.h"
+#include <core/frameallocator.h>
+
+namespace FD {
+namespace Bench {
+
+static void BM_MemoryAllocateFree(benchmark::State& state) {
+	uint64 size = (uint64)state.range(0);
+
+	for (auto _ : state) {
+		void* memory = Memory::Allocate(size, FD_MEMTAG_GENERAL);
+		benchmark::DoNotOptimize(memory);
+		Memory::Free(memory);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryAllocateFree)->Range(16, 64 << 10);
+
+//Baseline for the header and counter overhead of Memory::Allocate
+static void BM_MallocFree(benchmark::State& state) {
+	uint_t size = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		void* memory = malloc(size);
+		benchmark::DoNotOptimize(memory);
+		free(memory);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MallocFree)->Range(16, 64 << 10);
+
+//All threads use the same tag so they contend on the same counters
+static void BM_MemoryAllocateFreeThreaded(benchmark::State& state) {
+	for (auto _ : state) {
+		void* memory = Memory::Allocate(64, FD_MEMTAG_GENERAL);
+		benchmark::DoNotOptimize(memory);
+		Memory::Free(memory);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryAllocateFreeThreaded)->ThreadRange(1, 8);
+
+//A frame's worth of small allocations followed by the O(1) reset
+static void BM_FrameAllocatorAllocate(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < count; i++) {
+			void* memory = FrameAllocator::Allocate(64);
+			benchmark::DoNotOptimize(memory);
+		}
+
+		FrameAllocator::EndFrame();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FrameAllocatorAllocate)->Range(64, 16 << 10);
+
+static void BM_FrameListPushBack(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		{
+			FrameList<uint32> list;
+
+			for (uint_t i = 0; i < count; i++)
+				list.Push_back((uint32)i);
+
+			benchmark::DoNotOptimize(list.GetData());
+		}
+
+		FrameAllocator::EndFrame();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FrameListPushBack)->Range(64, 4 << 10);
+
+static void BM_SubStringHeapBatch(benchmark::State& state) {
+	Random random;
+	String text = MakeIdentifier(random, 256);
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < 64; i++) {
+			String sub = text.SubString(i, i + 32);
+			benchmark::DoNotOptimize(sub.str);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_SubStringHeapBatch);
+
+static void BM_SubStringFrameBatch(benchmark::State& state) {
+	Random random;
+	String text = MakeIdentifier(random, 256);
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < 64; i++) {
+			String sub = text.SubString(i, i + 32, FD_MEMTAG_FRAME);
+			benchmark::DoNotOptimize(sub.str);
+		}
+
+		FrameAllocator::EndFrame();
+	}
+
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_SubStringFrameBatch);
+
+}
+}
@@ -0,0 +1,33 @@
+#include "benchcommon.h"
+#include <util/objparser.h>
+#include <core/log.h>
+
+namespace FD {
+namespace Bench {
+
+//OBJParser::Parse is what MeshFactory loads .obj files with. Its debug messages are
+//still formatted, they just don't go to the console in between the results.
+static void BM_MeshParseOBJ(benchmark::State& state) {
+	String obj = MakeOBJ((uint_t)state.range(0));
+
+	Logger::RemoveSink(Logger::GetConsoleSink());
+
+	for (auto _ : state) {
+		List<vec3> vertices, normals;
+		List<vec2> texCoords;
+		List<uint32> indices;
+
+		OBJParser::Parse(obj, vertices, texCoords, normals, indices);
+
+		benchmark::DoNotOptimize(indices.GetData());
+	}
+
+	Logger::AddSink(Logger::GetConsoleSink());
+
+	state.SetBytesProcessed(state.iterations() * obj.length);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MeshParseOBJ)->Range(64, 4 << 10);
+
+}
+}
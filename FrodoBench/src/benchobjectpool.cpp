@@ -0,0 +1,74 @@
+#include "benchcommon.h"
+#include <util/objectpool.h>
+
+namespace FD {
+namespace Bench {
+
+//Roughly the size of an event or a small component
+struct PoolObject {
+	uint64 data[4];
+};
+
+//Shared by all threads so the threaded runs contend on the same free list
+static ObjectPool<PoolObject> pool(256);
+
+static void BM_ObjectPoolNewDelete(benchmark::State& state) {
+	for (auto _ : state) {
+		PoolObject* object = pool.New();
+		benchmark::DoNotOptimize(object);
+		pool.Delete(object);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ObjectPoolNewDelete)->ThreadRange(1, 8);
+
+//Baseline
+static void BM_HeapNewDelete(benchmark::State& state) {
+	for (auto _ : state) {
+		PoolObject* object = new PoolObject;
+		benchmark::DoNotOptimize(object);
+		delete object;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HeapNewDelete)->ThreadRange(1, 8);
+
+//A burst of objects alive at the same time, like the events of one frame
+static void BM_ObjectPoolBurst(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	PoolObject** objects = new PoolObject*[count];
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < count; i++) objects[i] = pool.New();
+		for (uint_t i = 0; i < count; i++) pool.Delete(objects[i]);
+
+		benchmark::ClobberMemory();
+	}
+
+	delete[] objects;
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ObjectPoolBurst)->Arg(1024);
+
+static void BM_HeapBurst(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	PoolObject** objects = new PoolObject*[count];
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < count; i++) objects[i] = new PoolObject;
+		for (uint_t i = 0; i < count; i++) delete objects[i];
+
+		benchmark::ClobberMemory();
+	}
+
+	delete[] objects;
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_HeapBurst)->Arg(1024);
+
+}
+}
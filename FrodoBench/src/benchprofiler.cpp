@@ -0,0 +1,47 @@
+#include "benchcommon.h"
+#include <core/profiler.h>
+
+namespace FD {
+namespace Bench {
+
+static void BM_ProfileScope(benchmark::State& state) {
+	Profiler::SetEnabled(state.range(0) != 0);
+
+	uint_t count = 0;
+
+	for (auto _ : state) {
+		FD_PROFILE_SCOPE("BM_ProfileScope");
+		benchmark::DoNotOptimize(count++);
+
+		//Drain before the ring fills up so the numbers don't include dropped zones
+		if ((count & 1023) == 0) {
+			state.PauseTiming();
+			Profiler::EndFrame();
+			state.ResumeTiming();
+		}
+	}
+
+	Profiler::EndFrame();
+	Profiler::SetEnabled(true);
+}
+BENCHMARK(BM_ProfileScope)->Arg(0)->Arg(1);
+
+static void BM_ProfilerEndFrame(benchmark::State& state) {
+	uint_t zones = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		for (uint_t i = 0; i < zones; i++) {
+			FD_PROFILE_SCOPE("BM_ProfilerEndFrame");
+		}
+		state.ResumeTiming();
+
+		Profiler::EndFrame();
+	}
+
+	state.SetItemsProcessed(state.iterations() * zones);
+}
+BENCHMARK(BM_ProfilerEndFrame)->Arg(64)->Arg(1024)->Arg(8192);
+
+}
+}
@@ -0,0 +1,84 @@
+#include "benchcommon.h"
+#include <util/radixsort.h>
+#include <algorithm>
+
+namespace FD {
+namespace Bench {
+
+/*
+ Sorting range(0) render queue keys with their command indices. The keys look like the ones
+ RenderQueue builds, a handful of shaders and materials in the top bits and a depth in the
+ bottom ones, so the radix sort skips the passes over the unused bits in between.
+ StableSort is the comparison sort it replaces.
+*/
+
+static void MakeKeys(List<uint64>& keys, uint_t count) {
+	Random random;
+
+	keys.Resize(count);
+
+	for (uint_t i = 0; i < count; i++) {
+		uint64 shader = random.Next() % 8;
+		uint64 material = random.Next() % 32;
+		uint64 mesh = random.Next() % 64;
+		uint64 depth = random.Next() & 0xFFFFFF;
+
+		keys[i] = (shader << 48) | (material << 36) | (mesh << 24) | depth;
+	}
+}
+
+static void BM_RadixSort(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	List<uint64> source(count, 1);
+	MakeKeys(source, count);
+
+	List<uint64> keys(count, 1);
+	List<uint32> values(count, 1);
+	List<uint64> tempKeys(count, 1);
+	List<uint32> tempValues(count, 1);
+
+	keys.Resize(count);
+	values.Resize(count);
+	tempKeys.Resize(count);
+	tempValues.Resize(count);
+
+	for (auto _ : state) {
+		memcpy(keys.GetData(), source.GetData(), count * sizeof(uint64));
+
+		for (uint_t i = 0; i < count; i++) values[i] = (uint32)i;
+
+		FDRadixSort(keys.GetData(), values.GetData(), tempKeys.GetData(), tempValues.GetData(), count);
+
+		benchmark::DoNotOptimize(values.GetData());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RadixSort)->Range(64, 16 << 10);
+
+static void BM_StableSort(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	List<uint64> source(count, 1);
+	MakeKeys(source, count);
+
+	List<uint32> values(count, 1);
+	values.Resize(count);
+
+	const uint64* keys = source.GetData();
+
+	for (auto _ : state) {
+		for (uint_t i = 0; i < count; i++) values[i] = (uint32)i;
+
+		std::stable_sort(values.GetData(), values.GetData() + count, [keys](uint32 a, uint32 b) { return keys[a] < keys[b]; });
+
+		benchmark::DoNotOptimize(values.GetData());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StableSort)->Range(64, 16 << 10);
+
+}
+}
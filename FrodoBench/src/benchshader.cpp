@@ -0,0 +1,40 @@
+#include "benchcommon.h"
+#include <util/hlslreflection.h>
+#include <util/shadergen.h>
+
+namespace FD {
+namespace Bench {
+
+//ShaderGen::RemoveComments and HLSLReflection are what Shader and the shader library builder run on every stage
+
+static void BM_ShaderRemoveComments(benchmark::State& state) {
+	String source = MakeShaderSource((uint_t)state.range(0));
+
+	for (auto _ : state) {
+		String tmp(source);
+		ShaderGen::RemoveComments(tmp);
+		benchmark::DoNotOptimize(tmp.str);
+	}
+
+	state.SetBytesProcessed(state.iterations() * source.length);
+}
+BENCHMARK(BM_ShaderRemoveComments)->Range(4, 256);
+
+//Comments included, the lexer skips them
+static void BM_ShaderReflect(benchmark::State& state) {
+	String source = MakeShaderSource((uint_t)state.range(0));
+
+	for (auto _ : state) {
+		HLSLReflection reflection;
+
+		reflection.Parse(source);
+
+		benchmark::DoNotOptimize(reflection.GetStructs().GetSize());
+	}
+
+	state.SetBytesProcessed(state.iterations() * source.length);
+}
+BENCHMARK(BM_ShaderReflect)->Range(4, 256);
+
+}
+}
@@ -0,0 +1,222 @@
+#include "benchcommon.h"
+#include <util/shadergen.h>
+#include <util/shadercache.h>
+
+namespace FD {
+namespace Bench {
+
+/*
+ ShaderGenComplete on the sprite pixel shader template (two generate loops over maxTextures)
+ with an if/else around a return. GenerateInPlace is what Shader::ShaderGenProcessGeneration
+ did before the ShaderGen tree: every generated block and every replaced variable is spliced
+ into the source with InsertString, which copies the rest of the source each time. The blocks
+ were extracted in the constructor then too so that isn't timed.
+*/
+
+static String MakeTemplate() {
+	return String(
+		"SamplerState samp : register(s0);\n"
+		"\n"
+		"#shaderGen define_b block1\n"
+		"Texture2D texvar : register(tsg_sub(var, 1));\n"
+		"#shaderGen endblock\n"
+		"\n"
+		"#shaderGen generate for(var, 1, le, maxTextures, 1) block1\n"
+		"\n"
+		"float4 psMain(float4 position : SV_POSITION, float2 texCoords : TEXCOORDS, float4 color : COLOR, float tid : TID) : SV_TARGET0 {\n"
+		"\tfloat4 texColor = float4(1, 1, 1, 1);\n"
+		"\n"
+		"\tswitch(tid) {\n"
+		"\tcase 0:\n"
+		"\t\tbreak;\n"
+		"#shaderGen define_b block2\n"
+		"\tcase var:\n"
+		"\t\ttexColor = texvar.Sample(samp, texCoords);\n"
+		"\t\tbreak;\n"
+		"#shaderGen endblock\n"
+		"\n"
+		"#shaderGen generate for(var, 1, le, maxTextures, 1) block2\n"
+		"\t}\n"
+		"\n"
+		"#shaderGen if defined(SHADOW)\n"
+		"\treturn float4(0, 0, 0, 1);\n"
+		"#shaderGen else\n"
+		"\treturn color * texColor;\n"
+		"#shaderGen endif\n"
+		"}\n");
+}
+
+static void InsertString(String& source, const String& code, uint_t offset) {
+	String afterBlock = source.SubString(offset, source.length);
+	source.Remove(offset, source.length);
+
+	source.Append(code);
+	source.Append(afterBlock);
+}
+
+static void WriteValue(String& source, uint_t start, float32 value) {
+	char buf[128];
+	sprintf(buf, "%f", value);
+
+	String data(buf);
+
+	if (start != 0 && String(" =<>+-*/").Find(source[start - 1]) == (uint_t)-1) {
+		uint_t point = data.Find(".");
+		if (point != (uint_t)-1) data.Remove(point, data.length);
+	}
+
+	InsertString(source, data, start);
+}
+
+static void GenerateInPlace(String& source, const String& block1, const String& block2, float32 maxTextures) {
+	//The if/else, same Find and Remove calls as ShaderGenProcessConditions with SHADOW undefined
+	uint_t ifStart = source.Find("#shaderGen if ");
+	uint_t elseStart = source.Find("#shaderGen else", ifStart);
+	uint_t endif = source.Find("#shaderGen endif", elseStart);
+
+	source.Remove(endif, endif + 16);
+	source.Remove(ifStart, elseStart + 15);
+
+	const String* blocks[2] = { &block1, &block2 };
+
+	for (uint_t b = 0; b < 2; b++) {
+		uint_t start = source.Find("#shaderGen generate ");
+		uint_t nameEnd = source.Find("\n", start);
+
+		source.Remove(start, nameEnd);
+
+		String result;
+
+		for (float32 var = 1; var <= maxTextures; var++) {
+			String code(*blocks[b]);
+
+			while (true) {
+				uint_t call = code.Find("sg_sub");
+				if (call == (uint_t)-1) break;
+
+				uint_t end = code.Find(")", call) + 1;
+				code.Remove(call, end);
+
+				WriteValue(code, call, var - 1);
+			}
+
+			while (true) {
+				uint_t name = code.Find("var");
+				if (name == (uint_t)-1) break;
+
+				code.Remove(name, name + 3);
+
+				WriteValue(code, name, var);
+			}
+
+			result += code;
+		}
+
+		InsertString(source, result, start);
+	}
+}
+
+static void BM_ShaderGenInPlace(benchmark::State& state) {
+	String source = MakeTemplate();
+
+	//Blocks and their directives taken out like ShaderGenParseDefinitions did
+	String block1 = "\nTexture2D texvar : register(tsg_sub(var, 1));\n";
+	String block2 = "\n\tcase var:\n\t\ttexColor = texvar.Sample(samp, texCoords);\n\t\tbreak;\n";
+
+	uint_t start;
+	while ((start = source.Find("#shaderGen define_b")) != (uint_t)-1) {
+		uint_t end = source.Find("#shaderGen endblock", start) + 19;
+		source.Remove(start, end);
+	}
+
+	for (auto _ : state) {
+		String copy(source);
+
+		GenerateInPlace(copy, block1, block2, (float32)state.range(0));
+
+		benchmark::DoNotOptimize(copy.str);
+	}
+}
+BENCHMARK(BM_ShaderGenInPlace)->Arg(8)->Arg(32)->Arg(128);
+
+static void BM_ShaderGenParse(benchmark::State& state) {
+	String source = MakeTemplate();
+	ShaderGen gen;
+
+	for (auto _ : state) {
+		gen.Parse(source);
+
+		benchmark::DoNotOptimize(gen.GetBlocks().GetSize());
+	}
+}
+BENCHMARK(BM_ShaderGenParse);
+
+static void BM_ShaderGenWalk(benchmark::State& state) {
+	ShaderGen gen;
+	gen.Parse(MakeTemplate());
+	gen.SetVariable("maxTextures", (float32)state.range(0));
+
+	for (auto _ : state) {
+		String output;
+		gen.Generate(output);
+
+		benchmark::DoNotOptimize(output.str);
+	}
+}
+BENCHMARK(BM_ShaderGenWalk)->Arg(8)->Arg(32)->Arg(128);
+
+//Switching between two permutations that were generated before
+static void BM_ShaderGenCached(benchmark::State& state) {
+	ShaderGen gen;
+	gen.Parse(MakeTemplate());
+
+	float32 maxTextures = (float32)state.range(0);
+
+	for (auto _ : state) {
+		gen.SetVariable("maxTextures", maxTextures);
+
+		const String& output = gen.Generate();
+
+		benchmark::DoNotOptimize(output.str);
+
+		maxTextures = maxTextures == 8 ? (float32)state.range(0) : 8;
+	}
+}
+BENCHMARK(BM_ShaderGenCached)->Arg(32)->Arg(128);
+
+//What ShaderGenComplete costs per stage when the permutation was compiled before, 64 cached
+//permutations of 16KB bytecode and a lookup of one that isn't the most recent
+static void BM_ShaderCacheFind(benchmark::State& state) {
+	ShaderGen gen;
+	gen.Parse(MakeTemplate());
+
+	List<byte> byteCode(16384, 1);
+	byteCode.Resize(16384);
+
+	for (uint32 i = 0; i < 64; i++) {
+		gen.SetVariable("maxTextures", (float32)i);
+		ShaderCache::Add(ShaderCache::MakeKey(gen.GetSourceHash(), gen.GetVariableHash(), "ps_5_0"), gen.Generate(), byteCode.GetData(), byteCode.GetSize());
+	}
+
+	uint32 i = 0;
+
+	for (auto _ : state) {
+		gen.SetVariable("maxTextures", (float32)(i++ & 31));
+
+		String source;
+		byte* data = nullptr;
+		uint_t size = 0;
+
+		bool found = ShaderCache::Find(ShaderCache::MakeKey(gen.GetSourceHash(), gen.GetVariableHash(), "ps_5_0"), &source, &data, &size);
+
+		benchmark::DoNotOptimize(found);
+
+		Memory::Free(data);
+	}
+
+	ShaderCache::Clear();
+}
+BENCHMARK(BM_ShaderCacheFind);
+
+}
+}
@@ -0,0 +1,127 @@
+#include "benchcommon.h"
+
+namespace FD {
+namespace Bench {
+
+static void BM_StringCopy(benchmark::State& state) {
+	Random random;
+	String source = MakeIdentifier(random, (uint_t)state.range(0));
+
+	for (auto _ : state) {
+		String copy(source);
+		benchmark::DoNotOptimize(copy.str);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringCopy)->Range(16, 64 << 10);
+
+static void BM_StringAppendChar(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		String str("");
+
+		for (uint_t i = 0; i < count; i++)
+			str.Append('a');
+
+		benchmark::DoNotOptimize(str.str);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StringAppendChar)->Range(16, 4 << 10);
+
+static void BM_StringAppendString(benchmark::State& state) {
+	uint_t count = (uint_t)state.range(0);
+	String word("identifier ");
+
+	for (auto _ : state) {
+		String str("");
+
+		for (uint_t i = 0; i < count; i++)
+			str.Append(word);
+
+		benchmark::DoNotOptimize(str.str);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StringAppendString)->Range(16, 4 << 10);
+
+static void BM_StringFind(benchmark::State& state) {
+	Random random;
+	String str = MakeIdentifier(random, (uint_t)state.range(0));
+	str.Append("needle");
+
+	String needle("needle");
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(str.Find(needle));
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringFind)->Range(64, 64 << 10);
+
+static void BM_StringSplit(benchmark::State& state) {
+	String text = MakeOBJ((uint_t)state.range(0));
+
+	for (auto _ : state) {
+		List<String*> lines = text.Split('\n');
+		benchmark::DoNotOptimize(lines.GetData());
+		lines.Free();
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.length);
+}
+BENCHMARK(BM_StringSplit)->Range(64, 4 << 10);
+
+static void BM_StringSubString(benchmark::State& state) {
+	Random random;
+	String str = MakeIdentifier(random, 4096);
+
+	uint_t length = (uint_t)state.range(0);
+
+	for (auto _ : state) {
+		uint_t start = random.Next() % (4096 - length);
+		String sub = str.SubString(start, start + length);
+		benchmark::DoNotOptimize(sub.str);
+	}
+
+	state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_StringSubString)->Range(8, 1 << 10);
+
+static void BM_StringRemove(benchmark::State& state) {
+	Random random;
+	String source = MakeIdentifier(random, (uint_t)state.range(0));
+
+	for (auto _ : state) {
+		String str(source);
+
+		while (str.length > 16)
+			str.Remove(0, 16);
+
+		benchmark::DoNotOptimize(str.str);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringRemove)->Range(64, 16 << 10);
+
+static void BM_StringCompare(benchmark::State& state) {
+	Random random;
+	String a = MakeIdentifier(random, (uint_t)state.range(0));
+	String b(a);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a == b);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringCompare)->Range(16, 4 << 10);
+
+}
+}
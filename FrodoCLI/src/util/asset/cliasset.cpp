@@ -16,7 +16,7 @@ bool Asset::SetData(System::String^ filename) {
 
 	uint_t fileSize = 0;
 
-	instance->data = FD::FDReadBinaryFile(fname, &fileSize);
+	instance->data = FD::FDReadBinaryFile(fname, &fileSize, FD::FD_MEMTAG_ASSET);
 	instance->size = fileSize;
 
 	if (instance->data == nullptr) {
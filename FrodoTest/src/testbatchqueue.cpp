@@ -0,0 +1,326 @@
+#include "testcommon.h"
+#include <util/batchqueue.h>
+#include <core/commandlist.h>
+#include <core/jobsystem.h>
+#include <string.h>
+
+namespace FD {
+namespace Test {
+
+//Stand ins for the engine's shaders, materials and meshes, BatchQueue only compares the pointers
+static byte shaders[4];
+static byte materials[4];
+static byte meshes[8192];
+
+static BatchItem MakeItem(uint_t shader, uint_t material, uint_t mesh, uint32 pass = 0, bool instanced = true, vec3 position = vec3(0, 0, 1)) {
+	BatchItem item;
+
+	item.shader = &shaders[shader];
+	item.material = &materials[material];
+	item.mesh = &meshes[mesh];
+	item.pass = pass;
+	item.instanced = instanced;
+	item.position = position;
+
+	return item;
+}
+
+enum REPLAY_COMMAND {
+	REPLAY_BIND_SHADER,
+	REPLAY_BIND_MATERIAL,
+	REPLAY_BIND_MESH,
+	//Argument is the submit index
+	REPLAY_DRAW,
+	//Argument is the instance count in the high and the first instance in the low 32 bits
+	REPLAY_DRAW_INSTANCED
+};
+
+//What PBRStaticRenderer::DrawBatches issues, binds everything from scratch so any range can be recorded on its own
+static void RecordBatches(RecordingCommandList* list, BatchQueue& queue, uint_t begin, uint_t end) {
+	const void* shader = nullptr;
+	const void* material = nullptr;
+	const void* mesh = nullptr;
+
+	const List<RenderBatch>& batches = queue.GetBatches();
+
+	for (uint_t i = begin; i < end; i++) {
+		const RenderBatch& batch = batches.Get(i);
+		const BatchItem& item = queue[batch.first];
+
+		if (item.shader != shader) {
+			shader = item.shader;
+			list->Record(REPLAY_BIND_SHADER, (uint64)(uint_t)shader);
+			material = nullptr;
+		}
+
+		if (item.material != material) {
+			material = item.material;
+			list->Record(REPLAY_BIND_MATERIAL, (uint64)(uint_t)material);
+		}
+
+		if (item.mesh != mesh) {
+			mesh = item.mesh;
+			list->Record(REPLAY_BIND_MESH, (uint64)(uint_t)mesh);
+		}
+
+		if (item.instanced) {
+			list->Record(REPLAY_DRAW_INSTANCED, ((uint64)batch.count << 32) | batch.firstInstance);
+		} else {
+			list->Record(REPLAY_DRAW, queue.GetOrder(batch.first));
+		}
+	}
+}
+
+struct ReplayCounts {
+	uint_t draws;
+	uint_t instancedDraws;
+	uint_t instances;
+	uint_t meshBinds;
+};
+
+static ReplayCounts Replay(BatchQueue& queue) {
+	List<RecordedCommand> executed;
+	RecordingCommandList list(&executed);
+
+	list.Begin();
+	RecordBatches(&list, queue, 0, queue.GetBatches().GetSize());
+	list.End();
+	list.Execute();
+
+	ReplayCounts counts = { 0, 0, 0, 0 };
+	uint32 nextInstance = 0;
+
+	for (uint_t i = 0; i < executed.GetSize(); i++) {
+		const RecordedCommand& cmd = executed[i];
+
+		switch (cmd.id) {
+			case REPLAY_DRAW:
+				counts.draws++;
+				break;
+			case REPLAY_DRAW_INSTANCED:
+				counts.instancedDraws++;
+				counts.instances += (uint_t)(cmd.argument >> 32);
+
+				//Batches take the instance data in order without gaps
+				EXPECT_EQ((uint32)cmd.argument, nextInstance);
+				nextInstance += (uint32)(cmd.argument >> 32);
+				break;
+			case REPLAY_BIND_MESH:
+				counts.meshBinds++;
+				break;
+		}
+	}
+
+	return counts;
+}
+
+TEST(PointerTable, IndicesInInsertOrder) {
+	PointerTable table(4);
+
+	for (uint_t i = 0; i < 1000; i++) EXPECT_EQ(table.Insert(&meshes[i]), (uint32)i);
+	for (uint_t i = 0; i < 1000; i++) EXPECT_EQ(table.Insert(&meshes[i]), (uint32)i);
+
+	EXPECT_EQ(table.GetSize(), 1000u);
+
+	table.Clear();
+
+	EXPECT_EQ(table.GetSize(), 0u);
+	EXPECT_EQ(table.Insert(&meshes[500]), 0u);
+}
+
+//The same shader, material and mesh in another pass is another batch
+TEST(BatchQueue, PassSplitsBatches) {
+	BatchQueue queue;
+
+	queue.Push(MakeItem(0, 0, 0, 0));
+	queue.Push(MakeItem(0, 0, 0, 1));
+	queue.Push(MakeItem(0, 0, 0, 0));
+	queue.Push(MakeItem(0, 0, 0, 1));
+	queue.Sort(vec3(0, 0, 0));
+
+	const List<RenderBatch>& batches = queue.GetBatches();
+
+	ASSERT_EQ(batches.GetSize(), 2u);
+	EXPECT_EQ(batches.Get(0).count, 2u);
+	EXPECT_EQ(batches.Get(1).count, 2u);
+	EXPECT_EQ(queue[batches.Get(0).first].pass, 0u);
+	EXPECT_EQ(queue[batches.Get(1).first].pass, 1u);
+	EXPECT_EQ(queue.GetNumInstances(), 4u);
+}
+
+TEST(BatchQueue, MaterialSplitsBatches) {
+	BatchQueue queue;
+
+	queue.Push(MakeItem(0, 0, 0));
+	queue.Push(MakeItem(0, 1, 0));
+	queue.Push(MakeItem(0, 0, 0));
+	queue.Sort(vec3(0, 0, 0));
+
+	const List<RenderBatch>& batches = queue.GetBatches();
+
+	ASSERT_EQ(batches.GetSize(), 2u);
+	EXPECT_EQ(batches.Get(0).count, 2u);
+	EXPECT_EQ(batches.Get(1).count, 1u);
+	EXPECT_EQ(batches.Get(1).firstInstance, 2u);
+}
+
+//Past the last id meshes share it, they sort together but mustn't be drawn as one
+TEST(BatchQueue, SaturatedIDsDontMerge) {
+	BatchQueue queue;
+
+	uint_t numMeshes = (1 << FD_RENDER_KEY_MESH_BITS) + 16;
+
+	for (uint_t i = 0; i < numMeshes; i++) queue.Push(MakeItem(0, 0, i));
+
+	queue.Sort(vec3(0, 0, 0));
+
+	const List<RenderBatch>& batches = queue.GetBatches();
+
+	ASSERT_EQ(batches.GetSize(), numMeshes);
+
+	for (uint_t i = 0; i < batches.GetSize(); i++) EXPECT_EQ(batches.Get(i).count, 1u);
+}
+
+//The same mesh submitted many times is one instanced draw
+TEST(BatchQueue, ReplayRepeatedMesh) {
+	BatchQueue queue;
+	Random random;
+
+	for (uint_t i = 0; i < 100; i++) queue.Push(MakeItem(0, 0, 0, 0, true, random.Vec3(-100.0f, 100.0f)));
+
+	queue.Sort(vec3(0, 0, 0));
+
+	ReplayCounts counts = Replay(queue);
+
+	EXPECT_EQ(counts.instancedDraws, 1u);
+	EXPECT_EQ(counts.instances, 100u);
+	EXPECT_EQ(counts.meshBinds, 1u);
+	EXPECT_EQ(counts.draws, 0u);
+	EXPECT_EQ(queue.GetNumInstances(), 100u);
+}
+
+//Meshes submitted interleaved are grouped again, one instanced draw per mesh
+TEST(BatchQueue, ReplayInterleavedMeshes) {
+	BatchQueue queue;
+
+	for (uint_t i = 0; i < 90; i++) queue.Push(MakeItem(0, 0, i % 3));
+
+	queue.Sort(vec3(0, 0, 0));
+
+	ReplayCounts counts = Replay(queue);
+
+	EXPECT_EQ(counts.instancedDraws, 3u);
+	EXPECT_EQ(counts.instances, 90u);
+	EXPECT_EQ(counts.meshBinds, 3u);
+
+	const List<RenderBatch>& batches = queue.GetBatches();
+
+	ASSERT_EQ(batches.GetSize(), 3u);
+
+	for (uint_t i = 0; i < batches.GetSize(); i++) EXPECT_EQ(batches.Get(i).count, 30u);
+}
+
+//Shaders without instance data draw every command on its own, the instanced ones still merge
+TEST(BatchQueue, ReplayMixedInstancing) {
+	BatchQueue queue;
+
+	for (uint_t i = 0; i < 40; i++) {
+		queue.Push(MakeItem(0, 0, i % 2, 0, true));
+		queue.Push(MakeItem(1, 1, i % 2, 0, false));
+	}
+
+	queue.Sort(vec3(0, 0, 0));
+
+	ReplayCounts counts = Replay(queue);
+
+	EXPECT_EQ(counts.instancedDraws, 2u);
+	EXPECT_EQ(counts.instances, 40u);
+	EXPECT_EQ(counts.draws, 40u);
+	EXPECT_EQ(queue.GetNumInstances(), 40u);
+	EXPECT_EQ(queue.GetBatches().GetSize(), 42u);
+}
+
+//Batches recorded in chunks on several workers execute to the same commands as on one thread
+TEST(BatchQueue, ParallelRecordMatchesSingleThread) {
+	JobSystem::Init(4);
+
+	BatchQueue queue;
+	Random random;
+
+	for (uint_t i = 0; i < 5000; i++) {
+		uint_t shader = random.Next() % 4;
+		queue.Push(MakeItem(shader, random.Next() % 4, random.Next() % 64, random.Next() % 2, shader < 2, random.Vec3(-100.0f, 100.0f)));
+	}
+
+	queue.Sort(vec3(0, 0, 0));
+
+	uint_t numBatches = queue.GetBatches().GetSize();
+
+	List<RecordedCommand> single;
+	RecordingCommandList list(&single);
+
+	list.Begin();
+	RecordBatches(&list, queue, 0, numBatches);
+	list.End();
+	list.Execute();
+
+	List<RecordedCommand> parallel;
+	ParallelRecorder recorder;
+
+	for (uint_t i = 0; i < 8; i++) recorder.AddList(new RecordingCommandList(&parallel));
+
+	uint_t chunks = recorder.Record(numBatches, 16, [&queue](CommandList* list, uint_t begin, uint_t end) {
+		RecordBatches((RecordingCommandList*)list, queue, begin, end);
+	});
+
+	recorder.Execute();
+
+	EXPECT_EQ(chunks, 8u);
+
+	//Every chunk starts by binding everything, leave those out and the draws have to line up
+	List<RecordedCommand> singleDraws;
+	List<RecordedCommand> parallelDraws;
+
+	for (uint_t i = 0; i < single.GetSize(); i++) {
+		if (single[i].id >= REPLAY_DRAW) singleDraws.Push_back(single[i]);
+	}
+
+	for (uint_t i = 0; i < parallel.GetSize(); i++) {
+		if (parallel[i].id >= REPLAY_DRAW) parallelDraws.Push_back(parallel[i]);
+	}
+
+	ASSERT_EQ(parallelDraws.GetSize(), singleDraws.GetSize());
+
+	for (uint_t i = 0; i < singleDraws.GetSize(); i++) {
+		ASSERT_EQ(parallelDraws[i].id, singleDraws[i].id) << i;
+		ASSERT_EQ(parallelDraws[i].argument, singleDraws[i].argument) << i;
+	}
+
+	//The state each draw sees is the same as well
+	const void* state[3] = { nullptr, nullptr, nullptr };
+	List<uint64> singleState;
+	List<uint64> parallelState;
+
+	for (uint_t pass = 0; pass < 2; pass++) {
+		List<RecordedCommand>& commands = pass == 0 ? single : parallel;
+		List<uint64>& result = pass == 0 ? singleState : parallelState;
+
+		for (uint_t i = 0; i < commands.GetSize(); i++) {
+			const RecordedCommand& cmd = commands[i];
+
+			if (cmd.id < REPLAY_DRAW) {
+				state[cmd.id] = (const void*)(uint_t)cmd.argument;
+			} else {
+				for (uint_t j = 0; j < 3; j++) result.Push_back((uint64)(uint_t)state[j]);
+			}
+		}
+	}
+
+	ASSERT_EQ(parallelState.GetSize(), singleState.GetSize());
+	EXPECT_EQ(memcmp(parallelState.GetData(), singleState.GetData(), singleState.GetSizeInBytes()), 0);
+
+	JobSystem::Dispose();
+}
+
+}
+}
@@ -0,0 +1,42 @@
+#include "testcommon.h"
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+
+namespace FD {
+namespace Test {
+
+static_assert(sizeof(mat4) == sizeof(float32) * 16, "mat4 is expected to be exactly its 16 floats");
+
+mat4 MakeMat4(const float32* columns) {
+	mat4 r;
+	memcpy((void*)&r, columns, sizeof(mat4));
+	return r;
+}
+
+float32 MaxDifference(const mat4& a, const mat4& b) {
+	float32 max = 0.0f;
+
+	for (uint_t i = 0; i < 16; i++) {
+		float32 diff = fabsf(a.GetData()[i] - b.GetData()[i]);
+		if (diff > max) max = diff;
+	}
+
+	return max;
+}
+
+String GetTempDirectory() {
+#ifdef FD_PLATFORM_WINDOWS
+	const char* tmp = getenv("TEMP");
+	String dir(tmp ? tmp : ".");
+	dir.Append('\\');
+#else
+	const char* tmp = getenv("TMPDIR");
+	String dir(tmp ? tmp : "/tmp");
+	dir.Append('/');
+#endif
+	return dir;
+}
+
+}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <fdutils.h>
+#include <math/math.h>
+#include <gtest/gtest.h>
+
+namespace FD {
+namespace Test {
+
+//Deterministic inputs so a failure can be reproduced
+class Random {
+private:
+	uint32 state;
+
+public:
+	Random(uint32 seed = 0x12345678) : state(seed) {}
+
+	inline uint32 Next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	inline float32 Float(float32 min, float32 max) { return min + (max - min) * (float32)(Next() & 0xFFFFFF) / (float32)0xFFFFFF; }
+	inline vec3 Vec3(float32 min, float32 max) { return vec3(Float(min, max), Float(min, max), Float(min, max)); }
+};
+
+//mat4 has no element setter, columns is 16 floats in the same column major layout
+mat4 MakeMat4(const float32* columns);
+
+//Largest absolute difference between two matrices
+float32 MaxDifference(const mat4& a, const mat4& b);
+
+//Directory for files written by the tests, ends with a slash
+String GetTempDirectory();
+
+}
+}
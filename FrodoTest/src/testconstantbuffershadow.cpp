@@ -0,0 +1,156 @@
+#include "testcommon.h"
+#include <util/constantbuffershadow.h>
+
+namespace FD {
+namespace Test {
+
+//4 registers
+#define FD_TEST_SHADOW_FLOATS 16
+#define FD_TEST_SHADOW_SIZE (FD_TEST_SHADOW_FLOATS * 4)
+
+static void FillBuffer(float32* buffer) {
+	for (uint32 i = 0; i < FD_TEST_SHADOW_FLOATS; i++) buffer[i] = (float32)i;
+}
+
+TEST(ConstantBufferShadow, UnchangedIsClean) {
+	ConstantBufferShadow shadow(FD_TEST_SHADOW_SIZE);
+	float32 buffer[FD_TEST_SHADOW_FLOATS];
+
+	FillBuffer(buffer);
+
+	//The first update always counts, even when it matches the zeroed copy
+	EXPECT_FALSE(shadow.IsSet());
+	EXPECT_TRUE(shadow.Update(buffer));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 0u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), (uint32)FD_TEST_SHADOW_SIZE);
+
+	shadow.ClearDirty();
+
+	EXPECT_FALSE(shadow.Update(buffer));
+	EXPECT_FALSE(shadow.Update(0, buffer, FD_TEST_SHADOW_SIZE));
+	EXPECT_FALSE(shadow.Update(20, buffer + 5, 8));
+	EXPECT_FALSE(shadow.IsDirty());
+}
+
+TEST(ConstantBufferShadow, SingleFloatMarksOneRegister) {
+	ConstantBufferShadow shadow(FD_TEST_SHADOW_SIZE);
+	float32 buffer[FD_TEST_SHADOW_FLOATS];
+
+	FillBuffer(buffer);
+	shadow.Update(buffer);
+	shadow.ClearDirty();
+
+	//Second float of the third register
+	buffer[9] = -1.0f;
+
+	EXPECT_TRUE(shadow.Update(buffer));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 32u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), 48u);
+	EXPECT_EQ(memcmp(shadow.GetData(), buffer, FD_TEST_SHADOW_SIZE), 0);
+}
+
+//The dirty range is clipped to the updated bytes, the rest of the register isn't touched
+TEST(ConstantBufferShadow, PartialUpdateMidRegister) {
+	ConstantBufferShadow shadow(FD_TEST_SHADOW_SIZE);
+	float32 buffer[FD_TEST_SHADOW_FLOATS];
+
+	FillBuffer(buffer);
+	shadow.Update(buffer);
+	shadow.ClearDirty();
+
+	//Floats 5 to 10 cover the end of register 1 and most of register 2, only register 2 changes
+	float32 part[6] = { 5.0f, 6.0f, 7.0f, 8.0f, 90.0f, 10.0f };
+
+	EXPECT_TRUE(shadow.Update(20, part, sizeof(part)));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 32u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), 44u);
+
+	//Registers 1 and 2 change, the range starts where the update did
+	part[1] = 60.0f;
+	part[5] = 100.0f;
+	shadow.ClearDirty();
+
+	EXPECT_TRUE(shadow.Update(20, part, sizeof(part)));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 20u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), 44u);
+
+	buffer[6] = 60.0f;
+	buffer[9] = 90.0f;
+	buffer[10] = 100.0f;
+
+	EXPECT_EQ(memcmp(shadow.GetData(), buffer, FD_TEST_SHADOW_SIZE), 0);
+}
+
+//Changes between two uploads end up in one range that covers both
+TEST(ConstantBufferShadow, DisjointUpdatesMerge) {
+	ConstantBufferShadow shadow(FD_TEST_SHADOW_SIZE);
+	float32 buffer[FD_TEST_SHADOW_FLOATS];
+
+	FillBuffer(buffer);
+	shadow.Update(buffer);
+	shadow.ClearDirty();
+
+	float32 value = -1.0f;
+
+	EXPECT_TRUE(shadow.Update(52, &value, sizeof(value)));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 52u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), 56u);
+
+	EXPECT_TRUE(shadow.Update(4, &value, sizeof(value)));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 4u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), 56u);
+
+	//Same in one whole update, from the first changed register to the last
+	shadow.ClearDirty();
+	FillBuffer(buffer);
+	buffer[0] = -2.0f;
+	buffer[13] = -2.0f;
+
+	EXPECT_TRUE(shadow.Update(buffer));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 0u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), (uint32)FD_TEST_SHADOW_SIZE);
+	EXPECT_EQ(memcmp(shadow.GetData(), buffer, FD_TEST_SHADOW_SIZE), 0);
+}
+
+//The same pointer and version isn't compared, a partial update in between drops that shortcut
+TEST(ConstantBufferShadow, VersionSkip) {
+	ConstantBufferShadow shadow(FD_TEST_SHADOW_SIZE);
+	float32 buffer[FD_TEST_SHADOW_FLOATS];
+
+	FillBuffer(buffer);
+
+	EXPECT_TRUE(shadow.Update(buffer, 1));
+
+	shadow.ClearDirty();
+
+	//Changed behind the shadow's back without a new version, it's skipped
+	buffer[0] = -1.0f;
+
+	EXPECT_FALSE(shadow.Update(buffer, 1));
+	EXPECT_FALSE(shadow.IsDirty());
+	EXPECT_EQ(((const float32*)shadow.GetData())[0], 0.0f);
+
+	//Version 0 always compares
+	EXPECT_TRUE(shadow.Update(buffer, 0));
+	//A new version compares, nothing changed since
+	EXPECT_FALSE(shadow.Update(buffer, 2));
+
+	shadow.ClearDirty();
+
+	float32 value = 100.0f;
+
+	EXPECT_TRUE(shadow.Update(60, &value, sizeof(value)));
+
+	//The partial update changed the copy, the same version is compared again and puts it back
+	shadow.ClearDirty();
+
+	EXPECT_TRUE(shadow.Update(buffer, 2));
+	EXPECT_EQ(shadow.GetDirtyBegin(), 48u);
+	EXPECT_EQ(shadow.GetDirtyEnd(), (uint32)FD_TEST_SHADOW_SIZE);
+	EXPECT_EQ(memcmp(shadow.GetData(), buffer, FD_TEST_SHADOW_SIZE), 0);
+
+	EXPECT_FALSE(shadow.Update(buffer, 2));
+}
+
+}
+}
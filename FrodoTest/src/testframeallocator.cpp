@@ -0,0 +1,60 @@
+#include "testcommon.h"
+#include <core/frameallocator.h>
+#include <string.h>
+#include <utility>
+
+namespace FD {
+namespace Test {
+
+//Writes over everything the frame allocator handed out since the last reset
+static void ScribbleFrame() {
+	byte* data = (byte*)FrameAllocator::Allocate(4096, 16);
+	memset(data, 'x', 4096);
+}
+
+//A string moved out of a frame string has to survive the frame it was made in
+TEST(FrameAllocator, MoveFromFrameStringCopies) {
+	FrameAllocator::Init(64 * 1024);
+
+	String moved;
+	String assigned;
+
+	{
+		FrameString frame("frame string contents");
+		const char* frameData = frame.str;
+
+		String constructed(std::move(frame));
+		EXPECT_NE(constructed.str, frameData);
+
+		FrameString other("other frame string");
+		assigned = std::move(other);
+		EXPECT_NE(assigned.str, other.str);
+
+		moved = std::move(constructed);
+	}
+
+	FrameAllocator::EndFrame();
+	FrameAllocator::EndFrame();
+	ScribbleFrame();
+	FrameAllocator::EndFrame();
+	ScribbleFrame();
+
+	EXPECT_STREQ(moved.str, "frame string contents");
+	EXPECT_STREQ(assigned.str, "other frame string");
+
+	FrameAllocator::Dispose();
+}
+
+//Regular strings still hand over their buffer
+TEST(FrameAllocator, MoveFromHeapStringSteals) {
+	String heap("heap string");
+	const char* data = heap.str;
+
+	String moved(std::move(heap));
+
+	EXPECT_EQ(moved.str, data);
+	EXPECT_EQ(heap.str, nullptr);
+}
+
+}
+}
@@ -0,0 +1,111 @@
+#include "testcommon.h"
+#include <core/framestats.h>
+#include <string.h>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_FRAMESTATS_SPIKE (64 * 1024 * 1024)
+
+//A spike that is freed again before anyone asks for the memory still has to show in the peak
+TEST(FrameStats, PeakKeepsUnsampledSpike) {
+	uint64 before = FrameStats::GetPeakProcessMemory();
+	uint64 resident = FrameStats::GetProcessMemory();
+
+	if (resident == 0) GTEST_SKIP() << "process memory can't be queried on this platform";
+
+	byte* spike = new byte[FD_TEST_FRAMESTATS_SPIKE];
+	memset(spike, 0x5A, FD_TEST_FRAMESTATS_SPIKE);
+	volatile byte sink = spike[FD_TEST_FRAMESTATS_SPIKE - 1];
+	(void)sink;
+	delete[] spike;
+
+	uint64 after = FrameStats::GetPeakProcessMemory();
+
+	EXPECT_GE(after, before);
+	EXPECT_GE(after, resident + FD_TEST_FRAMESTATS_SPIKE / 2);
+}
+
+//1 to 100 ms once each, the percentiles land in the bucket of the sample with that rank
+TEST(FrameStats, HistogramPercentiles) {
+	FrameTimeHistogram histogram;
+
+	//Added out of order, the histogram doesn't care
+	for (uint_t i = 0; i < 100; i++) histogram.Add((float64)((i * 37) % 100 + 1));
+
+	EXPECT_EQ(histogram.GetCount(), 100u);
+	EXPECT_NEAR(histogram.GetPercentile(0.5), 50.0, FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+	EXPECT_NEAR(histogram.GetPercentile(0.99), 99.0, FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+	EXPECT_NEAR(histogram.GetPercentile(0.0), 1.0, FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+	EXPECT_DOUBLE_EQ(histogram.GetPercentile(1.0), 100.0);
+	EXPECT_DOUBLE_EQ(histogram.GetAverage(), 50.5);
+	EXPECT_DOUBLE_EQ(histogram.GetMin(), 1.0);
+	EXPECT_DOUBLE_EQ(histogram.GetMax(), 100.0);
+
+	//Past the last bucket still counts, at the top of the range
+	histogram.Clear();
+	histogram.Add(250.0);
+
+	EXPECT_DOUBLE_EQ(histogram.GetPercentile(0.5), 250.0);
+}
+
+//Only the last FD_FRAMESTATS_WINDOW samples are kept
+TEST(FrameStats, HistogramWindowEviction) {
+	FrameTimeHistogram histogram;
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_WINDOW; i++) histogram.Add(10.0);
+	for (uint_t i = 0; i < FD_FRAMESTATS_WINDOW / 2; i++) histogram.Add(20.0);
+
+	EXPECT_EQ(histogram.GetCount(), (uint_t)FD_FRAMESTATS_WINDOW);
+	EXPECT_DOUBLE_EQ(histogram.GetAverage(), 15.0);
+	EXPECT_NEAR(histogram.GetPercentile(0.25), 10.0, FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+	EXPECT_NEAR(histogram.GetPercentile(0.75), 20.0, FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+	EXPECT_DOUBLE_EQ(histogram.GetLast(), 20.0);
+
+	for (uint_t i = 0; i < FD_FRAMESTATS_WINDOW / 2; i++) histogram.Add(20.0);
+
+	//Every 10 ms sample has been pushed out
+	EXPECT_DOUBLE_EQ(histogram.GetMin(), 20.0);
+	EXPECT_DOUBLE_EQ(histogram.GetAverage(), 20.0);
+	EXPECT_NEAR(histogram.GetPercentile(0.01), 20.0, FD_FRAMESTATS_HISTOGRAM_BUCKET_MS);
+}
+
+//Counters start from 0 every frame, the history keeps what each frame counted
+TEST(FrameStats, CountersResetEveryFrame) {
+	FrameStats::Reset();
+
+	FrameStats::BeginFrame();
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS, 5);
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+	FrameStats::EndFrame();
+
+	FrameCounterStats draws = FrameStats::GetCounter(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+
+	EXPECT_EQ(draws.last, 6u);
+	EXPECT_EQ(draws.total, 6u);
+
+	FrameStats::BeginFrame();
+	FrameStats::Count(FD_FRAMESTATS_COUNTER_INSTANCES, 3);
+	FrameStats::EndFrame();
+
+	draws = FrameStats::GetCounter(FD_FRAMESTATS_COUNTER_DRAW_CALLS);
+
+	EXPECT_EQ(draws.last, 0u);
+	EXPECT_EQ(draws.max, 6u);
+	EXPECT_DOUBLE_EQ(draws.average, 3.0);
+	EXPECT_EQ(draws.total, 6u);
+	EXPECT_EQ(FrameStats::GetCounter(FD_FRAMESTATS_COUNTER_INSTANCES).last, 3u);
+
+	EXPECT_EQ(FrameStats::GetFrameNumber(), 2u);
+	EXPECT_EQ(FrameStats::GetTimer(FD_FRAMESTATS_TIMER_FRAME).GetCount(), 2u);
+	//Timers that didn't run aren't added
+	EXPECT_EQ(FrameStats::GetTimer(FD_FRAMESTATS_TIMER_UPDATE).GetCount(), 0u);
+
+	FrameStats::Reset();
+
+	EXPECT_EQ(FrameStats::GetCounter(FD_FRAMESTATS_COUNTER_DRAW_CALLS).total, 0u);
+	EXPECT_EQ(FrameStats::GetFrameNumber(), 0u);
+}
+
+}
+}
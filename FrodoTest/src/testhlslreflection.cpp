@@ -0,0 +1,194 @@
+#include "testcommon.h"
+#include <util/hlslreflection.h>
+#include <util/fileutils.h>
+#include <string.h>
+
+namespace FD {
+namespace Test {
+
+//Offsets and sizes below are the ones D3DReflect reports for the same declarations
+
+static const HLSLVariable* FindMember(const List<HLSLVariable*>& members, const char* name) {
+	for (uint_t i = 0; i < members.GetSize(); i++) {
+		if (strcmp(members.Get(i)->name.str, name) == 0) return members.Get(i);
+	}
+
+	return nullptr;
+}
+
+#define EXPECT_MEMBER(members, name, expectedOffset, expectedSize) { \
+	const HLSLVariable* member = FindMember(members, name); \
+	ASSERT_NE(member, nullptr) << name; \
+	EXPECT_EQ(member->offset, expectedOffset) << name; \
+	EXPECT_EQ(member->size, expectedSize) << name; \
+}
+
+//The engine's built in shaders are wrapped in R"( )" so they can be #included as a string
+static String ReadBundledShader(const char* path) {
+	String source = FDReadTextFile(String(FD_TEST_SOURCE_DIR "/") + path);
+
+	if (source.StartsWith("R\"(")) {
+		uint_t end = source.Find(")\"");
+
+		if (end != (uint_t)-1) return source.SubString(3, end);
+	}
+
+	return source;
+}
+
+TEST(HLSLReflection, Matrices) {
+	HLSLReflection reflection;
+
+	ASSERT_TRUE(reflection.Parse(
+		"cbuffer Matrices : register(b3) {\n"
+		"	float4 a;\n"
+		"	row_major float3x2 rowMajor;\n"
+		"	float b;\n"
+		"	float3x2 columnMajor;\n"
+		"	float c;\n"
+		"	float4x4 full;\n"
+		"	row_major float2x3 wide;\n"
+		"};\n"));
+
+	const HLSLConstantBuffer* cbuffer = reflection.GetConstantBuffer("Matrices");
+	ASSERT_NE(cbuffer, nullptr);
+
+	EXPECT_EQ(cbuffer->semRegister, 3);
+
+	//Three rows of float2, each in its own 16 byte row
+	EXPECT_MEMBER(cbuffer->members, "a", 0u, 16u);
+	EXPECT_MEMBER(cbuffer->members, "rowMajor", 16u, 40u);
+	EXPECT_MEMBER(cbuffer->members, "b", 56u, 4u);
+	//Two columns of float3
+	EXPECT_MEMBER(cbuffer->members, "columnMajor", 64u, 28u);
+	EXPECT_MEMBER(cbuffer->members, "c", 92u, 4u);
+	EXPECT_MEMBER(cbuffer->members, "full", 96u, 64u);
+	EXPECT_MEMBER(cbuffer->members, "wide", 160u, 28u);
+
+	EXPECT_EQ(cbuffer->size, 192u);
+}
+
+TEST(HLSLReflection, ArraysAndPackOffset) {
+	HLSLReflection reflection;
+
+	ASSERT_TRUE(reflection.Parse(
+		"cbuffer Arrays {\n"
+		"	float scalars[3];\n"
+		"	float after;\n"
+		"	float2 pairs[2];\n"
+		"	float3 last;\n"
+		"};\n"
+		"cbuffer Packed {\n"
+		"	float3 first : packoffset(c0);\n"
+		"	float y : packoffset(c20.y);\n"
+		"	float2 zw : packoffset(c1.z);\n"
+		"};\n"));
+
+	const HLSLConstantBuffer* arrays = reflection.GetConstantBuffer("Arrays");
+	ASSERT_NE(arrays, nullptr);
+
+	//Every element but the last takes a full row
+	EXPECT_MEMBER(arrays->members, "scalars", 0u, 36u);
+	EXPECT_EQ(FindMember(arrays->members, "scalars")->stride, 16u);
+	EXPECT_MEMBER(arrays->members, "after", 36u, 4u);
+	EXPECT_MEMBER(arrays->members, "pairs", 48u, 24u);
+	EXPECT_MEMBER(arrays->members, "last", 80u, 12u);
+	EXPECT_EQ(arrays->size, 96u);
+
+	const HLSLConstantBuffer* packed = reflection.GetConstantBuffer("Packed");
+	ASSERT_NE(packed, nullptr);
+
+	EXPECT_MEMBER(packed->members, "first", 0u, 12u);
+	EXPECT_MEMBER(packed->members, "y", 324u, 4u);
+	EXPECT_MEMBER(packed->members, "zw", 24u, 8u);
+	EXPECT_EQ(packed->size, 336u);
+}
+
+TEST(HLSLReflection, BundledPBRLightingVertex) {
+	String source = ReadBundledShader("Sandbox/res/pbr/shaders/pbr_lighting_v.hlsl");
+	ASSERT_GT(source.length, 0u);
+
+	HLSLReflection reflection;
+	ASSERT_TRUE(reflection.Parse(source));
+
+	const HLSLConstantBuffer* camera = reflection.GetConstantBuffer("Camera");
+	ASSERT_NE(camera, nullptr);
+
+	EXPECT_EQ(camera->semRegister, 1);
+	EXPECT_MEMBER(camera->members, "c_Position", 0u, 12u);
+	EXPECT_MEMBER(camera->members, "c_Pad0", 12u, 4u);
+	EXPECT_MEMBER(camera->members, "c_ViewMatrix", 16u, 64u);
+	EXPECT_MEMBER(camera->members, "c_ProjectionMatrix", 80u, 64u);
+	EXPECT_EQ(camera->size, 144u);
+
+	const HLSLStruct* light = reflection.GetStruct("Light");
+	ASSERT_NE(light, nullptr);
+
+	EXPECT_MEMBER(light->members, "Color", 0u, 12u);
+	EXPECT_MEMBER(light->members, "Position", 16u, 12u);
+	EXPECT_MEMBER(light->members, "Attenuation", 32u, 12u);
+	EXPECT_MEMBER(light->members, "pad2", 44u, 4u);
+	EXPECT_EQ(light->size, 48u);
+
+	const HLSLConstantBuffer* lightBuffer = reflection.GetConstantBuffer("Light");
+	ASSERT_NE(lightBuffer, nullptr);
+
+	EXPECT_EQ(lightBuffer->semRegister, 6);
+	EXPECT_MEMBER(lightBuffer->members, "light", 0u, 48u);
+	EXPECT_EQ(lightBuffer->size, 48u);
+}
+
+TEST(HLSLReflection, BundledPBRLightingPixel) {
+	String source = ReadBundledShader("Sandbox/res/pbr/shaders/pbr_lighting_p.hlsl");
+	ASSERT_GT(source.length, 0u);
+
+	HLSLReflection reflection;
+	ASSERT_TRUE(reflection.Parse(source));
+
+	//The Light cbuffer is commented out, only the struct is left
+	EXPECT_EQ(reflection.GetConstantBuffer("Light"), nullptr);
+	EXPECT_NE(reflection.GetStruct("Light"), nullptr);
+
+	const HLSLConstantBuffer* material = reflection.GetConstantBuffer("Material");
+	ASSERT_NE(material, nullptr);
+
+	EXPECT_EQ(material->semRegister, 10);
+	EXPECT_MEMBER(material->members, "m", 0u, 48u);
+	EXPECT_EQ(material->size, 48u);
+
+	const HLSLStruct* m = reflection.GetStruct("Material");
+	ASSERT_NE(m, nullptr);
+
+	EXPECT_MEMBER(m->members, "Albedo", 0u, 12u);
+	EXPECT_MEMBER(m->members, "AlbedoFactor", 12u, 4u);
+	EXPECT_MEMBER(m->members, "Metallic", 16u, 4u);
+	EXPECT_MEMBER(m->members, "AmbientOcclusionFactor", 36u, 4u);
+	EXPECT_MEMBER(m->members, "m_Pad0", 40u, 8u);
+
+	//The sampler has a state block and is skipped, the textures keep their registers
+	EXPECT_EQ(reflection.GetSamplers().GetSize(), 0u);
+
+	const List<HLSLResource*>& textures = reflection.GetTextures();
+	ASSERT_EQ(textures.GetSize(), 5u);
+	EXPECT_EQ(textures.Get(0)->type, FD_HLSL_RESOURCE_TYPE_TEXTURECUBE);
+	EXPECT_EQ(textures.Get(0)->semRegister, 1);
+	EXPECT_EQ(textures.Get(4)->semRegister, 5);
+}
+
+TEST(HLSLReflection, BundledDeferredDirectionalLight) {
+	String source = ReadBundledShader("Frodo/src/graphics/shader/shaders/deferred/dPixel.hlsl");
+	ASSERT_GT(source.length, 0u);
+
+	HLSLReflection reflection;
+	ASSERT_TRUE(reflection.Parse(source));
+
+	const HLSLConstantBuffer* light = reflection.GetConstantBuffer("Light");
+	ASSERT_NE(light, nullptr);
+
+	EXPECT_EQ(light->semRegister, 0);
+	EXPECT_MEMBER(light->members, "light", 0u, 32u);
+	EXPECT_EQ(light->size, 32u);
+}
+
+}
+}
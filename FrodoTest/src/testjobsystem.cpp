@@ -0,0 +1,130 @@
+#include "testcommon.h"
+#include <core/jobsystem.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_JOB_WORKERS 4
+#define FD_TEST_JOB_FANOUT 4
+#define FD_TEST_JOB_DEPTH 6
+#define FD_TEST_JOB_ROUNDS 20
+
+struct JobTree {
+	std::atomic<uint32>* hits;
+	uint_t depth;
+};
+
+//Every job below the leaves starts its children and waits for them, so the waits run other
+//workers' jobs while those workers steal from the waiting one
+static void RunTree(void* data, uint_t begin, uint_t end) {
+	JobTree* tree = (JobTree*)data;
+
+	if (tree->depth == FD_TEST_JOB_DEPTH) {
+		tree->hits[begin].fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	JobTree children[FD_TEST_JOB_FANOUT];
+	Job jobs[FD_TEST_JOB_FANOUT];
+	JobCounter counter;
+
+	uint_t step = (end - begin) / FD_TEST_JOB_FANOUT;
+
+	for (uint_t i = 0; i < FD_TEST_JOB_FANOUT; i++) {
+		children[i].hits = tree->hits;
+		children[i].depth = tree->depth + 1;
+
+		jobs[i].function = RunTree;
+		jobs[i].data = &children[i];
+		jobs[i].begin = begin + i * step;
+		jobs[i].end = jobs[i].begin + step;
+	}
+
+	JobSystem::Run(jobs, FD_TEST_JOB_FANOUT, &counter);
+	JobSystem::Wait(&counter);
+}
+
+static void AddRange(void* data, uint_t begin, uint_t end) {
+	((std::atomic<uint64>*)data)->fetch_add(end - begin, std::memory_order_relaxed);
+}
+
+static uint_t GetNumLeaves() {
+	uint_t leaves = 1;
+
+	for (uint_t i = 0; i < FD_TEST_JOB_DEPTH; i++) leaves *= FD_TEST_JOB_FANOUT;
+
+	return leaves;
+}
+
+//Nested fork and join, every leaf has to run exactly once
+TEST(JobSystem, NestedWaitRunsEveryJobOnce) {
+	JobSystem::Init(FD_TEST_JOB_WORKERS);
+
+	uint_t leaves = GetNumLeaves();
+	std::vector<std::atomic<uint32>> hits(leaves);
+
+	for (uint_t round = 0; round < FD_TEST_JOB_ROUNDS; round++) {
+		for (uint_t i = 0; i < leaves; i++) hits[i].store(0, std::memory_order_relaxed);
+
+		JobTree root = { hits.data(), 0 };
+		RunTree(&root, 0, leaves);
+
+		uint_t wrong = 0;
+
+		for (uint_t i = 0; i < leaves; i++) wrong += hits[i].load(std::memory_order_relaxed) != 1;
+
+		ASSERT_EQ(wrong, 0u) << "round " << round;
+	}
+
+	JobSystem::Dispose();
+}
+
+//Threads that aren't workers go through the shared queue while workers steal from each other
+TEST(JobSystem, ExternalThreadsAndDependencies) {
+	JobSystem::Init(FD_TEST_JOB_WORKERS);
+
+	uint_t leaves = GetNumLeaves();
+	std::vector<std::atomic<uint32>> hits(leaves);
+
+	for (uint_t i = 0; i < leaves; i++) hits[i].store(0, std::memory_order_relaxed);
+
+	std::atomic<uint64> sum(0);
+	std::vector<std::thread> threads;
+
+	for (uint_t t = 0; t < FD_TEST_JOB_FANOUT; t++) {
+		threads.emplace_back([&, t]() {
+			uint_t step = leaves / FD_TEST_JOB_FANOUT;
+
+			JobTree tree = { hits.data(), 1 };
+			Job job = { RunTree, &tree, t * step, (t + 1) * step, nullptr };
+
+			JobCounter first;
+			JobCounter second;
+
+			JobSystem::Run(job, &first);
+
+			//Held back until the whole subtree is done
+			Job after = { AddRange, &sum, 0, step, nullptr };
+
+			JobSystem::Run(after, &second, &first);
+			JobSystem::Wait(&second);
+		});
+	}
+
+	for (std::thread& thread : threads) thread.join();
+
+	uint_t wrong = 0;
+
+	for (uint_t i = 0; i < leaves; i++) wrong += hits[i].load(std::memory_order_relaxed) != 1;
+
+	EXPECT_EQ(wrong, 0u);
+	EXPECT_EQ(sum.load(), leaves);
+
+	JobSystem::Dispose();
+}
+
+}
+}
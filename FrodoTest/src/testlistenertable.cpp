@@ -0,0 +1,147 @@
+#include "testcommon.h"
+#include <util/listenertable.h>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_LISTENER_TYPES 4
+
+class TestListener {
+public:
+	uint32 eventMask;
+	uint32 calls;
+
+	TestListener(uint32 eventMask = ~0u) : eventMask(eventMask), calls(0) {}
+
+	inline uint32 GetEventMask() const { return eventMask; }
+};
+
+typedef ListenerTable<TestListener, FD_TEST_LISTENER_TYPES> TestTable;
+
+TEST(ListenerTable, OnlySubscribedListenersInOrder) {
+	TestTable table;
+	TestListener a(1 << 0), b(1 << 1), c((1 << 0) | (1 << 1));
+
+	table.Add(&a);
+	table.Add(&b);
+	table.Add(&c);
+
+	List<TestListener*> order;
+
+	table.Dispatch(0, [&](TestListener* listener) { order.Push_back(listener); return false; });
+
+	ASSERT_EQ(order.GetSize(), 2u);
+	EXPECT_EQ(order[0], &a);
+	EXPECT_EQ(order[1], &c);
+
+	//Returning true stops the dispatch
+	order.Clear();
+	table.Dispatch(1, [&](TestListener* listener) { order.Push_back(listener); return true; });
+
+	ASSERT_EQ(order.GetSize(), 1u);
+	EXPECT_EQ(order[0], &b);
+}
+
+//Listeners added by a handler, also in a nested dispatch, start with the next dispatch
+TEST(ListenerTable, AddDuringDispatch) {
+	TestTable table;
+	List<TestListener*> owned;
+
+	for (uint_t i = 0; i < 4; i++) {
+		owned.Push_back(new TestListener);
+		table.Add(owned[i]);
+	}
+
+	uint_t depth = 0;
+
+	auto handler = [&](TestListener* listener) {
+		listener->calls++;
+
+		//Enough listeners that the per type lists would have to grow if they were rebuilt
+		for (uint_t i = 0; i < 64; i++) {
+			TestListener* added = new TestListener;
+			owned.Push_back(added);
+			table.Add(added);
+		}
+
+		if (depth == 0) {
+			depth++;
+			table.Dispatch(0, [&](TestListener* inner) { inner->calls++; return false; });
+			depth--;
+		}
+
+		return false;
+	};
+
+	table.Dispatch(0, handler);
+
+	//Each of the first four ran once in the outer dispatch, and once in each of the four nested ones
+	for (uint_t i = 0; i < 4; i++) EXPECT_EQ(owned[i]->calls, 5u);
+	for (uint_t i = 4; i < owned.GetSize(); i++) EXPECT_EQ(owned[i]->calls, 0u);
+
+	uint_t calls = 0;
+	table.Dispatch(0, [&](TestListener*) { calls++; return false; });
+
+	EXPECT_EQ(calls, owned.GetSize());
+
+	for (uint_t i = 0; i < owned.GetSize(); i++) delete owned[i];
+}
+
+//A listener removed by an earlier one is skipped, the ones after it still get the event
+TEST(ListenerTable, RemoveDuringDispatch) {
+	TestTable table;
+	TestListener a, b, c;
+
+	table.Add(&a);
+	table.Add(&b);
+	table.Add(&c);
+
+	table.Dispatch(2, [&](TestListener* listener) {
+		listener->calls++;
+
+		if (listener == &a) {
+			table.Remove(&b);
+			table.Remove(&a);
+		}
+
+		return false;
+	});
+
+	EXPECT_EQ(a.calls, 1u);
+	EXPECT_EQ(b.calls, 0u);
+	EXPECT_EQ(c.calls, 1u);
+	EXPECT_EQ(table.GetSize(), 1u);
+
+	table.Dispatch(2, [&](TestListener* listener) { listener->calls++; return false; });
+
+	EXPECT_EQ(a.calls, 1u);
+	EXPECT_EQ(c.calls, 2u);
+}
+
+//A mask changed during dispatch applies from the next dispatch
+TEST(ListenerTable, MaskChangeDuringDispatch) {
+	TestTable table;
+	TestListener a(1 << 3), b(1 << 3);
+
+	table.Add(&a);
+	table.Add(&b);
+
+	table.Dispatch(3, [&](TestListener* listener) {
+		listener->calls++;
+
+		a.eventMask = 0;
+		table.MarkDirty();
+
+		return false;
+	});
+
+	EXPECT_EQ(b.calls, 1u);
+
+	table.Dispatch(3, [&](TestListener* listener) { listener->calls++; return false; });
+
+	EXPECT_EQ(a.calls, 1u);
+	EXPECT_EQ(b.calls, 2u);
+}
+
+}
+}
@@ -0,0 +1,69 @@
+#include "testcommon.h"
+#include <core/log.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_LOG_THREADS 4
+#define FD_TEST_LOG_MESSAGES 20000
+
+class CountingLogSink : public LogSink {
+public:
+	std::atomic<uint_t> count;
+
+	CountingLogSink() : count(0) {}
+
+	void Write(byte, const char*, uint_t) override { count.fetch_add(1, std::memory_order_relaxed); }
+};
+
+//Producers keep logging while the writer thread is started and stopped, every message has
+//to reach the sink exactly once whichever path it took
+TEST(Log, InitDisposeWhileLogging) {
+	CountingLogSink sink;
+
+	Logger::RemoveSink(Logger::GetConsoleSink());
+	Logger::AddSink(&sink);
+
+	std::atomic<bool> start(false);
+	std::atomic<uint32> finished(0);
+	std::vector<std::thread> threads;
+
+	for (uint32 t = 0; t < FD_TEST_LOG_THREADS; t++) {
+		threads.emplace_back([&start, &finished, t]() {
+			while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+
+			for (uint32 i = 0; i < FD_TEST_LOG_MESSAGES; i++) FDLog(FD_LOG_LEVEL_INFO, "[Test] Thread %u message %u", t, i);
+
+			finished.fetch_add(1, std::memory_order_release);
+		});
+	}
+
+	start.store(true, std::memory_order_release);
+
+	uint32 cycles = 0;
+
+	while (finished.load(std::memory_order_acquire) < FD_TEST_LOG_THREADS) {
+		Logger::Init();
+		std::this_thread::yield();
+		Logger::Dispose();
+
+		cycles++;
+	}
+
+	for (std::thread& thread : threads) thread.join();
+
+	Logger::Flush();
+
+	Logger::RemoveSink(&sink);
+	Logger::AddSink(Logger::GetConsoleSink());
+
+	EXPECT_EQ(sink.count.load(), (uint_t)FD_TEST_LOG_THREADS * FD_TEST_LOG_MESSAGES);
+	EXPECT_FALSE(Logger::IsAsync());
+	EXPECT_GT(cycles, 0u);
+}
+
+}
+}
@@ -0,0 +1,100 @@
+#include "testcommon.h"
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_MAT4_ITERATIONS 10000
+
+//Random entries with a dominant diagonal, far enough from singular for a float inverse
+static mat4 MakeGeneral(Random& random) {
+	float32 m[16];
+
+	for (uint_t i = 0; i < 16; i++) m[i] = random.Float(-1, 1);
+	for (uint_t i = 0; i < 4; i++) m[i * 5] += random.Next() & 1 ? 4.0f : -4.0f;
+
+	return MakeMat4(m);
+}
+
+static mat4 MakeRigid(Random& random) {
+	return mat4::Translate(random.Vec3(-100, 100)) * mat4::Rotate(random.Vec3(-180, 180));
+}
+
+static mat4 MakeAffine(Random& random) {
+	return MakeRigid(random) * mat4::Scale(random.Vec3(0.25f, 4.0f));
+}
+
+TEST(Mat4, InverseGeneral) {
+	Random random;
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_MAT4_ITERATIONS; i++) {
+		mat4 m = MakeGeneral(random);
+		float32 diff = MaxDifference(m * mat4::Inverse(m), mat4::Identity());
+
+		if (diff > worst) worst = diff;
+	}
+
+	EXPECT_LT(worst, 1e-4f);
+}
+
+TEST(Mat4, InverseGeneralOfProjection) {
+	mat4 m = mat4::Perspective(1.2f, 16.0f / 9.0f, 0.1f, 1000.0f) * mat4::Translate(vec3(1, 2, 3));
+
+	EXPECT_LT(MaxDifference(m * mat4::Inverse(m), mat4::Identity()), 1e-4f);
+}
+
+TEST(Mat4, InverseAffine) {
+	Random random(0x9E3779B9);
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_MAT4_ITERATIONS; i++) {
+		mat4 m = MakeAffine(random);
+		mat4 inverse = mat4::InverseAffine(m);
+
+		float32 diff = MaxDifference(m * inverse, mat4::Identity());
+		if (diff > worst) worst = diff;
+
+		//Same result as the general inverse
+		diff = MaxDifference(inverse, mat4::Inverse(m));
+		if (diff > worst) worst = diff;
+	}
+
+	EXPECT_LT(worst, 1e-4f);
+}
+
+TEST(Mat4, InverseRigid) {
+	Random random(0xDEADBEEF);
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_MAT4_ITERATIONS; i++) {
+		mat4 m = MakeRigid(random);
+		mat4 inverse = mat4::InverseRigid(m);
+
+		float32 diff = MaxDifference(m * inverse, mat4::Identity());
+		if (diff > worst) worst = diff;
+
+		diff = MaxDifference(inverse, mat4::InverseAffine(m));
+		if (diff > worst) worst = diff;
+	}
+
+	EXPECT_LT(worst, 1e-4f);
+}
+
+//Singular input logs a warning and gives identity
+TEST(Mat4, InverseSingular) {
+	float32 rankThree[16] = {
+		1, 2, 3, 0,
+		2, 4, 6, 0,
+		0, 0, 1, 0,
+		5, 6, 7, 1
+	};
+
+	EXPECT_EQ(MaxDifference(mat4::Inverse(mat4(0)), mat4::Identity()), 0.0f);
+	EXPECT_EQ(MaxDifference(mat4::Inverse(MakeMat4(rankThree)), mat4::Identity()), 0.0f);
+
+	EXPECT_EQ(MaxDifference(mat4::InverseAffine(mat4::Scale(vec3(1, 0, 1))), mat4::Identity()), 0.0f);
+	EXPECT_EQ(MaxDifference(mat4::InverseAffine(MakeMat4(rankThree)), mat4::Identity()), 0.0f);
+}
+
+}
+}
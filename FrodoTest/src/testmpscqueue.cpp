@@ -0,0 +1,114 @@
+#include "testcommon.h"
+#include <util/mpscqueue.h>
+#include <thread>
+#include <vector>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_MPSC_PRODUCERS 4
+#define FD_TEST_MPSC_ITEMS 20000
+
+struct QueueItem : public MPSCNode {
+	uint32 producer;
+	uint32 sequence;
+};
+
+TEST(MPSCQueue, SingleThreadOrder) {
+	MPSCQueue<QueueItem> queue;
+	QueueItem items[3];
+
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_EQ(queue.Pop(), nullptr);
+
+	for (uint32 i = 0; i < 3; i++) {
+		items[i].sequence = i;
+		queue.Push(&items[i]);
+	}
+
+	EXPECT_FALSE(queue.IsEmpty());
+
+	for (uint32 i = 0; i < 3; i++) EXPECT_EQ(queue.Pop(), &items[i]);
+
+	EXPECT_EQ(queue.Pop(), nullptr);
+	EXPECT_TRUE(queue.IsEmpty());
+
+	//The stub goes back in after the last node, the queue keeps working
+	queue.Push(&items[1]);
+
+	EXPECT_EQ(queue.Pop(), &items[1]);
+	EXPECT_EQ(queue.Pop(), nullptr);
+}
+
+//Every item arrives exactly once and each producer's items come out in the order it pushed them
+TEST(MPSCQueue, MultipleProducers) {
+	MPSCQueue<QueueItem> queue;
+	std::vector<QueueItem> items(FD_TEST_MPSC_PRODUCERS * FD_TEST_MPSC_ITEMS);
+	std::vector<std::thread> producers;
+
+	for (uint32 p = 0; p < FD_TEST_MPSC_PRODUCERS; p++) {
+		producers.emplace_back([&queue, &items, p]() {
+			for (uint32 i = 0; i < FD_TEST_MPSC_ITEMS; i++) {
+				QueueItem& item = items[p * FD_TEST_MPSC_ITEMS + i];
+
+				item.producer = p;
+				item.sequence = i;
+
+				queue.Push(&item);
+
+				if ((i & 255) == 0) std::this_thread::yield();
+			}
+		});
+	}
+
+	std::vector<uint32> received(items.size(), 0);
+	uint32 next[FD_TEST_MPSC_PRODUCERS] = {};
+	uint32 outOfOrder = 0;
+	uint32 invalid = 0;
+	size_t count = 0;
+
+	//Pop can come back empty while a producer is mid push, keep going until everything is in
+	while (count < items.size()) {
+		QueueItem* item = queue.Pop();
+
+		if (!item) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		size_t index = item - items.data();
+
+		if (index >= items.size() || item->producer >= FD_TEST_MPSC_PRODUCERS) {
+			invalid++;
+			count++;
+			continue;
+		}
+
+		received[index]++;
+
+		if (item->sequence != next[item->producer]) outOfOrder++;
+
+		next[item->producer] = item->sequence + 1;
+		count++;
+	}
+
+	for (std::thread& thread : producers) thread.join();
+
+	EXPECT_EQ(invalid, 0u);
+	EXPECT_EQ(outOfOrder, 0u);
+	EXPECT_EQ(queue.Pop(), nullptr);
+	EXPECT_TRUE(queue.IsEmpty());
+
+	for (uint32 p = 0; p < FD_TEST_MPSC_PRODUCERS; p++) EXPECT_EQ(next[p], (uint32)FD_TEST_MPSC_ITEMS);
+
+	uint32 wrongCount = 0;
+
+	for (uint32 hits : received) {
+		if (hits != 1) wrongCount++;
+	}
+
+	EXPECT_EQ(wrongCount, 0u);
+}
+
+}
+}
@@ -0,0 +1,137 @@
+#include "testcommon.h"
+#include <util/objectpool.h>
+#include <thread>
+#include <vector>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_POOL_CHUNK 4
+#define FD_TEST_POOL_THREADS 4
+#define FD_TEST_POOL_LIVE 64
+#define FD_TEST_POOL_ROUNDS 200
+
+struct Tracked {
+	static uint32 constructed;
+	static uint32 destructed;
+
+	uint32 value;
+
+	Tracked(uint32 value) : value(value) { constructed++; }
+	~Tracked() { destructed++; }
+};
+
+uint32 Tracked::constructed = 0;
+uint32 Tracked::destructed = 0;
+
+//The free list is LIFO, a released slot is the next one handed out
+TEST(ObjectPool, ReuseAfterFree) {
+	ObjectPool<uint64> pool(FD_TEST_POOL_CHUNK);
+
+	uint64* a = pool.New(1ull);
+	uint64* b = pool.New(2ull);
+
+	pool.Delete(a);
+
+	uint64* c = pool.New(3ull);
+
+	EXPECT_EQ(c, a);
+	EXPECT_EQ(*b, 2ull);
+	EXPECT_EQ(*c, 3ull);
+	EXPECT_EQ(pool.GetCapacity(), (uint32)FD_TEST_POOL_CHUNK);
+
+	pool.Delete(b);
+	pool.Delete(c);
+}
+
+//Taking more than a chunk adds chunks, objects in earlier chunks stay where they are
+TEST(ObjectPool, GrowsPastFirstChunk) {
+	ObjectPool<uint64> pool(3);
+
+	//Rounded up to a power of 2
+	EXPECT_EQ(pool.GetChunkSize(), (uint32)FD_TEST_POOL_CHUNK);
+	EXPECT_EQ(pool.GetCapacity(), 0u);
+
+	std::vector<uint64*> objects;
+
+	for (uint64 i = 0; i < FD_TEST_POOL_CHUNK * 2 + 1; i++) objects.push_back(pool.New(i));
+
+	EXPECT_EQ(pool.GetCapacity(), (uint32)FD_TEST_POOL_CHUNK * 3);
+
+	for (size_t i = 0; i < objects.size(); i++) {
+		ASSERT_NE(objects[i], nullptr);
+		EXPECT_EQ(*objects[i], (uint64)i);
+
+		for (size_t j = 0; j < i; j++) EXPECT_NE(objects[i], objects[j]);
+	}
+
+	for (uint64* object : objects) pool.Delete(object);
+
+	//Everything is free again, no new chunk is needed
+	for (uint64 i = 0; i < FD_TEST_POOL_CHUNK * 3; i++) pool.Acquire();
+
+	EXPECT_EQ(pool.GetCapacity(), (uint32)FD_TEST_POOL_CHUNK * 3);
+}
+
+//New/Delete construct and destruct, Acquire/Release and the pool destructor don't
+TEST(ObjectPool, DestructorsRun) {
+	Tracked::constructed = 0;
+	Tracked::destructed = 0;
+
+	{
+		ObjectPool<Tracked> pool(FD_TEST_POOL_CHUNK);
+		Tracked* objects[6];
+
+		for (uint32 i = 0; i < 6; i++) objects[i] = pool.New(i);
+
+		EXPECT_EQ(Tracked::constructed, 6u);
+		EXPECT_EQ(objects[5]->value, 5u);
+
+		for (uint32 i = 0; i < 4; i++) pool.Delete(objects[i]);
+
+		EXPECT_EQ(Tracked::destructed, 4u);
+
+		objects[4]->~Tracked();
+		pool.Release(objects[4]);
+
+		EXPECT_EQ(Tracked::destructed, 5u);
+
+		pool.Delete(nullptr);
+	}
+
+	//objects[5] was still alive when the pool went away
+	EXPECT_EQ(Tracked::destructed, 5u);
+}
+
+//Threads taking and returning objects never get a slot another thread holds
+TEST(ObjectPool, ConcurrentAcquireRelease) {
+	ObjectPool<uint64> pool(FD_TEST_POOL_CHUNK);
+	std::vector<std::thread> threads;
+	std::atomic<uint32> errors(0);
+
+	for (uint64 t = 0; t < FD_TEST_POOL_THREADS; t++) {
+		threads.emplace_back([&pool, &errors, t]() {
+			uint64* objects[FD_TEST_POOL_LIVE];
+
+			for (uint32 round = 0; round < FD_TEST_POOL_ROUNDS; round++) {
+				for (uint64 i = 0; i < FD_TEST_POOL_LIVE; i++) objects[i] = pool.New(t << 32 | i);
+
+				std::this_thread::yield();
+
+				for (uint64 i = 0; i < FD_TEST_POOL_LIVE; i++) {
+					if (*objects[i] != (t << 32 | i)) errors.fetch_add(1, std::memory_order_relaxed);
+
+					pool.Delete(objects[i]);
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) thread.join();
+
+	EXPECT_EQ(errors.load(), 0u);
+	EXPECT_LE(pool.GetCapacity(), (uint32)(FD_TEST_POOL_THREADS * FD_TEST_POOL_LIVE));
+}
+
+}
+}
@@ -0,0 +1,125 @@
+#include "testcommon.h"
+#include <core/profiler.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace FD {
+namespace Test {
+
+//Reads the binary capture field by field in the order profiler.cpp documents it
+class CaptureReader {
+private:
+	FILE* file;
+
+public:
+	CaptureReader(const String& filename) : file(fopen(*filename, "rb")) {}
+	~CaptureReader() { if (file) fclose(file); }
+
+	inline bool IsOpen() const { return file != nullptr; }
+
+	template<typename T>
+	T Read() {
+		T value;
+		memset(&value, 0, sizeof(T));
+		EXPECT_EQ(fread(&value, sizeof(T), 1, file), 1u);
+		return value;
+	}
+
+	std::string ReadString(uint32 length) {
+		std::string str(length, '\0');
+		EXPECT_EQ(fread(&str[0], 1, length, file), length);
+		return str;
+	}
+
+	inline bool AtEnd() { return fgetc(file) == EOF; }
+};
+
+static void RecordFrame() {
+	Profiler::BeginFrame();
+
+	{
+		FD_PROFILE_SCOPE("Outer");
+		FD_PROFILE_SCOPE("Inner");
+	}
+
+	Profiler::EndFrame();
+}
+
+TEST(Profiler, BinaryCaptureLayout) {
+	String filename = GetTempDirectory() + "frodotest_capture.fdpc";
+
+	Profiler::SetEnabled(true);
+	Profiler::SetThreadName("Test");
+
+	Profiler::BeginCapture();
+	RecordFrame();
+	RecordFrame();
+	Profiler::EndCapture();
+
+	ASSERT_TRUE(Profiler::WriteBinaryCapture(filename));
+
+	CaptureReader reader(filename);
+	ASSERT_TRUE(reader.IsOpen());
+
+	EXPECT_EQ(reader.ReadString(4), "FDPC");
+	EXPECT_EQ(reader.Read<uint32>(), 2u);
+	EXPECT_GT(reader.Read<float64>(), 0.0);
+
+	uint32 numThreads = reader.Read<uint32>();
+	uint32 numNames = reader.Read<uint32>();
+	uint64 numFrames = reader.Read<uint64>();
+	uint64 numZones = reader.Read<uint64>();
+
+	//Threads other tests started are registered as well
+	ASSERT_GE(numThreads, 1u);
+	ASSERT_EQ(numNames, 2u);
+	ASSERT_EQ(numFrames, 2u);
+	ASSERT_EQ(numZones, 4u);
+
+	uint32 testThread = ~0u;
+
+	for (uint32 i = 0; i < numThreads; i++) {
+		uint32 threadID = reader.Read<uint32>();
+		if (reader.ReadString(reader.Read<uint32>()) == "Test") testThread = threadID;
+	}
+
+	EXPECT_NE(testThread, ~0u);
+
+	std::string names[2];
+
+	for (uint32 i = 0; i < numNames; i++) names[i] = reader.ReadString(reader.Read<uint32>());
+
+	for (uint64 i = 0; i < numFrames; i++) {
+		uint64 frame = reader.Read<uint64>();
+		uint64 start = reader.Read<uint64>();
+		uint64 end = reader.Read<uint64>();
+		uint64 firstZone = reader.Read<uint64>();
+		uint64 zones = reader.Read<uint64>();
+
+		EXPECT_LE(start, end);
+		EXPECT_EQ(firstZone, i * 2);
+		EXPECT_EQ(zones, 2u);
+		(void)frame;
+	}
+
+	for (uint64 i = 0; i < numZones; i++) {
+		uint32 nameIndex = reader.Read<uint32>();
+		EXPECT_EQ(reader.Read<uint32>(), testThread);
+		uint32 depth = reader.Read<uint32>();
+		EXPECT_EQ(reader.Read<uint32>(), 0u);
+		uint64 start = reader.Read<uint64>();
+		uint64 end = reader.Read<uint64>();
+
+		ASSERT_LT(nameIndex, numNames);
+		//Zones are sorted by start time, the outer zone starts first
+		EXPECT_EQ(names[nameIndex], depth == 0 ? "Outer" : "Inner");
+		EXPECT_LE(start, end);
+	}
+
+	EXPECT_TRUE(reader.AtEnd());
+
+	remove(*filename);
+}
+
+}
+}
@@ -0,0 +1,207 @@
+#include "testcommon.h"
+#include <util/shadercache.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_CACHE_CODE_SIZE 16
+#define FD_TEST_CACHE_CHURN 2000
+#define FD_TEST_CACHE_KEPT 100
+
+//In memory size of an entry with a 4 character source and FD_TEST_CACHE_CODE_SIZE bytes of code
+#define FD_TEST_CACHE_ENTRY_SIZE (sizeof(ShaderCacheEntry) + 4 + FD_TEST_CACHE_CODE_SIZE)
+
+static void AddEntry(uint64 key) {
+	byte code[FD_TEST_CACHE_CODE_SIZE];
+
+	memset(code, (byte)key, sizeof(code));
+
+	ShaderCache::Add(key, "src0", code, sizeof(code));
+}
+
+//Finds key and checks the bytes AddEntry wrote for it
+static bool FindEntry(uint64 key) {
+	String source;
+	byte* code = nullptr;
+	uint_t size = 0;
+
+	if (!ShaderCache::Find(key, &source, &code, &size)) return false;
+
+	EXPECT_STREQ(*source, "src0");
+	EXPECT_EQ(size, (uint_t)FD_TEST_CACHE_CODE_SIZE);
+
+	for (uint_t i = 0; i < size; i++) EXPECT_EQ(code[i], (byte)key);
+
+	Memory::Free(code);
+
+	return true;
+}
+
+static String GetCacheFilename(const String& directory, uint64 key) {
+	char name[32];
+	sprintf(name, "/%016llx.fdshader", (unsigned long long)key);
+
+	return directory + name;
+}
+
+//Overwrites the 4 bytes at offset in an existing file
+static void PatchFile(const String& filename, long offset, uint32 value) {
+	FILE* file = fopen(*filename, "r+b");
+
+	ASSERT_NE(file, nullptr);
+
+	fseek(file, offset, SEEK_SET);
+	fwrite(&value, sizeof(value), 1, file);
+	fclose(file);
+}
+
+//A lookup makes an entry the most recently used, the least recently used one is dropped first
+TEST(ShaderCache, LRUEviction) {
+	ShaderCache::Init(FD_TEST_CACHE_ENTRY_SIZE * 3);
+
+	AddEntry(1);
+	AddEntry(2);
+	AddEntry(3);
+
+	EXPECT_EQ(ShaderCache::GetMemoryUsed(), (uint64)FD_TEST_CACHE_ENTRY_SIZE * 3);
+	EXPECT_TRUE(FindEntry(1));
+
+	AddEntry(4);
+
+	EXPECT_EQ(ShaderCache::GetMemoryUsed(), (uint64)FD_TEST_CACHE_ENTRY_SIZE * 3);
+	EXPECT_FALSE(FindEntry(2));
+	EXPECT_TRUE(FindEntry(3));
+	EXPECT_TRUE(FindEntry(1));
+	EXPECT_TRUE(FindEntry(4));
+
+	//1 was found after 3, so 3 is next
+	AddEntry(5);
+
+	EXPECT_FALSE(FindEntry(3));
+	EXPECT_TRUE(FindEntry(1));
+
+	//Adding a key that is already there changes nothing
+	AddEntry(1);
+
+	EXPECT_EQ(ShaderCache::GetMemoryUsed(), (uint64)FD_TEST_CACHE_ENTRY_SIZE * 3);
+
+	ShaderCache::Dispose();
+
+	EXPECT_EQ(ShaderCache::GetMemoryUsed(), 0ull);
+	EXPECT_FALSE(FindEntry(1));
+}
+
+//Many keys through a small cache, evictions must not lose the keys that are still in it.
+//Misses don't change the cache so the order of the lookups doesn't matter
+TEST(ShaderCache, ChurnKeepsRecentKeys) {
+	ShaderCache::Init(FD_TEST_CACHE_ENTRY_SIZE * FD_TEST_CACHE_KEPT);
+
+	Random random(43);
+	List<uint64> keys(FD_TEST_CACHE_CHURN, 1);
+
+	for (uint32 i = 0; i < FD_TEST_CACHE_CHURN; i++) {
+		//Only the low byte of sequential keys differs, spread them over the table
+		uint64 key = (uint64)random.Next() << 32 | i;
+
+		keys.Push_back(key);
+		AddEntry(key);
+	}
+
+	uint32 missing = 0;
+	uint32 stale = 0;
+
+	for (uint32 i = 0; i < FD_TEST_CACHE_CHURN; i++) {
+		bool found = FindEntry(keys[i]);
+
+		if (i >= FD_TEST_CACHE_CHURN - FD_TEST_CACHE_KEPT && !found) missing++;
+		if (i < FD_TEST_CACHE_CHURN - FD_TEST_CACHE_KEPT && found) stale++;
+	}
+
+	EXPECT_EQ(missing, 0u);
+	EXPECT_EQ(stale, 0u);
+
+	ShaderCache::Dispose();
+}
+
+//Added entries are written to <directory>/<key>.fdshader and read back after the memory is cleared
+TEST(ShaderCache, FileRoundTrip) {
+	String directory = GetTempDirectory() + "frodotest_shadercache";
+	uint64 key = ShaderCache::MakeKey(1, 2, "ps_5_0");
+
+	ShaderCache::Init(FD_SHADER_CACHE_SIZE, directory);
+
+	String filename = GetCacheFilename(directory, key);
+
+	remove(*filename);
+	AddEntry(key);
+
+	FILE* file = fopen(*filename, "rb");
+
+	ASSERT_NE(file, nullptr);
+	fclose(file);
+
+	ShaderCache::Clear();
+
+	uint64 diskHits = ShaderCache::GetDiskHits();
+
+	EXPECT_TRUE(FindEntry(key));
+	EXPECT_EQ(ShaderCache::GetDiskHits(), diskHits + 1);
+
+	//Now it's in memory
+	uint64 hits = ShaderCache::GetHits();
+
+	EXPECT_TRUE(FindEntry(key));
+	EXPECT_EQ(ShaderCache::GetHits(), hits + 1);
+
+	ShaderCache::Dispose();
+
+	//Without a directory the file isn't looked at
+	EXPECT_FALSE(FindEntry(key));
+
+	remove(*filename);
+}
+
+//A file with the wrong magic or version is ignored and counts as a miss
+TEST(ShaderCache, RejectsBadHeader) {
+	String directory = GetTempDirectory() + "frodotest_shadercache";
+	uint64 key = ShaderCache::MakeKey(3, 4, "vs_5_0");
+
+	ShaderCache::Init(FD_SHADER_CACHE_SIZE, directory);
+
+	String filename = GetCacheFilename(directory, key);
+
+	AddEntry(key);
+	ShaderCache::Clear();
+	PatchFile(filename, 0, 0x12345678);
+
+	uint64 misses = ShaderCache::GetMisses();
+
+	EXPECT_FALSE(FindEntry(key));
+	EXPECT_EQ(ShaderCache::GetMisses(), misses + 1);
+
+	//Rewritten with the right magic but from another version
+	remove(*filename);
+	AddEntry(key);
+	ShaderCache::Clear();
+	PatchFile(filename, 4, FD_SHADER_CACHE_VERSION + 1);
+
+	EXPECT_FALSE(FindEntry(key));
+
+	//And the file of another key
+	uint64 other = ShaderCache::MakeKey(5, 6, "vs_5_0");
+	String otherFilename = GetCacheFilename(directory, other);
+
+	remove(*otherFilename);
+	rename(*filename, *otherFilename);
+
+	EXPECT_FALSE(FindEntry(other));
+
+	ShaderCache::Dispose();
+
+	remove(*otherFilename);
+}
+
+}
+}
@@ -0,0 +1,257 @@
+#include "testcommon.h"
+#include <util/shadergen.h>
+#include <util/fileutils.h>
+#include <stdio.h>
+
+namespace FD {
+namespace Test {
+
+//The engine #includes the bundled shaders as a raw string, which leaves only \n line endings
+static String ReadBundledShader(const char* path) {
+	String file = FDReadTextFile(String(FD_TEST_SOURCE_DIR "/") + path);
+	String source;
+
+	uint_t start = file.StartsWith("R\"(") ? 3 : 0;
+	uint_t end = file.Find(")\"");
+
+	if (end == (uint_t)-1) end = file.length;
+
+	for (uint_t i = start; i < end; i++) {
+		if (file.str[i] != '\r') source << file.str[i];
+	}
+
+	return source;
+}
+
+static const char* spriteHeader =
+	"\n"
+	"\n"
+	"SamplerState samp {\n"
+	"\tAddressU = Wrap;\n"
+	"\tAddressV = Wrap;\n"
+	"\tFilter = MIN_MAG_MIP_NEAREST;\n"
+	"};\n"
+	"\n"
+	"\n"
+	"\n";
+
+static const char* spriteMain =
+	"\n"
+	"\n"
+	"float4 psMain(float4 position : SV_POSITION, float2 texCoords : TEXCOORDS, float4 color : COLOR, float tid : TID) : SV_TARGET0 {\n"
+	"\tfloat4 texColor = float4(1, 1, 1, 1);\t\n"
+	"\n"
+	"\tswitch(tid) {\n"
+	"\tcase 0:\n"
+	"\t\tbreak;\n"
+	"\n"
+	"\n";
+
+static const char* spriteFooter =
+	"\n"
+	"\t}\n"
+	"\n"
+	"\treturn color * texColor;\n"
+	"}\n"
+	"\n";
+
+//Built line by line for any number of textures, checked against the literal goldens below
+static String MakeSpriteGolden(uint32 maxTextures) {
+	String golden(spriteHeader);
+	char line[128];
+
+	for (uint32 i = 1; i <= maxTextures; i++) {
+		sprintf(line, "\nTexture2D tex%u : register(t%u);\n", i, i - 1);
+		golden << line;
+	}
+
+	golden << spriteMain;
+
+	for (uint32 i = 1; i <= maxTextures; i++) {
+		sprintf(line, "\n\tcase %u.000000:\n\t\ttexColor = tex%u.Sample(samp, texCoords);\n\t\tbreak;\n", i, i);
+		golden << line;
+	}
+
+	golden << spriteFooter;
+
+	return golden;
+}
+
+//Case values come out with %f decimals the way the string rewriting wrote them
+TEST(ShaderGen, SpriteOneTexture) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(ReadBundledShader("Frodo/src/graphics/shader/shaders/sprite_default_p.hlsl")));
+
+	gen.SetVariable("maxTextures", 1);
+
+	String golden(spriteHeader);
+
+	golden << "\nTexture2D tex1 : register(t0);\n";
+	golden << spriteMain;
+	golden << "\n\tcase 1.000000:\n\t\ttexColor = tex1.Sample(samp, texCoords);\n\t\tbreak;\n";
+	golden << spriteFooter;
+
+	EXPECT_STREQ(*gen.Generate(), *golden);
+	EXPECT_STREQ(*MakeSpriteGolden(1), *golden);
+}
+
+TEST(ShaderGen, SpriteThreeTextures) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(ReadBundledShader("Frodo/src/graphics/shader/shaders/sprite_default_p.hlsl")));
+
+	gen.SetVariable("maxTextures", 3);
+
+	String golden(spriteHeader);
+
+	golden << "\nTexture2D tex1 : register(t0);\n";
+	golden << "\nTexture2D tex2 : register(t1);\n";
+	golden << "\nTexture2D tex3 : register(t2);\n";
+	golden << spriteMain;
+	golden << "\n\tcase 1.000000:\n\t\ttexColor = tex1.Sample(samp, texCoords);\n\t\tbreak;\n";
+	golden << "\n\tcase 2.000000:\n\t\ttexColor = tex2.Sample(samp, texCoords);\n\t\tbreak;\n";
+	golden << "\n\tcase 3.000000:\n\t\ttexColor = tex3.Sample(samp, texCoords);\n\t\tbreak;\n";
+	golden << spriteFooter;
+
+	EXPECT_STREQ(*gen.Generate(), *golden);
+	EXPECT_STREQ(*MakeSpriteGolden(3), *golden);
+}
+
+TEST(ShaderGen, SpriteMaxTextures) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(ReadBundledShader("Frodo/src/graphics/shader/shaders/sprite_default_p.hlsl")));
+
+	gen.SetVariable("maxTextures", 32);
+
+	const String& output = gen.Generate();
+
+	EXPECT_STREQ(*output, *MakeSpriteGolden(32));
+	//tex1 must not be matched inside tex10 and up
+	EXPECT_NE(output.Find("Texture2D tex32 : register(t31);"), (uint_t)-1);
+	EXPECT_NE(output.Find("texColor = tex12.Sample"), (uint_t)-1);
+}
+
+TEST(ShaderGen, NestedIf) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(
+		"#shaderGen define_r a\n"
+		"#shaderGen define_r b\n"
+		"#shaderGen if gr(a, 0)\n"
+		"A\n"
+		"#shaderGen if eq(b, a)\n"
+		"AB\n"
+		"#shaderGen elif defined(c)\n"
+		"AC\n"
+		"#shaderGen else\n"
+		"A_\n"
+		"#shaderGen endif\n"
+		"#shaderGen else\n"
+		"_\n"
+		"#shaderGen endif\n"));
+
+	String output;
+
+	gen.SetVariable("a", 1);
+	gen.SetVariable("b", 1);
+	gen.Generate(output);
+
+	EXPECT_STREQ(*output, "\n\n\nA\n\nAB\n\n\n");
+
+	gen.SetVariable("b", 2);
+	gen.Generate(output);
+
+	EXPECT_STREQ(*output, "\n\n\nA\n\nA_\n\n\n");
+
+	gen.SetVariable("c", 0);
+	gen.Generate(output);
+
+	EXPECT_STREQ(*output, "\n\n\nA\n\nAC\n\n\n");
+
+	gen.SetVariable("a", 0);
+	gen.Generate(output);
+
+	EXPECT_STREQ(*output, "\n\n\n_\n\n");
+}
+
+//Inside the loop the loop variable hides the global with the same name, after it the global is back
+TEST(ShaderGen, LoopVariableShadowsGlobal) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(
+		"#shaderGen define i 7\n"
+		"#shaderGen define_b value\n"
+		"=i;\n"
+		"#shaderGen endblock\n"
+		"#shaderGen generate for(i, 1, le, 2, 1) value\n"
+		"#shaderGen generate single value\n"));
+
+	EXPECT_STREQ(*gen.Generate(), "\n\n\n=1.000000;\n\n=2.000000;\n\n\n=7.000000;\n\n");
+	EXPECT_FLOAT_EQ(gen.GetVariable("i")->data, 7.0f);
+}
+
+//The longest name wins, var2 isn't var followed by a 2
+TEST(ShaderGen, OverlappingNames) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(
+		"#shaderGen define var 1\n"
+		"#shaderGen define var2 5\n"
+		"#shaderGen define_b names\n"
+		"a=var b=var2 c=var3 d(var2)\n"
+		"#shaderGen endblock\n"
+		"#shaderGen generate single names\n"));
+
+	EXPECT_STREQ(*gen.Generate(), "\n\n\n\na=1.000000 b=5.000000 c=1.0000003 d(5)\n\n");
+}
+
+//Different variable sets get their own output, the same set in any order is a cache hit
+TEST(ShaderGen, VariableSetsDontShareOutput) {
+	ShaderGen gen;
+
+	ASSERT_TRUE(gen.Parse(
+		"#shaderGen define_b values\n"
+		"=a =b\n"
+		"#shaderGen endblock\n"
+		"#shaderGen generate single values\n"));
+
+	gen.SetVariable("a", 1);
+	gen.SetVariable("b", 2);
+
+	uint64 firstHash = gen.GetVariableHash();
+	const String* first = &gen.Generate();
+
+	EXPECT_STREQ(**first, "\n\n=1.000000 =2.000000\n\n");
+
+	//Same values swapped between the names
+	gen.SetVariable("a", 2);
+	gen.SetVariable("b", 1);
+
+	EXPECT_NE(gen.GetVariableHash(), firstHash);
+
+	const String* second = &gen.Generate();
+
+	EXPECT_NE(second, first);
+	EXPECT_STREQ(**second, "\n\n=2.000000 =1.000000\n\n");
+
+	//Back to the first set, defined in the other order
+	ShaderGen reordered;
+
+	ASSERT_TRUE(reordered.Parse(gen.GetSource()));
+
+	reordered.SetVariable("b", 2);
+	reordered.SetVariable("a", 1);
+
+	EXPECT_EQ(reordered.GetVariableHash(), firstHash);
+
+	gen.SetVariable("a", 1);
+	gen.SetVariable("b", 2);
+
+	EXPECT_EQ(&gen.Generate(), first);
+	EXPECT_STREQ(**first, "\n\n=1.000000 =2.000000\n\n");
+}
+
+}
+}
@@ -0,0 +1,100 @@
+#include "testcommon.h"
+#include <util/statebuffer.h>
+#include <atomic>
+#include <thread>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_STATE_PUBLISHES 100000
+#define FD_TEST_STATE_VALUES 16
+
+struct TestState {
+	uint64 values[FD_TEST_STATE_VALUES];
+};
+
+TEST(StateBuffer, AcquireLatest) {
+	StateBuffer<TestState> buffer;
+
+	EXPECT_FALSE(buffer.Acquire());
+
+	buffer.GetWriteState().values[0] = 1;
+	buffer.Publish(1.0);
+	buffer.GetWriteState().values[0] = 2;
+	buffer.Publish(2.0);
+
+	//The first state was never picked up and is skipped
+	EXPECT_TRUE(buffer.Acquire());
+	EXPECT_FALSE(buffer.Acquire());
+	EXPECT_EQ(buffer.GetCurrent().values[0], 2ull);
+	EXPECT_DOUBLE_EQ(buffer.GetCurrentTime(), 2.0);
+
+	buffer.GetWriteState().values[0] = 3;
+	buffer.Publish(3.0);
+
+	EXPECT_TRUE(buffer.Acquire());
+	EXPECT_EQ(buffer.GetCurrent().values[0], 3ull);
+	EXPECT_EQ(buffer.GetPrevious().values[0], 2ull);
+	EXPECT_FLOAT_EQ(buffer.GetAlpha(3.5), 0.5f);
+	EXPECT_FLOAT_EQ(buffer.GetAlpha(5.0), 1.0f);
+	EXPECT_FLOAT_EQ(buffer.GetAlpha(2.0), 0.0f);
+}
+
+//The reader never holds the state the writer is filling and published times only go up
+TEST(StateBuffer, PublishAcquireStress) {
+	StateBuffer<TestState> buffer;
+	//State the writer is filling, nullptr while it publishes
+	std::atomic<const TestState*> writing(nullptr);
+
+	std::thread writer([&buffer, &writing]() {
+		for (uint64 i = 1; i <= FD_TEST_STATE_PUBLISHES; i++) {
+			TestState& state = buffer.GetWriteState();
+
+			writing.store(&state);
+
+			for (uint32 j = 0; j < FD_TEST_STATE_VALUES; j++) state.values[j] = i;
+
+			writing.store(nullptr);
+			buffer.Publish((float64)i);
+
+			if ((i & 63) == 0) std::this_thread::yield();
+		}
+	});
+
+	uint32 owned = 0;
+	uint32 torn = 0;
+	uint32 backwards = 0;
+	float64 last = 0.0;
+
+	while (last < FD_TEST_STATE_PUBLISHES) {
+		if (!buffer.Acquire()) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		const TestState& current = buffer.GetCurrent();
+		const TestState* filling = writing.load();
+
+		if (filling == &current || filling == &buffer.GetPrevious()) owned++;
+
+		float64 time = buffer.GetCurrentTime();
+
+		if (time <= last || buffer.GetPreviousTime() > last) backwards++;
+
+		for (uint32 j = 0; j < FD_TEST_STATE_VALUES; j++) {
+			if (current.values[j] != (uint64)time) torn++;
+		}
+
+		last = time;
+	}
+
+	writer.join();
+
+	EXPECT_EQ(owned, 0u);
+	EXPECT_EQ(torn, 0u);
+	EXPECT_EQ(backwards, 0u);
+	EXPECT_FALSE(buffer.Acquire());
+}
+
+}
+}
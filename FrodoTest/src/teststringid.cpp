@@ -0,0 +1,82 @@
+#include "testcommon.h"
+#include <util/stringid.h>
+#include <core/log.h>
+
+namespace FD {
+namespace Test {
+
+//Two names with the same 64 bit FNV-1a hash, found with a cycle search over 11 character names
+#define FD_TEST_SID_COLLISION_A "e1A.mzM5vBD"
+#define FD_TEST_SID_COLLISION_B "1qukgvkhZPB"
+
+static_assert(FD_SID("c_Position").GetHash() == StringID::Hash("c_Position", 10), "FD_SID isn't the runtime hash");
+
+TEST(StringID, CompileTimeMatchesRuntime) {
+	//FNV-1a reference values
+	EXPECT_EQ(FD_SID("").GetHash(), 0xcbf29ce484222325ull);
+	EXPECT_EQ(FD_SID("a").GetHash(), 0xaf63dc4c8601ec8cull);
+	EXPECT_EQ(FD_SID("foobar").GetHash(), 0x85944171f73967e8ull);
+
+	EXPECT_EQ(FD_SID("c_Position"), StringID(String("c_Position")));
+	EXPECT_EQ(FD_SID("c_ViewMatrix"), StringID(String("c_ViewMatrix")));
+	EXPECT_NE(FD_SID("c_ViewMatrix"), StringID(String("c_viewMatrix")));
+
+	//Only length bytes are hashed
+	String name("c_Position_unused");
+
+	EXPECT_EQ(StringID::Hash(name.str, 10), FD_SID("c_Position").GetHash());
+}
+
+TEST(StringID, InternRoundTrip) {
+	MemoryLogSink sink;
+
+	Logger::AddSink(&sink);
+
+	StringID id = StringID::Intern("frodotest_interned");
+
+	EXPECT_EQ(id, FD_SID("frodotest_interned"));
+	EXPECT_STREQ(*StringID::GetString(id), "frodotest_interned");
+
+	//Interning the same name again is quiet
+	EXPECT_EQ(StringID::Intern("frodotest_interned"), id);
+
+	//Names that were only hashed come back as the hash
+	EXPECT_STREQ(*StringID::GetString(StringID(0x1234ull)), "0x0000000000001234");
+	EXPECT_STREQ(*StringID::GetString(FD_SID("frodotest_never_interned")), *StringID::GetString(StringID(StringID::Hash("frodotest_never_interned"))));
+	EXPECT_TRUE(StringID::GetString(FD_SID("frodotest_never_interned")).StartsWith("0x"));
+
+	Logger::RemoveSink(&sink);
+
+	EXPECT_EQ(sink.GetCount(), 0u);
+}
+
+//The second name with an ID that is already taken is reported, the first keeps the ID
+TEST(StringID, CollisionWarning) {
+	ASSERT_EQ(FD_SID(FD_TEST_SID_COLLISION_A), FD_SID(FD_TEST_SID_COLLISION_B));
+
+	MemoryLogSink sink;
+
+	Logger::RemoveSink(Logger::GetConsoleSink());
+	Logger::AddSink(&sink);
+
+	StringID a = StringID::Intern(FD_TEST_SID_COLLISION_A);
+	StringID b = StringID::Intern(FD_TEST_SID_COLLISION_B);
+
+	Logger::RemoveSink(&sink);
+	Logger::AddSink(Logger::GetConsoleSink());
+
+	EXPECT_EQ(a, b);
+	EXPECT_STREQ(*StringID::GetString(b), FD_TEST_SID_COLLISION_A);
+
+	ASSERT_EQ(sink.GetCount(), 1u);
+
+	byte level = 0;
+	String message = sink.GetEntry(0, &level);
+
+	EXPECT_EQ(level, FD_LOG_LEVEL_WARNING);
+	EXPECT_NE(message.Find(FD_TEST_SID_COLLISION_A), (uint_t)-1);
+	EXPECT_NE(message.Find(FD_TEST_SID_COLLISION_B), (uint_t)-1);
+}
+
+}
+}
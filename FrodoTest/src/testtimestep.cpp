@@ -0,0 +1,77 @@
+#include "testcommon.h"
+#include <core/timestep.h>
+
+namespace FD {
+namespace Test {
+
+#define FD_TEST_TIMESTEP_EPSILON 1e-9
+
+//The remainder of a frame carries over into the next one
+TEST(FixedTimestep, StepsAndAlpha) {
+	FixedTimestep timestep(0.01);
+
+	EXPECT_EQ(timestep.Advance(0.035), 3u);
+	EXPECT_NEAR(timestep.GetAlpha(), 0.5, 1e-6);
+	EXPECT_DOUBLE_EQ(timestep.GetDelta(), 0.01);
+
+	//0.005 left over + 0.006 is one more step
+	EXPECT_EQ(timestep.Advance(0.006), 1u);
+	EXPECT_NEAR(timestep.GetAlpha(), 0.1, 1e-6);
+
+	EXPECT_EQ(timestep.Advance(0.002), 0u);
+	EXPECT_NEAR(timestep.GetAlpha(), 0.3, 1e-6);
+	EXPECT_EQ(timestep.GetTotalSteps(), 4ull);
+
+	//Negative frame times count as 0
+	EXPECT_EQ(timestep.Advance(-1.0), 0u);
+	EXPECT_NEAR(timestep.GetAlpha(), 0.3, 1e-6);
+
+	timestep.Reset();
+
+	EXPECT_EQ(timestep.GetTotalSteps(), 0ull);
+	EXPECT_DOUBLE_EQ(timestep.GetAlpha(), 0.0);
+}
+
+//A hitch is cut to the max steps and the time beyond that is dropped
+TEST(FixedTimestep, ClampsToMaxSteps) {
+	FixedTimestep timestep(0.01);
+
+	EXPECT_EQ(timestep.Advance(1.0), (uint32)FD_TIMESTEP_MAX_STEPS);
+	EXPECT_NEAR(timestep.GetAlpha(), 0.0, FD_TEST_TIMESTEP_EPSILON);
+
+	//Nothing of the dropped time is left for the next frame
+	EXPECT_EQ(timestep.Advance(0.005), 0u);
+	EXPECT_NEAR(timestep.GetAlpha(), 0.5, 1e-6);
+
+	FixedTimestep limited(0.01, 2);
+
+	EXPECT_EQ(limited.Advance(0.0351), 2u);
+	EXPECT_NEAR(limited.GetAlpha(), 0.0, FD_TEST_TIMESTEP_EPSILON);
+	EXPECT_EQ(limited.GetTotalSteps(), 2ull);
+}
+
+//A step of 0 is one step of the frame time per Advance
+TEST(FixedTimestep, VariableTimestep) {
+	FixedTimestep timestep(0.0);
+
+	EXPECT_EQ(timestep.Advance(0.035), 1u);
+	EXPECT_DOUBLE_EQ(timestep.GetDelta(), 0.035);
+	EXPECT_DOUBLE_EQ(timestep.GetAlpha(), 1.0);
+
+	EXPECT_EQ(timestep.Advance(2.0), 1u);
+	EXPECT_DOUBLE_EQ(timestep.GetDelta(), 2.0);
+
+	EXPECT_EQ(timestep.Advance(-1.0), 1u);
+	EXPECT_DOUBLE_EQ(timestep.GetDelta(), 0.0);
+	EXPECT_EQ(timestep.GetTotalSteps(), 3ull);
+
+	//Switching to a fixed step starts over
+	timestep.SetStep(0.01);
+
+	EXPECT_EQ(timestep.GetTotalSteps(), 0ull);
+	EXPECT_EQ(timestep.Advance(0.035), 3u);
+	EXPECT_DOUBLE_EQ(timestep.GetDelta(), 0.01);
+}
+
+}
+}
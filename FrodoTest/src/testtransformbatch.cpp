@@ -0,0 +1,175 @@
+#include "testcommon.h"
+#include <math/transformbatch.h>
+#include <math.h>
+
+namespace FD {
+namespace Test {
+
+//Not a multiple of 8 so the scalar tail runs too
+#define FD_TEST_TRANSFORM_COUNT 1003
+#define FD_TEST_TRANSFORM_EPSILON 1e-4f
+
+//Matrices with translations up to 100 are compared relative to their largest element
+static float32 RelativeDifference(const mat4& a, const mat4& b) {
+	float32 scale = 1.0f;
+
+	for (uint_t i = 0; i < 16; i++) scale = fmaxf(scale, fabsf(a.GetData()[i]));
+
+	return MaxDifference(a, b) / scale;
+}
+
+static float32 MaxDifference(const vec3& a, const vec3& b) {
+	return fmaxf(fabsf(a.x - b.x), fmaxf(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+}
+
+struct TransformInput {
+	List<vec3> positions;
+	List<vec3> rotations;
+	List<vec3> scales;
+
+	TransformInput() {
+		Random random;
+
+		for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) {
+			positions.Push_back(random.Vec3(-100, 100));
+			rotations.Push_back(random.Vec3(-180, 180));
+			scales.Push_back(random.Vec3(0.5f, 2));
+		}
+	}
+};
+
+TEST(TransformBatch, ComposeTRSEulerMatchesScalar) {
+	TransformInput in;
+	List<mat4> out;
+	out.Resize(FD_TEST_TRANSFORM_COUNT);
+
+	TransformBatch::ComposeTRS(in.positions.GetData(), in.rotations.GetData(), in.scales.GetData(), out.GetData(), FD_TEST_TRANSFORM_COUNT);
+
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) {
+		mat4 expected = mat4::Translate(in.positions[i]) * mat4::Rotate(in.rotations[i]) * mat4::Scale(in.scales[i]);
+
+		worst = fmaxf(worst, RelativeDifference(expected, out[i]));
+		worst = fmaxf(worst, RelativeDifference(expected, TransformBatch::ComposeTRS(in.positions[i], in.rotations[i], in.scales[i])));
+	}
+
+	EXPECT_LT(worst, FD_TEST_TRANSFORM_EPSILON);
+}
+
+TEST(TransformBatch, TransformPointsMatchesScalar) {
+	TransformInput in;
+	mat4 m = mat4::Translate(vec3(1, 2, 3)) * mat4::Rotate(vec3(10, 20, 30)) * mat4::Scale(vec3(2, 1, 0.5f));
+
+	List<vec3> out;
+	out.Resize(FD_TEST_TRANSFORM_COUNT);
+
+	TransformBatch::TransformPoints(m, in.positions.GetData(), out.GetData(), FD_TEST_TRANSFORM_COUNT);
+
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) worst = fmaxf(worst, MaxDifference(m * in.positions[i], out[i]));
+
+	EXPECT_LT(worst, FD_TEST_TRANSFORM_EPSILON * 100.0f);
+}
+
+TEST(TransformBatch, TransformAABBsEnclosesCorners) {
+	TransformInput in;
+	mat4 m = mat4::Translate(vec3(1, 2, 3)) * mat4::Rotate(vec3(10, 20, 30));
+
+	List<vec3> min, max, outMin, outMax;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) {
+		min.Push_back(in.positions[i]);
+		max.Push_back(in.positions[i] + in.scales[i]);
+	}
+
+	outMin.Resize(FD_TEST_TRANSFORM_COUNT);
+	outMax.Resize(FD_TEST_TRANSFORM_COUNT);
+
+	TransformBatch::TransformAABBs(m, min.GetData(), max.GetData(), outMin.GetData(), outMax.GetData(), FD_TEST_TRANSFORM_COUNT);
+
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) {
+		vec3 expectedMin(1e30f, 1e30f, 1e30f);
+		vec3 expectedMax(-1e30f, -1e30f, -1e30f);
+
+		for (uint_t corner = 0; corner < 8; corner++) {
+			vec3 p = m * vec3(corner & 1 ? max[i].x : min[i].x, corner & 2 ? max[i].y : min[i].y, corner & 4 ? max[i].z : min[i].z);
+
+			expectedMin = vec3(fminf(expectedMin.x, p.x), fminf(expectedMin.y, p.y), fminf(expectedMin.z, p.z));
+			expectedMax = vec3(fmaxf(expectedMax.x, p.x), fmaxf(expectedMax.y, p.y), fmaxf(expectedMax.z, p.z));
+		}
+
+		worst = fmaxf(worst, fmaxf(MaxDifference(expectedMin, outMin[i]), MaxDifference(expectedMax, outMax[i])));
+	}
+
+	EXPECT_LT(worst, FD_TEST_TRANSFORM_EPSILON * 100.0f);
+}
+
+TEST(TransformBatch, MultiplyMatchesScalar) {
+	TransformInput in;
+	mat4 left = mat4::Perspective(70.0f, 16.0f / 9.0f, 0.1f, 1000.0f) * mat4::Translate(vec3(0, -2, -10));
+
+	List<mat4> right, out;
+	out.Resize(FD_TEST_TRANSFORM_COUNT);
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) right.Push_back(mat4::Translate(in.positions[i]) * mat4::Rotate(in.rotations[i]));
+
+	TransformBatch::Multiply(left, right.GetData(), out.GetData(), FD_TEST_TRANSFORM_COUNT);
+
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) worst = fmaxf(worst, RelativeDifference(left * right[i], out[i]));
+
+	EXPECT_LT(worst, FD_TEST_TRANSFORM_EPSILON);
+}
+
+TEST(TransformBatch, ComposeTRSQuatMatchesScalar) {
+	TransformInput in;
+	List<quat> orientations;
+	List<mat4> out;
+	out.Resize(FD_TEST_TRANSFORM_COUNT);
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) orientations.Push_back(quat::FromEuler(in.rotations[i]));
+
+	TransformBatch::ComposeTRS(in.positions.GetData(), orientations.GetData(), in.scales.GetData(), out.GetData(), FD_TEST_TRANSFORM_COUNT);
+
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) {
+		//FromEuler follows mat4::Rotate, so both rotations have to give the same matrix
+		mat4 expected = mat4::Translate(in.positions[i]) * mat4::Rotate(in.rotations[i]) * mat4::Scale(in.scales[i]);
+
+		worst = fmaxf(worst, RelativeDifference(expected, out[i]));
+		worst = fmaxf(worst, RelativeDifference(expected, mat4::Translate(in.positions[i]) * mat4::Rotate(orientations[i]) * mat4::Scale(in.scales[i])));
+		worst = fmaxf(worst, RelativeDifference(expected, TransformBatch::ComposeTRS(in.positions[i], orientations[i], in.scales[i])));
+	}
+
+	EXPECT_LT(worst, FD_TEST_TRANSFORM_EPSILON);
+}
+
+TEST(Quat, RotateMatchesMatrix) {
+	TransformInput in;
+	float32 worst = 0.0f;
+
+	for (uint_t i = 0; i < FD_TEST_TRANSFORM_COUNT; i++) {
+		quat q = quat::FromEuler(in.rotations[i]);
+		mat4 m = mat4::Rotate(in.rotations[i]);
+
+		worst = fmaxf(worst, MaxDifference(m * in.positions[i], q * in.positions[i]) / 100.0f);
+		worst = fmaxf(worst, MaxDifference(m, q.ToMatrix()));
+
+		//The same rotation back, q and -q are both allowed
+		quat r = quat::FromMatrix(m);
+		float32 dot = fabsf(q.Dot(r));
+
+		worst = fmaxf(worst, fabsf(1.0f - dot));
+	}
+
+	EXPECT_LT(worst, FD_TEST_TRANSFORM_EPSILON);
+}
+
+}
+}
@@ -24,17 +24,16 @@ cbuffer Camera : register(b1) {
 	float4x4 c_ProjectionMatrix;
 };
 
-cbuffer Model : register(b5) {
-	float4x4 m_ModelMatrix;
-};
-
 cbuffer Light : register(b6) {
 	Light light;
 };
 
-Out vsMain(float3 position : POSITION, float3 normal : NORMAL, float2 texCoord : TEXCOORD, float3 tangent : TANGENT) {
+//Per instance, each row of the input is a column of the matrix
+Out vsMain(float3 position : POSITION, float3 normal : NORMAL, float2 texCoord : TEXCOORD, float3 tangent : TANGENT, float4x4 instanceModel : MODEL) {
 	Out o;
 
+	float4x4 m_ModelMatrix = transpose(instanceModel);
+
 /*	float3 T = normalize(mul(m_ModelMatrix, float4(tangent, 0.0)).xyz);
 	float3 N = mul(m_ModelMatrix, float4(normal, 0)).xyz;
 	
@@ -51,8 +51,6 @@ void PBRTest::OnInit() {
 	l.Push<vec2>("TEXCOORD");
 	l.Push<vec3>("TANGENT");
 
-	l.CreateInputLayout(shader);
-
 	Font::FD_RANGE<> r;
 
 	r.start = 0x20;
@@ -68,11 +66,15 @@ void PBRTest::OnInit() {
 
 	l.CreateInputLayout(skyboxShader);
 
+	//The spheres share a mesh and material, the renderer draws them as instances of one draw
+	l.PushInstanced<mat4>("MODEL");
+	l.CreateInputLayout(shader);
+
 	TextureCube* cubeMap = new TextureCube(new String[2]{ "res/cubemap.png", "" });
 
 	Material* skybox = new Material(skyboxShader);
 	skybox->SetTexture("m_EnvironmentMap", cubeMap);
-	skybox->SetVCBuffer("InverseViewMatrix", (void*)mat4::Inverse(camera->GetViewMatrix()).GetData());
+	skybox->SetVCBuffer("InverseViewMatrix", (void*)mat4::InverseRigid(camera->GetViewMatrix()).GetData());
 
 	skyboxMaterial = new Material(skybox);
 
@@ -193,7 +195,7 @@ void PBRTest::OnUpdate(float delta) {
 
 	light->SetPosition(vec3(cosf(aa) * 2.5f, 0.25f, -2));
 	
-	skyboxMaterial->SetVCBufferElement(0, (void*)mat4::Inverse(camera->GetViewMatrix()).GetData());
+	skyboxMaterial->SetVCBufferElement(0, (void*)mat4::InverseRigid(camera->GetViewMatrix()).GetData());
 
 	vec3 pos = vec3(cosf(aa) * 20.5f, 0.0f, 1);
 	//audio->UpdatePosition(pos, vec3(0, 0, 0));